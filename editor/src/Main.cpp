@@ -19,6 +19,7 @@ DISABLE_WARNINGS_PUSH()
 DISABLE_WARNINGS_POP()
 #include <Engine/Core/Keyboard.h>
 #include <Engine/Core/Mouse.h>
+#include <Engine/Core/Profiling.h>
 #include <Engine/Core/Stopwatch.h>
 #include <Engine/Core/Transform.h>
 #include <Engine/Core/Window.h>
@@ -52,6 +53,7 @@ DISABLE_WARNINGS_POP()
 #include <Engine/Util/FilePicker.h>
 #include <Engine/Util/ImguiHelpers.h>
 #include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <memory_resource>
@@ -114,6 +116,7 @@ struct RasterDebugPipeline {
 struct MeshShadingPipeline {
     inline static const char* guiName = "Mesh Shading";
     inline static bool bindless = true;
+    inline static bool meshletCulling = true;
 
     void buildFrameGraph(
         Render::FrameGraphBuilder& frameGraphBuilder, uint32_t frameBuffer,
@@ -126,7 +129,7 @@ struct MeshShadingPipeline {
         auto depthBuffer = frameGraphBuilder.createTransientResource(depthBufferDesc);
         frameGraphBuilder.clearDepthBuffer(depthBuffer);
         frameGraphBuilder.clearFrameBuffer(frameBuffer);
-        frameGraphBuilder.addOperation<Render::MeshShadingPass>({ .pScene = pScene, .bindless = bindless })
+        frameGraphBuilder.addOperation<Render::MeshShadingPass>({ .pScene = pScene, .bindless = bindless, .meshletCulling = meshletCulling })
             .bind<"framebuffer">(frameBuffer)
             .bind<"depthbuffer">(depthBuffer)
             .finalize();
@@ -135,6 +138,8 @@ struct MeshShadingPipeline {
     void displayGUI(bool& changed)
     {
         changed |= ImGui::Checkbox("Bindless", &bindless);
+        if (bindless)
+            changed |= ImGui::Checkbox("Meshlet culling", &meshletCulling);
     }
 };
 struct RayTraceDebugInlinePipeline {
@@ -550,7 +555,8 @@ static Render::FrameGraph buildFrameGraphImGuiWindowed(
     Render::RenderContext& renderContext,
     Render::Scene* pScene,
     const Core::Keyboard* pKeyboard,
-    ShouldUpdate* pShouldUpdate)
+    ShouldUpdate* pShouldUpdate,
+    Render::FrameGraph* pPreviousFrameGraph)
 {
     Render::FrameGraphBuilder frameGraphBuilder { &renderContext };
     const auto finalFrameBuffer = frameGraphBuilder.getSwapChainResource();
@@ -567,7 +573,7 @@ static Render::FrameGraph buildFrameGraphImGuiWindowed(
     frameGraphBuilder.addOperation<Render::ImGuiPass>()
         .bind<"framebuffer">(finalFrameBuffer)
         .finalize();
-    return frameGraphBuilder.compile();
+    return frameGraphBuilder.compile(pPreviousFrameGraph);
 }
 
 void mainFunc(HINSTANCE hInstance, int nCmdShow)
@@ -616,9 +622,11 @@ void mainFunc(HINSTANCE hInstance, int nCmdShow)
     });
 
     Core::Stopwatch stopwatch;
+    Core::CPUProfiler cpuProfiler { 32 };
     Render::GPUFrameProfiler gpuProfiler { renderContext, 32 };
     spdlog::info("Start render");
     while (!window.shouldClose && !keyboard.isKeyPress(Core::Key::ESCAPE)) {
+        cpuProfiler.newFrame();
         renderContext.waitForNextFrame();
         renderContext.resetFrameAllocators();
         window.updateInput(true);
@@ -627,18 +635,22 @@ void mainFunc(HINSTANCE hInstance, int nCmdShow)
 
         if (shaderHotReload.shouldReloadShaders()) {
             spdlog::debug("Shaders changed");
+            renderContext.pipelineStateCache.clear();
             shouldUpdate.rebuildFrameGraph = true;
         }
 
         // Rebuild the frame graph if necessary (e.g. window resize).
         if (shouldUpdate.rebuildFrameGraph) {
+            PROFILE_ZONE("Rebuild frame graph");
             renderContext.waitForIdle();
             if (shouldUpdate.resizeSwapChain) {
-                frameGraph.reset();
+                if (frameGraph)
+                    frameGraph->releaseSwapChainResources();
                 renderContext.resizeSwapChain(window.size);
             }
             scene.camera.aspectRatio = (float)shouldUpdate.viewportResolution.x / (float)shouldUpdate.viewportResolution.y;
-            frameGraph = buildFrameGraphImGuiWindowed(settings, renderContext, &scene, &keyboard, &shouldUpdate);
+            // Only the transient resources are recreated; the pipeline states and transient memory of the previous frame graph are reused.
+            frameGraph = buildFrameGraphImGuiWindowed(settings, renderContext, &scene, &keyboard, &shouldUpdate, frameGraph ? &frameGraph.value() : nullptr);
             shouldUpdate.rebuildFrameGraph = false;
             shouldUpdate.resizeSwapChain = false;
         }
@@ -669,6 +681,14 @@ void mainFunc(HINSTANCE hInstance, int nCmdShow)
 
         ImGui::Begin("Profiler");
         gpuProfiler.displayVerticalGUI();
+        if (ImGui::Button("Export trace")) {
+            // Written to the working directory; open in chrome://tracing or https://ui.perfetto.dev.
+            auto tracks = cpuProfiler.getTimeline();
+            for (auto& track : gpuProfiler.getTimeline())
+                tracks.push_back(std::move(track));
+            std::ofstream { "profile_trace.json" } << Core::exportChromeTrace(tracks);
+            spdlog::info("Exported profile trace to profile_trace.json ({} zones dropped)", cpuProfiler.numDroppedZones());
+        }
         ImGui::End();
 
         ImGui::Begin("Frame Graph");
@@ -1,11 +1,136 @@
 #pragma once
+#include <tbx/move_only.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <vector>
+
+// Scoped CPU profiling zones; compiled out unless ENABLE_CPU_PROFILING is set (see DX12_RENDER_ENABLE_PROFILING). Zones
+// are only recorded while a Core::CPUProfiler exists. The name must be a string literal (or otherwise outlive the profiler).
+#if defined(ENABLE_CPU_PROFILING) && ENABLE_CPU_PROFILING
+#define PROFILE_ZONE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) const Core::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __COUNTER__) { name }
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#endif
 
 namespace Core {
 
+// Time in nanoseconds. On Windows std::chrono::steady_clock is based on QueryPerformanceCounter, which is also the CPU
+// clock that ID3D12CommandQueue::GetClockCalibration() returns, such that GPU timestamps can be converted to this clock.
+inline uint64_t profileClockNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Interval on the profiling timeline, in nanoseconds (see profileClockNow()).
 struct ProfileTask {
     std::string name;
     uint64_t start, end;
 };
 
+// Tasks that are executed by one thread or GPU queue; tasks may be nested but should not partially overlap.
+struct ProfileTrack {
+    std::string name;
+    std::vector<ProfileTask> tasks;
+};
+
+// Chrome trace-event JSON format, which can be opened in chrome://tracing or https://ui.perfetto.dev. Every track is shown
+// as a separate thread; times are relative to the first task.
+std::string exportChromeTrace(std::span<const ProfileTrack> tracks);
+
+// Collects the zones of all threads. Each thread records into its own lock-free (single producer, single consumer) ring
+// buffer which is drained by newFrame(); zones are dropped when the ring buffer of a thread is full.
+//
+// At most one profiler exists at a time. It is published through an atomic pointer such that zones can be opened from any
+// thread while it is created or destroyed. Zones that are still open when the profiler is destroyed are not recorded, but
+// the profiler must not be destroyed while other threads may close a zone (join or idle the worker threads first).
+class CPUProfiler {
+public:
+    CPUProfiler(uint32_t resolvedFrameStorage, uint32_t zonesPerThread = 16 * 1024);
+    ~CPUProfiler();
+    NO_COPY(CPUProfiler);
+    NO_MOVE(CPUProfiler);
+
+    inline static CPUProfiler* getInstance()
+    {
+        return s_pInstance.load(std::memory_order_acquire);
+    }
+
+    // Thread-safe; only takes a lock the first time that a thread records a zone.
+    void recordZone(const char* name, uint64_t start, uint64_t end);
+
+    // Moves the zones that were recorded since the previous call into a new frame. newFrame() and getTimeline() must be
+    // called from the same thread.
+    void newFrame();
+    // A track with the frames followed by one track per thread, containing the zones of the stored frames.
+    std::vector<ProfileTrack> getTimeline() const;
+    uint64_t numDroppedZones() const;
+
+private:
+    struct Zone {
+        const char* name;
+        uint64_t start, end;
+    };
+    struct ThreadBuffer {
+        std::vector<Zone> zones;
+        std::atomic_uint64_t writeIdx = 0, readIdx = 0;
+        std::atomic_uint64_t numDroppedZones = 0;
+    };
+    ThreadBuffer& getThreadBuffer();
+
+private:
+    inline static std::atomic<CPUProfiler*> s_pInstance { nullptr };
+
+    const uint64_t m_id;
+    const uint32_t m_resolvedFrameStorage;
+    const uint32_t m_zonesPerThread; // Power of 2.
+
+    mutable std::mutex m_threadBuffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+
+    struct FrameZone {
+        uint32_t threadIdx;
+        Zone zone;
+    };
+    struct Frame {
+        uint64_t start, end;
+        std::vector<FrameZone> zones;
+    };
+    uint64_t m_frameStart;
+    std::deque<Frame> m_resolvedFrames; // Oldest first.
+};
+
+// Records a zone from construction until destruction; use the PROFILE_ZONE macro instead.
+class ProfileZone {
+public:
+    inline ProfileZone(const char* name)
+        : m_pProfiler(CPUProfiler::getInstance())
+        , m_name(name)
+        , m_start(m_pProfiler ? profileClockNow() : 0)
+    {
+    }
+    inline ~ProfileZone()
+    {
+        // Skip the zone if the profiler that it was opened with has been destroyed in the meantime.
+        if (m_pProfiler && m_pProfiler == CPUProfiler::getInstance())
+            m_pProfiler->recordZone(m_name, m_start, profileClockNow());
+    }
+    NO_COPY(ProfileZone);
+    NO_MOVE(ProfileZone);
+
+private:
+    CPUProfiler* m_pProfiler;
+    const char* m_name;
+    uint64_t m_start;
+};
+
 }
@@ -0,0 +1,58 @@
+#pragma once
+#include "Engine/Memory/Memory.h"
+#include <tbx/move_only.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Memory {
+
+// Offset-based ring allocator for per-frame data that is written by many threads at the same time. The ring is divided
+// into chunks; threads reserve a chunk with an atomic fetch-add and then sub-allocate from it without any synchronization.
+// Memory of the last numFramesInFlight frames (including the current one) is never handed out again; allocations that
+// would overwrite it throw.
+class ConcurrentRingAllocator {
+public:
+    ConcurrentRingAllocator(size_t size, size_t chunkSize, uint32_t numFramesInFlight);
+    NO_COPY(ConcurrentRingAllocator);
+    NO_MOVE(ConcurrentRingAllocator);
+
+    // Thread-safe.
+    Offset allocate(size_t size, size_t alignment);
+    // Must not be called while other threads are allocating.
+    void newFrame();
+
+    size_t size() const;
+    size_t chunkSize() const;
+
+private:
+    struct ThreadState {
+        uint64_t frameIdx = (uint64_t)-1; // Frame in which the chunk was reserved.
+        uint64_t chunkIdx;
+        size_t offsetInChunk;
+    };
+    ThreadState& getThreadState();
+    // Returns the index of the first chunk; chunk indices increase monotonically (modulo numChunks gives the position in the ring).
+    uint64_t reserveChunks(uint64_t numChunks);
+
+private:
+    const uint64_t m_id;
+    size_t m_chunkSize;
+    uint64_t m_numChunks;
+
+    std::atomic_uint64_t m_nextChunkIdx { 0 };
+    // Written by newFrame() only.
+    uint64_t m_frameIdx = 0;
+    uint64_t m_chunkIdxLimit; // Allocations may not reach this chunk (index), it contains data of a frame in flight.
+    std::deque<uint64_t> m_frameStartChunkIndices; // The first chunk of each frame in flight; the current frame is at the back.
+
+    std::mutex m_threadStatesMutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadState>> m_threadStates;
+};
+
+}
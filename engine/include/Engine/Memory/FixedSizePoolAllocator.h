@@ -1,26 +1,40 @@
 #pragma once
 #include "Engine/Memory/PoolAllocator.h"
 #include <tbx/move_only.h>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <span>
 
 namespace Memory {
 
+// Lock-free: allocate() and deallocate() may be called from multiple threads at the same time.
 class FixedSizePoolAllocator : public PoolAllocator {
 public:
     FixedSizePoolAllocator(std::span<std::byte> memory, size_t allocationSize);
     NO_COPY(FixedSizePoolAllocator);
 
+    // Returns nullptr when all blocks are in use.
     void* allocate() override;
     void deallocate(void* pMemory) override;
 
+    size_t numBlocks() const;
+
+private:
+    static constexpr uint32_t noBlock = (uint32_t)-1;
+
 private:
-    const size_t m_poolSize;
+    std::byte* const m_pMemory;
+    const uint32_t m_numBlocks;
+    // The free list is stored outside of the blocks; otherwise allocate() could read from a block that another thread just
+    // allocated (and is writing to).
+    std::unique_ptr<std::atomic<uint32_t>[]> m_pNextFreeBlock;
 
-	struct Header {
-        Header* pNext;
-	};
-    Header* m_pHead;
+    // The index of the first free block (lower 32 bits) and a tag (upper 32 bits) which is incremented on every allocation.
+    // Without the tag, a thread could pop block A (next = B) while other threads pop A & B and push A back; the compare-exchange
+    // would then succeed and install B as the head even though it is in use (the ABA problem).
+    std::atomic<uint64_t> m_head;
 };
 
 }
@@ -2,9 +2,12 @@
 
 namespace Memory {
 
+class ConcurrentRingAllocator;
 class FixedSizePoolAllocator;
 class LinearAllocator;
 class PoolAllocator;
+class SegregatedFitAllocator;
+class ThreadLocalLinearAllocator;
 class UnintrusiveBuddyAllocator;
 
 }
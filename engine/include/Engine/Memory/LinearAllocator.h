@@ -15,13 +15,15 @@ public:
     ~LinearAllocator();
 
     void* allocate(size_t size, size_t alignment = 8);
+    // Same as allocate() but returns nullptr when the pool allocator is out of memory.
+    void* tryAllocate(size_t size, size_t alignment = 8);
     void deallocate(void*);
 
     size_t maxAllocationSize();
     void reset();
 
 private:
-    void allocateNewBlock();
+    bool allocateNewBlock();
     void initializeNewBlock(std::span<std::byte> memory);
 
 private:
@@ -0,0 +1,83 @@
+#pragma once
+#include "Engine/Memory/Memory.h"
+#include <tbx/move_only.h>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Memory {
+
+struct SegregatedFitAllocatorStatistics {
+    size_t numAllocations; // Including the allocations that have a pending deallocation.
+    size_t numPendingDeallocations;
+    size_t allocatedSize;
+    size_t freeSize;
+    size_t largestFreeRangeSize;
+    size_t numFreeRanges;
+};
+
+// Unintrusive offset-based allocator (like UnintrusiveBuddyAllocator) for memory that is not accessible by the CPU, such
+// as descriptor heaps. Free ranges are stored in segregated free lists, one per power of 2 size class, and a bit mask
+// stores which of those lists are non-empty. Allocating takes the first free range of the smallest size class whose ranges
+// are all large enough, and splits it; deallocating merges the range with its free neighbours. Both are O(1): when none
+// of those size classes has a free range, only the first few ranges in the size class of the allocation are searched.
+//
+// The bookkeeping of each range (its size, its free list links & a tag at its end to find the left neighbour) is stored
+// in a contiguous array that is indexed by offset.
+//
+// Deallocations of memory that may still be in use by the GPU can be deferred until a fence value has been reached.
+class SegregatedFitAllocator {
+public:
+    SegregatedFitAllocator(size_t size);
+    NO_COPY(SegregatedFitAllocator);
+    DEFAULT_MOVE(SegregatedFitAllocator);
+
+    // Returns std::nullopt when there is no free range of the requested size.
+    std::optional<Offset> tryAllocate(size_t size);
+    void deallocate(Offset offset);
+    // Deallocate the memory once retire() is called with a completed fence value of at least fenceValue.
+    void deallocateAfter(Offset offset, uint64_t fenceValue);
+    void retire(uint64_t completedFenceValue);
+
+    void reset();
+
+    inline size_t size() const { return m_size; }
+    inline size_t numAllocations() const { return m_numAllocations; }
+    // Bit i is set if there is a free range of size [2^i, 2^(i+1)).
+    inline uint32_t nonEmptySizeClasses() const { return m_nonEmptySizeClasses; }
+    SegregatedFitAllocatorStatistics getStatistics() const;
+
+private:
+    static constexpr uint32_t null = (uint32_t)-1;
+    static constexpr uint32_t numSizeClasses = 31;
+
+    void insertFreeRange(uint32_t start, uint32_t size);
+    void removeFreeRange(uint32_t start);
+    void setRange(uint32_t start, uint32_t size, bool free);
+
+private:
+    struct Boundary {
+        uint32_t size : 31 = 0; // Size of the range that starts at this offset; 0 if no range starts here.
+        uint32_t free : 1 = false;
+        uint32_t start = 0; // Start of the range that ends at this offset.
+        uint32_t prevFree = null, nextFree = null; // Free list links of the free range that starts at this offset.
+    };
+    struct PendingDeallocation {
+        Offset offset;
+        uint64_t fenceValue;
+    };
+
+    uint32_t m_size;
+    std::vector<Boundary> m_boundaries;
+    std::array<uint32_t, numSizeClasses> m_freeListHeads;
+    uint32_t m_nonEmptySizeClasses = 0;
+    std::deque<PendingDeallocation> m_pendingDeallocations;
+
+    size_t m_numAllocations = 0;
+    size_t m_allocatedSize = 0;
+    size_t m_numFreeRanges = 0;
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Engine/Memory/FixedSizePoolAllocator.h"
+#include "Engine/Memory/LinearAllocator.h"
+#include <tbx/disable_all_warnings.h>
+#include <tbx/move_only.h>
+DISABLE_WARNINGS_PUSH()
+// Hide macro error in intrin0.h included by memory_resource
+#include <memory_resource>
+DISABLE_WARNINGS_POP()
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Memory {
+
+// Scratch memory that lives until the next call to reset() (e.g. one frame). Every thread allocates from its own
+// LinearAllocator, which takes blocks from a shared (lock-free) FixedSizePoolAllocator; allocating does not require any
+// synchronization except when a thread runs out of space in its current block, or allocates for the very first time.
+// Allocations that do not fit comfortably in a block, or that are made while the pool is exhausted, fall back to the
+// global heap and are freed on reset().
+//
+// Deallocating is a noop, so this can be used with std::pmr containers:
+//  std::pmr::vector<int> values { &threadLocalLinearAllocator };
+class ThreadLocalLinearAllocator : public std::pmr::memory_resource {
+public:
+    ThreadLocalLinearAllocator(size_t blockSize = 64 * 1024, size_t numBlocks = 256);
+    NO_COPY(ThreadLocalLinearAllocator);
+    ~ThreadLocalLinearAllocator() override;
+
+    void* allocate(size_t size, size_t alignment = 8);
+    // Frees all allocations of all threads at once. Must not be called while other threads are allocating.
+    void reset();
+
+    size_t blockSize() const;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void* pMemory, size_t size, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    LinearAllocator& getThreadAllocator();
+    void* allocateLarge(size_t size, size_t alignment);
+
+private:
+    const uint64_t m_id;
+    std::unique_ptr<std::byte[]> m_pPoolMemory;
+    FixedSizePoolAllocator m_blockPool;
+
+    std::mutex m_threadAllocatorsMutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<LinearAllocator>> m_threadAllocators;
+
+    struct LargeAllocation {
+        LargeAllocation* pNext;
+        size_t alignment;
+    };
+    std::atomic<LargeAllocation*> m_pLargeAllocations { nullptr };
+};
+
+}
@@ -1,41 +1,75 @@
 #pragma once
 #include "Engine/Memory/Memory.h"
 #include <tbx/move_only.h>
-#include <deque>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace Memory {
 
+struct BuddyAllocatorStatistics {
+    size_t numAllocations;
+    size_t allocatedSize; // Sum of the (power of 2) block sizes of the allocations.
+    size_t freeSize;
+    size_t largestFreeBlockSize; // The largest allocation that is guaranteed to succeed.
+    size_t numFreeBlocks;
+
+    // Fraction of the free memory that is not part of the largest free block: 0 if all free memory is contiguous.
+    float externalFragmentation() const;
+};
+
 // Unintrusive buddy allocator that uses offsets instead of pointers and is thus unable to use unallocated memory
 // for bookkeeping. This is less efficient than a regular (intrusive) allocator but such a unintrusive pointer-less
 // allocator can be used for allocation memory that is not accessible by the CPU (such as descriptors & GPU memory).
+//
+// Every level of the binary tree stores a bitmap of its free blocks and a bitmap of its blocks that have been split.
+// The free bitmap of each level is summarized by a hierarchy of bitmaps (bit i is set if word i of the level below is not
+// zero) that ends in a single word. Finding a free block takes one count-trailing-zeros per summary level (at most 5),
+// so allocating and deallocating are O(levels) without scanning any bitmap.
 class UnintrusiveBuddyAllocator {
 public:
     UnintrusiveBuddyAllocator(Offset baseOffset, size_t size, size_t minAllocationSize = 64);
     NO_COPY(UnintrusiveBuddyAllocator);
     DEFAULT_MOVE(UnintrusiveBuddyAllocator);
 
+    // Throws when out of memory.
     Offset allocate(size_t size);
+    // Returns std::nullopt when out of memory.
+    std::optional<Offset> tryAllocate(size_t size);
     void deallocate(Offset offset);
 
     void reset();
 
+    BuddyAllocatorStatistics getStatistics() const;
+
 private:
-    bool allocateRecurse(uint32_t nodeIdx, uint32_t depth, size_t offset, size_t size, Offset* pOutOffset);
-    void deallocateRecurse(uint32_t nodeIdx, uint32_t depth, Offset currentNodeOffset, Offset offsetToFree);
+    // 2^31 blocks (32 levels) take 2^25 words, which are summarized by 2^19, 2^13, 2^7, 2 and 1 words.
+    static constexpr uint32_t maxSummaryLevels = 5;
+    struct Bitmap {
+        uint32_t firstWord; // Offset into m_freeBits / m_splitBits.
+        uint32_t numWords;
+        uint32_t numSummaryLevels;
+        std::array<uint32_t, maxSummaryLevels> firstSummaryWords; // Offsets into m_freeWordsSummary, from fine to coarse.
+    };
 
-    struct TreeNode {
-        TreeNode(); // Zero initialize
+    size_t blockSize(uint32_t level) const;
+    uint32_t levelForSize(size_t size) const;
+    uint32_t findFreeBlock(uint32_t level) const;
 
-        uint32_t firstChild : 30;
-        uint32_t containsData : 1;
-        uint32_t hasChildren : 1;
-    };
+    bool testBit(const std::vector<uint64_t>& bits, uint32_t level, uint32_t blockIdx) const;
+    void setSplit(uint32_t level, uint32_t blockIdx, bool split);
+    void setFree(uint32_t level, uint32_t blockIdx, bool free);
 
 private:
-    std::vector<TreeNode> m_binaryTreeMemory;
-    std::deque<uint32_t> m_nodePairFreeList;
-    uint32_t m_rootIdx;
+    uint32_t m_numLevels;
+    std::vector<Bitmap> m_levelBitmaps;
+    std::vector<uint64_t> m_freeBits;
+    std::vector<uint64_t> m_splitBits;
+    std::vector<uint64_t> m_freeWordsSummary; // Bit i is set if word i of the bitmap below (of that level) is not zero.
+    std::vector<uint32_t> m_numFreeBlocks; // Per level.
+    size_t m_numAllocations;
+    size_t m_allocatedSize;
 
     size_t m_baseOffset;
     size_t m_size;
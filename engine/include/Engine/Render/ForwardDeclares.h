@@ -21,15 +21,25 @@ enum class TextureFileType {
 struct Camera;
 class DebugBufferReader;
 struct TextureCPU;
+struct TextureCPUView;
 struct Texture;
 struct SubMesh;
 struct Material;
 struct Mesh;
+struct MeshCPU;
+struct MeshCPUView;
+struct Meshlet;
+class MeshletCuller;
 class GPUFrameProfiler;
 struct RenderContext;
 template <typename T>
 struct Transformable;
 struct Scene;
+class SceneBinary;
+class SceneConversionCache;
+class SceneUploadSink;
+struct StreamingLoadSettings;
+struct StreamingLoadStats;
 class ShaderCache;
 class ShaderHotReload;
 struct PointLight;
@@ -0,0 +1,59 @@
+#pragma once
+#include "Engine/Render/FrameGraph/FrameGraphInternal.h"
+#include "Engine/RenderAPI/Internal/D3D12Includes.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+enum class FGBarrierType {
+    Aliasing,
+    Transition,
+    UAV
+};
+// Device independent description of a resource barrier; resources are referred to by their index in the resource registry.
+struct FGBarrier {
+    static constexpr uint32_t AllResources = (uint32_t)-1; // UAV barrier on all resources (merged UAV barriers).
+
+    FGBarrierType barrierType;
+    uint32_t resourceIdx;
+    D3D12_RESOURCE_STATES stateBefore = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_STATES stateAfter = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE; // BEGIN_ONLY/END_ONLY for split transitions.
+};
+
+struct FGBarrierStatistics {
+    uint32_t numBatches = 0; // Number of (non-empty) ResourceBarrier() calls per frame.
+    uint32_t numTransitions = 0;
+    uint32_t numSplitTransitions = 0; // Each split transition consists of a BEGIN_ONLY and an END_ONLY barrier.
+    uint32_t numUAVBarriers = 0;
+    uint32_t numMergedUAVBarriers = 0; // UAV barriers that were removed by merging them into a single global UAV barrier.
+    uint32_t numAliasingBarriers = 0;
+};
+
+// Barriers of a single frame, grouped into one batch per render pass. Batch i is recorded right before render pass i, the
+// last batch (numPasses) at the end of the frame. The plan is cyclic: every frame ends with all resources in their initial state.
+struct FGBarrierPlan {
+    std::vector<FGBarrier> barriers;
+    std::vector<size_t> batchStarts; // Batch i covers barriers[batchStarts[i], batchStarts[i + 1]).
+    std::vector<D3D12_RESOURCE_STATES> initialStates; // State of each resource at the start of every frame.
+    FGBarrierStatistics statistics;
+
+    size_t numBatches() const { return batchStarts.size() - 1; }
+    std::span<const FGBarrier> batch(size_t batchIdx) const;
+};
+
+struct FGBarrierPlannerSettings {
+    // Use split barriers for transitions of resources whose next use is at least minSplitDistance passes after their previous use.
+    bool splitBarriers = true;
+    uint32_t minSplitDistance = 2;
+    // Replace multiple UAV barriers in a single batch by one UAV barrier on all resources.
+    bool mergeUAVBarriers = true;
+};
+
+// Pure CPU function (no device access), only the resource type of the resources is used.
+FGBarrierPlan planBarriers(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses, const FGBarrierPlannerSettings& settings = {});
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Engine/Render/FrameGraph/BarrierPlanner.h"
+#include "Engine/Render/FrameGraph/QueueScheduling.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+// Contiguous range of render passes (in FGQueueSchedule::operationOrder) that is recorded into a single command list.
+struct FGPassGroup {
+    size_t operationBegin, operationEnd;
+    uint32_t segmentIdx = 0;
+};
+
+// Splits numOperations render passes into (at most) maxNumGroups groups of similar size with at least minPassesPerGroup
+// passes each; there is always at least one group.
+std::vector<FGPassGroup> partitionPassGroups(size_t numOperations, size_t maxNumGroups, size_t minPassesPerGroup);
+// Splits each segment of the queue schedule into pass groups; a pass group never spans multiple segments.
+std::vector<FGPassGroup> partitionPassGroups(const FGQueueSchedule& queueSchedule, size_t maxNumGroups, size_t minPassesPerGroup);
+
+// Split barriers must begin and end in the same command list. Returns a copy of the barrier plan in which split transitions
+// that cross a pass group boundary are replaced by a regular transition (at the location of the END_ONLY barrier).
+FGBarrierPlan legalizeSplitBarriers(const FGBarrierPlan& barrierPlan, const FGQueueSchedule& queueSchedule, std::span<const FGPassGroup> passGroups);
+
+// Receives the commands of one pass group. Implemented on top of an ID3D12GraphicsCommandList by the frame graph; tests
+// use a CPU-side implementation to verify the order of the recorded commands.
+class IFGCommandRecorder {
+public:
+    virtual ~IFGCommandRecorder() = default;
+
+    virtual void recordBarriers(std::span<const FGBarrier> barriers) = 0;
+    virtual void recordRenderPass(size_t operationIdx) = 0;
+};
+
+// Records each pass group into its own recorder; the groups are recorded in parallel. Each render pass is preceded by its
+// batch of barriers and the last group of a segment ends with the signal barriers of the segment. The first group starts
+// with initialBarriers and the last group ends with the end of frame barriers, such that submitting the recorders of a
+// graphics-only frame graph in order is equivalent to recording all passes into a single recorder.
+void recordPassGroups(const FGBarrierPlan& barrierPlan, const FGQueueSchedule& queueSchedule, std::span<const FGBarrier> initialBarriers, std::span<const FGPassGroup> passGroups, std::span<IFGCommandRecorder* const> recorders);
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Render/FrameGraph/BarrierPlanner.h"
+#include "Engine/Render/FrameGraph/FrameGraphInternal.h"
+#include "Engine/Render/FrameGraph/PassOrdering.h"
+#include "Engine/Render/FrameGraph/QueueScheduling.h"
+#include "Engine/Render/FrameGraph/RenderPass.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+struct FGPlanResource {
+    static constexpr uint32_t noPass = (uint32_t)-1;
+
+    FGResourceType resourceType;
+    uint64_t width;
+    uint32_t height;
+    DXGI_FORMAT format;
+    uint32_t firstPassIdx = noPass, lastPassIdx = noPass; // Lifetime (inclusive); noPass if no render pass uses the resource.
+    D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON;
+    // Placement within the transient heaps (transient resources only).
+    uint32_t heapIdx = 0;
+    size_t heapOffset = 0, sizeInBytes = 0;
+};
+
+struct FGPlanPass {
+    std::string name;
+    RenderPassQueue queue;
+    std::vector<FGResourceAccess> resourceAccesses;
+};
+
+// Everything that FrameGraphBuilder::compile() decided, without any device objects: the order of the render passes, the
+// lifetimes & placement of the resources, and the barriers. Used to inspect frame graphs offline and to compare them
+// between builds.
+struct FGCompiledPlan {
+    std::vector<FGPlanResource> resources;
+    std::vector<FGPlanPass> passes; // In execution order.
+    std::vector<size_t> heapSizes; // Sizes of the transient heaps.
+    FGPassOrderStatistics passOrderStatistics;
+    FGQueueSchedule queueSchedule;
+    FGBarrierPlan barrierPlan;
+    std::vector<FGBarrier> initialBarriers; // Recorded once, before the first frame.
+};
+
+// Fills in the resources (except for their initial state & placement) and the render passes; the other fields are left empty.
+FGCompiledPlan createCompiledPlan(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses);
+
+// Both formats are deterministic such that the exported plans of two builds can be compared with a text diff.
+std::string exportPlanToJSON(const FGCompiledPlan& plan);
+// Render passes (boxes, grouped by queue segment) connected to the resources (ellipses) that they read or write; dashed
+// edges are fence waits between the queue segments.
+std::string exportPlanToGraphviz(const FGCompiledPlan& plan);
+
+}
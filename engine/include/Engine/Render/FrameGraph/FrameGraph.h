@@ -2,9 +2,14 @@
 #include "Engine/Memory/ForwardDeclares.h"
 #include "Engine/Memory/LinearAllocator.h"
 #include "Engine/Render/ForwardDeclares.h"
+#include "Engine/Render/FrameGraph/BarrierPlanner.h"
+#include "Engine/Render/FrameGraph/CommandRecording.h"
+#include "Engine/Render/FrameGraph/CompiledPlan.h"
 #include "Engine/Render/FrameGraph/FrameGraphInternal.h"
 #include "Engine/Render/FrameGraph/FrameGraphRegistry.h"
+#include "Engine/Render/FrameGraph/QueueScheduling.h"
 #include "Engine/Render/FrameGraph/RenderPass.h"
+#include "Engine/RenderAPI/Descriptor/CpuDescriptorLinearAllocator.h"
 #include "Engine/RenderAPI/MaResource.h"
 #include "Engine/RenderAPI/MemoryAliasing.h"
 #include "Engine/RenderAPI/RenderAPI.h"
@@ -33,6 +38,12 @@ public:
 
     void displayGUI() const;
     void execute(GPUFrameProfiler* pProfiler = nullptr);
+    // Drop the references to the swap chain back buffers so that the swap chain can be resized while this frame graph is
+    // kept around to be passed to FrameGraphBuilder::compile().
+    void releaseSwapChainResources();
+
+    // Export with exportPlanToJSON()/exportPlanToGraphviz() to inspect the compiled frame graph offline.
+    const FrameGraphInternal::FGCompiledPlan& getCompiledPlan() const { return m_compiledPlan; }
 
     RenderAPI::D3D12MAResource const* getPersistentResource(uint32_t resourceIdx) const
     {
@@ -43,14 +54,36 @@ public:
 
 private:
     friend class FrameGraphBuilder;
+    class CommandRecorder;
 
 private:
     Tbx::MovePointer<RenderContext> m_pRenderContext;
     std::vector<FrameGraphInternal::FGResource> m_resourceRegistry;
     std::vector<FrameGraphInternal::FGResourceAccess> m_resourceAccesses;
     std::vector<FrameGraphInternal::FGRenderPass> m_operations;
+    // Render passes are submitted to their queue in segments, which are synchronized with fences (see scheduleQueues()).
+    // Each pass group (part of a segment) is recorded into its own command list, in parallel.
+    FrameGraphInternal::FGQueueSchedule m_queueSchedule;
+    std::vector<FrameGraphInternal::FGPassGroup> m_passGroups;
+    // Barriers are planned by FrameGraphBuilder::compile(). Resources that cannot be created in their initial state are
+    // transitioned by m_initialBarriers at the start of the first frame.
+    FrameGraphInternal::FGBarrierPlan m_barrierPlan;
+    std::vector<FrameGraphInternal::FGBarrier> m_initialBarriers;
+    // Render target & depth stencil views are created by FrameGraphBuilder::compile(), one per resource access that uses the
+    // resource as a render target or depth buffer. Swap chain accesses get a view for each back buffer; execute() points
+    // m_attachmentViews to the view of the current back buffer.
+    std::optional<RenderAPI::CPUDescriptorLinearAllocator> m_rtvDescriptorAllocator, m_dsvDescriptorAllocator;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_attachmentViews;
+    std::vector<FrameGraphInternal::FGSwapChainView> m_swapChainViews;
 
     std::optional<RenderAPI::ResourceAliasManager> m_resourceAliasingManager;
+    // Graphics fence value that is signaled once the GPU has finished the last execute() (including async compute).
+    uint64_t m_lastFenceValue = 0;
+    size_t m_transientMemorySize = 0, m_greedyTransientMemorySize = 0; // For comparison with the placement a runtime allocator would find.
+    // Device independent copy of the compiled frame graph (pass order, resource lifetimes & placement, barriers).
+    FrameGraphInternal::FGCompiledPlan m_compiledPlan;
+    float m_compileTimeInMs = 0.0f;
+    RenderAPI::PipelineStateCache::Statistics m_pipelineStateStatistics; // Pipeline states created/reused by compile().
     std::vector<RenderAPI::D3D12MAResource> m_persistentResourcesAllocations;
 };
 
@@ -75,7 +108,10 @@ public:
     uint32_t createPersistentResource(const CD3DX12_RESOURCE_DESC& desc, Formats formats = {});
     glm::uvec2 getTextureResolution(uint32_t resourceIdx) const;
 
-    FrameGraph compile();
+    // Pipeline states are shared with previously compiled frame graphs through the RenderContext. The transient memory of
+    // pPreviousFrameGraph is reused if it is large enough; the previous frame graph must no longer be in use by the GPU
+    // (asserted), for example by calling RenderContext::waitForIdle() first.
+    FrameGraph compile(FrameGraph* pPreviousFrameGraph = nullptr);
 
 private:
     template <render_pass T, typename... Args>
@@ -124,11 +160,12 @@ namespace FrameGraphInternal {
                 renderPass.displayGUI();
         }
 
-        void execute(std::span<const FGResource> resourceRegistry, std::span<const FGResourceAccess> resourceAccesses, const FrameGraphExecuteArgs& args) override
+        void execute(std::span<const FGResource> resourceRegistry, std::span<const FGResourceAccess> resourceAccesses, std::span<const D3D12_CPU_DESCRIPTOR_HANDLE> attachmentViews, const FrameGraphExecuteArgs& args) override
         {
             FrameGraphRegistry<T> registry;
             registry.m_resourceRegistry = resourceRegistry;
             registry.m_resourceAccesses = resourceAccesses;
+            registry.m_attachmentViews = attachmentViews;
             renderPass.execute(registry, args);
         }
 
@@ -160,6 +197,11 @@ template <render_pass T, typename... Args>
     }
     renderPass.pImplementation = std::move(pImplementation);
     renderPass.renderPassType = T::renderPassType;
+    if constexpr (render_pass_has_queue<T>) {
+        static_assert(T::queue == RenderPassQueue::Graphics || T::renderPassType == RenderPassType::Compute || T::renderPassType == RenderPassType::RayTracing,
+            "Only compute & ray tracing passes can run on the async compute queue");
+        renderPass.queue = T::queue;
+    }
     renderPass.resourceAccessBegin = m_resourceAccesses.size();
     m_resourceAccesses.resize(m_resourceAccesses.size() + builder.m_bindings.numUnbound());
     renderPass.resourceAccessEnd = m_resourceAccesses.size();
@@ -25,7 +25,6 @@ struct FGResource {
 
     // Non-owning pointer to the same resource.
     WRL::ComPtr<ID3D12Resource> pResource;
-    D3D12_RESOURCE_STATES currentState;
 
     CD3DX12_RESOURCE_DESC desc;
     DXGI_FORMAT dsvFormat;
@@ -43,6 +42,12 @@ struct FGResourceAccess {
     D3D12_RESOURCE_STATES desiredState;
 };
 
+// The render target/depth stencil views of a swap chain resource access; one view per back buffer, stored consecutively.
+struct FGSwapChainView {
+    size_t resourceAccessIdx;
+    CD3DX12_CPU_DESCRIPTOR_HANDLE firstBackBufferView;
+};
+
 struct IFGRenderPassImpl {
     virtual ~IFGRenderPassImpl() = default;
 
@@ -50,13 +55,14 @@ struct IFGRenderPassImpl {
     virtual void destroy(RenderContext&) = 0;
     virtual bool willDisplayGUI() const = 0;
     virtual void displayGUI() = 0;
-    virtual void execute(std::span<const FGResource>, std::span<const FGResourceAccess>, const FrameGraphExecuteArgs&) = 0;
+    virtual void execute(std::span<const FGResource>, std::span<const FGResourceAccess>, std::span<const D3D12_CPU_DESCRIPTOR_HANDLE>, const FrameGraphExecuteArgs&) = 0;
 };
 
 struct FGRenderPass {
     Tbx::MovePointer<RenderContext> pRenderContext;
     std::unique_ptr<IFGRenderPassImpl> pImplementation;
     RenderPassType renderPassType;
+    RenderPassQueue queue = RenderPassQueue::Graphics;
     std::string name;
 
     size_t resourceAccessBegin, resourceAccessEnd;
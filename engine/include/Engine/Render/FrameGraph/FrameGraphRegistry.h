@@ -34,6 +34,13 @@ public:
     template <ResourceBindingNameToIndex>
     RenderAPI::UAVDesc getTextureUAV() const;
 
+    // Views created when the frame graph was compiled; only valid for resources that are bound in the
+    // RENDER_TARGET or DEPTH_WRITE/DEPTH_READ state.
+    template <ResourceBindingNameToIndex>
+    D3D12_CPU_DESCRIPTOR_HANDLE getRenderTargetView() const;
+    template <ResourceBindingNameToIndex>
+    D3D12_CPU_DESCRIPTOR_HANDLE getDepthStencilView() const;
+
     template <ResourceBindingNameToIndex>
     const FrameGraphInternal::FGResource& getInternalResource() const;
 
@@ -48,6 +55,7 @@ private:
     static constexpr auto m_bindings = fillRenderPassBuilder<RenderPass>().m_bindings;
     std::span<const FrameGraphInternal::FGResource> m_resourceRegistry;
     std::span<const FrameGraphInternal::FGResourceAccess> m_resourceAccesses;
+    std::span<const D3D12_CPU_DESCRIPTOR_HANDLE> m_attachmentViews;
 };
 
 template <typename RenderPass>
@@ -81,6 +89,22 @@ RenderAPI::UAVDesc FrameGraphRegistry<RenderPass>::getTextureUAV() const
     };
 }
 
+template <typename RenderPass>
+template <typename FrameGraphRegistry<RenderPass>::ResourceBindingNameToIndex NameToIndex>
+D3D12_CPU_DESCRIPTOR_HANDLE FrameGraphRegistry<RenderPass>::getRenderTargetView() const
+{
+    assert(m_resourceAccesses[NameToIndex.idx].desiredState & D3D12_RESOURCE_STATE_RENDER_TARGET);
+    return m_attachmentViews[NameToIndex.idx];
+}
+
+template <typename RenderPass>
+template <typename FrameGraphRegistry<RenderPass>::ResourceBindingNameToIndex NameToIndex>
+D3D12_CPU_DESCRIPTOR_HANDLE FrameGraphRegistry<RenderPass>::getDepthStencilView() const
+{
+    assert(m_resourceAccesses[NameToIndex.idx].desiredState & (D3D12_RESOURCE_STATE_DEPTH_WRITE | D3D12_RESOURCE_STATE_DEPTH_READ));
+    return m_attachmentViews[NameToIndex.idx];
+}
+
 template <typename RenderPass>
 template <typename FrameGraphRegistry<RenderPass>::ResourceBindingNameToIndex NameToIndex>
 const FrameGraphInternal::FGResource& FrameGraphRegistry<RenderPass>::getInternalResource() const
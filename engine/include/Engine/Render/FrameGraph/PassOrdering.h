@@ -0,0 +1,34 @@
+#pragma once
+#include "Engine/Render/FrameGraph/FrameGraphInternal.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+struct FGPassOrderStatistics {
+    uint32_t numCulledPasses = 0;
+    uint32_t numMovedPasses = 0; // Render passes that are not executed at their original position (relative to the other passes).
+};
+
+struct FGPassOrder {
+    std::vector<uint32_t> order; // The render passes that are executed, in execution order.
+    FGPassOrderStatistics statistics;
+};
+
+// Whether a render pass may write to a resource that it uses in the given state.
+bool isWriteState(D3D12_RESOURCE_STATES state);
+
+// Pure CPU function. Render passes depend on the last render pass that wrote to one of their resources, and on the render
+// passes that read a resource since it was last written (writes may be partial, so writing a resource also reads it).
+//
+// Render passes whose writes never reach the swap chain or a persistent resource are culled. Render passes without any
+// writes (or without any resources) are assumed to have side effects outside of the frame graph; they are never culled.
+// Render passes without resources also keep their position relative to all other render passes.
+//
+// The remaining render passes are ordered topologically. Out of the render passes that are ready, the one that ends the
+// most (and starts the fewest) transient resource lifetimes goes first, which shortens the lifetimes of transient resources
+// and reduces the memory required to alias them. Ties are broken by the original order.
+FGPassOrder orderRenderPasses(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses);
+
+}
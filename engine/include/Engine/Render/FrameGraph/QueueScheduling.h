@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Render/FrameGraph/BarrierPlanner.h"
+#include "Engine/Render/FrameGraph/FrameGraphInternal.h"
+#include "Engine/Render/FrameGraph/RenderPass.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+// Consecutive render passes of a single queue that are submitted together. Before the segment is executed, the queue waits
+// for the segments of other queues that its render passes depend on. A segment that other segments wait for signals a fence
+// after its last render pass.
+struct FGQueueSegment {
+    RenderPassQueue queue;
+    size_t operationBegin, operationEnd; // Range of FGQueueSchedule::operationOrder.
+    std::vector<uint32_t> waitSegments; // Segments (of other queues) that must have completed before this segment starts.
+    bool signal = false;
+    // Transitions that the queue of the next user of the resource cannot record (see legalizeQueueBarriers()). They are
+    // recorded after the last render pass of the segment, before the fence is signaled.
+    std::vector<FGBarrier> signalBarriers;
+};
+
+struct FGQueueStatistics {
+    uint32_t numAsyncComputePasses = 0;
+    uint32_t numCrossQueueDependencies = 0; // Uses of a resource whose previous use was on another queue.
+    uint32_t numWaits = 0; // Fence waits per frame; dependencies that are implied by an earlier wait do not need a wait.
+    uint32_t numMovedTransitions = 0; // Transitions moved from the async compute queue to the graphics queue.
+};
+
+struct FGQueueSchedule {
+    static constexpr size_t numQueues = 2;
+
+    std::vector<uint32_t> operationOrder; // Render passes in submission order; the render passes of a segment are consecutive.
+    std::vector<FGQueueSegment> segments; // In submission order; segments only wait for segments that are submitted before them.
+    // The last render pass (in frame graph order) that may still be executing on another queue while the given render pass executes.
+    std::vector<uint32_t> lastConcurrentPass;
+    FGQueueStatistics statistics;
+};
+
+// Pure CPU function. A render pass depends on the render pass that used each of its resources before it; dependencies on
+// render passes of another queue are resolved with a fence. Frame graphs without async compute passes are scheduled as a
+// single graphics segment. Otherwise, the frame starts with an empty graphics segment that the async compute queue waits for
+// (such that async compute passes never overlap with the previous frame) and it ends on the graphics queue, after all
+// async compute passes have completed.
+FGQueueSchedule scheduleQueues(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses);
+
+// The async compute queue does not support graphics states (such as RENDER_TARGET). Transitions from those states are moved to
+// the graphics segment that contains the previous use of the resource (or to the frame start segment); the async compute
+// segment waits for that segment anyways. Must be called after the split barriers were legalized (split barriers never cross queues).
+FGBarrierPlan legalizeQueueBarriers(const FGBarrierPlan& barrierPlan, FGQueueSchedule& queueSchedule, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses);
+
+}
@@ -25,6 +25,12 @@ enum class RenderPassType {
     Compute,
     RayTracing
 };
+// Compute & ray tracing passes may opt into the async compute queue (static constexpr RenderPassQueue queue = ...). The frame
+// graph synchronizes the queues based on the resources that the render passes use.
+enum class RenderPassQueue {
+    Graphics,
+    AsyncCompute
+};
 
 template <typename RenderPass>
 concept render_pass_has_settings = requires(RenderPass& renderPass) {
@@ -70,6 +76,12 @@ concept render_pass_has_name = requires() {
     } -> std::common_with<std::string_view&>;
 };
 template <typename RenderPass>
+concept render_pass_has_queue = requires() {
+    {
+        RenderPass::queue
+    } -> std::same_as<const RenderPassQueue&>;
+};
+template <typename RenderPass>
 concept render_pass = requires(RenderPass& renderPass) {
     {
         RenderPass::renderPassType
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render::FrameGraphInternal {
+
+// Transient resource as seen by the placement solver: its memory requirements and the render passes that use it.
+struct FGTransientResource {
+    size_t sizeInBytes;
+    size_t alignment;
+    uint32_t firstPassIdx, lastPassIdx; // Lifetime (inclusive).
+    uint32_t heapIdx = 0; // Resources are only aliased with resources in the same heap.
+};
+
+enum class FGPlacementStrategy {
+    // Allocate/free in execution order at the first fitting offset; what a general purpose allocator does at runtime.
+    Greedy,
+    // Place the largest resources first, each in the smallest gap between the resources whose lifetimes it overlaps.
+    // Falls back to the greedy placement for heaps where that happens to be smaller.
+    BestFitDecreasingSize
+};
+
+struct FGTransientPlacement {
+    std::vector<size_t> offsets; // Offset of each resource within its heap.
+    std::vector<size_t> heapSizes; // Smallest size of each heap that fits all of its resources.
+
+    size_t totalSizeInBytes() const;
+};
+
+// CPU-only; the resource sizes & alignments are provided by ID3D12Device::GetResourceAllocationInfo().
+FGTransientPlacement placeTransientResources(std::span<const FGTransientResource> resources, size_t numHeaps, FGPlacementStrategy strategy = FGPlacementStrategy::BestFitDecreasingSize);
+// Largest amount of memory that is in use during any single render pass (per heap); no placement can use less memory.
+std::vector<size_t> computeTransientMemoryLowerBound(std::span<const FGTransientResource> resources, size_t numHeaps);
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Render {
+
+// Component types as defined by the GLTF 2.0 specification (accessor.componentType).
+enum class GLTFComponentType : uint32_t {
+    Byte = 5120,
+    UnsignedByte = 5121,
+    Short = 5122,
+    UnsignedShort = 5123,
+    UnsignedInt = 5125,
+    Float = 5126
+};
+
+// Undecoded GLTF accessor pointing into a (memory mapped) GLTF buffer.
+struct GLTFAccessor {
+    std::span<const std::byte> data; // Starts at the first element of the accessor.
+    size_t count;
+    size_t byteStride = 0; // 0 means tightly packed.
+    GLTFComponentType componentType;
+    uint32_t numComponents; // SCALAR = 1, VEC2 = 2, VEC3 = 3, VEC4 = 4.
+    bool normalized = false;
+
+    size_t componentSize() const;
+    size_t elementSize() const;
+    size_t stride() const;
+};
+
+// Decode an accessor into numComponents floats per element. Integer components are mapped to [0, 1] or [-1, 1] when
+// the accessor is normalized and are converted as-is otherwise.
+// Tightly packed accessors are decoded with SIMD kernels; large accessors are split across multiple threads.
+void decodeAccessor(const GLTFAccessor& accessor, std::span<float> out);
+// Decode a SCALAR integer accessor (e.g. an index buffer), widening 8- and 16-bit values to 32-bit.
+void decodeAccessor(const GLTFAccessor& accessor, std::span<uint32_t> out);
+
+}
@@ -7,6 +7,7 @@
 DISABLE_WARNINGS_PUSH()
 #include <imgui.h>
 DISABLE_WARNINGS_POP()
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <deque>
@@ -50,19 +51,33 @@ public:
     void endTask(ID3D12GraphicsCommandList5* pCommandList, uint32_t taskHandle);
     void endFrame(ID3D12GraphicsCommandList5* pCommandList);
 
+    // Tasks that are recorded from multiple threads (into different command lists) are added up front, in order. Their
+    // timestamps may then be recorded concurrently between startFrame() and endFrame(). Tasks on the async compute queue
+    // are timed with the clock of that queue.
+    uint32_t addTask(std::string name, bool asyncCompute = false);
+    void startTask(ID3D12GraphicsCommandList5* pCommandList, uint32_t taskHandle);
+
     void displayHorizontalGUI() const;
     void displayVerticalGUI() const;
 
+    // The tasks of the resolved frames, converted to the CPU profiling clock (see Core::profileClockNow()) such that
+    // they can be exported together with the zones of Core::CPUProfiler. Returns a graphics and an async compute track.
+    std::vector<Core::ProfileTrack> getTimeline() const;
+
 private:
 private:
     struct Task {
         std::string name;
         uint32_t startQueryIdx, endQueryIdx;
         uint64_t startTimestamp, endTimestamp;
+        bool asyncCompute = false;
     };
     struct Frame {
         uint32_t startQueryIdx, endQueryIdx;
         uint64_t startTimestamp, endTimestamp;
+        // GPU timestamp and CPU time (in nanoseconds) that were sampled at the same moment, for both queues.
+        uint64_t calibrationTimestamp, calibrationTime;
+        uint64_t computeCalibrationTimestamp, computeCalibrationTime;
         std::vector<Task> tasks;
     };
     uint32_t addTimingQuery(ID3D12GraphicsCommandList5* pCommandList);
@@ -70,12 +85,15 @@ private:
     void resolveQueriesCPU(Frame& frame);
 
 private:
+    WRL::ComPtr<ID3D12CommandQueue> m_pCommandQueue;
+    WRL::ComPtr<ID3D12CommandQueue> m_pComputeQueue;
     WRL::ComPtr<ID3D12QueryHeap> m_pQueryHeap;
     RenderAPI::D3D12MAResource m_readBackBuffer;
     std::vector<uint64_t> m_cpuBuffer;
-    uint32_t m_gpuQueryOffset = 0;
+    std::atomic_uint32_t m_gpuQueryCounter = 0; // Wraps around at a multiple of the query heap size.
 
     const double m_secondsPerTick;
+    const double m_secondsPerTickCompute;
     const uint32_t m_parallelFrames;
     const uint32_t m_resolvedFrameStorage;
     std::deque<Frame> m_inFlightFrames;
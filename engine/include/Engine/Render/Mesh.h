@@ -1,12 +1,14 @@
 #pragma once
 #include "Engine/Core/Bounds.h"
 #include "Engine/Render/ForwardDeclares.h"
+#include "Engine/Render/MeshOptimization.h"
 #include "Engine/Render/ShaderInputs/bindpoints/Material.h"
 #include "Engine/Render/ShaderInputs/bindpoints/RayTraceMesh.h"
 #include "Engine/Render/ShaderInputs/constants.h"
 #include "Engine/Render/ShaderInputs/structs/Meshlet.h"
 #include "Engine/Render/ShaderInputs/structs/PBRMaterial.h"
 #include "Engine/Render/ShaderInputs/structs/Vertex.h"
+#include "Engine/Render/VertexCompression.h"
 #include "Engine/RenderAPI/RenderAPI.h"
 #include "Engine/Util/ForwardDeclares.h"
 #include <tbx/disable_all_warnings.h>
@@ -14,6 +16,7 @@ DISABLE_WARNINGS_PUSH()
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 DISABLE_WARNINGS_POP()
+#include <chrono>
 #include <cstddef>
 #include <filesystem>
 #include <span>
@@ -21,17 +24,36 @@ DISABLE_WARNINGS_POP()
 
 namespace Render {
 
+// Meshlet header; the vertices & triangles of all meshlets of a mesh are stored in two shared buffers (see MeshCPU).
 struct Meshlet : ShaderInputs::Meshlet {
     static constexpr uint32_t MaxNumVertices = MESHLET_MAX_VERTICES;
     static constexpr uint32_t MaxNumPrimitives = MESHLET_MAX_PRIMITIVES;
 
     Meshlet()
     {
+        this->vertexOffset = 0;
+        this->primitiveOffset = 0;
         this->numVertices = 0;
         this->numPrimitives = 0;
+        this->boundingSphereCenter = glm::vec3(0.0f);
+        this->boundingSphereRadius = 0.0f;
+        this->coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        this->coneCutoff = 1.0f;
     }
 
     static uint32_t encodePrimitive(uint32_t i0, uint32_t i1, uint32_t i2);
+    // Triangles are stored as 3 bytes (one 8-bit local vertex index per corner); encoded as i0 | (i1 << 8) | (i2 << 16).
+    static void appendPrimitive(std::vector<uint8_t>& packedPrimitives, uint32_t encodedPrimitive);
+    static uint32_t loadPrimitive(std::span<const uint8_t> packedPrimitives, uint32_t primitiveIdx);
+};
+// Fixed size meshlet as stored by scene binary files up to version 7. Every meshlet reserves space for the maximum
+// number of vertices & primitives, which wastes most of the memory for small meshlets.
+struct LegacyMeshlet {
+    uint32_t vertices[Meshlet::MaxNumVertices]; // Indices into the vertex array.
+    uint32_t numVertices;
+    uint32_t numPrimitives;
+    uint32_t subMeshIdx;
+    uint32_t primitives[Meshlet::MaxNumPrimitives]; // Encoded primitives (see Meshlet::encodePrimitive).
 };
 
 struct SubMesh {
@@ -44,6 +66,41 @@ struct SubMesh {
     uint32_t meshletStart;
     uint32_t numMeshlets;
 };
+// Simplified version of a sub mesh (see MeshCPU::generateSubMeshLODs). The indices are stored in a separate buffer
+// (MeshCPU::lodIndices) and, like the indices of the sub mesh, are relative to SubMesh::baseVertex; all LODs share the
+// vertices of the full resolution sub mesh.
+struct SubMeshLOD {
+    uint32_t subMeshIdx;
+    uint32_t indexStart;
+    uint32_t numIndices;
+    float error; // Estimated object space distance between this LOD and the full resolution sub mesh.
+};
+// LODs are stored ordered by sub mesh and then from most to least detailed; returns the LODs of a single sub mesh.
+std::span<const SubMeshLOD> findSubMeshLODs(std::span<const SubMeshLOD> lods, uint32_t subMeshIdx);
+
+struct LODGenerationSettings {
+    uint32_t maxNumLODs = 8;
+    float reductionFactor = 0.5f; // Target number of triangles of each LOD relative to the previous LOD.
+    uint32_t minNumTriangles = 64; // Sub meshes are not simplified below this number of triangles.
+    float maxRelativeError = 0.05f; // Largest error of any LOD relative to the bounding box diagonal of the sub mesh.
+};
+
+// Selects the LOD of a sub mesh such that its geometric error, projected onto the screen, stays below a given number of pixels.
+class LODSelector {
+public:
+    LODSelector(float fovY, uint32_t viewportHeight, float maxPixelError);
+
+    // Size in pixels of a (view space) error at the given distance from the camera.
+    float projectedError(float geometricError, float distance) const;
+    // Returns 0 for the full resolution sub mesh and i + 1 for subMeshLODs[i]. The distance should be expressed in the
+    // same (object) space as the errors of the LODs; divide the world space distance by the scale of the instance.
+    uint32_t selectLOD(std::span<const SubMeshLOD> subMeshLODs, float distance) const;
+
+private:
+    float m_pixelsPerUnit; // Pixels covered by one unit at a distance of one unit from the camera.
+    float m_maxPixelError;
+};
+
 struct Material {
     ShaderInputs::Material shaderInputs;
     bool isOpague;
@@ -55,17 +112,51 @@ struct Mesh {
     uint32_t numMeshlets;
     uint32_t numVertices;
     uint32_t vertexStride;
-    // Core::Bounds3f bounds;
+    Core::Bounds3f bounds;
 
     std::vector<SubMesh> subMeshes;
     std::vector<Material> materials;
 
+    // LOD indices live in their own index buffer; see SubMeshLOD.
+    std::vector<SubMeshLOD> lods;
+    D3D12_INDEX_BUFFER_VIEW lodIndexBufferView;
+
     // Ray tracing information.
     RenderAPI::D3D12MAResource blas;
     std::vector<ShaderInputs::RayTraceMesh> subMeshProperties;
 
     // Owning pointers to the index- and vertex buffer to keep them alive while the mesh is alive.
-    RenderAPI::D3D12MAResource indexBuffer, vertexBuffer, meshletBuffer;
+    RenderAPI::D3D12MAResource indexBuffer, vertexBuffer, lodIndexBuffer, meshletBuffer, meshletVertexBuffer, meshletPrimitiveBuffer;
+    uint32_t numMeshletVertices;
+    uint32_t numMeshletPrimitiveWords;
+};
+
+// Time spent in each stage of meshlet generation. The stages are summed over all threads; total is the wall clock time.
+struct MeshletGenerationTimings {
+    std::chrono::nanoseconds gatherPositions { 0 };
+    std::chrono::nanoseconds generateAdjacency { 0 };
+    std::chrono::nanoseconds computeMeshlets { 0 };
+    std::chrono::nanoseconds convertMeshlets { 0 };
+    std::chrono::nanoseconds computeCullingData { 0 };
+    std::chrono::nanoseconds concatenate { 0 };
+    std::chrono::nanoseconds total { 0 };
+
+    MeshletGenerationTimings& operator+=(const MeshletGenerationTimings& other);
+};
+
+struct MeshOptimizationSettings {
+    bool weldVertices = true; // Merge vertices with (nearly) the same position, normal & texture coordinates.
+    bool optimizeVertexCache = true; // Reorder triangles for the post-transform vertex cache.
+    bool optimizeOverdraw = true; // Reorder clusters of triangles to reduce overdraw (see Render::optimizeOverdraw).
+    bool optimizeVertexFetch = true; // Reorder vertices in the order in which they are first referenced.
+    float overdrawThreshold = 1.05f; // Largest relative ACMR increase allowed by the overdraw optimization.
+};
+// Vertex processing efficiency before & after MeshCPU::optimize, summed over all sub meshes.
+struct MeshOptimizationStatistics {
+    VertexProcessingStatistics before, after;
+    size_t numVerticesBefore = 0, numVerticesAfter = 0; // Size of the vertex buffers, including unreferenced vertices.
+
+    MeshOptimizationStatistics& operator+=(const MeshOptimizationStatistics& other);
 };
 
 struct MaterialCPU : public ShaderInputs::PBRMaterial {
@@ -76,18 +167,72 @@ struct MeshCPU {
     std::vector<ShaderInputs::Vertex> vertices;
     std::vector<uint32_t> indices;
     std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> meshletVertices; // Indices into the vertex array; referenced by Meshlet::vertexOffset.
+    std::vector<uint8_t> meshletPrimitives; // Packed triangles; referenced by Meshlet::primitiveOffset.
     Core::Bounds3f bounds;
 
     std::vector<SubMesh> subMeshes;
     std::vector<MaterialCPU> materials;
 
+    std::vector<SubMeshLOD> lods;
+    std::vector<uint32_t> lodIndices; // Referenced by SubMeshLOD::indexStart.
+
     void writeTo(Util::BinaryWriter& writer) const;
     void readFrom(Util::BinaryReader& reader);
 
-    // Removes duplicate vertices & improves vertex ordering.
+    operator MeshCPUView() const;
+    size_t sizeInBytes() const;
+
+    // Removes duplicate vertices (MeshOptimizationSettings::weldVertices) or improves the triangle & vertex order
+    // (all other optimizations); see optimize().
     void removeDuplicateVertices();
     void optimizeIndexVertexOrder();
+    // Builds a chain of increasingly simplified versions (LODs) of every sub mesh using quadric error edge collapses.
+    void generateSubMeshLODs(const LODGenerationSettings& settings = {});
     void generateMeshlets();
+    // Conversion from/to the fixed size meshlet layout of older scene binary files. setMeshlets() also computes the
+    // culling data of the meshlets, so the vertices must already be set.
+    void setMeshlets(std::span<const LegacyMeshlet> legacyMeshlets);
+    std::vector<LegacyMeshlet> legacyMeshlets() const;
+    // Generates the meshlets of all sub meshes of all meshes in parallel. Sub meshes are processed independently and
+    // the results are concatenated in order, so the output does not depend on the number of threads.
+    static MeshletGenerationTimings generateMeshlets(std::span<MeshCPU* const> meshes);
+    // Generates the LODs of all sub meshes of all meshes in parallel; like generateMeshlets, the output does not depend
+    // on the number of threads.
+    static void generateSubMeshLODs(std::span<MeshCPU* const> meshes, const LODGenerationSettings& settings = {});
+    // Optimizes all sub meshes of all meshes in parallel; the results are written to preallocated ranges of the new
+    // index & vertex buffers, in sub mesh order. Meshlets & LODs that were generated before stay valid (they are
+    // remapped to the new vertices), but are not reordered themselves so run this before generating them.
+    static MeshOptimizationStatistics optimize(std::span<MeshCPU* const> meshes, const MeshOptimizationSettings& settings = {});
+};
+// Non-owning version of MeshCPU; used to point directly into a memory mapped scene file.
+struct MeshCPUView {
+    std::span<const ShaderInputs::Vertex> vertices;
+    // Vertices of a scene binary file stored as VertexFormat::Compressed (one quantization per sub mesh). The vertices
+    // are decoded by SceneBinary::load, so only SceneBinary::store/load deal with these.
+    std::span<const CompressedVertex> compressedVertices;
+    std::span<const VertexQuantization> vertexQuantizations;
+    std::span<const uint32_t> indices;
+    std::span<const Meshlet> meshlets;
+    std::span<const uint32_t> meshletVertices;
+    std::span<const uint8_t> meshletPrimitives;
+    Core::Bounds3f bounds;
+
+    std::span<const SubMesh> subMeshes;
+    std::span<const MaterialCPU> materials;
+
+    std::span<const SubMeshLOD> lods;
+    std::span<const uint32_t> lodIndices;
+
+    // Memory used by the meshlets, and the memory that the same meshlets would use in the LegacyMeshlet layout.
+    size_t meshletSizeInBytes() const;
+    size_t legacyMeshletSizeInBytes() const;
+    // Memory used by the (decoded) vertices, and the memory that the same vertices would use as CompressedVertex.
+    size_t vertexSizeInBytes() const;
+    size_t compressedVertexSizeInBytes() const;
+
+    void writeTo(Util::BinaryWriter& writer) const;
+    void readFrom(Util::MappedBinaryReader& reader);
 };
 
 }
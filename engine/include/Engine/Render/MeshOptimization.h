@@ -0,0 +1,38 @@
+#pragma once
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/vec3.hpp>
+DISABLE_WARNINGS_POP()
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Render {
+
+// Simulated cost of processing the vertices of a triangle list. Counts (rather than ratios) such that the statistics of
+// multiple meshes can be summed.
+struct VertexProcessingStatistics {
+    size_t numTriangles = 0;
+    size_t numVertices = 0; // Unique vertices referenced by the triangles.
+    size_t numTransformedVertices = 0; // Vertex shader invocations with a FIFO post-transform cache.
+    size_t numVertexBytes = 0; // Size of the unique vertices (numVertices * vertex size).
+    size_t numFetchedBytes = 0; // Bytes read from the vertex buffer through a small cache of 64 byte lines.
+
+    float acmr() const; // Average cache miss ratio: transformed vertices per triangle (0.5 is optimal for large grids, 3 is the worst case).
+    float atvr() const; // Average transform to vertex ratio: transformed vertices per unique vertex (1 is optimal).
+    float overfetch() const; // Fetched bytes per vertex byte (1 is optimal).
+
+    VertexProcessingStatistics& operator+=(const VertexProcessingStatistics& other);
+};
+
+constexpr uint32_t defaultVertexCacheSize = 16;
+
+VertexProcessingStatistics analyzeVertexProcessing(std::span<const uint32_t> indices, size_t numVertices, size_t vertexSize, uint32_t cacheSize = defaultVertexCacheSize);
+
+// Reorders the triangles of a triangle list, which should already be optimized for the vertex cache, to reduce overdraw
+// (Sander et al. 2007). The list is split into clusters that each keep (close to) the vertex cache efficiency of the
+// input, and clusters that face away from the center of the mesh are drawn first as they are likely to occlude the
+// other clusters. The ACMR increases by roughly a factor threshold at most.
+void optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold = 1.05f, uint32_t cacheSize = defaultVertexCacheSize);
+
+}
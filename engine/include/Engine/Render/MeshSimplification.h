@@ -0,0 +1,27 @@
+#pragma once
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/vec3.hpp>
+DISABLE_WARNINGS_POP()
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Render {
+
+struct SimplifiedMesh {
+    std::vector<uint32_t> indices; // Indices into the vertex array of the input mesh.
+    float error = 0.0f; // Estimated (object space) distance between the simplified and the input surface.
+};
+
+// Simplifies a triangle list by collapsing edges in order of increasing quadric error (Garland & Heckbert), until
+// at most targetNumIndices indices remain or every remaining collapse would introduce an error larger than maxError.
+//
+// An edge collapse moves a vertex onto one of its neighbours, so the output only references vertices of the input and
+// can share its vertex buffer. Vertices on open borders and vertices that share their position with another vertex
+// (attribute seams) are never moved; this keeps the outline of the mesh and its texture seams intact.
+SimplifiedMesh simplifyMesh(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, size_t targetNumIndices, float maxError = std::numeric_limits<float>::max());
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Engine/Render/ForwardDeclares.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+DISABLE_WARNINGS_POP()
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render {
+
+enum class MeshletVisibility {
+    Visible,
+    OutsideFrustum,
+    BackFacing
+};
+
+struct MeshletCullingStats {
+    uint32_t numMeshlets = 0;
+    uint32_t numOutsideFrustum = 0;
+    uint32_t numBackFacing = 0;
+
+    uint32_t numVisible() const;
+    MeshletCullingStats& operator+=(const MeshletCullingStats& other);
+};
+
+// CPU reference implementation of the meshlet culling in the amplification shader (meshlet_culling.hlsl).
+// Meshlets are culled when their bounding sphere lies outside the view frustum, or when their normal cone
+// faces away from the camera.
+class MeshletCuller {
+public:
+    MeshletCuller(const glm::mat4& viewProjectionMatrix, const glm::vec3& cameraPosition);
+
+    MeshletVisibility test(const Meshlet& meshlet, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix) const;
+    // Tests all meshlets of a mesh instance. Optionally returns the indices of the visible meshlets.
+    MeshletCullingStats cull(std::span<const Meshlet> meshlets, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix, std::vector<uint32_t>* pVisibleMeshlets = nullptr) const;
+
+private:
+    std::array<glm::vec4, 6> m_frustumPlanes;
+    glm::vec3 m_cameraPosition;
+};
+
+}
@@ -1,9 +1,12 @@
 #pragma once
 #include "Engine/Core/ForwardDeclares.h"
+#include "Engine/Memory/ThreadLocalLinearAllocator.h"
+#include "Engine/Render/UploadManager.h"
 #include "Engine/RenderAPI/Buffer/CpuBufferLinearAllocator.h"
 #include "Engine/RenderAPI/Buffer/CpuBufferRingAllocator.h"
 #include "Engine/RenderAPI/Descriptor/CpuDescriptorLinearAllocator.h"
 #include "Engine/RenderAPI/Descriptor/DescriptorBlockAllocator.h"
+#include "Engine/RenderAPI/Descriptor/DescriptorTableCache.h"
 #include "Engine/RenderAPI/Descriptor/GpuDescriptorLinearAllocator.h"
 #include "Engine/RenderAPI/Descriptor/GpuDescriptorStaticAllocator.h"
 #include "Engine/RenderAPI/RenderAPI.h"
@@ -44,11 +47,17 @@ struct RenderContext {
 
     WRL::ComPtr<ID3D12CommandQueue> pGraphicsQueue;
     RenderAPI::Fence graphicsFence;
+    // Used by render passes that opt into the async compute queue; the frame graph synchronizes it with the graphics queue.
+    // Every frame ends on the graphics queue after all async compute work, so a graphics fence value that is signaled after
+    // a frame also implies that the async compute work of that frame has completed.
+    WRL::ComPtr<ID3D12CommandQueue> pComputeQueue;
+    RenderAPI::Fence computeFence;
     std::optional<RenderAPI::SwapChain> optSwapChain;
     std::array<uint64_t, RenderAPI::SwapChain::s_parallelFrames> frameFenceValues;
     uint32_t backBufferIndex = 0;
 
     RenderAPI::CommandListManager commandListManager;
+    RenderAPI::CommandListManager computeCommandListManager;
 
     std::unique_ptr<RenderAPI::DescriptorBlockAllocator> pCbvSrvUavDescriptorBaseAllocatorCPU;
     std::unique_ptr<RenderAPI::DescriptorBlockAllocator> pCbvSrvUavDescriptorBaseAllocatorGPU;
@@ -60,18 +69,28 @@ struct RenderContext {
     RenderAPI::GPUDescriptorLinearAllocator& getCurrentCbvSrvUavDescriptorTransientAllocator();
     RenderAPI::CPUDescriptorLinearAllocator rtvDescriptorAllocator;
     RenderAPI::CPUDescriptorLinearAllocator dsvDescriptorAllocator;
+    // Descriptor tables of the generated ShaderInputs::*::generateTransientBindings() that are identical across instances & frames.
+    RenderAPI::DescriptorTableCache descriptorTableCache;
 
     std::optional<RenderAPI::DescriptorAllocation> optImGuiDescriptorAllocation;
 
     // Allocator for transient CPU visible data such as per-frame ConstantBuffers.
     RenderAPI::CPUBufferRingAllocator singleFrameBufferAllocator;
+    // Scratch CPU memory (e.g. for std::pmr containers) that is valid until the end of the frame; can be used from any thread.
+    Memory::ThreadLocalLinearAllocator frameAllocator;
+
+    // Pipeline states are reused when render passes are initialized again (e.g. when the frame graph is rebuilt).
+    mutable RenderAPI::PipelineStateCache pipelineStateCache;
+
+    // Batches the copies of createBufferWith*Data() and Texture::uploadToGPU() instead of waiting for each one.
+    UploadManager uploadManager;
 
 public:
     RenderContext(); // Headless mode
     RenderContext(const Core::Window& window, bool imgui = true); // From window
     ~RenderContext();
 
-    RenderAPI::ResourceAliasManager createResourceAliasManager(size_t size);
+    RenderAPI::ResourceAliasManager createResourceAliasManager(std::span<const size_t> heapSizes);
 
     RenderAPI::D3D12MAResource createResource(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState);
     template <typename T>
@@ -119,6 +138,7 @@ void RenderContext::copyBufferFromGPUToCPU(const RenderAPI::D3D12MAResource& buf
         pCommandList->ResourceBarrier(1, &toResourceStateBarrier);
     }
     pCommandList->Close();
+    uploadManager.flush();
     ID3D12CommandList* const pRawCommandList = pCommandList.Get();
     pGraphicsQueue->ExecuteCommandLists(1, &pRawCommandList);
     commandListManager.recycleCommandList(pGraphicsQueue.Get(), pCommandList);
@@ -155,10 +175,6 @@ template <typename T>
 RenderAPI::D3D12MAResource RenderContext::createBufferWithArrayData(std::span<const T> data, D3D12_RESOURCE_FLAGS resourceFlags, D3D12_RESOURCE_STATES finalState)
 {
     const size_t bufferSize = data.size() * sizeof(T);
-    auto pCopyBuffer = createResource(
-        D3D12_HEAP_TYPE_UPLOAD,
-        CD3DX12_RESOURCE_DESC::Buffer(bufferSize, D3D12_RESOURCE_FLAG_NONE),
-        D3D12_RESOURCE_STATE_GENERIC_READ);
     // NOTE(Mathijs): we cannot create the buffer in D3D12_RESOURCE_STATE_COPY_DEST state as this gives a validation layer warning:
     // > Ignoring InitialState D3D12_RESOURCE_STATE_COPY_DEST. Buffers are effectively created in state D3D12_RESOURCE_STATE_COMMON
     auto pFinalBuffer = createResource(
@@ -166,37 +182,8 @@ RenderAPI::D3D12MAResource RenderContext::createBufferWithArrayData(std::span<co
         CD3DX12_RESOURCE_DESC::Buffer(bufferSize, resourceFlags),
         D3D12_RESOURCE_STATE_COMMON);
 
-    // Copy the data to the upload heap.
-    void* pMappedCopyBuffer;
-    D3D12_RANGE readRange { 0, 0 };
-    RenderAPI::ThrowIfFailed(pCopyBuffer->Map(0, &readRange, &pMappedCopyBuffer));
-    std::memcpy(pMappedCopyBuffer, data.data(), bufferSize);
-    pCopyBuffer->Unmap(0, nullptr);
-
-    // Copy from the upload heap to the default heap.
-    auto pCommandList = commandListManager.acquireCommandList();
-    const auto initialStateTransition = CD3DX12_RESOURCE_BARRIER::Transition(
-        pFinalBuffer.pResource.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-    pCommandList->ResourceBarrier(1, &initialStateTransition);
-    pCommandList->CopyBufferRegion(
-        pFinalBuffer.pResource.Get(),
-        0,
-        pCopyBuffer.pResource.Get(),
-        0,
-        bufferSize);
-    const auto finalStateTransition = CD3DX12_RESOURCE_BARRIER::Transition(
-        pFinalBuffer.pResource.Get(), D3D12_RESOURCE_STATE_COPY_DEST, finalState);
-    pCommandList->ResourceBarrier(1, &finalStateTransition);
-
-    pCommandList->Close();
-    ID3D12CommandList* const pRawCommandList = pCommandList.Get();
-    pGraphicsQueue->ExecuteCommandLists(1, &pRawCommandList);
-    commandListManager.recycleCommandList(pGraphicsQueue.Get(), pCommandList);
-
-    // Wait for copy to complete before freeing the copy buffer.
-    waitForIdle();
-
-    // pCopyBuffer will be deallocated automatically due to RAII.
+    // The copy is executed by the graphics queue before any command lists that are submitted after this call.
+    uploadManager.uploadBuffer(pFinalBuffer, std::as_bytes(data), finalState);
     return pFinalBuffer;
 }
 
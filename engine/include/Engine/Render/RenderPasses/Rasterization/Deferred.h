@@ -42,6 +42,8 @@ public:
 
 public:
     static constexpr RenderPassType renderPassType = RenderPassType::Compute;
+    // Overlaps with the graphics passes that do not depend on the sun visibility.
+    static constexpr RenderPassQueue queue = RenderPassQueue::AsyncCompute;
 
     static consteval void declareFrameResources(RenderPassBuilder& builder)
     {
@@ -36,6 +36,8 @@ private:
     WRL::ComPtr<ID3D12PipelineState> m_pPipelineState;
 
     inline static float m_taaJitter = 1.0f;
+    // Sub meshes are drawn at the coarsest LOD whose projected error is below this many pixels; 0 disables LODs.
+    inline static float m_lodMaxPixelError = 1.0f;
 };
 
 }
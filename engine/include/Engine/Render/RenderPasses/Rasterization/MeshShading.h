@@ -12,6 +12,8 @@ public:
     struct Settings {
         Render::Scene* pScene;
         bool bindless;
+        // Frustum & back face culling of meshlets in the amplification shader (bindless only).
+        bool meshletCulling = true;
     } settings;
 
 public:
@@ -5,6 +5,7 @@
 #include "Engine/Render/ForwardDeclares.h"
 #include "Engine/Render/Light.h"
 #include "Engine/Render/Mesh.h"
+#include "Engine/Render/SceneStreaming.h"
 #include "Engine/Render/ShaderInputs/bindpoints/RenderPass.h"
 #include "Engine/Render/Texture.h"
 #include "Engine/RenderAPI/Internal/D3D12Includes.h"
@@ -54,6 +55,9 @@ struct Scene {
     std::vector<Texture> textures;
     std::vector<Mesh> meshes;
     std::vector<Transformable<MeshInstance>> meshInstances;
+    // Vertex buffers are kept in a state that covers both rasterization and ray tracing, such that render passes (which
+    // may be recorded in parallel) don't have to transition them.
+    static constexpr D3D12_RESOURCE_STATES vertexBufferReadState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
     D3D12_RESOURCE_STATES vertexBufferState;
 
     RenderAPI::D3D12MAResource bindlessSubMeshes;
@@ -70,17 +74,21 @@ struct Scene {
     glm::ivec2 mouseCursorPosition;
 
 public:
-    void transitionVertexBuffers(ID3D12GraphicsCommandList6* pCommandList, D3D12_RESOURCE_STATES desiredState);
+    // The barriers are stored in temporary memory allocated from pMemoryResource.
+    void transitionVertexBuffers(ID3D12GraphicsCommandList6* pCommandList, D3D12_RESOURCE_STATES desiredState, std::pmr::memory_resource* pMemoryResource);
     void updateHistoricalTransformMatrices(); // Copies transform matrices.
 
     void buildRayTracingAccelerationStructure(Render::RenderContext& renderContext);
     RenderAPI::SRVDesc tlasBinding() const;
 
-    static void gltf2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath);
-    static void glb2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath);
+    static StreamingLoadStats gltf2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath, const StreamingLoadSettings& settings = {}, VertexFormat vertexFormat = VertexFormat::Float);
+    static StreamingLoadStats glb2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath, const StreamingLoadSettings& settings = {}, VertexFormat vertexFormat = VertexFormat::Float);
 
-    void loadFromGLTF(const std::filesystem::path& filePath, RenderContext& renderContext);
-    void loadFromGLB(const std::filesystem::path& filePath, RenderContext& renderContext);
+    void loadFromGLTF(const std::filesystem::path& filePath, RenderContext& renderContext, const StreamingLoadSettings& settings = {});
+    void loadFromGLB(const std::filesystem::path& filePath, RenderContext& renderContext, const StreamingLoadSettings& settings = {});
+    // Load the scene graph, camera & lights into this scene while streaming the meshes & textures to the sink in batches.
+    StreamingLoadStats streamFromGLTF(const std::filesystem::path& filePath, SceneUploadSink& sink, const StreamingLoadSettings& settings = {});
+    StreamingLoadStats streamFromGLB(const std::filesystem::path& filePath, SceneUploadSink& sink, const StreamingLoadSettings& settings = {});
     void loadFromBinary(const std::filesystem::path& filePath, RenderContext& renderContext);
     void loadFromMeshes(std::span<const MeshCPU> meshes, std::span<const TextureCPU> textures, RenderContext& renderContext);
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/Render/Camera.h"
+#include "Engine/Render/ForwardDeclares.h"
+#include "Engine/Render/Light.h"
+#include "Engine/Render/Mesh.h"
+#include "Engine/Render/Scene.h"
+#include "Engine/Render/Texture.h"
+#include "Engine/Util/MappedBinaryReader.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <tbx/move_only.h>
+#include <vector>
+
+namespace Render {
+
+// CPU side contents of a scene binary (*.bin) file as generated by gltf_optimizer.
+//
+// Starting at version 7 all mesh & texture payloads are stored aligned such that the meshes & textures can point
+// directly into the memory mapped file (no copy). Version 8 replaced the fixed size meshlets (LegacyMeshlet) by
+// the compact meshlet encoding, version 9 added the meshlet culling data, version 10 added the sub mesh LODs and
+// version 11 added the (optional) compressed vertex format. Compressed vertices are decoded into heap memory when
+// the file is loaded; all other payloads still point into the file.
+// Version 6 & 7 files are still supported, but their meshes are converted into heap memory (version 6 is read using
+// the stream based Util::BinaryReader) and come without LODs. Version 8 to 10 files need to be regenerated.
+class SceneBinary {
+public:
+    static constexpr uint64_t versionNumber = 11;
+    static constexpr uint64_t legacyVersionNumber = 6;
+    static constexpr uint64_t legacyMeshletVersionNumber = 7;
+
+    NO_COPY(SceneBinary);
+    DEFAULT_MOVE(SceneBinary);
+
+    static SceneBinary load(const std::filesystem::path& filePath);
+    static void store(const std::filesystem::path& filePath, const Scene& scene, std::span<const MeshCPU> meshes, std::span<const TextureCPU> textures, VertexFormat vertexFormat = VertexFormat::Float);
+
+public:
+    uint64_t fileVersionNumber;
+    DirectionalLight sun;
+    std::vector<Transformable<MeshInstance>> meshInstances;
+    Transformable<Camera> camera;
+
+    // Valid for as long as this object is alive.
+    std::vector<MeshCPUView> meshes;
+    std::vector<TextureCPUView> textures;
+
+private:
+    SceneBinary() = default;
+
+private:
+    std::optional<Util::MappedBinaryReader> m_optMappedFile;
+    // Storage for version 6 & 7 files (which cannot be mapped directly).
+    std::vector<MeshCPU> m_legacyMeshes;
+    std::vector<TextureCPU> m_legacyTextures;
+    // Decoded vertices of meshes that were stored with VertexFormat::Compressed.
+    std::vector<std::vector<ShaderInputs::Vertex>> m_decodedVertices;
+};
+
+}
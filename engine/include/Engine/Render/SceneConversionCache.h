@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Render/ForwardDeclares.h"
+#include <tbx/move_only.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace Render {
+
+struct SceneConversionCacheStats {
+    uint32_t meshHits, meshMisses;
+    uint32_t textureHits, textureMisses;
+};
+
+// On-disk cache of converted meshes (including meshlets) and textures (including mip maps & KTX transcodes).
+// Entries are content-addressed: the key is a hash of the source data (GLTF buffer views/images) and the settings
+// used to process it, so unchanged items are reused regardless of where they are stored in the source file.
+// All functions may be called from multiple threads at the same time.
+class SceneConversionCache {
+public:
+    // Increment when the conversion output changes to invalidate all existing cache entries.
+    static constexpr uint32_t versionNumber = 5;
+
+public:
+    SceneConversionCache(const std::filesystem::path& cacheDirectory);
+    NO_COPY(SceneConversionCache);
+    NO_MOVE(SceneConversionCache);
+
+    std::optional<MeshCPU> loadMesh(uint64_t key);
+    void storeMesh(uint64_t key, const MeshCPU& mesh);
+    std::optional<TextureCPU> loadTexture(uint64_t key);
+    void storeTexture(uint64_t key, const TextureCPU& texture);
+
+    SceneConversionCacheStats stats() const;
+
+private:
+    std::filesystem::path entryFilePath(uint64_t key, const char* extension) const;
+    template <typename T>
+    std::optional<T> load(uint64_t key, const char* extension);
+    template <typename T>
+    void store(uint64_t key, const char* extension, const T& item);
+
+private:
+    std::filesystem::path m_cacheDirectory;
+    std::atomic_uint32_t m_meshHits { 0 }, m_meshMisses { 0 };
+    std::atomic_uint32_t m_textureHits { 0 }, m_textureMisses { 0 };
+    std::atomic_uint64_t m_tmpFileCounter { 0 };
+};
+
+}
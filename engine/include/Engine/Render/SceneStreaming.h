@@ -0,0 +1,76 @@
+#pragma once
+#include "Engine/Render/ForwardDeclares.h"
+#include "Engine/Render/Mesh.h"
+#include "Engine/Render/Texture.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Render {
+
+struct StreamingLoadSettings {
+    // Maximum amount of decoded mesh/texture data (in bytes) that the loader holds before handing it to the sink.
+    // Items are never split; an item that is larger than the budget is handed to the sink on its own.
+    size_t memoryBudget = size_t(256) << 20;
+    // Maximum number of textures that are decoded in parallel. Decoding runs ahead of the budget check, so the
+    // peak amount of streamed data may exceed the budget by at most this many textures.
+    uint32_t maxParallelTextureDecodes = 8;
+    // Optional cache of converted meshes & textures; items found in the cache are not decoded/processed again.
+    SceneConversionCache* pConversionCache = nullptr;
+    // Weld vertices and optimize the triangle & vertex order of every mesh (see MeshCPU::optimize).
+    bool optimizeMeshes = true;
+};
+struct StreamingLoadStats {
+    // Largest amount of decoded mesh/texture data held by the loader at any point in time (bytes). Only counts the items that
+    // the loader tracks against the memory budget, not the memory usage of the process.
+    size_t peakStreamedBytes = 0;
+    uint32_t numTextureBatches = 0;
+    uint32_t numMeshBatches = 0;
+    MeshletGenerationTimings meshletTimings;
+    // Memory used by the meshlets of all meshes, and what the same meshlets would use with fixed size meshlets (bytes).
+    size_t meshletMemoryUsage = 0;
+    size_t legacyMeshletMemoryUsage = 0;
+    // Memory used by the vertices of all meshes, and what the same vertices would use as CompressedVertex (bytes).
+    size_t vertexMemoryUsage = 0;
+    size_t compressedVertexMemoryUsage = 0;
+    MeshOptimizationStatistics meshOptimization;
+    std::chrono::nanoseconds meshOptimizationTime { 0 }; // Wall clock time.
+    std::chrono::nanoseconds lodGenerationTime { 0 }; // Wall clock time.
+    size_t numLODs = 0;
+    size_t lodMemoryUsage = 0; // Memory used by the indices of all LODs (bytes).
+};
+
+// Destination of the meshes & textures produced by the streaming scene loader (see Scene::streamFromGLTF).
+// Items arrive in batches and in index order; all textures are submitted before the first mesh. The sink may move
+// from the items that it wants to keep, the loader releases whatever remains after the call returns.
+class SceneUploadSink {
+public:
+    virtual ~SceneUploadSink() = default;
+
+    virtual void uploadTextures(uint32_t firstTextureIdx, std::span<TextureCPU> textures) = 0;
+    virtual void uploadMeshes(uint32_t firstMeshIdx, std::span<MeshCPU> meshes) = 0;
+};
+
+// CPU-side stand-in for the GPU upload. Either keeps all meshes & textures (offline conversion) or only records
+// statistics, which allows measuring the throughput & peak memory usage of the loader without a GPU.
+class CPUSceneUploadSink : public SceneUploadSink {
+public:
+    CPUSceneUploadSink(bool keepItems = true);
+
+    void uploadTextures(uint32_t firstTextureIdx, std::span<TextureCPU> textures) override;
+    void uploadMeshes(uint32_t firstMeshIdx, std::span<MeshCPU> meshes) override;
+
+public:
+    std::vector<TextureCPU> textures;
+    std::vector<MeshCPU> meshes;
+
+    uint32_t numTextures = 0, numMeshes = 0;
+    size_t numTextureBytes = 0, numMeshBytes = 0;
+
+private:
+    bool m_keepItems;
+};
+
+}
@@ -46,6 +46,20 @@ public:
 
     void writeTo(Util::BinaryWriter& writer) const;
     void readFrom(Util::BinaryReader& reader);
+
+    operator TextureCPUView() const;
+    size_t sizeInBytes() const;
+};
+// Non-owning version of TextureCPU; used to point directly into a memory mapped scene file.
+struct TextureCPUView {
+    glm::uvec2 resolution;
+    DXGI_FORMAT textureFormat;
+    std::span<const std::byte> pixelData;
+    std::span<const TextureCPU::MipLevel> mipLevels;
+    bool isOpague;
+
+    void writeTo(Util::BinaryWriter& writer) const;
+    void readFrom(Util::MappedBinaryReader& reader);
 };
 
 struct Texture {
@@ -60,7 +74,7 @@ struct Texture {
         };
     }
 
-    static Texture uploadToGPU(const TextureCPU& image, D3D12_RESOURCE_STATES resourceState, RenderContext& renderContext);
+    static Texture uploadToGPU(const TextureCPUView& image, D3D12_RESOURCE_STATES resourceState, RenderContext& renderContext);
 };
 
 }
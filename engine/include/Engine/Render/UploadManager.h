@@ -0,0 +1,82 @@
+#pragma once
+#include "Engine/Render/ForwardDeclares.h"
+#include "Engine/Render/UploadRing.h"
+#include "Engine/RenderAPI/CommandListManager.h"
+#include "Engine/RenderAPI/Fence.h"
+#include "Engine/RenderAPI/Internal/D3D12Includes.h"
+#include "Engine/RenderAPI/MaResource.h"
+#include <tbx/move_only.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Render {
+
+// Uploads data from the CPU to GPU resources through a persistently mapped staging ring buffer. Uploads are recorded into a
+// single command list (on a copy queue if enabled) which is submitted by flush(); the graphics queue waits for the copies
+// before it executes any command lists that are submitted after flush(). Staging memory is reused once the copy queue's
+// fence shows that the GPU has finished reading from it; the CPU only waits when the staging ring is full.
+//
+// The destination resources must be created in the COMMON state and must stay alive until the upload has completed.
+// Not thread-safe.
+class UploadManager {
+public:
+    UploadManager(RenderContext* pRenderContext, size_t stagingBufferSize, bool useCopyQueue = true);
+    NO_COPY(UploadManager);
+    NO_MOVE(UploadManager);
+    ~UploadManager();
+
+    void uploadBuffer(ID3D12Resource* pDestination, std::span<const std::byte> data, D3D12_RESOURCE_STATES finalState);
+    // One entry per subresource (mip level).
+    void uploadTexture(ID3D12Resource* pDestination, std::span<const D3D12_SUBRESOURCE_DATA> subresources, D3D12_RESOURCE_STATES finalState);
+
+    // Submits the uploads that have been recorded so far. Called by RenderContext before submitting to the graphics queue.
+    void flush();
+    // Flush and wait (on the CPU) until all uploads have completed.
+    void waitForIdle();
+
+private:
+    struct StagingAllocation {
+        ID3D12Resource* pResource;
+        size_t offset;
+        std::byte* pMappedMemory; // Pointer to the start of the allocation.
+    };
+    StagingAllocation allocateStaging(size_t size, size_t alignment);
+    ID3D12GraphicsCommandList6* getCommandList();
+    void retire();
+
+private:
+    RenderContext* m_pRenderContext;
+
+    // The copy queue and its fence; the graphics queue (and fence) are used when the copy queue is disabled.
+    WRL::ComPtr<ID3D12CommandQueue> m_pCopyQueue;
+    RenderAPI::Fence m_copyFence;
+    std::optional<RenderAPI::CommandListManager> m_optCopyCommandListManager;
+    ID3D12CommandQueue* m_pQueue;
+    RenderAPI::Fence* m_pFence;
+    RenderAPI::CommandListManager* m_pCommandListManager;
+
+    RenderAPI::D3D12MAResource m_stagingBuffer;
+    std::byte* m_pMappedStagingBuffer { nullptr };
+    UploadRing m_stagingRing;
+
+    WRL::ComPtr<ID3D12GraphicsCommandList6> m_pCommandList;
+    struct PendingTransition {
+        ID3D12Resource* pResource;
+        D3D12_RESOURCE_STATES finalState;
+    };
+    std::vector<PendingTransition> m_pendingTransitions;
+
+    // Uploads that do not fit in the staging ring get their own staging buffer, which is released once the copy has completed.
+    std::vector<RenderAPI::D3D12MAResource> m_pendingStagingBuffers;
+    struct InFlightStagingBuffer {
+        RenderAPI::D3D12MAResource stagingBuffer;
+        uint64_t fenceValue;
+    };
+    std::deque<InFlightStagingBuffer> m_inFlightStagingBuffers;
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace Render {
+
+// Pure CPU sub-allocator for a staging ring buffer. Allocations are grouped into batches; a batch is closed with the
+// fence value that signals when the GPU has finished copying from it, and its memory is reused once that fence value
+// has been reached. Batches retire in the order that they were closed.
+class UploadRing {
+public:
+    UploadRing(size_t size);
+
+    // Returns the offset of the allocation within the ring or std::nullopt if there is not enough free space (until
+    // older batches retire). Allocations never wrap around the end of the ring.
+    std::optional<size_t> tryAllocate(size_t size, size_t alignment);
+    // The allocations made since the previous call to closeBatch() are freed once completedFenceValue >= fenceValue.
+    void closeBatch(uint64_t fenceValue);
+    // Frees all closed batches with fenceValue <= completedFenceValue.
+    void retire(uint64_t completedFenceValue);
+
+    size_t size() const;
+    size_t usedSize() const;
+    bool hasOpenBatch() const; // Whether any allocations were made since the last call to closeBatch().
+    // The fence value of the oldest batch that is still in flight, if any.
+    std::optional<uint64_t> oldestBatchFenceValue() const;
+
+private:
+    struct Batch {
+        uint64_t fenceValue;
+        size_t end; // Offset in the ring after the last allocation of the batch.
+        size_t size; // Including padding (for alignment and wrapping around).
+    };
+    std::deque<Batch> m_batches;
+
+    size_t m_size;
+    size_t m_head = 0, m_tail = 0; // Allocations are made at m_head; m_tail is the start of the oldest batch.
+    size_t m_usedSize = 0;
+    size_t m_openBatchSize = 0;
+};
+
+}
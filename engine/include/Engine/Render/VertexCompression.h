@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Render/ShaderInputs/structs/Vertex.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/gtc/type_precision.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+DISABLE_WARNINGS_POP()
+#include <cstdint>
+#include <span>
+
+namespace Render {
+
+// How the vertices of a mesh are stored in a scene binary file (see SceneBinary::store).
+enum class VertexFormat : uint32_t {
+    Float, // ShaderInputs::Vertex (32 bytes).
+    Compressed // CompressedVertex (16 bytes) + one VertexQuantization per sub mesh.
+};
+
+// Maps 16-bit unsigned integer positions back to object space: pos = offset + quantized * scale.
+struct VertexQuantization {
+    glm::vec3 offset;
+    glm::vec3 scale;
+
+    // Quantization grid covering the bounding box of the given vertices.
+    static VertexQuantization fromVertices(std::span<const ShaderInputs::Vertex> vertices);
+    // Largest difference (per axis) between a position and its decoded quantized position.
+    glm::vec3 maxPositionError() const;
+};
+
+// Every attribute maps to a DXGI format such that the vertices could also be decoded by the input assembler:
+//  - position: R16G16B16A16_UNORM relative to the sub mesh bounds (w is unused);
+//  - normal: R16G16_SNORM octahedral encoding;
+//  - texCoord: R16G16_FLOAT.
+struct CompressedVertex {
+    glm::u16vec4 pos;
+    glm::i16vec2 normal;
+    glm::u16vec2 texCoord;
+};
+static_assert(sizeof(CompressedVertex) == 16);
+
+// Largest distance between a unit length normal and its decoded octahedral encoding.
+constexpr float maxNormalError = 1e-4f;
+// Largest error of a half precision texture coordinate relative to its magnitude (for |texCoord| >= 2^-14).
+constexpr float maxRelativeTexCoordError = 1.0f / 2048.0f;
+
+// Octahedral normal encoding (Meyer et al. 2010); maps unit vectors to [-1, 1]^2. Zero length normals encode as +Z.
+glm::vec2 encodeOctahedral(const glm::vec3& normal);
+glm::vec3 decodeOctahedral(const glm::vec2& encodedNormal);
+
+CompressedVertex encodeVertex(const ShaderInputs::Vertex& vertex, const VertexQuantization& quantization);
+ShaderInputs::Vertex decodeVertex(const CompressedVertex& vertex, const VertexQuantization& quantization);
+// Encode/decode a range of vertices that share the same quantization (i.e. the vertices of a sub mesh).
+void encodeVertices(std::span<const ShaderInputs::Vertex> vertices, const VertexQuantization& quantization, std::span<CompressedVertex> out);
+void decodeVertices(std::span<const CompressedVertex> vertices, const VertexQuantization& quantization, std::span<ShaderInputs::Vertex> out);
+
+}
@@ -1,19 +1,20 @@
 #pragma once
 #include "../Internal/D3D12Includes.h"
+#include "Engine/Memory/ConcurrentRingAllocator.h"
 #include "Engine/RenderAPI/ShaderInput.h"
 #include "Engine/Util/Align.h"
 #include "Engine/Util/Math.h"
 #include <bit>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <span>
 #include <tbx/move_only.h>
-#ifndef NDEBUG
-#include <queue>
-#endif
 
 namespace RenderAPI {
 
+// Upload heap buffer for data that is written by the CPU every frame. Allocations are thread-safe and lock-free; see
+// Memory::ConcurrentRingAllocator.
 class CPUBufferRingAllocator {
 public:
     CPUBufferRingAllocator(const WRL::ComPtr<ID3D12Device5>& pDevice, size_t desiredSize, int numFrames);
@@ -90,10 +91,8 @@ private:
     D3D12_GPU_VIRTUAL_ADDRESS m_baseAddress;
     std::byte* m_pMappedBuffer { nullptr };
 
-    size_t m_size;
-    size_t m_writeOffset;
-#ifndef NDEBUG
-    std::queue<size_t> m_markers;
-#endif
+    // Allocations may be made from multiple threads while the frame graph records its command lists in parallel. Heap
+    // allocated so that the allocator remains movable.
+    std::unique_ptr<Memory::ConcurrentRingAllocator> m_pRingAllocator;
 };
 }
@@ -1,6 +1,5 @@
 #pragma once
 #include "Engine/RenderAPI/Internal/D3D12Includes.h"
-#include "Engine/RenderAPI/Internal/D3D12MAHelpers.h"
 #include <tbx/move_only.h>
 
 namespace RenderAPI {
@@ -10,7 +9,7 @@ struct DescriptorAllocation {
     CD3DX12_GPU_DESCRIPTOR_HANDLE firstGPUDescriptor;
     uint32_t numDescriptors;
 
-    D3D12MA::VirtualAllocation gpuDescriptorAlloc;
+    uint32_t staticBlockIdx = 0; // Block of the GPUDescriptorStaticAllocator that the descriptors were allocated from.
 
     inline DescriptorAllocation offset(uint32_t offsetInDescriptors, uint32_t descriptorIncrementSize) const
     {
@@ -1,12 +1,13 @@
 #pragma once
 #include "../Internal/D3D12Includes.h"
 #include "DescriptorAllocation.h"
-#include <list>
 #include <tbx/move_only.h>
 #include <vector>
 
 namespace RenderAPI {
 
+// Splits a descriptor heap into fixed size blocks; the free blocks are stored in a bit mask. A summary word (bit i is set if
+// word i of the bit mask is not zero) makes allocating O(1), which limits the heap to 64 * 64 blocks.
 class DescriptorBlockAllocator {
 public:
     struct Block {
@@ -36,7 +37,8 @@ public:
     void release(const Block& descriptorBlock);
 
 private:
-    std::list<uint32_t> m_freeBlocks;
+    std::vector<uint64_t> m_freeBlocks; // Bit mask of the free blocks.
+    uint64_t m_freeBlocksSummary = 0;
     std::vector<Block> m_blocks;
 };
 
@@ -0,0 +1,128 @@
+#pragma once
+#include "DescriptorAllocation.h"
+#include "Engine/RenderAPI/Descriptor/GpuDescriptorStaticAllocator.h"
+#include "Engine/RenderAPI/ForwardDeclares.h"
+#include "Engine/RenderAPI/ShaderInput.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <EASTL/fixed_vector.h>
+DISABLE_WARNINGS_POP()
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tbx/move_only.h>
+#include <unordered_map>
+#include <vector>
+
+namespace RenderAPI {
+
+// Descriptor tables only contain views of resources (constants are bound as root CBVs) and are cached by the exact views
+// that they contain, such that tables that are identical across instances and frames share their descriptors instead of creating & copying them again. Tables
+// that have not been used for maxUnusedFrames frames are evicted.
+//
+// Cached tables hold a reference to the resources that they point to, so the address of a resource (which is part of the key)
+// cannot be reused by another resource while the table is in the cache.
+class DescriptorTableCache {
+public:
+    // The contents of a descriptor table; built by the generated ShaderInputs code.
+    class Key {
+    public:
+        inline explicit Key(uint32_t numDescriptors)
+            : m_numDescriptors(numDescriptors)
+        {
+            appendBytes(numDescriptors);
+        }
+        inline void addView(uint32_t descriptorOffset, const SRVDesc& srvDesc)
+        {
+            addView(ViewType::SRV, descriptorOffset, srvDesc.desc, srvDesc.pResource);
+        }
+        inline void addView(uint32_t descriptorOffset, const UAVDesc& uavDesc)
+        {
+            addView(ViewType::UAV, descriptorOffset, uavDesc.desc, uavDesc.pResource);
+        }
+
+    private:
+        friend class DescriptorTableCache;
+        enum class ViewType : uint8_t {
+            SRV,
+            UAV
+        };
+        // Padding bytes of the view descriptions are copied as-is which may (in theory) cause a cache miss, but never a false hit.
+        template <typename T>
+        inline void appendBytes(const T& value)
+        {
+            const auto* pBytes = reinterpret_cast<const char*>(&value);
+            m_bytes.insert(std::end(m_bytes), pBytes, pBytes + sizeof(value));
+        }
+        template <typename ViewDesc>
+        inline void addView(ViewType viewType, uint32_t descriptorOffset, const ViewDesc& viewDesc, ID3D12Resource* pResource)
+        {
+            appendBytes(viewType);
+            appendBytes(descriptorOffset);
+            appendBytes(viewDesc);
+            appendBytes(pResource);
+            if (pResource)
+                m_resources.push_back(pResource);
+        }
+
+    private:
+        uint32_t m_numDescriptors;
+        eastl::fixed_vector<char, 256, true> m_bytes;
+        eastl::fixed_vector<ID3D12Resource*, 8, true> m_resources;
+    };
+
+    struct Statistics {
+        uint32_t numHits = 0;
+        uint32_t numMisses = 0;
+        uint32_t numDescriptorsCopied = 0; // Descriptors that were created & copied to the shader visible heap (misses).
+        uint32_t numEvictions = 0;
+        uint32_t numCachedTables = 0;
+
+        float hitRate() const;
+    };
+
+public:
+    DescriptorTableCache(WRL::ComPtr<ID3D12Device5> pDevice, DescriptorBlockAllocator* pParentCPU, DescriptorBlockAllocator* pParentGPU, uint32_t maxUnusedFrames);
+    NO_COPY(DescriptorTableCache);
+    NO_MOVE(DescriptorTableCache);
+    ~DescriptorTableCache();
+
+    // Thread-safe. Returns the descriptors of the table and whether they were found in the cache. If not, the caller should
+    // create the descriptors (using the CPU descriptor handles) before flush() is called.
+    std::pair<DescriptorAllocation, bool> findOrAllocate(const Key& key);
+
+    // Upload the descriptors of new tables to the GPU.
+    void flush();
+    // Evict tables that have not been used for maxUnusedFrames frames. The caller must ensure that the GPU has finished the
+    // frames that used them.
+    void newFrame();
+
+    // Statistics of the previous frame.
+    Statistics getStatistics() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        inline size_t operator()(std::string_view str) const { return std::hash<std::string_view> {}(str); }
+    };
+    struct CachedTable {
+        DescriptorAllocation descriptors;
+        uint64_t lastUsedFrame;
+        std::vector<WRL::ComPtr<ID3D12Resource>> resources;
+    };
+
+    GPUDescriptorStaticAllocator m_descriptorAllocator;
+    const uint32_t m_maxUnusedFrames;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, CachedTable, StringHash, std::equal_to<>> m_tables;
+    uint64_t m_frameIdx = 0;
+
+    std::atomic_uint32_t m_numHits { 0 }, m_numMisses { 0 }, m_numDescriptorsCopied { 0 };
+    Statistics m_previousFrameStatistics;
+};
+
+}
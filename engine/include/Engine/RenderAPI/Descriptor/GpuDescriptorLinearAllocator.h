@@ -3,6 +3,8 @@
 #include "Engine/RenderAPI/Descriptor/DescriptorBlockAllocator.h"
 #include "Engine/RenderAPI/ForwardDeclares.h"
 #include <deque>
+#include <memory>
+#include <mutex>
 #include <tbx/move_only.h>
 
 namespace RenderAPI {
@@ -14,6 +16,7 @@ public:
     DEFAULT_MOVE(GPUDescriptorLinearAllocator);
     ~GPUDescriptorLinearAllocator();
 
+    // Thread-safe; flush() and reset() are not.
     DescriptorAllocation allocate(uint32_t numDescriptors);
 
     // Upload all descriptors (that weren't flushed) before to the GPU.
@@ -37,6 +40,9 @@ private:
     // When we call flush() we immediately release the CPU blocks to the parent.
     // The GPU blocks must be tracked seprately so that they can stay alive and be freed when reset() is called.
     std::vector<typename DescriptorBlockAllocator::Block> m_pParentAllocationsGPU;
+
+    // Heap allocated so that the allocator remains movable.
+    std::unique_ptr<std::mutex> m_pMutex { std::make_unique<std::mutex>() };
 };
 
 }
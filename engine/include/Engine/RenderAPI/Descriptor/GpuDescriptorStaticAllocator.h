@@ -1,14 +1,18 @@
 #pragma once
 #include "DescriptorAllocation.h"
+#include "Engine/Memory/SegregatedFitAllocator.h"
 #include "Engine/RenderAPI/Descriptor/DescriptorBlockAllocator.h"
 #include "Engine/RenderAPI/ForwardDeclares.h"
-#include "Engine/RenderAPI/Internal/D3D12MAHelpers.h"
-#include <list>
+#include <array>
+#include <optional>
 #include <tbx/move_only.h>
 #include <vector>
 
 namespace RenderAPI {
 
+// Sub allocates descriptor tables from blocks of a shader visible descriptor heap. The blocks are grouped by the size class
+// of their largest free range (see Memory::SegregatedFitAllocator) in bit masks, so allocating picks a block that is
+// guaranteed to fit the table with a few bit scans instead of trying every block.
 class GPUDescriptorStaticAllocator {
 public:
     GPUDescriptorStaticAllocator(WRL::ComPtr<ID3D12Device5> pDevice, DescriptorBlockAllocator* pParentCPU, DescriptorBlockAllocator* pParentGPU);
@@ -19,10 +23,20 @@ public:
     DescriptorAllocation allocate(uint32_t numDescriptors);
 
     void release(const DescriptorAllocation& alloc);
+    // Release the descriptors once the GPU has reached fenceValue (see retire()).
+    void release(const DescriptorAllocation& alloc, uint64_t fenceValue);
+    // Release the descriptors of which the fence value has been reached.
+    void retire(uint64_t completedFenceValue);
 
     // Upload all descriptors (that weren't flushed) before to the GPU.
     void flush();
 
+private:
+    uint32_t offsetInBlock(const DescriptorAllocation& alloc) const;
+    bool tryAllocateFromBlockGPU(uint32_t blockIdx, DescriptorAllocation& out);
+    // Release the block to the parent if it is empty, otherwise update the size class of its largest free range.
+    void updateBlock(uint32_t blockIdx);
+
 private:
     WRL::ComPtr<ID3D12Device5> m_pDevice;
     Tbx::MovePointer<DescriptorBlockAllocator> m_pParentCPU;
@@ -36,13 +50,19 @@ private:
     std::vector<typename DescriptorBlockAllocator::Block> m_blocksCPU;
     uint32_t m_offsetInBlockCPU = 0;
 
-    // Vector of blocks to sub allocate from.
+    // Blocks to sub allocate from; DescriptorAllocation::staticBlockIdx indexes into this vector. Empty blocks are returned
+    // to the parent, their slot (and sub allocator) is reused for the next block.
+    static constexpr uint32_t maxBlocksGPU = 64;
+    static constexpr uint32_t noFreeRange = (uint32_t)-1;
     struct GPUBlock {
-        typename DescriptorBlockAllocator::Block parentAllocation;
-        D3D12MAWrapper<D3D12MA::VirtualBlock> maVirtualBlock; // Use AMDs memory allocator for sub allocations.
-        uint32_t memoryUsed = 0; // Number of descriptors currently allocated from block. May differ from maxAllocSize due to fragmentation.
+        std::optional<typename DescriptorBlockAllocator::Block> optParentAllocation;
+        Memory::SegregatedFitAllocator subAllocator;
+        uint32_t largestSizeClass = noFreeRange;
     };
-    std::list<GPUBlock> m_blocksGPU;
+    std::vector<GPUBlock> m_blocksGPU;
+    uint64_t m_emptySlotsGPU = 0; // Slots in m_blocksGPU without a parent allocation.
+    std::array<uint64_t, 32> m_blocksByLargestSizeClass {}; // Bit i of entry c is set if the largest free range of block i is in size class c.
+    uint32_t m_nonEmptyLargestSizeClasses = 0;
 };
 
 }
@@ -20,6 +20,8 @@ struct Fence {
 Fence createFence(ID3D12Device5* pDevice);
 
 uint64_t insertFence(Fence& fence, ID3D12CommandQueue* pCommandQueue);
+// Let the command queue wait (on the GPU) until the fence reaches fenceValue.
+void insertWait(const Fence& fence, uint64_t fenceValue, ID3D12CommandQueue* pCommandQueue);
 bool fenceReached(const Fence&, uint64_t);
 void waitForFence(const Fence& fence, uint64_t fenceValue);
 void waitForIdle(Fence& fence, ID3D12CommandQueue* pCommandQueue);
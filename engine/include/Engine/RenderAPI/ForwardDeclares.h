@@ -11,6 +11,7 @@ class CPUBufferRingAllocator;
 class CPUDescriptorLinearAllocator;
 struct DescriptorAllocation;
 class DescriptorBlockAllocator;
+class DescriptorTableCache;
 class GPUDescriptorLinearAllocator;
 class GPUDescriptorStaticAllocator;
 
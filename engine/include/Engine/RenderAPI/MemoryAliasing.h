@@ -2,14 +2,14 @@
 #pragma once
 #include "Internal/D3D12Includes.h"
 #include "Internal/D3D12MAHelpers.h"
+#include <span>
 #include <vector>
 
 namespace RenderAPI {
 
 struct AliasingResource {
     WRL::ComPtr<ID3D12Resource> pResource;
-    size_t allocatorIdx;
-    D3D12MA::VirtualAllocation alloc;
+    size_t heapIdx;
 
     inline operator ID3D12Resource*() const
     {
@@ -31,21 +31,24 @@ struct AliasingResource {
 
 class ResourceAliasManager {
 public:
-    ResourceAliasManager(const WRL::ComPtr<ID3D12Device5>& pDevice, D3D12MA::Allocator* pParentAllocator, size_t size, size_t numFrames);
-    
-    AliasingResource allocate(const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState, D3D12_CLEAR_VALUE* pOptimizedClearValue = nullptr);
-    void releaseMemory(const AliasingResource& resource);
+    // Create heaps of exactly the given sizes (one per heap index, see getNumHeaps()) for resources that are placed up front.
+    ResourceAliasManager(const WRL::ComPtr<ID3D12Device5>& pDevice, D3D12MA::Allocator* pParentAllocator, std::span<const size_t> heapSizes);
+
+    // Tier 1 devices require separate heaps for render targets/depth buffers, other textures and buffers.
+    static size_t getNumHeaps(ID3D12Device* pDevice);
+    static size_t getHeapIdx(const D3D12_RESOURCE_DESC& resourceDesc, size_t numHeaps);
+    std::span<const size_t> getHeapSizes() const { return m_heapSizes; }
+
+    // Create a resource at a fixed offset in one of the heaps; placed resources are never released.
+    AliasingResource createPlacedResource(size_t heapIdx, size_t offset, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState);
 
 private:
-    WRL::ComPtr<ID3D12Device5> m_pDevice;
     D3D12MA::Allocator* m_pParentAllocator;
 
-    // Owning pointers to allocators which automatically free the memory when the ResourceAliasManager is destroyed.
-    struct Allocator {
-        D3D12MAWrapper<D3D12MA::Allocation> pBaseAllocation;
-        D3D12MAWrapper<D3D12MA::VirtualBlock> pVirtualBlock;
-    };
-    std::vector<Allocator> m_allocators;
+    // Owning pointers to the heap memory which is automatically freed when the ResourceAliasManager is destroyed.
+    std::vector<D3D12MAWrapper<D3D12MA::Allocation>> m_heapAllocations;
+    std::vector<size_t> m_heapSizes;
+    static D3D12MAWrapper<D3D12MA::Allocation> allocateHeap(D3D12MA::Allocator* pParentAllocator, D3D12_HEAP_FLAGS heapFlags, size_t size);
 
     static constexpr size_t RenderTargetAllocatorIdx = 0;
     static constexpr size_t TextureAllocatorIdx = 1;
@@ -1,5 +1,9 @@
 #pragma once
 #include "Internal/D3D12Includes.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace RenderAPI {
 
@@ -10,6 +14,38 @@ struct PipelineState {
     inline WRL::ComPtr<ID3D12PipelineState>& operator->() { return pPipelineState; };
 };
 
+// Pipeline state objects are cached by the contents of their description (including the shader byte code), such that render
+// passes that are initialized again (when the frame graph is rebuilt) reuse the pipeline states that were created before.
+class PipelineStateCache {
+public:
+    WRL::ComPtr<ID3D12PipelineState> createGraphicsPipelineState(ID3D12Device5* pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& pipelineStateDesc);
+    WRL::ComPtr<ID3D12PipelineState> createComputePipelineState(ID3D12Device5* pDevice, const D3D12_COMPUTE_PIPELINE_STATE_DESC& pipelineStateDesc);
+    WRL::ComPtr<ID3D12PipelineState> createMeshShaderPipelineState(ID3D12Device5* pDevice, const D3DX12_MESH_SHADER_PIPELINE_STATE_DESC& pipelineStateDesc);
+
+    // Release all pipeline states that are not in use (e.g. after shaders were reloaded).
+    void clear();
+
+    struct Statistics {
+        uint32_t numCreated = 0;
+        uint32_t numReused = 0;
+    };
+    Statistics getStatistics() const;
+
+private:
+    template <typename F>
+    WRL::ComPtr<ID3D12PipelineState> findOrCreate(std::string&& key, ID3D12RootSignature* pRootSignature, F&& createPipelineState);
+
+private:
+    struct CachedPipelineState {
+        WRL::ComPtr<ID3D12PipelineState> pPipelineState;
+        // Keep the root signature alive so its address (which is part of the key) cannot be reused by another root signature.
+        WRL::ComPtr<ID3D12RootSignature> pRootSignature;
+    };
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, CachedPipelineState> m_pipelineStates;
+    Statistics m_statistics;
+};
+
 D3D12_INPUT_ELEMENT_DESC sensibleDefaultsInputElementDesc();
 template <typename T = D3D12_GRAPHICS_PIPELINE_STATE_DESC>
 void setSensibleDefaultPipelineStateDesc(T& pipelineStateDesc);
@@ -10,6 +10,7 @@ DISABLE_WARNINGS_POP()
 #include <filesystem>
 #include <fstream>
 #include <optional>
+#include <span>
 #include <tbx/error_handling.h>
 
 namespace Util {
@@ -47,6 +48,11 @@ public:
     template <typename T>
     void write(const std::optional<T>&);
 
+    // Write the array size followed by the array contents, starting at a multiple of alignment bytes from the start of the file.
+    // This allows MappedBinaryReader::readAligned() to return a span into the mapped file without copying.
+    template <typename T>
+    void writeAligned(std::span<const T> items, size_t alignment = 64);
+
 private:
     template <typename T, size_t idx = 0>
     void writeVariant(const T& variant);
@@ -111,6 +117,20 @@ void BinaryWriter::write(const std::optional<T>& optSrc)
         write(optSrc.value());
 }
 
+template <typename T>
+void BinaryWriter::writeAligned(std::span<const T> items, size_t alignment)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    assert(alignment % alignof(T) == 0);
+
+    write(items.size());
+    const size_t offset = (size_t)m_fileStream.tellp();
+    const size_t padding = (alignment - offset % alignment) % alignment;
+    for (size_t i = 0; i < padding; ++i)
+        m_fileStream.put(0);
+    m_fileStream.write(reinterpret_cast<const char*>(items.data()), items.size_bytes());
+}
+
 template <typename T, size_t idx>
 void BinaryWriter::writeVariant(const T& variant)
 {
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace Util {
+
+// Incremental 64-bit (non-cryptographic) hash of binary content; used to content-address cached data.
+// Processes 8 bytes at a time and finalizes with the MurmurHash3 64-bit finalizer.
+class ContentHasher {
+public:
+    ContentHasher(uint64_t seed = 0);
+
+    void add(std::span<const std::byte> bytes);
+    void add(std::string_view string);
+    template <typename T>
+    void add(const T& value) requires std::is_trivially_copyable_v<T>;
+
+    uint64_t digest() const;
+
+private:
+    static uint64_t mix(uint64_t hash, uint64_t word);
+
+private:
+    uint64_t m_hash;
+    uint64_t m_numBytes = 0;
+};
+
+inline ContentHasher::ContentHasher(uint64_t seed)
+    : m_hash(seed ^ 0x9e3779b97f4a7c15ull)
+{
+}
+
+inline void ContentHasher::add(std::span<const std::byte> bytes)
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, &bytes[i], sizeof(word));
+        m_hash = mix(m_hash, word);
+    }
+    if (i < bytes.size()) {
+        uint64_t word = 0;
+        std::memcpy(&word, &bytes[i], bytes.size() - i);
+        m_hash = mix(m_hash, word);
+    }
+    // Include the length so that splitting the same bytes into different add() calls gives different results.
+    m_hash = mix(m_hash, bytes.size());
+    m_numBytes += bytes.size();
+}
+
+inline void ContentHasher::add(std::string_view string)
+{
+    add(std::as_bytes(std::span(string)));
+}
+
+template <typename T>
+inline void ContentHasher::add(const T& value) requires std::is_trivially_copyable_v<T>
+{
+    add(std::as_bytes(std::span(&value, 1)));
+}
+
+inline uint64_t ContentHasher::digest() const
+{
+    uint64_t hash = m_hash ^ m_numBytes;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline uint64_t ContentHasher::mix(uint64_t hash, uint64_t word)
+{
+    word *= 0x87c37b91114253d5ull;
+    word = (word << 31) | (word >> 33);
+    word *= 0x4cf5ad432745937full;
+    hash ^= word;
+    hash = (hash << 27) | (hash >> 37);
+    return hash * 5 + 0x52dce729;
+}
+
+}
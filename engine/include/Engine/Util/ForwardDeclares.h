@@ -10,6 +10,7 @@ class BinaryWriter;
 struct CompileTimeString;
 template <typename K, typename V, int maxSize>
 class CompileTimeMap;
+class MappedBinaryReader;
 class ImguiBarProfilerLegendRight;
 class TmpDir;
 
@@ -0,0 +1,119 @@
+#pragma once
+#include "Engine/Util/ErrorHandling.h"
+#include "Engine/Util/IsOfType.h"
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <tbx/disable_all_warnings.h>
+#include <tbx/error_handling.h>
+#include <type_traits>
+#include <vector>
+DISABLE_WARNINGS_PUSH()
+#include <mio/mmap.hpp>
+DISABLE_WARNINGS_POP()
+
+namespace Util {
+
+class MappedBinaryReader;
+template <typename T>
+concept has_mapped_read_from = requires(T& item, MappedBinaryReader& reader) {
+    {
+        item.readFrom(reader)
+    }
+    -> std::same_as<void>;
+};
+
+// Read objects from a memory mapped binary file that was written with BinaryWriter.
+// Supports trivially copyable types, std::vector of trivially copyable types and custom types with a readFrom(MappedBinaryReader&) function.
+//
+// Arrays written with BinaryWriter::writeAligned() can be accessed with readAligned(), which returns a span pointing
+// directly into the memory mapped file. These spans remain valid for as long as the MappedBinaryReader is alive.
+class MappedBinaryReader {
+public:
+    MappedBinaryReader(const std::filesystem::path& filePath);
+
+    template <typename T>
+    void read(T& dst);
+    template <typename T>
+    T read();
+
+    template <typename T>
+    std::span<const T> readAligned(size_t alignment = 64);
+
+private:
+    std::span<const std::byte> readBytes(size_t numBytes);
+
+private:
+    mio::mmap_source m_file;
+    size_t m_offset = 0;
+};
+
+inline MappedBinaryReader::MappedBinaryReader(const std::filesystem::path& filePath)
+{
+    Assert(std::filesystem::exists(filePath));
+    std::error_code error;
+    m_file.map(filePath.string(), error);
+    Assert(!error);
+}
+
+template <typename T>
+inline void MappedBinaryReader::read(T& dst)
+{
+    dst = read<T>();
+}
+
+template <typename T>
+inline T MappedBinaryReader::read()
+{
+    if constexpr (has_mapped_read_from<T>) {
+        T dst {};
+        dst.readFrom(*this);
+        return dst;
+    } else if constexpr (is_std_vector<T>::value) {
+        using ItemT = typename T::value_type;
+        const size_t vectorLength = read<size_t>();
+
+        T dst;
+        if constexpr (std::is_trivially_copyable_v<ItemT>) {
+            dst.resize(vectorLength);
+            std::memcpy(dst.data(), readBytes(vectorLength * sizeof(ItemT)).data(), vectorLength * sizeof(ItemT));
+        } else {
+            dst.reserve(vectorLength);
+            for (size_t i = 0; i < vectorLength; i++)
+                dst.push_back(read<ItemT>());
+        }
+        return dst;
+    } else if constexpr (std::is_trivially_copyable_v<T>) {
+        T dst {};
+        std::memcpy(&dst, readBytes(sizeof(T)).data(), sizeof(T));
+        return dst;
+    } else {
+        static_assert(Tbx::always_false<T>, "Type does not support deserialization.");
+    }
+}
+
+template <typename T>
+inline std::span<const T> MappedBinaryReader::readAligned(size_t alignment)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    assert(alignment % alignof(T) == 0);
+
+    const size_t arrayLength = read<size_t>();
+    // The file mapping itself is page aligned so aligning the offset also aligns the pointer.
+    m_offset += (alignment - m_offset % alignment) % alignment;
+    const auto bytes = readBytes(arrayLength * sizeof(T));
+    return std::span(reinterpret_cast<const T*>(bytes.data()), arrayLength);
+}
+
+inline std::span<const std::byte> MappedBinaryReader::readBytes(size_t numBytes)
+{
+    Assert(m_offset + numBytes <= m_file.size());
+    const std::span<const std::byte> out { reinterpret_cast<const std::byte*>(m_file.data()) + m_offset, numBytes };
+    m_offset += numBytes;
+    return out;
+}
+
+}
@@ -1,6 +1,22 @@
+#include "ShaderInputs/constants.hlsl"
+
 struct Payload {
 	float4x4 mvpMatrix;
 	float3x3 normalMatrix;
 	uint32_t meshIdx;
 	uint32_t meshletStart;
-};
\ No newline at end of file
+	uint32_t meshletIndices[MESHLET_CULLING_GROUP_SIZE]; // Visible meshlets; one mesh shader group per meshlet.
+};
+
+// Triangles are stored as three 8-bit local vertex indices, tightly packed (3 bytes per triangle).
+// A triangle may straddle two 32-bit words; the buffer is padded such that reading the next word is always valid.
+// Must match Meshlet::loadPrimitive() on the CPU.
+uint3 loadMeshletPrimitive(StructuredBuffer<uint32_t> packedPrimitives, uint32_t primitiveIdx)
+{
+	const uint32_t byteOffset = 3 * primitiveIdx;
+	const uint32_t wordIdx = byteOffset >> 2;
+	const uint32_t shift = (byteOffset & 3) * 8;
+	// (hi << 1) << (31 - shift) == hi << (32 - shift) but without the undefined shift by 32 when shift == 0.
+	const uint32_t encodedPrimitive = (packedPrimitives[wordIdx] >> shift) | ((packedPrimitives[wordIdx + 1] << 1) << (31 - shift));
+	return uint3(encodedPrimitive & 0xFF, (encodedPrimitive >> 8) & 0xFF, (encodedPrimitive >> 16) & 0xFF);
+}
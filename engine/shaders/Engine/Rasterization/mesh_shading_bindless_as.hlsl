@@ -1,16 +1,43 @@
 #include "mesh_shading.hlsl"
+#include "meshlet_culling.hlsl"
 #include "ShaderInputs/inputgroups/DefaultLayout/BindlessScene.hlsl"
 #include "ShaderInputs/inputgroups/DefaultLayout/MeshShadingBindless.hlsl"
 
-[NumThreads(1, 1, 1)]
-void main(uint threadIdx : SV_DispatchThreadID)
+groupshared Payload s_payload;
+groupshared uint32_t s_numVisibleMeshlets;
+
+// Dispatched as (meshlet groups, mesh instances); every group tests MESHLET_CULLING_GROUP_SIZE meshlets of one instance.
+[NumThreads(MESHLET_CULLING_GROUP_SIZE, 1, 1)]
+void main(uint threadIdxInGroup : SV_GroupThreadID, uint2 groupIdx : SV_GroupID)
 {
-    const BindlessMeshInstance meshInstance = g_bindlessScene.getMeshInstances()[threadIdx];
+    if (threadIdxInGroup == 0)
+        s_numVisibleMeshlets = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint32_t meshInstanceIdx = g_meshShadingBindless.getBaseMeshInstance() + groupIdx.y;
+    const BindlessMeshInstance meshInstance = g_bindlessScene.getMeshInstances()[meshInstanceIdx];
     const BindlessMesh mesh = g_bindlessScene.getMeshes()[meshInstance.meshIdx];
 
-    Payload payload;
-    payload.mvpMatrix = mul(g_meshShadingBindless.getViewProjectionMatrix(), meshInstance.modelMatrix);
-    payload.normalMatrix = meshInstance.normalMatrix;
-    payload.meshIdx = meshInstance.meshIdx;
-    DispatchMesh(mesh.numMeshlets, 1, 1, payload);
-}
\ No newline at end of file
+    const uint32_t meshletIdx = groupIdx.x * MESHLET_CULLING_GROUP_SIZE + threadIdxInGroup;
+    bool isVisible = meshletIdx < mesh.numMeshlets;
+    if (isVisible && g_meshShadingBindless.getMeshletCulling()) {
+        const Meshlet meshlet = g_bindlessScene.getMeshlets(meshInstance.meshIdx)[meshletIdx];
+        const MeshletCuller culler = createMeshletCuller(g_meshShadingBindless.getViewProjectionMatrix(), g_meshShadingBindless.getCameraPosition());
+        isVisible = culler.isVisible(meshlet, meshInstance.modelMatrix, meshInstance.normalMatrix);
+    }
+
+    // Compact through groupshared memory rather than wave intrinsics; the group may span multiple waves.
+    if (isVisible) {
+        uint32_t visibleMeshletIdx;
+        InterlockedAdd(s_numVisibleMeshlets, 1, visibleMeshletIdx);
+        s_payload.meshletIndices[visibleMeshletIdx] = meshletIdx;
+    }
+    if (threadIdxInGroup == 0) {
+        s_payload.mvpMatrix = mul(g_meshShadingBindless.getViewProjectionMatrix(), meshInstance.modelMatrix);
+        s_payload.normalMatrix = meshInstance.normalMatrix;
+        s_payload.meshIdx = meshInstance.meshIdx;
+        s_payload.meshletStart = groupIdx.x * MESHLET_CULLING_GROUP_SIZE;
+    }
+    GroupMemoryBarrierWithGroupSync();
+    DispatchMesh(s_numVisibleMeshlets, 1, 1, s_payload);
+}
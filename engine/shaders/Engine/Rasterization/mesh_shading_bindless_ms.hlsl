@@ -35,24 +35,24 @@ VERTEX_DATA convertVertex(in Vertex v, in Payload payload, float3 color)
         out vertices VERTEX_DATA verts[MESHLET_MAX_VERTICES],
         out indices uint3 tris[MESHLET_MAX_PRIMITIVES]
 ) {
-        const Meshlet meshlet = g_bindlessScene.getMeshlets(payload.meshIdx)[groupIdx];
+        const uint32_t meshletIdx = payload.meshletIndices[groupIdx];
+        const Meshlet meshlet = g_bindlessScene.getMeshlets(payload.meshIdx)[meshletIdx];
         SetMeshOutputCounts(meshlet.numVertices, meshlet.numPrimitives);
 
-        RNG rng = createRandomNumberGenerator(79821479821, groupIdx);
+        RNG rng = createRandomNumberGenerator(79821479821, meshletIdx);
         const float3 color = rng.generateFloat3();
 
         StructuredBuffer<Vertex> vertices = g_bindlessScene.getVertexBuffers(payload.meshIdx);
+        StructuredBuffer<uint32_t> meshletVertices = g_bindlessScene.getMeshletVertices(payload.meshIdx);
         for (uint32_t vertexBase = 0; vertexBase < meshlet.numVertices; vertexBase += MESH_SHADING_WORK_GROUP_SIZE) {
             const uint32_t i = vertexBase + threadIdxInGroup;
             if (i < meshlet.numVertices)
-                verts[i] = convertVertex(vertices[meshlet.vertices[i]], payload, color);
+                verts[i] = convertVertex(vertices[meshletVertices[meshlet.vertexOffset + i]], payload, color);
         }
 
         for (uint32_t indexBase = 0; indexBase < meshlet.numPrimitives; indexBase += MESH_SHADING_WORK_GROUP_SIZE) {
             const uint32_t i = indexBase + threadIdxInGroup;
-            if (i < meshlet.numPrimitives) {
-                const uint32_t encodedPrimitive = meshlet.primitives[i];
-                tris[i] = uint3(encodedPrimitive & 0xFF, (encodedPrimitive >> 8) & 0xFF, (encodedPrimitive >> 16) & 0xFF);
-            }
+            if (i < meshlet.numPrimitives)
+                tris[i] = loadMeshletPrimitive(g_bindlessScene.getMeshletPrimitives(payload.meshIdx), meshlet.primitiveOffset + i);
         }
     }
\ No newline at end of file
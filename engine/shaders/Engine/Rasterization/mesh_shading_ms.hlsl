@@ -6,6 +6,7 @@
 #include "ShaderInputs/structs/Meshlet.hlsl"
 #include "ShaderInputs/constants.hlsl"
 #include "Engine/Util/random.hlsl"
+#include "mesh_shading.hlsl"
 
 struct VERTEX_DATA {
     float4 position : SV_Position;
@@ -42,14 +43,12 @@ void main(
     for (uint32_t vertexBase = 0; vertexBase < meshlet.numVertices; vertexBase += MESH_SHADING_WORK_GROUP_SIZE) {
         const uint32_t i = vertexBase + threadIdxInGroup;
         if (i < meshlet.numVertices)
-            verts[i] = convertVertex(g_meshShading.getVertices()[meshlet.vertices[i]], g_meshShading, color);
+            verts[i] = convertVertex(g_meshShading.getVertices()[g_meshShading.getMeshletVertices()[meshlet.vertexOffset + i]], g_meshShading, color);
     }
 
     for (uint32_t indexBase = 0; indexBase < meshlet.numPrimitives; indexBase += MESH_SHADING_WORK_GROUP_SIZE) {
         const uint32_t i = indexBase + threadIdxInGroup;
-        if (i < meshlet.numPrimitives) {
-            const uint32_t encodedPrimitive = meshlet.primitives[i];
-            tris[i] = uint3(encodedPrimitive & 0xFF, (encodedPrimitive >> 8) & 0xFF, (encodedPrimitive >> 16) & 0xFF);
-        }
+        if (i < meshlet.numPrimitives)
+            tris[i] = loadMeshletPrimitive(g_meshShading.getMeshletPrimitives(), meshlet.primitiveOffset + i);
     }
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "ShaderInputs/structs/Meshlet.hlsl"
+
+// Must match Render::MeshletCuller on the CPU.
+struct MeshletCuller {
+	float4 frustumPlanes[6];
+	float3 cameraPosition;
+
+	// Bounding sphere & normal cone of the meshlet in world space. The cone is only approximate for non-uniform scales.
+	bool isVisible(Meshlet meshlet, float4x4 modelMatrix, float3x3 normalMatrix)
+	{
+		const float3 center = mul(modelMatrix, float4(meshlet.boundingSphereCenter, 1.0f)).xyz;
+		const float scale = max(length(modelMatrix._m00_m10_m20), max(length(modelMatrix._m01_m11_m21), length(modelMatrix._m02_m12_m22)));
+		const float radius = meshlet.boundingSphereRadius * scale;
+		for (uint32_t i = 0; i < 6; ++i) {
+			if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius)
+				return false;
+		}
+
+		if (meshlet.coneCutoff < 1.0f) {
+			const float3 coneAxis = normalize(mul(normalMatrix, meshlet.coneAxis));
+			const float3 cameraToCenter = center - cameraPosition;
+			if (dot(cameraToCenter, coneAxis) >= meshlet.coneCutoff * length(cameraToCenter) + radius)
+				return false;
+		}
+		return true;
+	}
+};
+
+// Extract the (normalized) world space frustum planes from a view projection matrix with a [0, 1] depth range.
+MeshletCuller createMeshletCuller(float4x4 viewProjectionMatrix, float3 cameraPosition)
+{
+	MeshletCuller out;
+	out.frustumPlanes[0] = viewProjectionMatrix[3] + viewProjectionMatrix[0]; // Left
+	out.frustumPlanes[1] = viewProjectionMatrix[3] - viewProjectionMatrix[0]; // Right
+	out.frustumPlanes[2] = viewProjectionMatrix[3] + viewProjectionMatrix[1]; // Bottom
+	out.frustumPlanes[3] = viewProjectionMatrix[3] - viewProjectionMatrix[1]; // Top
+	out.frustumPlanes[4] = viewProjectionMatrix[2]; // Near
+	out.frustumPlanes[5] = viewProjectionMatrix[3] - viewProjectionMatrix[2]; // Far
+	for (uint32_t i = 0; i < 6; ++i)
+		out.frustumPlanes[i] /= length(out.frustumPlanes[i].xyz);
+	out.cameraPosition = cameraPosition;
+	return out;
+}
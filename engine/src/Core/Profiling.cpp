@@ -0,0 +1,151 @@
+#include "Engine/Core/Profiling.h"
+#include <tbx/disable_all_warnings.h>
+#include <tbx/error_handling.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Core {
+
+// Every thread caches the buffer that it records into. The profiler is identified by a unique id rather than its address
+// such that a profiler that is created at the address of a destroyed one does not reuse its (dangling) buffers.
+struct ThreadLocalBuffer {
+    uint64_t profilerID = 0;
+    void* pBuffer = nullptr;
+};
+static thread_local ThreadLocalBuffer s_threadLocalBuffer;
+static std::atomic_uint64_t s_nextProfilerID { 1 };
+
+std::string exportChromeTrace(std::span<const ProfileTrack> tracks)
+{
+    uint64_t firstStart = std::numeric_limits<uint64_t>::max();
+    for (const auto& track : tracks) {
+        for (const auto& task : track.tasks)
+            firstStart = std::min(firstStart, task.start);
+    }
+    // Microseconds relative to the first task.
+    const auto toMicroseconds = [&](uint64_t time) { return (double)(int64_t)(time - firstStart) / 1000.0; };
+
+    nlohmann::ordered_json events = nlohmann::ordered_json::array();
+    for (size_t trackIdx = 0; trackIdx < tracks.size(); ++trackIdx) {
+        const auto& track = tracks[trackIdx];
+        events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", trackIdx }, { "args", { { "name", track.name } } } });
+        events.push_back({ { "name", "thread_sort_index" }, { "ph", "M" }, { "pid", 0 }, { "tid", trackIdx }, { "args", { { "sort_index", trackIdx } } } });
+        for (const auto& task : track.tasks) {
+            events.push_back({
+                { "name", task.name },
+                { "ph", "X" }, // Complete event.
+                { "ts", toMicroseconds(task.start) },
+                { "dur", (double)(task.end - task.start) / 1000.0 },
+                { "pid", 0 },
+                { "tid", trackIdx },
+            });
+        }
+    }
+
+    nlohmann::ordered_json out;
+    out["traceEvents"] = std::move(events);
+    out["displayTimeUnit"] = "ms";
+    return out.dump();
+}
+
+CPUProfiler::CPUProfiler(uint32_t resolvedFrameStorage, uint32_t zonesPerThread)
+    : m_id(s_nextProfilerID.fetch_add(1, std::memory_order_relaxed))
+    , m_resolvedFrameStorage(resolvedFrameStorage)
+    , m_zonesPerThread(std::bit_ceil(zonesPerThread))
+    , m_frameStart(profileClockNow())
+{
+    Tbx::assert_always(resolvedFrameStorage > 0);
+    // Publish the profiler once it is fully constructed.
+    CPUProfiler* pExpected = nullptr;
+    Tbx::assert_always(s_pInstance.compare_exchange_strong(pExpected, this, std::memory_order_release, std::memory_order_relaxed), "Only one CPUProfiler may exist at a time");
+}
+
+CPUProfiler::~CPUProfiler()
+{
+    s_pInstance.store(nullptr, std::memory_order_release);
+}
+
+void CPUProfiler::recordZone(const char* name, uint64_t start, uint64_t end)
+{
+    auto& threadBuffer = getThreadBuffer();
+    const uint64_t writeIdx = threadBuffer.writeIdx.load(std::memory_order_relaxed);
+    if (writeIdx - threadBuffer.readIdx.load(std::memory_order_acquire) == m_zonesPerThread) {
+        threadBuffer.numDroppedZones.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    threadBuffer.zones[writeIdx & (m_zonesPerThread - 1)] = { .name = name, .start = start, .end = end };
+    threadBuffer.writeIdx.store(writeIdx + 1, std::memory_order_release);
+}
+
+void CPUProfiler::newFrame()
+{
+    const uint64_t frameEnd = profileClockNow();
+    Frame frame { .start = m_frameStart, .end = frameEnd, .zones = {} };
+    {
+        std::scoped_lock lock { m_threadBuffersMutex };
+        for (uint32_t threadIdx = 0; threadIdx < m_threadBuffers.size(); ++threadIdx) {
+            auto& threadBuffer = *m_threadBuffers[threadIdx];
+            const uint64_t readIdx = threadBuffer.readIdx.load(std::memory_order_relaxed);
+            const uint64_t writeIdx = threadBuffer.writeIdx.load(std::memory_order_acquire);
+            for (uint64_t i = readIdx; i < writeIdx; ++i)
+                frame.zones.push_back({ .threadIdx = threadIdx, .zone = threadBuffer.zones[i & (m_zonesPerThread - 1)] });
+            threadBuffer.readIdx.store(writeIdx, std::memory_order_release);
+        }
+    }
+
+    m_resolvedFrames.push_back(std::move(frame));
+    if (m_resolvedFrames.size() > m_resolvedFrameStorage)
+        m_resolvedFrames.pop_front();
+    m_frameStart = frameEnd;
+}
+
+std::vector<ProfileTrack> CPUProfiler::getTimeline() const
+{
+    std::vector<ProfileTrack> out(1);
+    out[0].name = "CPU frames";
+    {
+        std::scoped_lock lock { m_threadBuffersMutex };
+        for (uint32_t threadIdx = 0; threadIdx < m_threadBuffers.size(); ++threadIdx)
+            out.push_back({ .name = fmt::format("CPU thread {}", threadIdx), .tasks = {} });
+    }
+
+    for (const auto& frame : m_resolvedFrames) {
+        out[0].tasks.push_back({ .name = "Frame", .start = frame.start, .end = frame.end });
+        for (const auto& [threadIdx, zone] : frame.zones)
+            out[threadIdx + 1].tasks.push_back({ .name = zone.name, .start = zone.start, .end = zone.end });
+    }
+    // Zones are recorded when they end; sort by start time such that outer zones come before the zones nested in them.
+    for (auto& track : out) {
+        std::stable_sort(std::begin(track.tasks), std::end(track.tasks),
+            [](const ProfileTask& lhs, const ProfileTask& rhs) { return lhs.start < rhs.start || (lhs.start == rhs.start && lhs.end > rhs.end); });
+    }
+    return out;
+}
+
+uint64_t CPUProfiler::numDroppedZones() const
+{
+    std::scoped_lock lock { m_threadBuffersMutex };
+    uint64_t out = 0;
+    for (const auto& pThreadBuffer : m_threadBuffers)
+        out += pThreadBuffer->numDroppedZones.load(std::memory_order_relaxed);
+    return out;
+}
+
+CPUProfiler::ThreadBuffer& CPUProfiler::getThreadBuffer()
+{
+    if (s_threadLocalBuffer.profilerID == m_id)
+        return *static_cast<ThreadBuffer*>(s_threadLocalBuffer.pBuffer);
+
+    auto pThreadBuffer = std::make_unique<ThreadBuffer>();
+    pThreadBuffer->zones.resize(m_zonesPerThread);
+    s_threadLocalBuffer = { .profilerID = m_id, .pBuffer = pThreadBuffer.get() };
+    std::scoped_lock lock { m_threadBuffersMutex };
+    return *m_threadBuffers.emplace_back(std::move(pThreadBuffer));
+}
+
+}
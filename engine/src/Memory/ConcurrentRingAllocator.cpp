@@ -0,0 +1,102 @@
+#include "Engine/Memory/ConcurrentRingAllocator.h"
+#include <tbx/error_handling.h>
+#include <cassert>
+
+namespace Memory {
+
+static std::atomic_uint64_t s_nextAllocatorID { 0 };
+
+// The state of the allocator that the current thread used most recently. IDs are never reused so a destroyed
+// ConcurrentRingAllocator will never match.
+struct ThreadStateCache {
+    uint64_t allocatorID = (uint64_t)-1;
+    void* pThreadState = nullptr;
+};
+static thread_local ThreadStateCache s_threadStateCache;
+
+ConcurrentRingAllocator::ConcurrentRingAllocator(size_t size, size_t chunkSize, uint32_t numFramesInFlight)
+    : m_id(s_nextAllocatorID.fetch_add(1, std::memory_order_relaxed))
+    , m_chunkSize(chunkSize)
+    , m_numChunks(size / chunkSize)
+    , m_chunkIdxLimit(m_numChunks)
+    , m_frameStartChunkIndices(numFramesInFlight, 0)
+{
+    Tbx::assert_always(m_numChunks > 0 && numFramesInFlight > 0);
+}
+
+Offset ConcurrentRingAllocator::allocate(size_t size, size_t alignment)
+{
+    // The alignment does not have to be a power of 2 (structured buffers are aligned to their stride), so offsets are aligned
+    // relative to the start of the ring rather than to the start of the chunk.
+    assert(alignment > 0 && alignment <= m_chunkSize / 2);
+
+    // Large allocations get their own chunk(s); sub-allocating them would waste most of the remainder of the current chunk.
+    if (size > m_chunkSize / 2) {
+        const size_t maxPadding = m_chunkSize % alignment == 0 ? 0 : alignment - 1;
+        const uint64_t numChunks = (size + maxPadding + m_chunkSize - 1) / m_chunkSize;
+        return alignSize((reserveChunks(numChunks) % m_numChunks) * m_chunkSize, alignment);
+    }
+
+    auto& threadState = getThreadState();
+    if (threadState.frameIdx == m_frameIdx) {
+        const Offset chunkOffset = (threadState.chunkIdx % m_numChunks) * m_chunkSize;
+        const Offset offset = alignSize(chunkOffset + threadState.offsetInChunk, alignment);
+        if (offset + size <= chunkOffset + m_chunkSize) {
+            threadState.offsetInChunk = offset + size - chunkOffset;
+            return offset;
+        }
+    }
+
+    // Chunks are not reused across frames such that every chunk belongs to exactly one frame.
+    threadState.frameIdx = m_frameIdx;
+    threadState.chunkIdx = reserveChunks(1);
+    const Offset chunkOffset = (threadState.chunkIdx % m_numChunks) * m_chunkSize;
+    const Offset offset = alignSize(chunkOffset, alignment);
+    threadState.offsetInChunk = offset + size - chunkOffset;
+    return offset;
+}
+
+void ConcurrentRingAllocator::newFrame()
+{
+    ++m_frameIdx;
+    m_frameStartChunkIndices.pop_front();
+    m_frameStartChunkIndices.push_back(m_nextChunkIdx.load(std::memory_order_relaxed));
+    m_chunkIdxLimit = m_frameStartChunkIndices.front() + m_numChunks;
+}
+
+size_t ConcurrentRingAllocator::size() const
+{
+    return m_numChunks * m_chunkSize;
+}
+
+size_t ConcurrentRingAllocator::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+ConcurrentRingAllocator::ThreadState& ConcurrentRingAllocator::getThreadState()
+{
+    if (s_threadStateCache.allocatorID == m_id)
+        return *static_cast<ThreadState*>(s_threadStateCache.pThreadState);
+
+    std::lock_guard lock { m_threadStatesMutex };
+    auto& pThreadState = m_threadStates[std::this_thread::get_id()];
+    if (!pThreadState)
+        pThreadState = std::make_unique<ThreadState>();
+    s_threadStateCache = { .allocatorID = m_id, .pThreadState = pThreadState.get() };
+    return *pThreadState;
+}
+
+uint64_t ConcurrentRingAllocator::reserveChunks(uint64_t numChunks)
+{
+    Tbx::assert_always(numChunks <= m_numChunks, "ConcurrentRingAllocator: allocation is larger than the ring");
+    while (true) {
+        const uint64_t firstChunkIdx = m_nextChunkIdx.fetch_add(numChunks, std::memory_order_relaxed);
+        Tbx::assert_always(firstChunkIdx + numChunks <= m_chunkIdxLimit, "ConcurrentRingAllocator: out of memory (would overwrite a frame in flight)");
+        // Allocations cannot wrap around the end of the ring; skip the chunks at the end.
+        if (firstChunkIdx % m_numChunks + numChunks <= m_numChunks)
+            return firstChunkIdx;
+    }
+}
+
+}
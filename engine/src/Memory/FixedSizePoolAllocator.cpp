@@ -3,36 +3,56 @@
 
 namespace Memory {
 
+static uint64_t packHead(uint32_t blockIdx, uint32_t tag)
+{
+    return (uint64_t(tag) << 32) | blockIdx;
+}
+
 FixedSizePoolAllocator::FixedSizePoolAllocator(std::span<std::byte> memory, size_t allocationSize)
     : PoolAllocator(allocationSize)
-    , m_poolSize(static_cast<size_t>(memory.size()))
+    , m_pMemory(memory.data())
+    , m_numBlocks(static_cast<uint32_t>(memory.size() / allocationSize))
+    , m_pNextFreeBlock(std::make_unique<std::atomic<uint32_t>[]>(m_numBlocks))
 {
-    assert(allocationSize > sizeof(std::byte*));
-
-    std::byte* pMemory = memory.data();
-    for (size_t i = 0; i < m_poolSize; i += allocationSize) {
-        auto* pHeader = reinterpret_cast<Header*>(pMemory + i);
-        pHeader->pNext = reinterpret_cast<Header*>(pMemory + i + allocationSize);
-
-        if (i + allocationSize >= m_poolSize)
-            pHeader->pNext = nullptr;
-    }
+    assert(allocationSize > 0);
+    assert(memory.size() / allocationSize < noBlock);
 
-    m_pHead = reinterpret_cast<Header*>(pMemory);
+    for (uint32_t blockIdx = 0; blockIdx < m_numBlocks; ++blockIdx)
+        m_pNextFreeBlock[blockIdx].store(blockIdx + 1 < m_numBlocks ? blockIdx + 1 : noBlock, std::memory_order_relaxed);
+    m_head.store(packHead(m_numBlocks > 0 ? 0 : noBlock, 0), std::memory_order_release);
 }
 
 void* FixedSizePoolAllocator::allocate()
 {
-    Header* pHeader = m_pHead;
-    m_pHead = pHeader->pNext;
-    return reinterpret_cast<void*>(pHeader);
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    while (true) {
+        const uint32_t blockIdx = static_cast<uint32_t>(head);
+        if (blockIdx == noBlock)
+            return nullptr;
+
+        // The block may be allocated by another thread in the meantime; the compare-exchange will fail in that case.
+        const uint32_t next = m_pNextFreeBlock[blockIdx].load(std::memory_order_relaxed);
+        const uint64_t newHead = packHead(next, static_cast<uint32_t>(head >> 32) + 1);
+        if (m_head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            return m_pMemory + blockIdx * m_allocationSize;
+    }
 }
 
 void FixedSizePoolAllocator::deallocate(void* pMemory)
 {
-    auto* pHeader = reinterpret_cast<Header*>(pMemory);
-    pHeader->pNext = m_pHead;
-    m_pHead = pHeader;
+    const size_t offset = static_cast<size_t>(reinterpret_cast<std::byte*>(pMemory) - m_pMemory);
+    assert(offset % m_allocationSize == 0 && offset / m_allocationSize < m_numBlocks);
+    const uint32_t blockIdx = static_cast<uint32_t>(offset / m_allocationSize);
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    do {
+        m_pNextFreeBlock[blockIdx].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, packHead(blockIdx, static_cast<uint32_t>(head >> 32)), std::memory_order_release, std::memory_order_relaxed));
+}
+
+size_t FixedSizePoolAllocator::numBlocks() const
+{
+    return m_numBlocks;
 }
 
 }
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <tbx/error_handling.h>
 
 namespace Memory {
 
@@ -37,8 +38,15 @@ LinearAllocator::~LinearAllocator()
 
 void* LinearAllocator::allocate(size_t size, size_t alignment)
 {
-    if (!m_pCurrent)
-        allocateNewBlock();
+    void* pResult = tryAllocate(size, alignment);
+    Tbx::assert_always(pResult != nullptr, "LinearAllocator: pool allocator is out of memory");
+    return pResult;
+}
+
+void* LinearAllocator::tryAllocate(size_t size, size_t alignment)
+{
+    if (!m_pCurrent && !allocateNewBlock())
+        return nullptr;
 
     while (true) {
         if (std::align(alignment, size, reinterpret_cast<void*&>(m_pCurrent), m_remainingBytes)) {
@@ -49,7 +57,8 @@ void* LinearAllocator::allocate(size_t size, size_t alignment)
         } else {
             assert(m_pPoolAllocator);
             assert(size < m_pPoolAllocator->allocationSize());
-            allocateNewBlock();
+            if (!allocateNewBlock())
+                return nullptr;
         }
     }
 }
@@ -84,12 +93,15 @@ void LinearAllocator::reset()
     }
 }
 
-void LinearAllocator::allocateNewBlock()
+bool LinearAllocator::allocateNewBlock()
 {
     auto* pMemory = reinterpret_cast<std::byte*>(m_pPoolAllocator->allocate());
+    if (!pMemory)
+        return false;
     std::span<std::byte> memory = std::span(pMemory, m_pPoolAllocator->allocationSize());
 
     initializeNewBlock(memory);
+    return true;
 }
 
 void LinearAllocator::initializeNewBlock(std::span<std::byte> memory)
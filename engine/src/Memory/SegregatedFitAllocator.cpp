@@ -0,0 +1,179 @@
+#include "Engine/Memory/SegregatedFitAllocator.h"
+#include <tbx/error_handling.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace Memory {
+
+static constexpr uint32_t maxSearchedFreeRanges = 8;
+
+// Size class of a free range: ranges of size [2^i, 2^(i+1)) are stored in free list i.
+static uint32_t sizeClass(uint32_t size)
+{
+    assert(size > 0);
+    return (uint32_t)std::bit_width(size) - 1;
+}
+
+SegregatedFitAllocator::SegregatedFitAllocator(size_t size)
+    : m_size((uint32_t)size)
+{
+    Tbx::assert_always(size > 0 && size < (1llu << 31), "SegregatedFitAllocator size out of range");
+    reset();
+}
+
+std::optional<Offset> SegregatedFitAllocator::tryAllocate(size_t size)
+{
+    assert(size > 0);
+    if (size > m_size)
+        return {};
+    const uint32_t size32 = (uint32_t)size;
+
+    // All free ranges in this size class (and the ones above) are large enough.
+    const uint32_t minSizeClass = (uint32_t)std::bit_width(size32 - 1);
+    const uint32_t largeEnoughSizeClasses = minSizeClass < numSizeClasses ? m_nonEmptySizeClasses & (~0u << minSizeClass) : 0;
+
+    uint32_t start = null;
+    if (largeEnoughSizeClasses) {
+        start = m_freeListHeads[std::countr_zero(largeEnoughSizeClasses)];
+    } else {
+        // Only free ranges in the size class of the allocation itself may fit. Search a bounded number of them to keep
+        // allocating O(1) when the allocator is (nearly) full.
+        uint32_t freeRange = m_freeListHeads[sizeClass(size32)];
+        for (uint32_t i = 0; i < maxSearchedFreeRanges && freeRange != null; ++i, freeRange = m_boundaries[freeRange].nextFree) {
+            if (m_boundaries[freeRange].size >= size32) {
+                start = freeRange;
+                break;
+            }
+        }
+        if (start == null)
+            return {};
+    }
+
+    const uint32_t freeRangeSize = m_boundaries[start].size;
+    removeFreeRange(start);
+    setRange(start, size32, false);
+    if (freeRangeSize > size32)
+        insertFreeRange(start + size32, freeRangeSize - size32);
+
+    ++m_numAllocations;
+    m_allocatedSize += size32;
+    return start;
+}
+
+void SegregatedFitAllocator::deallocate(Offset offset)
+{
+    assert(offset < m_size);
+    uint32_t start = (uint32_t)offset;
+    uint32_t size = m_boundaries[start].size;
+    assert(size > 0 && !m_boundaries[start].free);
+    --m_numAllocations;
+    m_allocatedSize -= size;
+
+    // Merge with the free ranges to the left and right.
+    if (start > 0) {
+        const uint32_t leftStart = m_boundaries[start - 1].start;
+        if (m_boundaries[leftStart].free) {
+            removeFreeRange(leftStart);
+            m_boundaries[start].size = 0;
+            size += m_boundaries[leftStart].size;
+            start = leftStart;
+        }
+    }
+    const uint32_t rightStart = start + size;
+    if (rightStart < m_size && m_boundaries[rightStart].free) {
+        removeFreeRange(rightStart);
+        size += m_boundaries[rightStart].size;
+        m_boundaries[rightStart].size = 0;
+    }
+    insertFreeRange(start, size);
+}
+
+void SegregatedFitAllocator::deallocateAfter(Offset offset, uint64_t fenceValue)
+{
+    assert(offset < m_size && m_boundaries[offset].size > 0 && !m_boundaries[offset].free);
+    // Fence values are expected to increase monotonically, such that retire() only has to look at the oldest deallocation.
+    assert(m_pendingDeallocations.empty() || m_pendingDeallocations.back().fenceValue <= fenceValue);
+    m_pendingDeallocations.push_back({ .offset = offset, .fenceValue = fenceValue });
+}
+
+void SegregatedFitAllocator::retire(uint64_t completedFenceValue)
+{
+    while (!m_pendingDeallocations.empty() && m_pendingDeallocations.front().fenceValue <= completedFenceValue) {
+        deallocate(m_pendingDeallocations.front().offset);
+        m_pendingDeallocations.pop_front();
+    }
+}
+
+void SegregatedFitAllocator::reset()
+{
+    m_boundaries.clear();
+    m_boundaries.resize(m_size);
+    m_freeListHeads.fill(null);
+    m_nonEmptySizeClasses = 0;
+    m_pendingDeallocations.clear();
+    m_numAllocations = 0;
+    m_allocatedSize = 0;
+    m_numFreeRanges = 0;
+    insertFreeRange(0, m_size);
+}
+
+SegregatedFitAllocatorStatistics SegregatedFitAllocator::getStatistics() const
+{
+    SegregatedFitAllocatorStatistics out {
+        .numAllocations = m_numAllocations,
+        .numPendingDeallocations = m_pendingDeallocations.size(),
+        .allocatedSize = m_allocatedSize,
+        .freeSize = m_size - m_allocatedSize,
+        .largestFreeRangeSize = 0,
+        .numFreeRanges = m_numFreeRanges
+    };
+    if (m_nonEmptySizeClasses) {
+        const uint32_t largestSizeClass = (uint32_t)std::bit_width(m_nonEmptySizeClasses) - 1;
+        for (uint32_t freeRange = m_freeListHeads[largestSizeClass]; freeRange != null; freeRange = m_boundaries[freeRange].nextFree)
+            out.largestFreeRangeSize = std::max(out.largestFreeRangeSize, (size_t)m_boundaries[freeRange].size);
+    }
+    return out;
+}
+
+void SegregatedFitAllocator::insertFreeRange(uint32_t start, uint32_t size)
+{
+    setRange(start, size, true);
+
+    const uint32_t freeListIdx = sizeClass(size);
+    auto& boundary = m_boundaries[start];
+    boundary.prevFree = null;
+    boundary.nextFree = m_freeListHeads[freeListIdx];
+    if (boundary.nextFree != null)
+        m_boundaries[boundary.nextFree].prevFree = start;
+    m_freeListHeads[freeListIdx] = start;
+    m_nonEmptySizeClasses |= 1u << freeListIdx;
+    ++m_numFreeRanges;
+}
+
+void SegregatedFitAllocator::removeFreeRange(uint32_t start)
+{
+    auto& boundary = m_boundaries[start];
+    assert(boundary.free);
+    const uint32_t freeListIdx = sizeClass(boundary.size);
+    if (boundary.prevFree != null)
+        m_boundaries[boundary.prevFree].nextFree = boundary.nextFree;
+    else
+        m_freeListHeads[freeListIdx] = boundary.nextFree;
+    if (boundary.nextFree != null)
+        m_boundaries[boundary.nextFree].prevFree = boundary.prevFree;
+    if (m_freeListHeads[freeListIdx] == null)
+        m_nonEmptySizeClasses &= ~(1u << freeListIdx);
+    boundary.prevFree = boundary.nextFree = null;
+    boundary.free = false;
+    --m_numFreeRanges;
+}
+
+void SegregatedFitAllocator::setRange(uint32_t start, uint32_t size, bool free)
+{
+    m_boundaries[start].size = size;
+    m_boundaries[start].free = free;
+    m_boundaries[start + size - 1].start = start;
+}
+
+}
@@ -0,0 +1,104 @@
+#include "Engine/Memory/ThreadLocalLinearAllocator.h"
+#include "Engine/Memory/Memory.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace Memory {
+
+static std::atomic_uint64_t s_nextAllocatorID { 0 };
+
+// Cache of the allocator that the current thread used most recently. IDs are never reused so a destroyed
+// ThreadLocalLinearAllocator will never match.
+struct ThreadAllocatorCache {
+    uint64_t allocatorID = (uint64_t)-1;
+    LinearAllocator* pAllocator = nullptr;
+};
+static thread_local ThreadAllocatorCache s_threadAllocatorCache;
+
+ThreadLocalLinearAllocator::ThreadLocalLinearAllocator(size_t blockSize, size_t numBlocks)
+    : m_id(s_nextAllocatorID.fetch_add(1, std::memory_order_relaxed))
+    , m_pPoolMemory(std::make_unique<std::byte[]>(blockSize * numBlocks))
+    , m_blockPool(std::span(m_pPoolMemory.get(), blockSize * numBlocks), blockSize)
+{
+}
+
+ThreadLocalLinearAllocator::~ThreadLocalLinearAllocator()
+{
+    reset();
+}
+
+void* ThreadLocalLinearAllocator::allocate(size_t size, size_t alignment)
+{
+    // Allocations larger than half a block could waste most of a block; put them on the heap instead.
+    if (size + alignment > m_blockPool.allocationSize() / 2)
+        return allocateLarge(size, alignment);
+    // Degrade to the heap rather than failing when the block pool is exhausted.
+    if (void* pMemory = getThreadAllocator().tryAllocate(std::max(size, size_t(1)), alignment))
+        return pMemory;
+    return allocateLarge(size, alignment);
+}
+
+void ThreadLocalLinearAllocator::reset()
+{
+    {
+        std::lock_guard lock { m_threadAllocatorsMutex };
+        for (auto& [threadID, pThreadAllocator] : m_threadAllocators)
+            pThreadAllocator->reset();
+    }
+
+    LargeAllocation* pLargeAllocation = m_pLargeAllocations.exchange(nullptr, std::memory_order_acquire);
+    while (pLargeAllocation) {
+        LargeAllocation* pNext = pLargeAllocation->pNext;
+        ::operator delete(pLargeAllocation, std::align_val_t(pLargeAllocation->alignment));
+        pLargeAllocation = pNext;
+    }
+}
+
+size_t ThreadLocalLinearAllocator::blockSize() const
+{
+    return m_blockPool.allocationSize();
+}
+
+void* ThreadLocalLinearAllocator::do_allocate(size_t size, size_t alignment)
+{
+    return allocate(size, alignment);
+}
+
+void ThreadLocalLinearAllocator::do_deallocate(void*, size_t, size_t)
+{
+    // noop
+}
+
+bool ThreadLocalLinearAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+LinearAllocator& ThreadLocalLinearAllocator::getThreadAllocator()
+{
+    if (s_threadAllocatorCache.allocatorID == m_id)
+        return *s_threadAllocatorCache.pAllocator;
+
+    std::lock_guard lock { m_threadAllocatorsMutex };
+    auto& pThreadAllocator = m_threadAllocators[std::this_thread::get_id()];
+    if (!pThreadAllocator)
+        pThreadAllocator = std::make_unique<LinearAllocator>(&m_blockPool);
+    s_threadAllocatorCache = { .allocatorID = m_id, .pAllocator = pThreadAllocator.get() };
+    return *pThreadAllocator;
+}
+
+void* ThreadLocalLinearAllocator::allocateLarge(size_t size, size_t alignment)
+{
+    alignment = std::max(alignment, alignof(LargeAllocation));
+    const size_t headerSize = alignSize(sizeof(LargeAllocation), alignment);
+    auto* pLargeAllocation = new (::operator new(headerSize + size, std::align_val_t(alignment))) LargeAllocation();
+    pLargeAllocation->alignment = alignment;
+
+    pLargeAllocation->pNext = m_pLargeAllocations.load(std::memory_order_relaxed);
+    while (!m_pLargeAllocations.compare_exchange_weak(pLargeAllocation->pNext, pLargeAllocation, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    return reinterpret_cast<std::byte*>(pLargeAllocation) + headerSize;
+}
+
+}
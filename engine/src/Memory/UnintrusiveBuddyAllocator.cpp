@@ -6,13 +6,20 @@ DISABLE_WARNINGS_PUSH()
 #include <exception>
 #include <spdlog/spdlog.h>
 DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <bit>
 
 namespace Memory {
 
+static constexpr uint32_t bitsPerWord = 64;
+
+static uint32_t divideRoundUp(uint32_t a, uint32_t b)
+{
+    return (a + b - 1) / b;
+}
+
 UnintrusiveBuddyAllocator::UnintrusiveBuddyAllocator(Offset baseOffset, size_t size, size_t minAllocationSize)
-    : m_binaryTreeMemory()
-    , m_rootIdx(0)
-    , m_baseOffset(baseOffset)
+    : m_baseOffset(baseOffset)
     , m_size(size)
     , m_minAllocationSize(minAllocationSize)
 {
@@ -21,124 +28,203 @@ UnintrusiveBuddyAllocator::UnintrusiveBuddyAllocator(Offset baseOffset, size_t s
         throw std::exception {};
     }
 
-    m_binaryTreeMemory.emplace_back();
-    m_binaryTreeMemory.emplace_back();
+    // Blocks are only subdivided if both halves are at least minAllocationSize.
+    m_numLevels = 1;
+    while ((m_size >> m_numLevels) >= std::max(m_minAllocationSize, size_t(1)))
+        ++m_numLevels;
+    if (m_numLevels > 32) {
+        spdlog::error("UnintrusiveBuddyAllocator minAllocationSize too small for the given size");
+        throw std::exception {};
+    }
+
+    uint32_t numWords = 0, numSummaryWords = 0;
+    for (uint32_t level = 0; level < m_numLevels; ++level) {
+        Bitmap bitmap { .firstWord = numWords, .numWords = divideRoundUp(1u << level, bitsPerWord), .numSummaryLevels = 0, .firstSummaryWords = {} };
+        numWords += bitmap.numWords;
+        // Keep summarizing until a single word covers the whole level.
+        for (uint32_t levelNumWords = bitmap.numWords; levelNumWords > 1;) {
+            levelNumWords = divideRoundUp(levelNumWords, bitsPerWord);
+            assert(bitmap.numSummaryLevels < maxSummaryLevels);
+            bitmap.firstSummaryWords[bitmap.numSummaryLevels++] = numSummaryWords;
+            numSummaryWords += levelNumWords;
+        }
+        m_levelBitmaps.push_back(bitmap);
+    }
+    m_freeBits.resize(numWords);
+    m_splitBits.resize(numWords);
+    m_freeWordsSummary.resize(numSummaryWords);
+    m_numFreeBlocks.resize(m_numLevels);
+
+    reset();
 }
 
-Offset UnintrusiveBuddyAllocator::allocate(size_t allocationSize)
+Offset UnintrusiveBuddyAllocator::allocate(size_t size)
 {
-    Offset ret;
-    if (!allocateRecurse(m_rootIdx, 0, 0, allocationSize, &ret)) {
-        spdlog::error("UnintrusiveBuddyAllocator allocation failed");
-        throw std::exception {};
+    if (const auto optOffset = tryAllocate(size))
+        return *optOffset;
+
+    spdlog::error("UnintrusiveBuddyAllocator allocation of {} bytes failed", size);
+    throw std::exception {};
+}
+
+std::optional<Offset> UnintrusiveBuddyAllocator::tryAllocate(size_t size)
+{
+    if (size > m_size)
+        return {};
+
+    // Find the smallest free block that fits the allocation.
+    const uint32_t targetLevel = levelForSize(size);
+    uint32_t level = targetLevel;
+    while (m_numFreeBlocks[level] == 0) {
+        if (level == 0)
+            return {};
+        --level;
+    }
+    uint32_t blockIdx = findFreeBlock(level);
+    setFree(level, blockIdx, false);
+
+    // Split it until it matches the allocation size; the right halves are added to the free blocks.
+    for (; level < targetLevel; ++level) {
+        setSplit(level, blockIdx, true);
+        blockIdx *= 2;
+        setFree(level + 1, blockIdx + 1, true);
     }
-    return ret;
+
+    ++m_numAllocations;
+    m_allocatedSize += blockSize(targetLevel);
+    return m_baseOffset + blockIdx * blockSize(targetLevel);
 }
 
-void UnintrusiveBuddyAllocator::deallocate(Offset allocation)
+void UnintrusiveBuddyAllocator::deallocate(Offset offset)
 {
-    deallocateRecurse(m_rootIdx, 0, 0, allocation);
+    assert(offset >= m_baseOffset && offset < m_baseOffset + m_size);
+    const size_t relativeOffset = offset - m_baseOffset;
+
+    // Walk down the split blocks to find the block of the allocation.
+    uint32_t level = 0;
+    while (level + 1 < m_numLevels && testBit(m_splitBits, level, static_cast<uint32_t>(relativeOffset / blockSize(level))))
+        ++level;
+    uint32_t blockIdx = static_cast<uint32_t>(relativeOffset / blockSize(level));
+    assert(relativeOffset % blockSize(level) == 0);
+    assert(!testBit(m_freeBits, level, blockIdx));
+
+    --m_numAllocations;
+    m_allocatedSize -= blockSize(level);
+
+    // Merge with the buddy block for as long as it is free.
+    while (level > 0 && testBit(m_freeBits, level, blockIdx ^ 1)) {
+        setFree(level, blockIdx ^ 1, false);
+        blockIdx /= 2;
+        --level;
+        setSplit(level, blockIdx, false);
+    }
+    setFree(level, blockIdx, true);
 }
 
 void UnintrusiveBuddyAllocator::reset()
 {
-    m_binaryTreeMemory.clear();
-
-    m_binaryTreeMemory.emplace_back();
-    m_binaryTreeMemory.emplace_back();
-	m_rootIdx = 0;
-    m_binaryTreeMemory[m_rootIdx].hasChildren = false;
-    m_binaryTreeMemory[m_rootIdx].containsData = false;
+    std::fill(std::begin(m_freeBits), std::end(m_freeBits), 0);
+    std::fill(std::begin(m_splitBits), std::end(m_splitBits), 0);
+    std::fill(std::begin(m_freeWordsSummary), std::end(m_freeWordsSummary), 0);
+    std::fill(std::begin(m_numFreeBlocks), std::end(m_numFreeBlocks), 0);
+    m_numAllocations = 0;
+    m_allocatedSize = 0;
+
+    setFree(0, 0, true);
+}
 
-    m_nodePairFreeList.clear();
+BuddyAllocatorStatistics UnintrusiveBuddyAllocator::getStatistics() const
+{
+    BuddyAllocatorStatistics out {
+        .numAllocations = m_numAllocations,
+        .allocatedSize = m_allocatedSize,
+        .freeSize = 0,
+        .largestFreeBlockSize = 0,
+        .numFreeBlocks = 0
+    };
+    for (uint32_t level = 0; level < m_numLevels; ++level) {
+        const uint32_t numFreeBlocks = m_numFreeBlocks[level];
+        if (numFreeBlocks > 0 && out.largestFreeBlockSize == 0)
+            out.largestFreeBlockSize = blockSize(level);
+        out.freeSize += numFreeBlocks * blockSize(level);
+        out.numFreeBlocks += numFreeBlocks;
+    }
+    return out;
 }
 
-bool UnintrusiveBuddyAllocator::allocateRecurse(uint32_t nodeIdx, uint32_t depth, size_t offset, size_t allocationSize, Offset* pOutOffset)
+float BuddyAllocatorStatistics::externalFragmentation() const
 {
-    auto& node = m_binaryTreeMemory[nodeIdx];
-    if (node.containsData)
-        return false;
-
-    size_t levelSize = m_size >> depth;
-    size_t nextLevelSize = levelSize >> 1;
-    if (allocationSize > nextLevelSize || nextLevelSize < m_minAllocationSize) {
-        // Cannot subdivide further (next level is smaller than the allocation size).
-        if (!node.hasChildren) {
-            node.containsData = true;
-            *pOutOffset = m_baseOffset + offset;
-            return true;
-        } else {
-            return false;
-        }
-    } else {
-        uint32_t firstChildIdx = node.firstChild;
-        if (!node.hasChildren) {
-            // Subdivide
-            if (!m_nodePairFreeList.empty()) {
-                firstChildIdx = m_nodePairFreeList.back();
-                m_nodePairFreeList.pop_back();
-
-                m_binaryTreeMemory[firstChildIdx] = TreeNode {};
-                m_binaryTreeMemory[static_cast<size_t>(firstChildIdx) + 1] = TreeNode {};
-            } else {
-                firstChildIdx = static_cast<uint32_t>(m_binaryTreeMemory.size());
-            }
-            node.firstChild = firstChildIdx;
-            node.hasChildren = true;
-            m_binaryTreeMemory.emplace_back(); // WARNING: invalidates node reference (may realloc m_binaryTreeMemory)
-            m_binaryTreeMemory.emplace_back(); // WARNING: invalidates node reference (may realloc m_binaryTreeMemory)
-        }
+    if (freeSize == 0)
+        return 0.0f;
+    return 1.0f - float(largestFreeBlockSize) / float(freeSize);
+}
 
-		// Traverse
-        bool ret = false;
-        ret |= allocateRecurse(firstChildIdx, depth + 1, offset, allocationSize, pOutOffset);
-        if (!ret)
-            ret |= allocateRecurse(firstChildIdx + 1, depth + 1, offset + levelSize / 2, allocationSize, pOutOffset);
+size_t UnintrusiveBuddyAllocator::blockSize(uint32_t level) const
+{
+    return m_size >> level;
+}
 
-        // Propagate up the tree that this whole subtree is full.
-        if (m_binaryTreeMemory[firstChildIdx].containsData && m_binaryTreeMemory[static_cast<size_t>(firstChildIdx) + 1].containsData)
-            node.containsData = true;
+uint32_t UnintrusiveBuddyAllocator::levelForSize(size_t size) const
+{
+    // The deepest level whose blocks are at least size bytes.
+    const uint32_t level = static_cast<uint32_t>(std::countr_zero(m_size) - std::countr_zero(std::bit_ceil(std::max(size, size_t(1)))));
+    return std::min(level, m_numLevels - 1);
+}
 
-        return ret;
+uint32_t UnintrusiveBuddyAllocator::findFreeBlock(uint32_t level) const
+{
+    // Walk down from the single top summary word; every non-zero bit leads to a word that contains a free block.
+    const auto& bitmap = m_levelBitmaps[level];
+    uint32_t wordIdx = 0;
+    for (uint32_t summaryLevel = bitmap.numSummaryLevels; summaryLevel-- > 0;) {
+        const uint64_t summaryWord = m_freeWordsSummary[bitmap.firstSummaryWords[summaryLevel] + wordIdx];
+        assert(summaryWord != 0);
+        wordIdx = wordIdx * bitsPerWord + std::countr_zero(summaryWord);
     }
+    const uint64_t word = m_freeBits[bitmap.firstWord + wordIdx];
+    assert(word != 0);
+    return wordIdx * bitsPerWord + std::countr_zero(word);
 }
 
-void UnintrusiveBuddyAllocator::deallocateRecurse(uint32_t nodeIdx, uint32_t depth, Offset currentNodeOffset, Offset offsetToFree)
+bool UnintrusiveBuddyAllocator::testBit(const std::vector<uint64_t>& bits, uint32_t level, uint32_t blockIdx) const
 {
-    auto& node = m_binaryTreeMemory[nodeIdx];
-    size_t levelSize = m_size >> depth;
-
-    if (node.hasChildren) {
-        if (offsetToFree < currentNodeOffset + levelSize / 2) {
-            deallocateRecurse(node.firstChild, depth + 1, currentNodeOffset, offsetToFree);
-        } else {
-            deallocateRecurse(node.firstChild + 1, depth + 1, currentNodeOffset + levelSize / 2, offsetToFree);
-        }
-
-        auto& leftChild = m_binaryTreeMemory[node.firstChild];
-        auto& rightChild = m_binaryTreeMemory[static_cast<size_t>(node.firstChild) + 1];
-        if (!leftChild.containsData && !leftChild.hasChildren && !rightChild.containsData && !rightChild.hasChildren) {
-            // Both children are empty => collapse.
-            // List represents pairs of unused nodes so only push the first one, the second child is implicit.
-            m_nodePairFreeList.push_back(node.firstChild);
-            node.firstChild = 0;
-            node.hasChildren = false;
-        }
-    } else {
-        // This must be the node that represents the allocation.
-        assert(currentNodeOffset == offsetToFree);
-        assert(node.containsData);
-        assert(!node.hasChildren);
-    }
+    const uint64_t word = bits[m_levelBitmaps[level].firstWord + blockIdx / bitsPerWord];
+    return (word >> (blockIdx % bitsPerWord)) & 1;
+}
 
-    node.containsData = false;
+void UnintrusiveBuddyAllocator::setSplit(uint32_t level, uint32_t blockIdx, bool split)
+{
+    uint64_t& word = m_splitBits[m_levelBitmaps[level].firstWord + blockIdx / bitsPerWord];
+    const uint64_t mask = uint64_t(1) << (blockIdx % bitsPerWord);
+    word = split ? (word | mask) : (word & ~mask);
 }
 
-UnintrusiveBuddyAllocator::TreeNode::TreeNode()
-    : firstChild(0)
-    , containsData(0)
-    , hasChildren(0)
+void UnintrusiveBuddyAllocator::setFree(uint32_t level, uint32_t blockIdx, bool free)
 {
+    const auto& bitmap = m_levelBitmaps[level];
+    const uint32_t wordIdx = blockIdx / bitsPerWord;
+    uint64_t& word = m_freeBits[bitmap.firstWord + wordIdx];
+    const uint64_t mask = uint64_t(1) << (blockIdx % bitsPerWord);
+    assert(((word & mask) != 0) != free);
+    if (free) {
+        word |= mask;
+        ++m_numFreeBlocks[level];
+    } else {
+        word &= ~mask;
+        --m_numFreeBlocks[level];
+    }
+
+    // Propagate up the summary hierarchy for as long as a word changes between zero and non-zero.
+    bool nonZero = word != 0;
+    for (uint32_t summaryLevel = 0, childIdx = wordIdx; summaryLevel < bitmap.numSummaryLevels; ++summaryLevel, childIdx /= bitsPerWord) {
+        uint64_t& summaryWord = m_freeWordsSummary[bitmap.firstSummaryWords[summaryLevel] + childIdx / bitsPerWord];
+        const bool wasNonZero = summaryWord != 0;
+        const uint64_t summaryMask = uint64_t(1) << (childIdx % bitsPerWord);
+        summaryWord = nonZero ? (summaryWord | summaryMask) : (summaryWord & ~summaryMask);
+        nonZero = summaryWord != 0;
+        if (nonZero == wasNonZero)
+            break;
+    }
 }
 
 }
@@ -0,0 +1,138 @@
+#include "Engine/Render/FrameGraph/BarrierPlanner.h"
+#include <algorithm>
+#include <tbx/error_handling.h>
+
+namespace Render::FrameGraphInternal {
+
+std::span<const FGBarrier> FGBarrierPlan::batch(size_t batchIdx) const
+{
+    return std::span(barriers).subspan(batchStarts[batchIdx], batchStarts[batchIdx + 1] - batchStarts[batchIdx]);
+}
+
+static bool isReadOnlyState(D3D12_RESOURCE_STATES state)
+{
+    constexpr D3D12_RESOURCE_STATES writeStates = D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_DEPTH_WRITE
+        | D3D12_RESOURCE_STATE_STREAM_OUT | D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_RESOLVE_DEST | D3D12_RESOURCE_STATE_VIDEO_DECODE_WRITE
+        | D3D12_RESOURCE_STATE_VIDEO_PROCESS_WRITE | D3D12_RESOURCE_STATE_VIDEO_ENCODE_WRITE;
+    return state != D3D12_RESOURCE_STATE_COMMON && (state & writeStates) == 0;
+}
+
+// Barriers within a batch are ordered by kind: aliasing barriers activate a resource before it is transitioned, and split
+// transitions are started after all barriers that the next render pass waits for.
+static int batchOrder(const FGBarrier& barrier)
+{
+    switch (barrier.barrierType) {
+    case FGBarrierType::Aliasing:
+        return 0;
+    case FGBarrierType::Transition:
+        return barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY ? 3 : 1;
+    case FGBarrierType::UAV:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+FGBarrierPlan planBarriers(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses, const FGBarrierPlannerSettings& settings)
+{
+    // All uses of each resource in execution order; a render pass that binds a resource multiple times uses it once, with the
+    // combined state if all bindings are read-only and with the state of the last binding otherwise.
+    struct ResourceUse {
+        uint32_t passIdx;
+        D3D12_RESOURCE_STATES state;
+    };
+    std::vector<std::vector<ResourceUse>> resourceUses(resources.size());
+    for (uint32_t passIdx = 0; passIdx < renderPasses.size(); ++passIdx) {
+        const auto& renderPass = renderPasses[passIdx];
+        for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+            const auto& resourceAccess = resourceAccesses[resourceAccessIdx];
+            Tbx::assert_always(resourceAccess.resourceIdx < resources.size());
+            auto& uses = resourceUses[resourceAccess.resourceIdx];
+            if (!uses.empty() && uses.back().passIdx == passIdx) {
+                if (isReadOnlyState(uses.back().state) && isReadOnlyState(resourceAccess.desiredState))
+                    uses.back().state |= resourceAccess.desiredState;
+                else
+                    uses.back().state = resourceAccess.desiredState;
+            } else {
+                uses.push_back({ .passIdx = passIdx, .state = resourceAccess.desiredState });
+            }
+        }
+    }
+
+    const uint32_t endOfFrame = (uint32_t)renderPasses.size();
+    std::vector<std::vector<FGBarrier>> batches(renderPasses.size() + 1);
+    FGBarrierPlan out {};
+    out.initialStates.resize(resources.size(), D3D12_RESOURCE_STATE_COMMON);
+    const auto transition = [&](uint32_t resourceIdx, uint32_t previousPassIdx, uint32_t passIdx, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter) {
+        const FGBarrier barrier { .barrierType = FGBarrierType::Transition, .resourceIdx = resourceIdx, .stateBefore = stateBefore, .stateAfter = stateAfter };
+        // A split transition needs at least one batch in between (its BEGIN_ONLY barrier is recorded after the END_ONLY barriers of a batch).
+        if (settings.splitBarriers && passIdx - previousPassIdx >= std::max(settings.minSplitDistance, 2u)) {
+            auto beginBarrier = barrier, endBarrier = barrier;
+            beginBarrier.flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+            endBarrier.flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+            batches[previousPassIdx + 1].push_back(beginBarrier);
+            batches[passIdx].push_back(endBarrier);
+            ++out.statistics.numSplitTransitions;
+        } else {
+            batches[passIdx].push_back(barrier);
+            ++out.statistics.numTransitions;
+        }
+    };
+
+    for (uint32_t resourceIdx = 0; resourceIdx < resources.size(); ++resourceIdx) {
+        const auto& uses = resourceUses[resourceIdx];
+        const bool isSwapChain = resources[resourceIdx].resourceType == FGResourceType::SwapChain;
+        if (uses.empty()) {
+            out.initialStates[resourceIdx] = isSwapChain ? D3D12_RESOURCE_STATE_PRESENT : D3D12_RESOURCE_STATE_COMMON;
+            continue;
+        }
+
+        // The swap chain is presented at the end of the frame; all other resources start each frame in the state in
+        // which the previous frame left them. The first use of a frame is never split because it would have to start in the previous frame.
+        const auto finalState = isSwapChain ? D3D12_RESOURCE_STATE_PRESENT : uses.back().state;
+        out.initialStates[resourceIdx] = finalState;
+        if (resources[resourceIdx].resourceType == FGResourceType::Transient) {
+            batches[uses.front().passIdx].push_back({ .barrierType = FGBarrierType::Aliasing, .resourceIdx = resourceIdx });
+            ++out.statistics.numAliasingBarriers;
+        }
+        if (uses.front().state != finalState)
+            transition(resourceIdx, uses.front().passIdx, uses.front().passIdx, finalState, uses.front().state);
+
+        for (size_t useIdx = 1; useIdx < uses.size(); ++useIdx) {
+            const auto& previousUse = uses[useIdx - 1];
+            const auto& use = uses[useIdx];
+            if (previousUse.state != use.state) {
+                transition(resourceIdx, previousUse.passIdx, use.passIdx, previousUse.state, use.state);
+            } else if (use.state == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
+                // Consecutive unordered accesses are not ordered by a transition.
+                batches[use.passIdx].push_back({ .barrierType = FGBarrierType::UAV, .resourceIdx = resourceIdx });
+            }
+        }
+        if (isSwapChain && uses.back().state != finalState)
+            transition(resourceIdx, uses.back().passIdx, endOfFrame, uses.back().state, finalState);
+    }
+
+    out.batchStarts.push_back(0);
+    for (auto& batch : batches) {
+        std::stable_sort(std::begin(batch), std::end(batch), [](const FGBarrier& lhs, const FGBarrier& rhs) { return batchOrder(lhs) < batchOrder(rhs); });
+
+        const auto numUAVBarriers = std::count_if(std::begin(batch), std::end(batch), [](const FGBarrier& barrier) { return barrier.barrierType == FGBarrierType::UAV; });
+        if (settings.mergeUAVBarriers && numUAVBarriers > 1) {
+            const auto firstUAVBarrier = std::find_if(std::begin(batch), std::end(batch), [](const FGBarrier& barrier) { return barrier.barrierType == FGBarrierType::UAV; });
+            firstUAVBarrier->resourceIdx = FGBarrier::AllResources;
+            batch.erase(firstUAVBarrier + 1, firstUAVBarrier + numUAVBarriers);
+            out.statistics.numMergedUAVBarriers += (uint32_t)numUAVBarriers - 1;
+            out.statistics.numUAVBarriers += 1;
+        } else {
+            out.statistics.numUAVBarriers += (uint32_t)numUAVBarriers;
+        }
+
+        if (!batch.empty())
+            ++out.statistics.numBatches;
+        out.barriers.insert(std::end(out.barriers), std::begin(batch), std::end(batch));
+        out.batchStarts.push_back(out.barriers.size());
+    }
+    return out;
+}
+
+}
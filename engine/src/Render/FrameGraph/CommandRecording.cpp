@@ -0,0 +1,129 @@
+#include "Engine/Render/FrameGraph/CommandRecording.h"
+#include "Engine/Core/Profiling.h"
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <tbx/error_handling.h>
+
+namespace Render::FrameGraphInternal {
+
+std::vector<FGPassGroup> partitionPassGroups(size_t numOperations, size_t maxNumGroups, size_t minPassesPerGroup)
+{
+    const size_t numGroups = std::clamp(numOperations / std::max(minPassesPerGroup, size_t(1)), size_t(1), std::max(maxNumGroups, size_t(1)));
+    const size_t passesPerGroup = numOperations / numGroups, remainder = numOperations % numGroups;
+
+    std::vector<FGPassGroup> out;
+    size_t operationBegin = 0;
+    for (size_t groupIdx = 0; groupIdx < numGroups; ++groupIdx) {
+        const size_t operationEnd = operationBegin + passesPerGroup + (groupIdx < remainder ? 1 : 0);
+        out.push_back({ .operationBegin = operationBegin, .operationEnd = operationEnd });
+        operationBegin = operationEnd;
+    }
+    return out;
+}
+
+std::vector<FGPassGroup> partitionPassGroups(const FGQueueSchedule& queueSchedule, size_t maxNumGroups, size_t minPassesPerGroup)
+{
+    std::vector<FGPassGroup> out;
+    for (uint32_t segmentIdx = 0; segmentIdx < queueSchedule.segments.size(); ++segmentIdx) {
+        const auto& segment = queueSchedule.segments[segmentIdx];
+        for (const auto& passGroup : partitionPassGroups(segment.operationEnd - segment.operationBegin, maxNumGroups, minPassesPerGroup)) {
+            out.push_back({ .operationBegin = segment.operationBegin + passGroup.operationBegin,
+                .operationEnd = segment.operationBegin + passGroup.operationEnd,
+                .segmentIdx = segmentIdx });
+        }
+    }
+    return out;
+}
+
+FGBarrierPlan legalizeSplitBarriers(const FGBarrierPlan& barrierPlan, const FGQueueSchedule& queueSchedule, std::span<const FGPassGroup> passGroups)
+{
+    // The pass group that records each batch of barriers; the end of frame batch is recorded by the last group.
+    const size_t numBatches = barrierPlan.numBatches();
+    std::vector<size_t> batchToGroup(numBatches);
+    for (size_t groupIdx = 0; groupIdx < passGroups.size(); ++groupIdx) {
+        const auto& passGroup = passGroups[groupIdx];
+        Tbx::assert_always(passGroup.operationBegin == (groupIdx == 0 ? 0 : passGroups[groupIdx - 1].operationEnd));
+        for (size_t i = passGroup.operationBegin; i < passGroup.operationEnd; ++i)
+            batchToGroup[queueSchedule.operationOrder[i]] = groupIdx;
+    }
+    Tbx::assert_always(!passGroups.empty() && passGroups.back().operationEnd + 1 == numBatches);
+    batchToGroup.back() = passGroups.size() - 1;
+
+    // Find the split transitions whose BEGIN_ONLY and END_ONLY barriers are recorded by different groups. A resource has
+    // at most one split transition in flight, so the END_ONLY barrier belongs to the last BEGIN_ONLY barrier of the resource.
+    static constexpr size_t noBarrier = (size_t)-1;
+    std::vector<size_t> pendingBeginBarrier(barrierPlan.initialStates.size(), noBarrier);
+    std::vector<bool> crossesGroups(barrierPlan.barriers.size(), false);
+    for (size_t batchIdx = 0; batchIdx < numBatches; ++batchIdx) {
+        for (size_t barrierIdx = barrierPlan.batchStarts[batchIdx]; barrierIdx < barrierPlan.batchStarts[batchIdx + 1]; ++barrierIdx) {
+            const auto& barrier = barrierPlan.barriers[barrierIdx];
+            if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+                pendingBeginBarrier[barrier.resourceIdx] = barrierIdx;
+            } else if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+                const size_t beginBarrierIdx = pendingBeginBarrier[barrier.resourceIdx];
+                Tbx::assert_always(beginBarrierIdx != noBarrier);
+                const auto beginBatchIdx = std::upper_bound(std::begin(barrierPlan.batchStarts), std::end(barrierPlan.batchStarts), beginBarrierIdx) - std::begin(barrierPlan.batchStarts) - 1;
+                if (batchToGroup[beginBatchIdx] != batchToGroup[batchIdx])
+                    crossesGroups[beginBarrierIdx] = crossesGroups[barrierIdx] = true;
+                pendingBeginBarrier[barrier.resourceIdx] = noBarrier;
+            }
+        }
+    }
+
+    FGBarrierPlan out {};
+    out.initialStates = barrierPlan.initialStates;
+    out.statistics = barrierPlan.statistics;
+    out.statistics.numBatches = 0;
+    out.batchStarts.push_back(0);
+    for (size_t batchIdx = 0; batchIdx < numBatches; ++batchIdx) {
+        for (size_t barrierIdx = barrierPlan.batchStarts[batchIdx]; barrierIdx < barrierPlan.batchStarts[batchIdx + 1]; ++barrierIdx) {
+            auto barrier = barrierPlan.barriers[barrierIdx];
+            if (crossesGroups[barrierIdx]) {
+                if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                    continue;
+                barrier.flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                --out.statistics.numSplitTransitions;
+                ++out.statistics.numTransitions;
+            }
+            out.barriers.push_back(barrier);
+        }
+        if (out.barriers.size() != out.batchStarts.back())
+            ++out.statistics.numBatches;
+        out.batchStarts.push_back(out.barriers.size());
+    }
+    return out;
+}
+
+void recordPassGroups(const FGBarrierPlan& barrierPlan, const FGQueueSchedule& queueSchedule, std::span<const FGBarrier> initialBarriers, std::span<const FGPassGroup> passGroups, std::span<IFGCommandRecorder* const> recorders)
+{
+    Tbx::assert_always(recorders.size() == passGroups.size());
+    const size_t endOfFrame = barrierPlan.numBatches() - 1;
+
+    std::vector<size_t> groupIndices(passGroups.size());
+    std::iota(std::begin(groupIndices), std::end(groupIndices), size_t(0));
+    std::for_each(std::execution::par, std::begin(groupIndices), std::end(groupIndices),
+        [&](size_t groupIdx) {
+            PROFILE_ZONE("Record pass group");
+            auto& recorder = *recorders[groupIdx];
+            const auto recordBarriers = [&](std::span<const FGBarrier> barriers) {
+                if (!barriers.empty())
+                    recorder.recordBarriers(barriers);
+            };
+
+            const auto& passGroup = passGroups[groupIdx];
+            if (groupIdx == 0)
+                recordBarriers(initialBarriers);
+            for (size_t i = passGroup.operationBegin; i < passGroup.operationEnd; ++i) {
+                const uint32_t operationIdx = queueSchedule.operationOrder[i];
+                recordBarriers(barrierPlan.batch(operationIdx));
+                recorder.recordRenderPass(operationIdx);
+            }
+            if (groupIdx == passGroups.size() - 1 || passGroups[groupIdx + 1].segmentIdx != passGroup.segmentIdx)
+                recordBarriers(queueSchedule.segments[passGroup.segmentIdx].signalBarriers);
+            if (groupIdx == passGroups.size() - 1)
+                recordBarriers(barrierPlan.batch(endOfFrame));
+        });
+}
+
+}
@@ -0,0 +1,287 @@
+#include "Engine/Render/FrameGraph/CompiledPlan.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace Render::FrameGraphInternal {
+
+FGCompiledPlan createCompiledPlan(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses)
+{
+    FGCompiledPlan out {};
+    for (const auto& resource : resources) {
+        out.resources.push_back({ .resourceType = resource.resourceType,
+            .width = resource.desc.Width,
+            .height = resource.desc.Height,
+            .format = resource.desc.Format });
+    }
+    for (uint32_t passIdx = 0; passIdx < renderPasses.size(); ++passIdx) {
+        const auto& renderPass = renderPasses[passIdx];
+        auto& planPass = out.passes.emplace_back(FGPlanPass { .name = renderPass.name, .queue = renderPass.queue });
+        for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+            const auto& resourceAccess = resourceAccesses[resourceAccessIdx];
+            planPass.resourceAccesses.push_back(resourceAccess);
+            auto& planResource = out.resources[resourceAccess.resourceIdx];
+            if (planResource.firstPassIdx == FGPlanResource::noPass)
+                planResource.firstPassIdx = passIdx;
+            planResource.lastPassIdx = passIdx;
+        }
+    }
+    return out;
+}
+
+static const char* resourceTypeToString(FGResourceType resourceType)
+{
+    switch (resourceType) {
+    case FGResourceType::Transient:
+        return "Transient";
+    case FGResourceType::Persistent:
+        return "Persistent";
+    case FGResourceType::SwapChain:
+        return "SwapChain";
+    default:
+        return "Unknown";
+    }
+}
+
+static const char* queueToString(RenderPassQueue queue)
+{
+    return queue == RenderPassQueue::Graphics ? "Graphics" : "AsyncCompute";
+}
+
+// Resource states are bit flags; print them as "NON_PIXEL_SHADER_RESOURCE|PIXEL_SHADER_RESOURCE".
+static std::string stateToString(D3D12_RESOURCE_STATES state)
+{
+    static constexpr std::array stateNames {
+        std::pair { D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, "VERTEX_AND_CONSTANT_BUFFER" },
+        std::pair { D3D12_RESOURCE_STATE_INDEX_BUFFER, "INDEX_BUFFER" },
+        std::pair { D3D12_RESOURCE_STATE_RENDER_TARGET, "RENDER_TARGET" },
+        std::pair { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, "UNORDERED_ACCESS" },
+        std::pair { D3D12_RESOURCE_STATE_DEPTH_WRITE, "DEPTH_WRITE" },
+        std::pair { D3D12_RESOURCE_STATE_DEPTH_READ, "DEPTH_READ" },
+        std::pair { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, "NON_PIXEL_SHADER_RESOURCE" },
+        std::pair { D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, "PIXEL_SHADER_RESOURCE" },
+        std::pair { D3D12_RESOURCE_STATE_STREAM_OUT, "STREAM_OUT" },
+        std::pair { D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, "INDIRECT_ARGUMENT" },
+        std::pair { D3D12_RESOURCE_STATE_COPY_DEST, "COPY_DEST" },
+        std::pair { D3D12_RESOURCE_STATE_COPY_SOURCE, "COPY_SOURCE" },
+        std::pair { D3D12_RESOURCE_STATE_RESOLVE_DEST, "RESOLVE_DEST" },
+        std::pair { D3D12_RESOURCE_STATE_RESOLVE_SOURCE, "RESOLVE_SOURCE" },
+        std::pair { D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, "RAYTRACING_ACCELERATION_STRUCTURE" },
+        std::pair { D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE, "SHADING_RATE_SOURCE" },
+    };
+    if (state == D3D12_RESOURCE_STATE_COMMON)
+        return "COMMON";
+
+    std::string out;
+    for (const auto& [flag, name] : stateNames) {
+        if ((state & flag) != flag)
+            continue;
+        if (!out.empty())
+            out += '|';
+        out += name;
+        state = (D3D12_RESOURCE_STATES)(state & ~flag);
+    }
+    if (state != D3D12_RESOURCE_STATE_COMMON)
+        out += fmt::format("{}0x{:x}", out.empty() ? "" : "|", (uint32_t)state);
+    return out;
+}
+
+static nlohmann::ordered_json barriersToJSON(std::span<const FGBarrier> barriers)
+{
+    auto out = nlohmann::ordered_json::array();
+    for (const auto& barrier : barriers) {
+        nlohmann::ordered_json jsonBarrier;
+        if (barrier.resourceIdx == FGBarrier::AllResources)
+            jsonBarrier["resource"] = nullptr;
+        else
+            jsonBarrier["resource"] = barrier.resourceIdx;
+        switch (barrier.barrierType) {
+        case FGBarrierType::Aliasing: {
+            jsonBarrier["type"] = "Aliasing";
+        } break;
+        case FGBarrierType::Transition: {
+            jsonBarrier["type"] = "Transition";
+            jsonBarrier["before"] = stateToString(barrier.stateBefore);
+            jsonBarrier["after"] = stateToString(barrier.stateAfter);
+            if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                jsonBarrier["split"] = "Begin";
+            else if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+                jsonBarrier["split"] = "End";
+        } break;
+        case FGBarrierType::UAV: {
+            jsonBarrier["type"] = "UAV";
+        } break;
+        }
+        out.push_back(std::move(jsonBarrier));
+    }
+    return out;
+}
+
+// The queue segment that each render pass is submitted in.
+static std::vector<uint32_t> getPassSegments(const FGCompiledPlan& plan)
+{
+    std::vector<uint32_t> out(plan.passes.size(), 0);
+    const auto& queueSchedule = plan.queueSchedule;
+    for (uint32_t segmentIdx = 0; segmentIdx < queueSchedule.segments.size(); ++segmentIdx) {
+        const auto& segment = queueSchedule.segments[segmentIdx];
+        for (size_t i = segment.operationBegin; i < segment.operationEnd; ++i)
+            out[queueSchedule.operationOrder[i]] = segmentIdx;
+    }
+    return out;
+}
+
+std::string exportPlanToJSON(const FGCompiledPlan& plan)
+{
+    const auto& barrierStatistics = plan.barrierPlan.statistics;
+    const auto& queueStatistics = plan.queueSchedule.statistics;
+    nlohmann::ordered_json out;
+    out["statistics"] = {
+        { "numCulledPasses", plan.passOrderStatistics.numCulledPasses },
+        { "numMovedPasses", plan.passOrderStatistics.numMovedPasses },
+        { "numBarrierBatches", barrierStatistics.numBatches },
+        { "numTransitions", barrierStatistics.numTransitions },
+        { "numSplitTransitions", barrierStatistics.numSplitTransitions },
+        { "numUAVBarriers", barrierStatistics.numUAVBarriers },
+        { "numMergedUAVBarriers", barrierStatistics.numMergedUAVBarriers },
+        { "numAliasingBarriers", barrierStatistics.numAliasingBarriers },
+        { "numAsyncComputePasses", queueStatistics.numAsyncComputePasses },
+        { "numFenceWaits", queueStatistics.numWaits },
+        { "transientMemorySize", std::accumulate(std::begin(plan.heapSizes), std::end(plan.heapSizes), size_t(0)) }
+    };
+    out["heapSizes"] = plan.heapSizes;
+
+    auto& jsonResources = out["resources"] = nlohmann::ordered_json::array();
+    for (const auto& resource : plan.resources) {
+        nlohmann::ordered_json jsonResource;
+        jsonResource["type"] = resourceTypeToString(resource.resourceType);
+        jsonResource["width"] = resource.width;
+        jsonResource["height"] = resource.height;
+        jsonResource["format"] = (uint32_t)resource.format;
+        if (resource.firstPassIdx == FGPlanResource::noPass)
+            jsonResource["lifetime"] = nullptr;
+        else
+            jsonResource["lifetime"] = { resource.firstPassIdx, resource.lastPassIdx };
+        jsonResource["initialState"] = stateToString(resource.initialState);
+        if (resource.resourceType == FGResourceType::Transient) {
+            jsonResource["heap"] = resource.heapIdx;
+            jsonResource["offset"] = resource.heapOffset;
+            jsonResource["size"] = resource.sizeInBytes;
+        }
+        jsonResources.push_back(std::move(jsonResource));
+    }
+
+    const auto passSegments = getPassSegments(plan);
+    // One batch per render pass plus one at the end of the frame (if the barriers were planned).
+    const bool hasBarriers = plan.barrierPlan.batchStarts.size() == plan.passes.size() + 2;
+    auto& jsonPasses = out["passes"] = nlohmann::ordered_json::array();
+    for (size_t passIdx = 0; passIdx < plan.passes.size(); ++passIdx) {
+        const auto& pass = plan.passes[passIdx];
+        nlohmann::ordered_json jsonPass;
+        jsonPass["name"] = pass.name;
+        jsonPass["queue"] = queueToString(pass.queue);
+        jsonPass["segment"] = passSegments[passIdx];
+        auto& jsonAccesses = jsonPass["accesses"] = nlohmann::ordered_json::array();
+        for (const auto& resourceAccess : pass.resourceAccesses)
+            jsonAccesses.push_back({ { "resource", resourceAccess.resourceIdx }, { "state", stateToString(resourceAccess.desiredState) } });
+        // The barriers that are recorded right before the render pass.
+        jsonPass["barriers"] = hasBarriers ? barriersToJSON(plan.barrierPlan.batch(passIdx)) : nlohmann::ordered_json::array();
+        jsonPasses.push_back(std::move(jsonPass));
+    }
+    out["endOfFrameBarriers"] = hasBarriers ? barriersToJSON(plan.barrierPlan.batch(plan.passes.size())) : nlohmann::ordered_json::array();
+    out["initialBarriers"] = barriersToJSON(plan.initialBarriers);
+
+    auto& jsonSegments = out["segments"] = nlohmann::ordered_json::array();
+    for (const auto& segment : plan.queueSchedule.segments) {
+        nlohmann::ordered_json jsonSegment;
+        jsonSegment["queue"] = queueToString(segment.queue);
+        jsonSegment["passes"] = std::vector(std::begin(plan.queueSchedule.operationOrder) + segment.operationBegin, std::begin(plan.queueSchedule.operationOrder) + segment.operationEnd);
+        jsonSegment["waitSegments"] = segment.waitSegments;
+        jsonSegment["signal"] = segment.signal;
+        jsonSegment["signalBarriers"] = barriersToJSON(segment.signalBarriers);
+        jsonSegments.push_back(std::move(jsonSegment));
+    }
+    return out.dump(2);
+}
+
+// Render pass names are generated from type names (which may contain quotes in template arguments).
+static std::string escapeGraphviz(const std::string& str)
+{
+    std::string out;
+    for (const char c : str) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string exportPlanToGraphviz(const FGCompiledPlan& plan)
+{
+    std::string out = "digraph FrameGraph {\n";
+    out += "    rankdir=LR;\n";
+    out += "    node [fontname=\"Helvetica\"];\n";
+    out += "    edge [fontname=\"Helvetica\", fontsize=10];\n";
+
+    // Render passes, grouped by queue segment.
+    const auto& queueSchedule = plan.queueSchedule;
+    const auto addPass = [&](size_t passIdx) {
+        const auto& pass = plan.passes[passIdx];
+        const char* color = pass.queue == RenderPassQueue::Graphics ? "lightblue" : "lightsalmon";
+        out += fmt::format("        pass{} [shape=box, style=filled, fillcolor={}, label=\"{}: {}\"];\n", passIdx, color, passIdx, escapeGraphviz(pass.name));
+    };
+    if (queueSchedule.segments.empty()) {
+        for (size_t passIdx = 0; passIdx < plan.passes.size(); ++passIdx)
+            addPass(passIdx);
+    }
+    for (size_t segmentIdx = 0; segmentIdx < queueSchedule.segments.size(); ++segmentIdx) {
+        const auto& segment = queueSchedule.segments[segmentIdx];
+        out += fmt::format("    subgraph cluster_segment{} {{\n", segmentIdx);
+        out += fmt::format("        label=\"Segment {} ({})\";\n", segmentIdx, queueToString(segment.queue));
+        for (size_t i = segment.operationBegin; i < segment.operationEnd; ++i)
+            addPass(queueSchedule.operationOrder[i]);
+        // Segments without render passes (the start/end of the frame) still need a node to connect the fence waits to.
+        if (segment.operationBegin == segment.operationEnd)
+            out += fmt::format("        segment{} [shape=point];\n", segmentIdx);
+        out += "    }\n";
+    }
+
+    for (size_t resourceIdx = 0; resourceIdx < plan.resources.size(); ++resourceIdx) {
+        const auto& resource = plan.resources[resourceIdx];
+        if (resource.firstPassIdx == FGPlanResource::noPass)
+            continue;
+        std::string label = fmt::format("{}: {}\\n{}x{}", resourceIdx, resourceTypeToString(resource.resourceType), resource.width, resource.height);
+        if (resource.resourceType == FGResourceType::Transient)
+            label += fmt::format("\\nheap {} @ {} KiB ({} KiB)", resource.heapIdx, resource.heapOffset / 1024, resource.sizeInBytes / 1024);
+        out += fmt::format("    resource{} [shape=ellipse, label=\"{}\"];\n", resourceIdx, label);
+    }
+    for (size_t passIdx = 0; passIdx < plan.passes.size(); ++passIdx) {
+        for (const auto& resourceAccess : plan.passes[passIdx].resourceAccesses) {
+            if (isWriteState(resourceAccess.desiredState))
+                out += fmt::format("    pass{} -> resource{} [label=\"{}\"];\n", passIdx, resourceAccess.resourceIdx, stateToString(resourceAccess.desiredState));
+            else
+                out += fmt::format("    resource{} -> pass{} [label=\"{}\"];\n", resourceAccess.resourceIdx, passIdx, stateToString(resourceAccess.desiredState));
+        }
+    }
+
+    // Fence waits go from the last render pass of the signaling segment to the first render pass of the waiting segment.
+    const auto segmentNode = [&](uint32_t segmentIdx, bool last) {
+        const auto& segment = queueSchedule.segments[segmentIdx];
+        if (segment.operationBegin == segment.operationEnd)
+            return fmt::format("segment{}", segmentIdx);
+        return fmt::format("pass{}", queueSchedule.operationOrder[last ? segment.operationEnd - 1 : segment.operationBegin]);
+    };
+    for (uint32_t segmentIdx = 0; segmentIdx < queueSchedule.segments.size(); ++segmentIdx) {
+        for (const uint32_t waitSegmentIdx : queueSchedule.segments[segmentIdx].waitSegments)
+            out += fmt::format("    {} -> {} [style=dashed, label=\"fence\"];\n", segmentNode(waitSegmentIdx, true), segmentNode(segmentIdx, false));
+    }
+    out += "}\n";
+    return out;
+}
+
+}
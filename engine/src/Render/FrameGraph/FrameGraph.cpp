@@ -1,5 +1,10 @@
 #include "Engine/Render/FrameGraph/FrameGraph.h"
+#include "Engine/Core/Profiling.h"
+#include "Engine/Core/Stopwatch.h"
+#include "Engine/Render/FrameGraph/CompiledPlan.h"
 #include "Engine/Render/FrameGraph/Operations.h"
+#include "Engine/Render/FrameGraph/PassOrdering.h"
+#include "Engine/Render/FrameGraph/TransientPlacement.h"
 #include "Engine/Render/GPUProfiler.h"
 #include "Engine/Render/RenderContext.h"
 #include "Engine/RenderAPI/Buffer/CpuBufferLinearAllocator.h"
@@ -10,12 +15,16 @@ DISABLE_WARNINGS_PUSH()
 #include <EASTL/fixed_vector.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
+#include <spdlog/spdlog.h>
 DISABLE_WARNINGS_POP()
+#include <fstream>
 #include <functional>
 #include <limits>
+#include <numeric>
 #include <optional>
+#include <tbx/error_handling.h>
 #include <tbx/variant_helper.h>
-#include <unordered_map>
+#include <thread>
 #include <vector>
 
 using namespace RenderAPI;
@@ -23,8 +32,37 @@ using namespace Render::FrameGraphInternal;
 
 namespace Render {
 
+// Recording a few render passes on a separate thread does not make up for the cost of an additional command list.
+static constexpr size_t minPassesPerCommandList = 8;
+
 void FrameGraph::displayGUI() const
 {
+    const auto& barrierStatistics = m_barrierPlan.statistics;
+    ImGui::Text("Barriers (%u batches)", barrierStatistics.numBatches);
+    ImGui::Text("Transitions: %u (+ %u split)", barrierStatistics.numTransitions, barrierStatistics.numSplitTransitions);
+    ImGui::Text("UAV: %u (%u merged)", barrierStatistics.numUAVBarriers, barrierStatistics.numMergedUAVBarriers);
+    ImGui::Text("Aliasing: %u", barrierStatistics.numAliasingBarriers);
+    ImGui::Text("Transient memory: %zu KiB (greedy: %zu KiB)", m_transientMemorySize / 1024, m_greedyTransientMemorySize / 1024);
+    ImGui::Text("Compile time: %.2fms", m_compileTimeInMs);
+    ImGui::Text("Pipeline states: %u created, %u reused", m_pipelineStateStatistics.numCreated, m_pipelineStateStatistics.numReused);
+    const auto descriptorTableStatistics = m_pRenderContext->descriptorTableCache.getStatistics();
+    ImGui::Text("Descriptor tables: %u hits, %u misses (%.0f%% hit rate)", descriptorTableStatistics.numHits, descriptorTableStatistics.numMisses, descriptorTableStatistics.hitRate() * 100.0f);
+    ImGui::Text("Descriptors copied: %u (%u tables cached, %u evicted)", descriptorTableStatistics.numDescriptorsCopied, descriptorTableStatistics.numCachedTables, descriptorTableStatistics.numEvictions);
+    const auto& passOrderStatistics = m_compiledPlan.passOrderStatistics;
+    ImGui::Text("Render passes: %zu (%u culled, %u reordered)", m_operations.size(), passOrderStatistics.numCulledPasses, passOrderStatistics.numMovedPasses);
+    ImGui::Text("Command lists: %zu", m_passGroups.size());
+    const auto& queueStatistics = m_queueSchedule.statistics;
+    ImGui::Text("Async compute: %u passes, %u fence waits", queueStatistics.numAsyncComputePasses, queueStatistics.numWaits);
+    if (ImGui::Button("Export plan")) {
+        // Written to the working directory; render with "dot -Tsvg frame_graph.dot -o frame_graph.svg".
+        std::ofstream { "frame_graph.json" } << exportPlanToJSON(m_compiledPlan);
+        std::ofstream { "frame_graph.dot" } << exportPlanToGraphviz(m_compiledPlan);
+        spdlog::info("Exported frame graph plan to frame_graph.json and frame_graph.dot");
+    }
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
     bool first = true;
     for (const auto& operation : m_operations) {
         if (!operation.pImplementation->willDisplayGUI())
@@ -42,138 +80,196 @@ void FrameGraph::displayGUI() const
     }
 }
 
-void FrameGraph::execute(GPUFrameProfiler* pProfiler)
-{
-    auto pCommandList = m_pRenderContext->commandListManager.acquireCommandList();
-    if (pProfiler)
-        pProfiler->startFrame(pCommandList.Get());
-
-    // Update the framebuffer resource to point to the current frame.
-    for (auto& resource : m_resourceRegistry) {
-        if (resource.resourceType == FGResourceType::SwapChain)
-            resource.pResource = m_pRenderContext->optSwapChain->getCurrentBackBuffer();
+// Records the barriers and render passes of one pass group into a D3D12 command list.
+class FrameGraph::CommandRecorder : public IFGCommandRecorder {
+public:
+    CommandRecorder(FrameGraph* pFrameGraph, ID3D12GraphicsCommandList6* pCommandList, GPUFrameProfiler* pProfiler, std::span<const uint32_t> profilerTaskHandles)
+        : m_pFrameGraph(pFrameGraph)
+        , m_pCommandList(pCommandList)
+        , m_pProfiler(pProfiler)
+        , m_profilerTaskHandles(profilerTaskHandles)
+    {
+        const std::array descriptorHeaps {
+            m_pFrameGraph->m_pRenderContext->pCbvSrvUavDescriptorBaseAllocatorGPU->pDescriptorHeap.Get(),
+            // renderContext.pImGuiDescriptorHeap.Get()
+        };
+        m_pCommandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
     }
 
-    const auto insertAliasingBarrierIfNecessary = [&](const size_t resourceAccessIdx) {
-        const auto& resourceAccess = m_resourceAccesses[resourceAccessIdx];
-        auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
-        if (resource.resourceType == FGResourceType::Transient && resource.firstResourceAccessIndex == resourceAccessIdx) {
-            const auto barrier = CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource.pResource.Get());
-            pCommandList->ResourceBarrier(1, &barrier);
-        }
-    };
-    const auto insertUAVBarrierIfNecessary = [&](const size_t resourceAccessIdx) {
-        const auto& resourceAccess = m_resourceAccesses[resourceAccessIdx];
-        const auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
-        // No need for a UAV barrier when also performing a state transition.
-        // if (resource.currentState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS && resourceAccess.desiredState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
-        if (resource.currentState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS || resourceAccess.desiredState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
-            assert(resource.pResource);
-            const auto barrier = CD3DX12_RESOURCE_BARRIER::UAV(resource.pResource.Get());
-            pCommandList->ResourceBarrier(1, &barrier);
-        }
-    };
-    const auto transitionResourceIfNecessary = [&](const size_t resourceAccessIdx) {
-        const auto& resourceAccess = m_resourceAccesses[resourceAccessIdx];
-        auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
-        if (resource.currentState != resourceAccess.desiredState) {
-            // TODO(Mathijs): batch state transitions
-            const auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource.pResource.Get(), resource.currentState, resourceAccess.desiredState);
-            pCommandList->ResourceBarrier(1, &barrier);
-            resource.currentState = resourceAccess.desiredState;
+    // Record a batch of planned barriers with a single ResourceBarrier() call.
+    void recordBarriers(std::span<const FGBarrier> barriers) override
+    {
+        const auto& resourceRegistry = m_pFrameGraph->m_resourceRegistry;
+        eastl::fixed_vector<D3D12_RESOURCE_BARRIER, 16> d3d12Barriers;
+        for (const auto& barrier : barriers) {
+            ID3D12Resource* pResource = barrier.resourceIdx == FGBarrier::AllResources ? nullptr : resourceRegistry[barrier.resourceIdx].pResource.Get();
+            assert(pResource || barrier.barrierType == FGBarrierType::UAV);
+            switch (barrier.barrierType) {
+            case FGBarrierType::Aliasing: {
+                d3d12Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, pResource));
+            } break;
+            case FGBarrierType::Transition: {
+                d3d12Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(
+                    pResource, barrier.stateBefore, barrier.stateAfter, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, barrier.flags));
+            } break;
+            case FGBarrierType::UAV: {
+                d3d12Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(pResource));
+            } break;
+            }
         }
-    };
+        m_pCommandList->ResourceBarrier((UINT)d3d12Barriers.size(), d3d12Barriers.data());
+    }
 
-    const std::array descriptorHeaps {
-        m_pRenderContext->pCbvSrvUavDescriptorBaseAllocatorGPU->pDescriptorHeap.Get(),
-        // renderContext.pImGuiDescriptorHeap.Get()
-    };
-    pCommandList->SetDescriptorHeaps((UINT)descriptorHeaps.size(), descriptorHeaps.data());
-    for (const auto& operation : m_operations) {
-        uint32_t profilerTaskHandle = (uint32_t)-1;
-        if (pProfiler)
-            profilerTaskHandle = pProfiler->startTask(pCommandList.Get(), operation.name);
-
-        for (size_t resourceAccessIdx = operation.resourceAccessBegin; resourceAccessIdx < operation.resourceAccessEnd; resourceAccessIdx++) {
-            insertAliasingBarrierIfNecessary(resourceAccessIdx);
-            // BEFORE stateTransition so it knows when **not** to insert a barrier (state transition == barrier).
-            insertUAVBarrierIfNecessary(resourceAccessIdx);
-            transitionResourceIfNecessary(resourceAccessIdx);
-        }
+    void recordRenderPass(size_t operationIdx) override
+    {
+        const auto& operation = m_pFrameGraph->m_operations[operationIdx];
+        const auto& resourceRegistry = m_pFrameGraph->m_resourceRegistry;
+        const auto& resourceAccesses = m_pFrameGraph->m_resourceAccesses;
+        const auto& attachmentViews = m_pFrameGraph->m_attachmentViews;
+        if (m_pProfiler)
+            m_pProfiler->startTask(m_pCommandList, m_profilerTaskHandles[operationIdx]);
 
         if (operation.renderPassType == RenderPassType::Graphics || operation.renderPassType == RenderPassType::MeshShading) {
-            // Create & fill render pass info struct.
-            eastl::fixed_vector<CD3DX12_CPU_DESCRIPTOR_HANDLE, 8, false> rtvDescriptorHandles;
-            std::optional<CD3DX12_CPU_DESCRIPTOR_HANDLE> optDsvDescriptorHandle {};
+            // Bind the render target & depth stencil views that were created by FrameGraphBuilder::compile().
+            eastl::fixed_vector<D3D12_CPU_DESCRIPTOR_HANDLE, 8, false> rtvDescriptorHandles;
+            std::optional<D3D12_CPU_DESCRIPTOR_HANDLE> optDsvDescriptorHandle {};
             D3D12_VIEWPORT viewport { .TopLeftX = 0.0f, .TopLeftY = 0.0f, .MinDepth = 0.0f, .MaxDepth = 1.0f };
             D3D12_RECT scissorRect { .left = 0, .top = 0 };
             for (size_t resourceAccessIdx = operation.resourceAccessBegin; resourceAccessIdx < operation.resourceAccessEnd; resourceAccessIdx++) {
-                const auto& resourceAccess = m_resourceAccesses[resourceAccessIdx];
-                auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
-
-                if (resourceAccess.accessType == FGResourceAccessType::RenderTarget) {
-                    // Allocate RenderTargetView descriptor
-                    const auto rtvDescriptor = m_pRenderContext->rtvDescriptorAllocator.allocate(1);
-                    D3D12_RENDER_TARGET_VIEW_DESC rtvDesc {
-                        .Format = resource.desc.Format,
-                        .ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D
-                    };
-                    rtvDesc.Texture2D.MipSlice = rtvDesc.Texture2D.PlaneSlice = 0;
-                    m_pRenderContext->pDevice->CreateRenderTargetView(resource.pResource.Get(), &rtvDesc, rtvDescriptor);
-                    rtvDescriptorHandles.push_back(rtvDescriptor);
-                } else if (resourceAccess.accessType == FGResourceAccessType::Depth) {
-                    // D3D12_RESOURCE_STATE_DEPTH_READ and/or D3D12_RESOURCE_STATE_DEPTH_WRITE
-                    const auto dsvDescriptor = m_pRenderContext->dsvDescriptorAllocator.allocate(1);
-                    const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc {
-                        .Format = resource.dsvFormat,
-                        .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
-                        .Flags = D3D12_DSV_FLAG_NONE,
-                        .Texture2D = D3D12_TEX2D_DSV {}
-                    };
-                    m_pRenderContext->pDevice->CreateDepthStencilView(resource.pResource.Get(), &dsvDesc, dsvDescriptor);
-                    optDsvDescriptorHandle = dsvDescriptor;
-                }
-
-                if (resourceAccess.accessType == FGResourceAccessType::RenderTarget || resourceAccess.accessType == FGResourceAccessType::Depth) {
-                    scissorRect.right = (LONG)resource.desc.Width;
-                    scissorRect.bottom = (LONG)resource.desc.Height;
-                    viewport.Width = (FLOAT)resource.desc.Width;
-                    viewport.Height = (FLOAT)resource.desc.Height;
-                }
+                const auto& resourceAccess = resourceAccesses[resourceAccessIdx];
+                if (resourceAccess.accessType == FGResourceAccessType::General)
+                    continue;
+
+                if (resourceAccess.accessType == FGResourceAccessType::RenderTarget)
+                    rtvDescriptorHandles.push_back(attachmentViews[resourceAccessIdx]);
+                else
+                    optDsvDescriptorHandle = attachmentViews[resourceAccessIdx];
+
+                const auto& resource = resourceRegistry[resourceAccess.resourceIdx];
+                scissorRect.right = (LONG)resource.desc.Width;
+                scissorRect.bottom = (LONG)resource.desc.Height;
+                viewport.Width = (FLOAT)resource.desc.Width;
+                viewport.Height = (FLOAT)resource.desc.Height;
             }
 
-            pCommandList->RSSetViewports(1, &viewport);
-            pCommandList->RSSetScissorRects(1, &scissorRect);
-            pCommandList->OMSetRenderTargets((UINT)rtvDescriptorHandles.size(), rtvDescriptorHandles.data(), false, optDsvDescriptorHandle ? &optDsvDescriptorHandle.value() : nullptr);
+            m_pCommandList->RSSetViewports(1, &viewport);
+            m_pCommandList->RSSetScissorRects(1, &scissorRect);
+            m_pCommandList->OMSetRenderTargets((UINT)rtvDescriptorHandles.size(), rtvDescriptorHandles.data(), false, optDsvDescriptorHandle ? &optDsvDescriptorHandle.value() : nullptr);
         }
 
-        const std::span<const FGResourceAccess> resourceAccesses = std::span(m_resourceAccesses).subspan(operation.resourceAccessBegin, operation.resourceAccessEnd - operation.resourceAccessBegin);
+        const size_t numResourceAccesses = operation.resourceAccessEnd - operation.resourceAccessBegin;
         const FrameGraphExecuteArgs executeArgs {
-            .pRenderContext = m_pRenderContext,
-            .pCommandList = pCommandList.Get()
+            .pRenderContext = m_pFrameGraph->m_pRenderContext,
+            .pCommandList = m_pCommandList,
+            .pMemoryResource = &m_pFrameGraph->m_pRenderContext->frameAllocator
         };
-        operation.pImplementation->execute(m_resourceRegistry, resourceAccesses, executeArgs);
-        if (pProfiler)
-            pProfiler->endTask(pCommandList.Get(), profilerTaskHandle);
+        operation.pImplementation->execute(
+            resourceRegistry,
+            std::span(resourceAccesses).subspan(operation.resourceAccessBegin, numResourceAccesses),
+            std::span(attachmentViews).subspan(operation.resourceAccessBegin, numResourceAccesses),
+            executeArgs);
+        if (m_pProfiler)
+            m_pProfiler->endTask(m_pCommandList, m_profilerTaskHandles[operationIdx]);
     }
 
-    // Transition the frame buffer to the PRESENT state.
-    for (auto& resource : m_resourceRegistry) {
-        if (resource.resourceType == FGResourceType::SwapChain && resource.currentState != D3D12_RESOURCE_STATE_PRESENT) {
-            const auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource.pResource.Get(), resource.currentState, D3D12_RESOURCE_STATE_PRESENT);
-            pCommandList->ResourceBarrier(1, &barrier);
-            resource.currentState = D3D12_RESOURCE_STATE_PRESENT;
+private:
+    FrameGraph* m_pFrameGraph;
+    ID3D12GraphicsCommandList6* m_pCommandList;
+    GPUFrameProfiler* m_pProfiler;
+    std::span<const uint32_t> m_profilerTaskHandles;
+};
+
+void FrameGraph::execute(GPUFrameProfiler* pProfiler)
+{
+    PROFILE_FUNCTION();
+    // Render passes may read resources that were uploaded since the previous frame.
+    m_pRenderContext->uploadManager.flush();
+
+    const auto getQueue = [this](RenderPassQueue queue) {
+        return queue == RenderPassQueue::Graphics ? m_pRenderContext->pGraphicsQueue.Get() : m_pRenderContext->pComputeQueue.Get();
+    };
+    const auto getFence = [this](RenderPassQueue queue) -> RenderAPI::Fence& {
+        return queue == RenderPassQueue::Graphics ? m_pRenderContext->graphicsFence : m_pRenderContext->computeFence;
+    };
+    const auto getCommandListManager = [this](RenderPassQueue queue) -> RenderAPI::CommandListManager& {
+        return queue == RenderPassQueue::Graphics ? m_pRenderContext->commandListManager : m_pRenderContext->computeCommandListManager;
+    };
+
+    // The command list manager is not thread-safe: acquire a command list for every pass group up front. The first and last
+    // pass groups are always recorded on the graphics queue.
+    std::vector<WRL::ComPtr<ID3D12GraphicsCommandList6>> commandLists;
+    for (const auto& passGroup : m_passGroups)
+        commandLists.push_back(getCommandListManager(m_queueSchedule.segments[passGroup.segmentIdx].queue).acquireCommandList());
+    if (pProfiler)
+        pProfiler->startFrame(commandLists.front().Get());
+
+    // Update the framebuffer resource (and its views) to point to the current frame.
+    if (m_pRenderContext->optSwapChain) {
+        const auto backBufferIdx = m_pRenderContext->optSwapChain->getCurrentBackBufferIndex();
+        for (auto& resource : m_resourceRegistry) {
+            if (resource.resourceType == FGResourceType::SwapChain)
+                resource.pResource = m_pRenderContext->optSwapChain->backBuffers[backBufferIdx];
         }
+        const auto descriptorIncrementSize = m_pRenderContext->pRtvDescriptorBaseAllocatorCPU->descriptorIncrementSize;
+        for (const auto& swapChainView : m_swapChainViews)
+            m_attachmentViews[swapChainView.resourceAccessIdx] = CD3DX12_CPU_DESCRIPTOR_HANDLE(swapChainView.firstBackBufferView, backBufferIdx, descriptorIncrementSize);
     }
 
+    // Profiler tasks are added in execution order; their timestamps are recorded by the threads that record the pass groups.
+    std::vector<uint32_t> profilerTaskHandles;
+    if (pProfiler) {
+        for (const auto& operation : m_operations)
+            profilerTaskHandles.push_back(pProfiler->addTask(operation.name, operation.queue == RenderPassQueue::AsyncCompute));
+    }
+
+    std::vector<CommandRecorder> recorders;
+    std::vector<IFGCommandRecorder*> pRecorders;
+    recorders.reserve(commandLists.size());
+    for (const auto& pCommandList : commandLists)
+        pRecorders.push_back(&recorders.emplace_back(this, pCommandList.Get(), pProfiler, profilerTaskHandles));
+    recordPassGroups(m_barrierPlan, m_queueSchedule, m_initialBarriers, m_passGroups, pRecorders);
+    m_initialBarriers.clear();
+
     if (pProfiler)
-        pProfiler->endFrame(pCommandList.Get());
+        pProfiler->endFrame(commandLists.back().Get());
 
     m_pRenderContext->getCurrentCbvSrvUavDescriptorTransientAllocator().flush();
-    pCommandList->Close();
-    ID3D12CommandList* const pRawCommandList = pCommandList.Get();
-    m_pRenderContext->pGraphicsQueue->ExecuteCommandLists(1, &pRawCommandList);
-    m_pRenderContext->commandListManager.recycleCommandList(m_pRenderContext->pGraphicsQueue.Get(), pCommandList);
+    m_pRenderContext->descriptorTableCache.flush();
+    for (const auto& pCommandList : commandLists)
+        pCommandList->Close();
+
+    // Submit the segments in order; each segment waits for the fences that the segments it depends on signal.
+    PROFILE_ZONE("Submit");
+    std::vector<uint64_t> segmentFenceValues(m_queueSchedule.segments.size(), 0);
+    std::vector<ID3D12CommandList*> rawCommandLists;
+    for (size_t segmentIdx = 0, groupIdx = 0; segmentIdx < m_queueSchedule.segments.size(); ++segmentIdx) {
+        const auto& segment = m_queueSchedule.segments[segmentIdx];
+        auto* pQueue = getQueue(segment.queue);
+        for (const uint32_t waitSegmentIdx : segment.waitSegments)
+            RenderAPI::insertWait(getFence(m_queueSchedule.segments[waitSegmentIdx].queue), segmentFenceValues[waitSegmentIdx], pQueue);
+
+        rawCommandLists.clear();
+        for (; groupIdx < m_passGroups.size() && m_passGroups[groupIdx].segmentIdx == segmentIdx; ++groupIdx)
+            rawCommandLists.push_back(commandLists[groupIdx].Get());
+        pQueue->ExecuteCommandLists((UINT)rawCommandLists.size(), rawCommandLists.data());
+        if (segment.signal)
+            segmentFenceValues[segmentIdx] = RenderAPI::insertFence(getFence(segment.queue), pQueue);
+    }
+    // The frame ends on the graphics queue (after waiting for the async compute segments).
+    m_lastFenceValue = RenderAPI::insertFence(m_pRenderContext->graphicsFence, m_pRenderContext->pGraphicsQueue.Get());
+    for (size_t groupIdx = 0; groupIdx < m_passGroups.size(); ++groupIdx) {
+        const auto queue = m_queueSchedule.segments[m_passGroups[groupIdx].segmentIdx].queue;
+        getCommandListManager(queue).recycleCommandList(getQueue(queue), commandLists[groupIdx]);
+    }
+}
+
+void FrameGraph::releaseSwapChainResources()
+{
+    // execute() points the swap chain resource to the current back buffer at the start of every frame.
+    for (auto& resource : m_resourceRegistry) {
+        if (resource.resourceType == FGResourceType::SwapChain)
+            resource.pResource = nullptr;
+    }
 }
 
 FrameGraphBuilder::FrameGraphBuilder(Render::RenderContext* pRenderContext)
@@ -183,7 +279,7 @@ FrameGraphBuilder::FrameGraphBuilder(Render::RenderContext* pRenderContext)
         const auto dummyDesc = CD3DX12_RESOURCE_DESC::Tex2D(
             DXGI_FORMAT_R8G8B8A8_UNORM, m_pRenderContext->optSwapChain->width, m_pRenderContext->optSwapChain->height);
         m_frameBuffer = (uint32_t)m_resourceRegistry.size();
-        m_resourceRegistry.push_back(FGResource { .resourceType = FGResourceType::SwapChain, .currentState = D3D12_RESOURCE_STATE_PRESENT, .desc = dummyDesc });
+        m_resourceRegistry.push_back(FGResource { .resourceType = FGResourceType::SwapChain, .desc = dummyDesc });
     } else {
         m_frameBuffer = (uint32_t)-1;
     }
@@ -237,6 +333,27 @@ glm::uvec2 FrameGraphBuilder::getTextureResolution(uint32_t resourceIdx) const
     return glm::uvec2(resourceDesc.Width, resourceDesc.Height);
 }
 
+static void createRenderTargetView(ID3D12Device5* pDevice, ID3D12Resource* pResource, DXGI_FORMAT format, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
+{
+    D3D12_RENDER_TARGET_VIEW_DESC rtvDesc {
+        .Format = format,
+        .ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D
+    };
+    rtvDesc.Texture2D.MipSlice = rtvDesc.Texture2D.PlaneSlice = 0;
+    pDevice->CreateRenderTargetView(pResource, &rtvDesc, descriptor);
+}
+
+static void createDepthStencilView(ID3D12Device5* pDevice, ID3D12Resource* pResource, DXGI_FORMAT format, D3D12_CPU_DESCRIPTOR_HANDLE descriptor)
+{
+    const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc {
+        .Format = format,
+        .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
+        .Flags = D3D12_DSV_FLAG_NONE,
+        .Texture2D = D3D12_TEX2D_DSV {}
+    };
+    pDevice->CreateDepthStencilView(pResource, &dsvDesc, descriptor);
+}
+
 // Invoke F on each item.
 template <typename F, typename T, typename... Ts>
 void invoke_items(F&& f, T&& arg, Ts&&... tail)
@@ -250,8 +367,31 @@ void invoke_items(F&& f, T&& arg)
     f(std::forward<T>(arg));
 }
 
-FrameGraph FrameGraphBuilder::compile()
+FrameGraph FrameGraphBuilder::compile(FrameGraph* pPreviousFrameGraph)
 {
+    Core::Stopwatch stopwatch;
+    const auto pipelineStateStatisticsBefore = m_pRenderContext->pipelineStateCache.getStatistics();
+
+    // Cull the render passes that do not contribute to the output and reorder the others to shorten the lifetimes of the
+    // transient resources. This happens before the render passes are initialized so that culled passes create no state.
+    const auto passOrder = orderRenderPasses(m_resourceRegistry, m_resourceAccesses, m_operations);
+    {
+        std::vector<FGRenderPass> operations;
+        std::vector<FGResourceAccess> resourceAccesses;
+        for (const uint32_t passIdx : passOrder.order) {
+            auto& operation = operations.emplace_back(std::move(m_operations[passIdx]));
+            const size_t resourceAccessBegin = resourceAccesses.size();
+            resourceAccesses.insert(std::end(resourceAccesses), std::begin(m_resourceAccesses) + operation.resourceAccessBegin, std::begin(m_resourceAccesses) + operation.resourceAccessEnd);
+            operation.resourceAccessBegin = resourceAccessBegin;
+            operation.resourceAccessEnd = resourceAccesses.size();
+        }
+        // Culled render passes were never initialized, so they should not be destroyed either.
+        for (auto& operation : m_operations)
+            operation.pRenderContext = Tbx::MovePointer<RenderContext> {};
+        m_operations = std::move(operations);
+        m_resourceAccesses = std::move(resourceAccesses);
+    }
+
     // Create the global/static state (such as shaders, root signature and pipeline states) for each render pass.
     for (const auto& operation : m_operations) {
         const auto initializePipelineState = [&]<typename T>(T& pipelineStateDesc) {
@@ -290,47 +430,182 @@ FrameGraph FrameGraphBuilder::compile()
             resource.firstResourceAccessIndex = resourceAccessIndex;
     }
 
-    // Allocate and release the temporary textures in the order that the operations will be executed.
-    // Note that releasing a resource is not the same as destroying it. The resource will stay alive
-    // but it's memory may be reused by another resource allocated afterwards.
-    auto resourceAliasManager = m_pRenderContext->createResourceAliasManager(512 * 1024 * 1024);
-    std::unordered_map<size_t, RenderAPI::AliasingResource> aliasingMemoryAllocations;
+    // Resources start every frame in the state in which the previous frame left them; create them in that state. The render
+    // passes are recorded in parallel (in groups); split barriers may not cross the command lists of the pass groups, and
+    // the async compute queue cannot transition resources from graphics states.
+    auto queueSchedule = scheduleQueues(m_resourceRegistry, m_resourceAccesses, m_operations);
+    auto passGroups = partitionPassGroups(queueSchedule, std::max(std::thread::hardware_concurrency(), 1u), minPassesPerCommandList);
+    auto barrierPlan = legalizeSplitBarriers(planBarriers(m_resourceRegistry, m_resourceAccesses, m_operations), queueSchedule, passGroups);
+    barrierPlan = legalizeQueueBarriers(barrierPlan, queueSchedule, m_resourceAccesses, m_operations);
+    std::vector<FGBarrier> initialBarriers;
+
+    // Place all transient resources up front: resources whose lifetimes (first to last render pass) don't overlap may share
+    // memory. The heaps are allocated at exactly the size required by the placement.
+    auto pDevice = m_pRenderContext->pDevice;
+    const size_t numHeaps = RenderAPI::ResourceAliasManager::getNumHeaps(pDevice.Get());
+    std::vector<uint32_t> resourceAccessToPass(m_resourceAccesses.size());
+    for (uint32_t passIdx = 0; passIdx < m_operations.size(); ++passIdx) {
+        const auto& operation = m_operations[passIdx];
+        std::fill(std::begin(resourceAccessToPass) + operation.resourceAccessBegin, std::begin(resourceAccessToPass) + operation.resourceAccessEnd, passIdx);
+    }
+    std::vector<FGTransientResource> transientPlacementInput;
+    std::vector<size_t> transientPlacementIndices(m_resourceRegistry.size(), (size_t)-1);
+    for (uint32_t resourceIdx = 0; resourceIdx < m_resourceRegistry.size(); ++resourceIdx) {
+        const auto& resource = m_resourceRegistry[resourceIdx];
+        if (resource.resourceType != FGResourceType::Transient || resource.firstResourceAccessIndex == (size_t)-1)
+            continue;
+        const auto allocationInfo = pDevice->GetResourceAllocationInfo(0, 1, &resource.desc);
+        transientPlacementIndices[resourceIdx] = transientPlacementInput.size();
+        transientPlacementInput.push_back({ .sizeInBytes = allocationInfo.SizeInBytes,
+            .alignment = allocationInfo.Alignment,
+            .firstPassIdx = resourceAccessToPass[resource.firstResourceAccessIndex],
+            .lastPassIdx = resourceAccessToPass[resource.lastResourceAccessIndex],
+            .heapIdx = (uint32_t)RenderAPI::ResourceAliasManager::getHeapIdx(resource.desc, numHeaps) });
+    }
+    // Render passes on different queues may execute concurrently: the memory of a transient resource can only be reused
+    // after all render passes that may overlap with one of its uses have completed.
+    for (size_t resourceAccessIdx = 0; resourceAccessIdx < m_resourceAccesses.size(); ++resourceAccessIdx) {
+        const size_t placementIdx = transientPlacementIndices[m_resourceAccesses[resourceAccessIdx].resourceIdx];
+        if (placementIdx == (size_t)-1)
+            continue;
+        auto& lastPassIdx = transientPlacementInput[placementIdx].lastPassIdx;
+        lastPassIdx = std::max(lastPassIdx, queueSchedule.lastConcurrentPass[resourceAccessToPass[resourceAccessIdx]]);
+    }
+    const auto transientPlacement = placeTransientResources(transientPlacementInput, numHeaps);
+    const auto greedyTransientPlacement = placeTransientResources(transientPlacementInput, numHeaps, FGPlacementStrategy::Greedy);
+    spdlog::info("Transient memory: {} KiB (greedy placement: {} KiB)", transientPlacement.totalSizeInBytes() / 1024, greedyTransientPlacement.totalSizeInBytes() / 1024);
+
+    // Reuse the heaps of the previous frame graph if they are large enough, but not if they waste more memory than they use.
+    std::optional<RenderAPI::ResourceAliasManager> optResourceAliasManager;
+    if (pPreviousFrameGraph && pPreviousFrameGraph->m_resourceAliasingManager) {
+        // Transient resources are placed in the heaps without any synchronization with frames that are still in flight.
+        Tbx::assert_always(RenderAPI::fenceReached(m_pRenderContext->graphicsFence, pPreviousFrameGraph->m_lastFenceValue),
+            "The previous frame graph is still in use by the GPU");
+        const auto previousHeapSizes = pPreviousFrameGraph->m_resourceAliasingManager->getHeapSizes();
+        bool canReuseHeaps = previousHeapSizes.size() == numHeaps;
+        for (size_t heapIdx = 0; canReuseHeaps && heapIdx < numHeaps; ++heapIdx)
+            canReuseHeaps = previousHeapSizes[heapIdx] >= transientPlacement.heapSizes[heapIdx];
+        const size_t previousSize = std::accumulate(std::begin(previousHeapSizes), std::end(previousHeapSizes), size_t(0));
+        if (canReuseHeaps && previousSize <= 2 * transientPlacement.totalSizeInBytes()) {
+            optResourceAliasManager = std::move(pPreviousFrameGraph->m_resourceAliasingManager);
+            pPreviousFrameGraph->m_resourceAliasingManager.reset();
+        }
+    }
+    if (!optResourceAliasManager)
+        optResourceAliasManager = m_pRenderContext->createResourceAliasManager(transientPlacement.heapSizes);
+    auto& resourceAliasManager = *optResourceAliasManager;
     std::vector<RenderAPI::D3D12MAResource> persistentResourcesAllocations;
     for (const auto& operation : m_operations) {
         for (size_t resourceAccessIndex = operation.resourceAccessBegin; resourceAccessIndex < operation.resourceAccessEnd; ++resourceAccessIndex) {
             const auto& resourceAccess = m_resourceAccesses[resourceAccessIndex];
             auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
+            if (resource.resourceType == FGResourceType::SwapChain || resource.firstResourceAccessIndex != resourceAccessIndex)
+                continue;
+
             // Buffer cannot be created in D3D12_RESOURCE_STATE_UNORDERED_ACCESS state.
-            const auto initialState = resourceAccess.desiredState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS ? resourceAccess.desiredState : D3D12_RESOURCE_STATE_COMMON;
-            if (resource.resourceType == FGResourceType::Transient && resource.firstResourceAccessIndex == resourceAccessIndex) {
-                auto& allocation = aliasingMemoryAllocations[resourceAccess.resourceIdx] = resourceAliasManager.allocate(resource.desc, initialState);
+            const auto frameState = barrierPlan.initialStates[resourceAccess.resourceIdx];
+            const auto initialState = frameState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS ? frameState : D3D12_RESOURCE_STATE_COMMON;
+            if (resource.resourceType == FGResourceType::Transient) {
+                const size_t placementIdx = transientPlacementIndices[resourceAccess.resourceIdx];
+                const auto allocation = resourceAliasManager.createPlacedResource(
+                    transientPlacementInput[placementIdx].heapIdx, transientPlacement.offsets[placementIdx], resource.desc, initialState);
                 resource.pResource = allocation.pResource;
-                resource.currentState = initialState;
-            }
-
-            if (resource.resourceType == FGResourceType::Persistent && resource.firstResourceAccessIndex == resourceAccessIndex) {
+            } else if (resource.resourceType == FGResourceType::Persistent) {
                 auto resourceAllocation = m_pRenderContext->createResource(D3D12_HEAP_TYPE_DEFAULT, resource.desc, initialState);
                 resource.pResource = resourceAllocation;
                 persistentResourcesAllocations.emplace_back(std::move(resourceAllocation));
-                resource.currentState = initialState;
             }
+            if (initialState != frameState)
+                initialBarriers.push_back({ .barrierType = FGBarrierType::Transition, .resourceIdx = resourceAccess.resourceIdx, .stateBefore = initialState, .stateAfter = frameState });
         }
-        for (size_t resourceAccessIndex = operation.resourceAccessBegin; resourceAccessIndex < operation.resourceAccessEnd; ++resourceAccessIndex) {
-            const auto& resourceAccess = m_resourceAccesses[resourceAccessIndex];
-            auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
-            if (resource.resourceType == FGResourceType::Transient && resource.lastResourceAccessIndex == resourceAccessIndex) {
-                resourceAliasManager.releaseMemory(aliasingMemoryAllocations.find(resourceAccess.resourceIdx)->second);
+    }
+
+    // Create the render target & depth stencil views up front so that execute() does not have to create them every frame.
+    // Resource accesses that use the same resource share a view; swap chain resources get a view for each back buffer.
+    RenderAPI::CPUDescriptorLinearAllocator rtvDescriptorAllocator { m_pRenderContext->pRtvDescriptorBaseAllocatorCPU.get() };
+    RenderAPI::CPUDescriptorLinearAllocator dsvDescriptorAllocator { m_pRenderContext->pDsvDescriptorBaseAllocatorCPU.get() };
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> attachmentViews(m_resourceAccesses.size(), D3D12_CPU_DESCRIPTOR_HANDLE { 0 });
+    std::vector<FGSwapChainView> swapChainViews;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> resourceRTVs(m_resourceRegistry.size(), D3D12_CPU_DESCRIPTOR_HANDLE { 0 });
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> resourceDSVs(m_resourceRegistry.size(), D3D12_CPU_DESCRIPTOR_HANDLE { 0 });
+    for (size_t resourceAccessIdx = 0; resourceAccessIdx < m_resourceAccesses.size(); ++resourceAccessIdx) {
+        const auto& resourceAccess = m_resourceAccesses[resourceAccessIdx];
+        const auto& resource = m_resourceRegistry[resourceAccess.resourceIdx];
+        const bool isSwapChain = resource.resourceType == FGResourceType::SwapChain;
+        const uint32_t numViews = isSwapChain ? RenderAPI::SwapChain::s_parallelFrames : 1;
+        // Returns the (first) view of the resource, creating it if this is the first access that needs it.
+        const auto getOrCreateView = [&](std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& resourceViews, RenderAPI::CPUDescriptorLinearAllocator& descriptorAllocator,
+                                         uint32_t descriptorIncrementSize, const auto& createView) {
+            auto& view = resourceViews[resourceAccess.resourceIdx];
+            if (view.ptr == 0) {
+                view = descriptorAllocator.allocate(numViews);
+                if (isSwapChain) {
+                    for (uint32_t backBufferIdx = 0; backBufferIdx < numViews; ++backBufferIdx)
+                        createView(m_pRenderContext->optSwapChain->backBuffers[backBufferIdx].Get(), CD3DX12_CPU_DESCRIPTOR_HANDLE(view, backBufferIdx, descriptorIncrementSize));
+                } else {
+                    createView(resource.pResource.Get(), view);
+                }
             }
+            return view;
+        };
+
+        if (resourceAccess.desiredState & D3D12_RESOURCE_STATE_RENDER_TARGET) {
+            attachmentViews[resourceAccessIdx] = getOrCreateView(resourceRTVs, rtvDescriptorAllocator, m_pRenderContext->pRtvDescriptorBaseAllocatorCPU->descriptorIncrementSize,
+                [&](ID3D12Resource* pResource, D3D12_CPU_DESCRIPTOR_HANDLE descriptor) { createRenderTargetView(pDevice.Get(), pResource, resource.desc.Format, descriptor); });
+        } else if (resourceAccess.desiredState & (D3D12_RESOURCE_STATE_DEPTH_WRITE | D3D12_RESOURCE_STATE_DEPTH_READ)) {
+            attachmentViews[resourceAccessIdx] = getOrCreateView(resourceDSVs, dsvDescriptorAllocator, m_pRenderContext->pDsvDescriptorBaseAllocatorCPU->descriptorIncrementSize,
+                [&](ID3D12Resource* pResource, D3D12_CPU_DESCRIPTOR_HANDLE descriptor) { createDepthStencilView(pDevice.Get(), pResource, resource.dsvFormat, descriptor); });
+        } else {
+            continue;
         }
+        if (isSwapChain)
+            swapChainViews.push_back({ .resourceAccessIdx = resourceAccessIdx, .firstBackBufferView = CD3DX12_CPU_DESCRIPTOR_HANDLE(attachmentViews[resourceAccessIdx]) });
     }
 
+    // Keep a device independent copy of the decisions made above so that the frame graph can be inspected offline.
+    auto compiledPlan = createCompiledPlan(m_resourceRegistry, m_resourceAccesses, m_operations);
+    for (size_t resourceIdx = 0; resourceIdx < m_resourceRegistry.size(); ++resourceIdx) {
+        auto& planResource = compiledPlan.resources[resourceIdx];
+        planResource.initialState = barrierPlan.initialStates[resourceIdx];
+        if (const size_t placementIdx = transientPlacementIndices[resourceIdx]; placementIdx != (size_t)-1) {
+            planResource.heapIdx = transientPlacementInput[placementIdx].heapIdx;
+            planResource.heapOffset = transientPlacement.offsets[placementIdx];
+            planResource.sizeInBytes = transientPlacementInput[placementIdx].sizeInBytes;
+        }
+    }
+    compiledPlan.heapSizes = transientPlacement.heapSizes;
+    compiledPlan.passOrderStatistics = passOrder.statistics;
+    compiledPlan.queueSchedule = queueSchedule;
+    compiledPlan.barrierPlan = barrierPlan;
+    compiledPlan.initialBarriers = initialBarriers;
+
     FrameGraph out;
     out.m_pRenderContext = m_pRenderContext;
     out.m_resourceRegistry = std::move(m_resourceRegistry);
     out.m_resourceAccesses = std::move(m_resourceAccesses);
     out.m_operations = std::move(m_operations);
-    out.m_resourceAliasingManager = std::move(resourceAliasManager); // Ensure that the memory used by the transient memory pool remains allocated.
+    out.m_queueSchedule = std::move(queueSchedule);
+    out.m_passGroups = std::move(passGroups);
+    out.m_barrierPlan = std::move(barrierPlan);
+    out.m_initialBarriers = std::move(initialBarriers);
+    out.m_rtvDescriptorAllocator = std::move(rtvDescriptorAllocator);
+    out.m_dsvDescriptorAllocator = std::move(dsvDescriptorAllocator);
+    out.m_attachmentViews = std::move(attachmentViews);
+    out.m_swapChainViews = std::move(swapChainViews);
+    out.m_transientMemorySize = transientPlacement.totalSizeInBytes();
+    out.m_greedyTransientMemorySize = greedyTransientPlacement.totalSizeInBytes();
+    out.m_resourceAliasingManager = std::move(optResourceAliasManager); // Ensure that the memory used by the transient memory pool remains allocated.
     out.m_persistentResourcesAllocations = std::move(persistentResourcesAllocations); // Ensure that the memory used by the transient memory pool remains allocated.
+
+    const auto pipelineStateStatistics = m_pRenderContext->pipelineStateCache.getStatistics();
+    out.m_pipelineStateStatistics = {
+        .numCreated = pipelineStateStatistics.numCreated - pipelineStateStatisticsBefore.numCreated,
+        .numReused = pipelineStateStatistics.numReused - pipelineStateStatisticsBefore.numReused
+    };
+    out.m_compiledPlan = std::move(compiledPlan);
+    out.m_compileTimeInMs = stopwatch.timeSinceStart().count();
+    spdlog::info("Compiled frame graph in {:.2f}ms ({} pipeline states created, {} reused)",
+        out.m_compileTimeInMs, out.m_pipelineStateStatistics.numCreated, out.m_pipelineStateStatistics.numReused);
     return out;
 }
 
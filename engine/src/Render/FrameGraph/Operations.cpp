@@ -14,33 +14,12 @@ namespace Render {
 
 void ClearFrameBuffer::execute(const FrameGraphRegistry<ClearFrameBuffer>& registry, const FrameGraphExecuteArgs& args)
 {
-    const auto& resource = registry.getInternalResource<"buffer">();
-    auto& renderContext = *args.pRenderContext;
-
-    const auto rtvDescriptor = renderContext.rtvDescriptorAllocator.allocate(1);
-    D3D12_RENDER_TARGET_VIEW_DESC rtvDesc {
-        .Format = resource.desc.Format,
-        .ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D
-    };
-    rtvDesc.Texture2D.MipSlice = rtvDesc.Texture2D.PlaneSlice = 0;
-    renderContext.pDevice->CreateRenderTargetView(resource.pResource.Get(), &rtvDesc, rtvDescriptor);
-    args.pCommandList->ClearRenderTargetView(rtvDescriptor, glm::value_ptr(settings.clearColor), 0, nullptr);
+    args.pCommandList->ClearRenderTargetView(registry.getRenderTargetView<"buffer">(), glm::value_ptr(settings.clearColor), 0, nullptr);
 }
 
 void ClearDepthBuffer::execute(const FrameGraphRegistry<ClearDepthBuffer>& registry, const FrameGraphExecuteArgs& args)
 {
-    const auto& resource = registry.getInternalResource<"buffer">();
-    auto& renderContext = *args.pRenderContext;
-
-    const auto dsvDescriptor = renderContext.dsvDescriptorAllocator.allocate(1);
-    const D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc {
-        .Format = resource.dsvFormat,
-        .ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D,
-        .Flags = D3D12_DSV_FLAG_NONE,
-        .Texture2D = D3D12_TEX2D_DSV {}
-    };
-    renderContext.pDevice->CreateDepthStencilView(resource.pResource.Get(), &dsvDesc, dsvDescriptor);
-    args.pCommandList->ClearDepthStencilView(dsvDescriptor, D3D12_CLEAR_FLAG_DEPTH, settings.depthValue, 0, 0, nullptr);
+    args.pCommandList->ClearDepthStencilView(registry.getDepthStencilView<"buffer">(), D3D12_CLEAR_FLAG_DEPTH, settings.depthValue, 0, 0, nullptr);
 }
 
 void CopyTexture::execute(const FrameGraphRegistry<CopyTexture>& registry, const FrameGraphExecuteArgs& args)
@@ -69,8 +48,7 @@ void ShaderCopyTexture::initialize(const RenderContext& renderContext, D3D12_GRA
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"Shader Copy Texture");
 }
 
@@ -98,8 +76,7 @@ void CopyTextureChannels::initialize(const RenderContext& renderContext, D3D12_G
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"Shader Copy Texture");
 }
 
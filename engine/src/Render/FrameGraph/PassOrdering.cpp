@@ -0,0 +1,175 @@
+#include "Engine/Render/FrameGraph/PassOrdering.h"
+#include <algorithm>
+#include <tbx/error_handling.h>
+
+namespace Render::FrameGraphInternal {
+
+static constexpr uint32_t noPass = (uint32_t)-1;
+
+// Resource states in which a render pass (may) write to the resource.
+static constexpr D3D12_RESOURCE_STATES writeStates = D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_DEPTH_WRITE
+    | D3D12_RESOURCE_STATE_STREAM_OUT | D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_RESOLVE_DEST | D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
+
+bool isWriteState(D3D12_RESOURCE_STATES state)
+{
+    return (state & writeStates) != 0;
+}
+
+static bool isWrite(const FGResourceAccess& resourceAccess)
+{
+    return isWriteState(resourceAccess.desiredState);
+}
+
+FGPassOrder orderRenderPasses(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses)
+{
+    const uint32_t numPasses = (uint32_t)renderPasses.size();
+    const auto accessesOf = [&](uint32_t passIdx) {
+        const auto& renderPass = renderPasses[passIdx];
+        return resourceAccesses.subspan(renderPass.resourceAccessBegin, renderPass.resourceAccessEnd - renderPass.resourceAccessBegin);
+    };
+
+    // Visit the render passes back to front; a render pass is required if it writes to a resource that is accessed by a
+    // required render pass after it.
+    std::vector<bool> requiredPasses(numPasses, false), requiredResources(resources.size(), false);
+    for (uint32_t passIdx = numPasses; passIdx-- > 0;) {
+        const auto accesses = accessesOf(passIdx);
+        bool required = std::none_of(std::begin(accesses), std::end(accesses), isWrite);
+        for (const auto& resourceAccess : accesses) {
+            Tbx::assert_always(resourceAccess.resourceIdx < resources.size());
+            if (isWrite(resourceAccess) && (resources[resourceAccess.resourceIdx].resourceType != FGResourceType::Transient || requiredResources[resourceAccess.resourceIdx]))
+                required = true;
+        }
+        if (!required)
+            continue;
+        requiredPasses[passIdx] = true;
+        for (const auto& resourceAccess : accesses)
+            requiredResources[resourceAccess.resourceIdx] = true;
+    }
+
+    // Build the dependency graph of the required render passes.
+    std::vector<std::vector<uint32_t>> dependencies(numPasses);
+    std::vector<uint32_t> lastWriter(resources.size(), noPass);
+    std::vector<std::vector<uint32_t>> readersSinceWrite(resources.size());
+    uint32_t lastPassWithoutResources = noPass;
+    std::vector<uint32_t> passesSincePassWithoutResources;
+    std::vector<uint32_t> originalOrder;
+    for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+        if (!requiredPasses[passIdx])
+            continue;
+        originalOrder.push_back(passIdx);
+
+        auto& passDependencies = dependencies[passIdx];
+        const auto accesses = accessesOf(passIdx);
+        if (accesses.empty()) {
+            passDependencies = std::move(passesSincePassWithoutResources);
+            passesSincePassWithoutResources.clear();
+            if (lastPassWithoutResources != noPass)
+                passDependencies.push_back(lastPassWithoutResources);
+            lastPassWithoutResources = passIdx;
+            continue;
+        }
+        if (lastPassWithoutResources != noPass)
+            passDependencies.push_back(lastPassWithoutResources);
+        passesSincePassWithoutResources.push_back(passIdx);
+
+        for (const auto& resourceAccess : accesses) {
+            if (lastWriter[resourceAccess.resourceIdx] != noPass)
+                passDependencies.push_back(lastWriter[resourceAccess.resourceIdx]);
+            if (isWrite(resourceAccess)) {
+                const auto& readers = readersSinceWrite[resourceAccess.resourceIdx];
+                passDependencies.insert(std::end(passDependencies), std::begin(readers), std::end(readers));
+            }
+        }
+        // Update the state after visiting all accesses; a render pass may access the same resource multiple times.
+        for (const auto& resourceAccess : accesses) {
+            if (isWrite(resourceAccess)) {
+                lastWriter[resourceAccess.resourceIdx] = passIdx;
+                readersSinceWrite[resourceAccess.resourceIdx].clear();
+            }
+        }
+        for (const auto& resourceAccess : accesses) {
+            auto& readers = readersSinceWrite[resourceAccess.resourceIdx];
+            if (!isWrite(resourceAccess) && lastWriter[resourceAccess.resourceIdx] != passIdx && (readers.empty() || readers.back() != passIdx))
+                readers.push_back(passIdx);
+        }
+        std::erase(passDependencies, passIdx);
+        std::sort(std::begin(passDependencies), std::end(passDependencies));
+        passDependencies.erase(std::unique(std::begin(passDependencies), std::end(passDependencies)), std::end(passDependencies));
+    }
+
+    std::vector<std::vector<uint32_t>> dependents(numPasses);
+    std::vector<uint32_t> numUnresolvedDependencies(numPasses, 0);
+    for (const uint32_t passIdx : originalOrder) {
+        numUnresolvedDependencies[passIdx] = (uint32_t)dependencies[passIdx].size();
+        for (const uint32_t dependency : dependencies[passIdx])
+            dependents[dependency].push_back(passIdx);
+    }
+
+    // The transient resources that each render pass uses (each resource once), and the number of render passes that use them.
+    std::vector<std::vector<uint32_t>> transientResources(numPasses);
+    std::vector<uint32_t> numRemainingUsers(resources.size(), 0);
+    for (const uint32_t passIdx : originalOrder) {
+        auto& passTransientResources = transientResources[passIdx];
+        for (const auto& resourceAccess : accessesOf(passIdx)) {
+            if (resources[resourceAccess.resourceIdx].resourceType == FGResourceType::Transient)
+                passTransientResources.push_back(resourceAccess.resourceIdx);
+        }
+        std::sort(std::begin(passTransientResources), std::end(passTransientResources));
+        passTransientResources.erase(std::unique(std::begin(passTransientResources), std::end(passTransientResources)), std::end(passTransientResources));
+        for (const uint32_t resourceIdx : passTransientResources)
+            ++numRemainingUsers[resourceIdx];
+    }
+
+    // Topological sort; a render pass that starts a transient resource lifetime increases the amount of memory that is in use
+    // while one that ends a lifetime decreases it.
+    FGPassOrder out {};
+    out.statistics.numCulledPasses = numPasses - (uint32_t)originalOrder.size();
+    std::vector<bool> startedResources(resources.size(), false);
+    std::vector<uint32_t> readyPasses;
+    for (const uint32_t passIdx : originalOrder) {
+        if (numUnresolvedDependencies[passIdx] == 0)
+            readyPasses.push_back(passIdx);
+    }
+    const auto memoryDelta = [&](uint32_t passIdx) {
+        int delta = 0;
+        for (const uint32_t resourceIdx : transientResources[passIdx]) {
+            if (!startedResources[resourceIdx])
+                ++delta;
+            if (numRemainingUsers[resourceIdx] == 1)
+                --delta;
+        }
+        return delta;
+    };
+    while (!readyPasses.empty()) {
+        auto bestIter = std::begin(readyPasses);
+        int bestDelta = memoryDelta(*bestIter);
+        for (auto iter = std::next(bestIter); iter != std::end(readyPasses); ++iter) {
+            const int delta = memoryDelta(*iter);
+            if (delta < bestDelta || (delta == bestDelta && *iter < *bestIter)) {
+                bestIter = iter;
+                bestDelta = delta;
+            }
+        }
+        const uint32_t passIdx = *bestIter;
+        readyPasses.erase(bestIter);
+
+        out.order.push_back(passIdx);
+        for (const uint32_t resourceIdx : transientResources[passIdx]) {
+            startedResources[resourceIdx] = true;
+            --numRemainingUsers[resourceIdx];
+        }
+        for (const uint32_t dependent : dependents[passIdx]) {
+            if (--numUnresolvedDependencies[dependent] == 0)
+                readyPasses.push_back(dependent);
+        }
+    }
+    Tbx::assert_always(out.order.size() == originalOrder.size());
+
+    for (size_t i = 0; i < out.order.size(); ++i) {
+        if (out.order[i] != originalOrder[i])
+            ++out.statistics.numMovedPasses;
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,229 @@
+#include "Engine/Render/FrameGraph/QueueScheduling.h"
+#include <algorithm>
+#include <array>
+#include <tbx/error_handling.h>
+#include <utility>
+
+namespace Render::FrameGraphInternal {
+
+static constexpr uint32_t noPass = (uint32_t)-1;
+static constexpr uint32_t noSegment = (uint32_t)-1;
+
+// Resource states that are only supported by the graphics queue.
+static constexpr D3D12_RESOURCE_STATES graphicsOnlyStates = D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE | D3D12_RESOURCE_STATE_DEPTH_READ
+    | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_INDEX_BUFFER | D3D12_RESOURCE_STATE_STREAM_OUT | D3D12_RESOURCE_STATE_RESOLVE_DEST
+    | D3D12_RESOURCE_STATE_RESOLVE_SOURCE | D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE;
+
+FGQueueSchedule scheduleQueues(std::span<const FGResource> resources, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses)
+{
+    constexpr size_t numQueues = FGQueueSchedule::numQueues;
+    constexpr size_t graphicsQueue = (size_t)RenderPassQueue::Graphics;
+    using QueuePasses = std::array<uint32_t, numQueues>; // Per queue: 1 + index of a render pass on that queue (0 if none).
+    const uint32_t numPasses = (uint32_t)renderPasses.size();
+    const auto queueOf = [&](uint32_t passIdx) { return (size_t)renderPasses[passIdx].queue; };
+
+    // The latest render pass of each other queue that a render pass depends on; dependencies on the same queue are
+    // satisfied by the execution order of the queue.
+    FGQueueSchedule out {};
+    std::vector<QueuePasses> dependencies(numPasses, QueuePasses {});
+    QueuePasses lastPassOfQueue {};
+    std::vector<uint32_t> previousUser(resources.size(), noPass);
+    for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+        const auto& renderPass = renderPasses[passIdx];
+        if (renderPass.queue == RenderPassQueue::AsyncCompute)
+            ++out.statistics.numAsyncComputePasses;
+        lastPassOfQueue[queueOf(passIdx)] = passIdx + 1;
+
+        for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+            const auto& resourceAccess = resourceAccesses[resourceAccessIdx];
+            Tbx::assert_always(resourceAccess.resourceIdx < resources.size());
+            Tbx::assert_always(renderPass.queue == RenderPassQueue::Graphics || (resourceAccess.desiredState & graphicsOnlyStates) == 0);
+
+            const uint32_t previousPassIdx = std::exchange(previousUser[resourceAccess.resourceIdx], passIdx);
+            if (previousPassIdx == noPass || previousPassIdx == passIdx || queueOf(previousPassIdx) == queueOf(passIdx))
+                continue;
+            auto& dependency = dependencies[passIdx][queueOf(previousPassIdx)];
+            dependency = std::max(dependency, previousPassIdx + 1);
+            ++out.statistics.numCrossQueueDependencies;
+        }
+    }
+
+    // Visit the render passes in order and track which render passes of the other queues are known to have completed when a
+    // render pass starts. A queue only waits for a dependency that is not implied by an earlier wait. Waiting for a render
+    // pass implies waiting for everything that had completed before that render pass started.
+    std::vector<QueuePasses> completedPasses(numPasses), waits(numPasses, QueuePasses {});
+    std::array<QueuePasses, numQueues> queueCompletedPasses {};
+    std::vector<bool> signalAfterPass(numPasses, false);
+    const auto wait = [&](size_t queue, size_t otherQueue, uint32_t otherPassIdx) {
+        signalAfterPass[otherPassIdx] = true;
+        ++out.statistics.numWaits;
+        auto& completed = queueCompletedPasses[queue];
+        for (size_t queue2 = 0; queue2 < numQueues; ++queue2)
+            completed[queue2] = std::max(completed[queue2], completedPasses[otherPassIdx][queue2]);
+        completed[otherQueue] = otherPassIdx + 1;
+    };
+    for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+        const size_t queue = queueOf(passIdx);
+        for (size_t otherQueue = 0; otherQueue < numQueues; ++otherQueue) {
+            if (dependencies[passIdx][otherQueue] > queueCompletedPasses[queue][otherQueue]) {
+                waits[passIdx][otherQueue] = dependencies[passIdx][otherQueue];
+                wait(queue, otherQueue, dependencies[passIdx][otherQueue] - 1);
+            }
+        }
+        completedPasses[passIdx] = queueCompletedPasses[queue];
+    }
+    // The frame ends on the graphics queue after all other queues have completed.
+    QueuePasses endOfFrameWaits {};
+    for (size_t otherQueue = 0; otherQueue < numQueues; ++otherQueue) {
+        if (otherQueue != graphicsQueue && lastPassOfQueue[otherQueue] > queueCompletedPasses[graphicsQueue][otherQueue]) {
+            endOfFrameWaits[otherQueue] = lastPassOfQueue[otherQueue];
+            wait(graphicsQueue, otherQueue, lastPassOfQueue[otherQueue] - 1);
+        }
+    }
+
+    // A render pass may overlap with the render passes of other queues that are not known to start after it completed.
+    out.lastConcurrentPass.resize(numPasses);
+    for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+        uint32_t lastConcurrentPass = passIdx;
+        for (uint32_t otherPassIdx = passIdx + 1; otherPassIdx < numPasses; ++otherPassIdx) {
+            if (queueOf(otherPassIdx) != queueOf(passIdx) && completedPasses[otherPassIdx][queueOf(passIdx)] <= passIdx)
+                lastConcurrentPass = otherPassIdx;
+        }
+        out.lastConcurrentPass[passIdx] = lastConcurrentPass;
+    }
+
+    // A segment starts at a render pass that waits for another queue and ends at a render pass that another queue waits for.
+    // Segments are created in the order of their first render pass, which is a valid submission order because render
+    // passes only wait for render passes that come before them.
+    std::vector<std::vector<uint32_t>> segmentOperations;
+    std::vector<uint32_t> passSegments(numPasses);
+    const auto addSegment = [&](RenderPassQueue queue, const QueuePasses& segmentWaits) {
+        const auto segmentIdx = (uint32_t)out.segments.size();
+        auto& segment = out.segments.emplace_back(FGQueueSegment { .queue = queue });
+        for (size_t otherQueue = 0; otherQueue < numQueues; ++otherQueue) {
+            if (segmentWaits[otherQueue] == 0)
+                continue;
+            const uint32_t waitSegmentIdx = passSegments[segmentWaits[otherQueue] - 1];
+            segment.waitSegments.push_back(waitSegmentIdx);
+            out.segments[waitSegmentIdx].signal = true;
+        }
+        segmentOperations.emplace_back();
+        return segmentIdx;
+    };
+    const bool hasAsyncCompute = out.statistics.numAsyncComputePasses > 0;
+    const uint32_t frameStartSegmentIdx = hasAsyncCompute ? addSegment(RenderPassQueue::Graphics, {}) : noSegment;
+    std::array<uint32_t, numQueues> openSegments;
+    std::fill(std::begin(openSegments), std::end(openSegments), noSegment);
+    std::array<bool, numQueues> queueStarted {};
+    for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+        const size_t queue = queueOf(passIdx);
+        const bool hasWaits = std::any_of(std::begin(waits[passIdx]), std::end(waits[passIdx]), [](uint32_t waitPass) { return waitPass != 0; });
+        if (openSegments[queue] == noSegment || hasWaits) {
+            openSegments[queue] = addSegment(renderPasses[passIdx].queue, waits[passIdx]);
+            if (queue != graphicsQueue && !queueStarted[queue]) {
+                out.segments[openSegments[queue]].waitSegments.push_back(frameStartSegmentIdx);
+                out.segments[frameStartSegmentIdx].signal = true;
+                ++out.statistics.numWaits;
+            }
+            queueStarted[queue] = true;
+        }
+        passSegments[passIdx] = openSegments[queue];
+        segmentOperations[openSegments[queue]].push_back(passIdx);
+        if (signalAfterPass[passIdx])
+            openSegments[queue] = noSegment;
+    }
+    if (std::any_of(std::begin(endOfFrameWaits), std::end(endOfFrameWaits), [](uint32_t waitPass) { return waitPass != 0; }) || out.segments.empty())
+        addSegment(RenderPassQueue::Graphics, endOfFrameWaits);
+    Tbx::assert_always(out.segments.back().queue == RenderPassQueue::Graphics);
+    // Resources (such as the descriptors of shader bind points) are released after the next graphics fence, which relies on
+    // the graphics queue waiting for the last async compute segment of the frame.
+    for (size_t otherQueue = 0; otherQueue < numQueues; ++otherQueue) {
+        if (otherQueue == graphicsQueue || lastPassOfQueue[otherQueue] == 0)
+            continue;
+        const uint32_t lastSegmentIdx = passSegments[lastPassOfQueue[otherQueue] - 1];
+        Tbx::assert_always(std::any_of(std::begin(out.segments) + lastSegmentIdx + 1, std::end(out.segments), [&](const FGQueueSegment& segment) {
+            return segment.queue == RenderPassQueue::Graphics && std::find(std::begin(segment.waitSegments), std::end(segment.waitSegments), lastSegmentIdx) != std::end(segment.waitSegments);
+        }));
+    }
+
+    for (size_t segmentIdx = 0; segmentIdx < out.segments.size(); ++segmentIdx) {
+        auto& segment = out.segments[segmentIdx];
+        std::sort(std::begin(segment.waitSegments), std::end(segment.waitSegments));
+        segment.operationBegin = out.operationOrder.size();
+        out.operationOrder.insert(std::end(out.operationOrder), std::begin(segmentOperations[segmentIdx]), std::end(segmentOperations[segmentIdx]));
+        segment.operationEnd = out.operationOrder.size();
+    }
+    return out;
+}
+
+FGBarrierPlan legalizeQueueBarriers(const FGBarrierPlan& barrierPlan, FGQueueSchedule& queueSchedule, std::span<const FGResourceAccess> resourceAccesses, std::span<const FGRenderPass> renderPasses)
+{
+    std::vector<uint32_t> passSegments(renderPasses.size());
+    for (uint32_t segmentIdx = 0; segmentIdx < queueSchedule.segments.size(); ++segmentIdx) {
+        const auto& segment = queueSchedule.segments[segmentIdx];
+        for (size_t i = segment.operationBegin; i < segment.operationEnd; ++i)
+            passSegments[queueSchedule.operationOrder[i]] = segmentIdx;
+    }
+
+    FGBarrierPlan out {};
+    out.initialStates = barrierPlan.initialStates;
+    out.statistics = barrierPlan.statistics;
+    out.statistics.numBatches = 0;
+    out.batchStarts.push_back(0);
+    // The previous user of each resource; a resource that was not used yet this frame was last used by the previous frame.
+    std::vector<uint32_t> previousUser(barrierPlan.initialStates.size(), noPass);
+    std::vector<bool> unsplitTransitions(barrierPlan.initialStates.size(), false);
+    for (size_t batchIdx = 0; batchIdx < barrierPlan.numBatches(); ++batchIdx) {
+        const bool isAsyncCompute = batchIdx < renderPasses.size() && renderPasses[batchIdx].queue == RenderPassQueue::AsyncCompute;
+        for (auto barrier : barrierPlan.batch(batchIdx)) {
+            if (barrier.barrierType != FGBarrierType::Transition) {
+                out.barriers.push_back(barrier);
+                continue;
+            }
+            if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY && unsplitTransitions[barrier.resourceIdx]) {
+                barrier.flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                unsplitTransitions[barrier.resourceIdx] = false;
+                --out.statistics.numSplitTransitions;
+                ++out.statistics.numTransitions;
+            }
+            if (!isAsyncCompute || ((barrier.stateBefore | barrier.stateAfter) & graphicsOnlyStates) == 0) {
+                out.barriers.push_back(barrier);
+                continue;
+            }
+
+            // Split transitions only remain within a command list; both halves are recorded by the async compute queue.
+            if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+                unsplitTransitions[barrier.resourceIdx] = true;
+                continue;
+            }
+            Tbx::assert_always(barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_NONE);
+            // Async compute passes never use graphics states themselves, so the previous user is a graphics pass. If the wait
+            // for the segment of the previous user was implied by a later wait then the transition is recorded by the first
+            // graphics segment that signals; the async compute pass (transitively) waits for that segment.
+            const uint32_t previousPassIdx = previousUser[barrier.resourceIdx];
+            uint32_t segmentIdx = previousPassIdx == noPass ? 0 : passSegments[previousPassIdx];
+            while (segmentIdx < queueSchedule.segments.size() && !(queueSchedule.segments[segmentIdx].queue == RenderPassQueue::Graphics && queueSchedule.segments[segmentIdx].signal))
+                ++segmentIdx;
+            Tbx::assert_always(segmentIdx < passSegments[batchIdx]);
+            auto& segment = queueSchedule.segments[segmentIdx];
+            segment.signalBarriers.push_back(barrier);
+            ++queueSchedule.statistics.numMovedTransitions;
+        }
+        if (out.barriers.size() != out.batchStarts.back())
+            ++out.statistics.numBatches;
+        out.batchStarts.push_back(out.barriers.size());
+
+        if (batchIdx < renderPasses.size()) {
+            const auto& renderPass = renderPasses[batchIdx];
+            for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx)
+                previousUser[resourceAccesses[resourceAccessIdx].resourceIdx] = (uint32_t)batchIdx;
+        }
+    }
+    for (const auto& segment : queueSchedule.segments) {
+        if (!segment.signalBarriers.empty())
+            ++out.statistics.numBatches;
+    }
+    return out;
+}
+
+}
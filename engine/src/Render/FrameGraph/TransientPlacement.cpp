@@ -0,0 +1,163 @@
+#include "Engine/Render/FrameGraph/TransientPlacement.h"
+#include "Engine/Util/Align.h"
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <tbx/error_handling.h>
+
+namespace Render::FrameGraphInternal {
+
+size_t FGTransientPlacement::totalSizeInBytes() const
+{
+    return std::accumulate(std::begin(heapSizes), std::end(heapSizes), size_t(0));
+}
+
+namespace {
+    struct Range {
+        size_t offset, sizeInBytes;
+    };
+}
+
+// Finds an offset at which a resource fits in between the given ranges (sorted by offset). Returns the first gap that fits,
+// or the smallest one when bestFit is set; the resource is placed after all ranges if no gap is large enough.
+static size_t findOffset(std::span<const Range> sortedRanges, size_t sizeInBytes, size_t alignment, bool bestFit)
+{
+    std::optional<size_t> optBestOffset;
+    size_t bestGapSize = 0, cursor = 0;
+    for (const auto& range : sortedRanges) {
+        const size_t offset = Util::roundUpToClosestMultiple(cursor, alignment);
+        if (offset + sizeInBytes <= range.offset) {
+            const size_t gapSize = range.offset - cursor;
+            if (!bestFit)
+                return offset;
+            if (!optBestOffset || gapSize < bestGapSize) {
+                optBestOffset = offset;
+                bestGapSize = gapSize;
+            }
+        }
+        cursor = std::max(cursor, range.offset + range.sizeInBytes);
+    }
+    return optBestOffset.value_or(Util::roundUpToClosestMultiple(cursor, alignment));
+}
+
+static void insertSorted(std::vector<Range>& sortedRanges, const Range& range)
+{
+    const auto iter = std::upper_bound(std::begin(sortedRanges), std::end(sortedRanges), range, [](const Range& lhs, const Range& rhs) { return lhs.offset < rhs.offset; });
+    sortedRanges.insert(iter, range);
+}
+
+// Both placements return the offsets of the given resources (which all belong to the same heap) and the size of the heap.
+static size_t placeGreedy(std::span<const FGTransientResource> resources, std::span<const uint32_t> resourceIndices, std::span<size_t> offsets)
+{
+    // Allocate the resources in the order in which they are first used, and free them after their last use.
+    std::vector<uint32_t> allocationOrder { std::begin(resourceIndices), std::end(resourceIndices) };
+    std::stable_sort(std::begin(allocationOrder), std::end(allocationOrder),
+        [&](uint32_t lhs, uint32_t rhs) { return resources[lhs].firstPassIdx < resources[rhs].firstPassIdx; });
+
+    struct LiveRange {
+        Range range;
+        uint32_t resourceIdx;
+    };
+    std::vector<LiveRange> liveRanges;
+    std::vector<Range> sortedRanges;
+    size_t heapSize = 0;
+    for (size_t i = 0; i < allocationOrder.size();) {
+        const uint32_t passIdx = resources[allocationOrder[i]].firstPassIdx;
+        std::erase_if(liveRanges, [&](const LiveRange& liveRange) { return resources[liveRange.resourceIdx].lastPassIdx < passIdx; });
+        for (; i < allocationOrder.size() && resources[allocationOrder[i]].firstPassIdx == passIdx; ++i) {
+            const uint32_t resourceIdx = allocationOrder[i];
+            const auto& resource = resources[resourceIdx];
+            sortedRanges.clear();
+            for (const auto& liveRange : liveRanges)
+                insertSorted(sortedRanges, liveRange.range);
+            offsets[resourceIdx] = findOffset(sortedRanges, resource.sizeInBytes, resource.alignment, false);
+            liveRanges.push_back({ .range = { offsets[resourceIdx], resource.sizeInBytes }, .resourceIdx = resourceIdx });
+            heapSize = std::max(heapSize, offsets[resourceIdx] + resource.sizeInBytes);
+        }
+    }
+    return heapSize;
+}
+
+static size_t placeBestFitDecreasingSize(std::span<const FGTransientResource> resources, std::span<const uint32_t> resourceIndices, std::span<size_t> offsets)
+{
+    // Largest resources first; ties are placed in execution order.
+    std::vector<uint32_t> placementOrder { std::begin(resourceIndices), std::end(resourceIndices) };
+    std::stable_sort(std::begin(placementOrder), std::end(placementOrder),
+        [&](uint32_t lhs, uint32_t rhs) {
+            if (resources[lhs].sizeInBytes != resources[rhs].sizeInBytes)
+                return resources[lhs].sizeInBytes > resources[rhs].sizeInBytes;
+            return resources[lhs].firstPassIdx < resources[rhs].firstPassIdx;
+        });
+
+    std::vector<uint32_t> placedResources;
+    std::vector<Range> sortedRanges;
+    size_t heapSize = 0;
+    for (const uint32_t resourceIdx : placementOrder) {
+        const auto& resource = resources[resourceIdx];
+        sortedRanges.clear();
+        for (const uint32_t otherResourceIdx : placedResources) {
+            const auto& otherResource = resources[otherResourceIdx];
+            if (otherResource.firstPassIdx <= resource.lastPassIdx && resource.firstPassIdx <= otherResource.lastPassIdx)
+                insertSorted(sortedRanges, { offsets[otherResourceIdx], otherResource.sizeInBytes });
+        }
+        offsets[resourceIdx] = findOffset(sortedRanges, resource.sizeInBytes, resource.alignment, true);
+        placedResources.push_back(resourceIdx);
+        heapSize = std::max(heapSize, offsets[resourceIdx] + resource.sizeInBytes);
+    }
+    return heapSize;
+}
+
+FGTransientPlacement placeTransientResources(std::span<const FGTransientResource> resources, size_t numHeaps, FGPlacementStrategy strategy)
+{
+    FGTransientPlacement out {};
+    out.offsets.resize(resources.size(), 0);
+    out.heapSizes.resize(numHeaps, 0);
+
+    std::vector<size_t> greedyOffsets(resources.size(), 0);
+    for (uint32_t heapIdx = 0; heapIdx < numHeaps; ++heapIdx) {
+        std::vector<uint32_t> resourceIndices;
+        for (uint32_t resourceIdx = 0; resourceIdx < resources.size(); ++resourceIdx) {
+            const auto& resource = resources[resourceIdx];
+            Tbx::assert_always(resource.heapIdx < numHeaps && resource.firstPassIdx <= resource.lastPassIdx && resource.alignment > 0);
+            if (resource.heapIdx == heapIdx)
+                resourceIndices.push_back(resourceIdx);
+        }
+
+        const size_t greedyHeapSize = placeGreedy(resources, resourceIndices, greedyOffsets);
+        if (strategy == FGPlacementStrategy::BestFitDecreasingSize) {
+            const size_t heapSize = placeBestFitDecreasingSize(resources, resourceIndices, out.offsets);
+            if (heapSize <= greedyHeapSize) {
+                out.heapSizes[heapIdx] = heapSize;
+                continue;
+            }
+        }
+        for (const uint32_t resourceIdx : resourceIndices)
+            out.offsets[resourceIdx] = greedyOffsets[resourceIdx];
+        out.heapSizes[heapIdx] = greedyHeapSize;
+    }
+    return out;
+}
+
+std::vector<size_t> computeTransientMemoryLowerBound(std::span<const FGTransientResource> resources, size_t numHeaps)
+{
+    uint32_t numPasses = 0;
+    for (const auto& resource : resources)
+        numPasses = std::max(numPasses, resource.lastPassIdx + 1);
+
+    std::vector<size_t> out(numHeaps, 0);
+    std::vector<size_t> memoryPerPass(numPasses);
+    for (uint32_t heapIdx = 0; heapIdx < numHeaps; ++heapIdx) {
+        std::fill(std::begin(memoryPerPass), std::end(memoryPerPass), 0);
+        for (const auto& resource : resources) {
+            if (resource.heapIdx != heapIdx)
+                continue;
+            for (uint32_t passIdx = resource.firstPassIdx; passIdx <= resource.lastPassIdx; ++passIdx)
+                memoryPerPass[passIdx] += resource.sizeInBytes;
+        }
+        if (numPasses > 0)
+            out[heapIdx] = *std::max_element(std::begin(memoryPerPass), std::end(memoryPerPass));
+    }
+    return out;
+}
+
+}
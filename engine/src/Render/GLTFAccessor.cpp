@@ -0,0 +1,268 @@
+#include "Engine/Render/GLTFAccessor.h"
+#include <tbx/error_handling.h>
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#if defined(_M_X64) || defined(__SSE4_1__)
+#include <smmintrin.h>
+#define GLTF_ACCESSOR_SSE 1
+#endif
+
+namespace Render {
+
+// Elements are decoded in chunks of this size; accessors with more than one chunk are decoded in parallel.
+static constexpr size_t chunkSize = 64 * 1024;
+
+template <typename F>
+static void parallelForChunks(size_t count, F&& f)
+{
+    if (count <= chunkSize) {
+        f(size_t(0), count);
+        return;
+    }
+
+    std::vector<size_t> chunkStarts((count + chunkSize - 1) / chunkSize);
+    std::generate(std::begin(chunkStarts), std::end(chunkStarts), [i = size_t(0)]() mutable { return (i++) * chunkSize; });
+    std::for_each(std::execution::par, std::begin(chunkStarts), std::end(chunkStarts),
+        [&](size_t start) { f(start, std::min(start + chunkSize, count)); });
+}
+
+template <typename T>
+static T loadUnaligned(const std::byte* pData)
+{
+    T out;
+    std::memcpy(&out, pData, sizeof(T));
+    return out;
+}
+
+// Scale which maps an integer component to [0, 1] or [-1, 1] when normalized (GLTF 2.0 specification, section 3.11).
+template <typename T>
+static constexpr float normalizationScale(bool normalized)
+{
+    return normalized ? 1.0f / float(std::numeric_limits<T>::max()) : 1.0f;
+}
+
+template <typename T>
+static float convertComponent(T value, float scale, bool normalized)
+{
+    const float out = float(value) * scale;
+    if constexpr (std::is_signed_v<T>)
+        return normalized ? std::max(out, -1.0f) : out;
+    else
+        return out;
+}
+
+// Convert numComponents tightly packed integer components to float.
+template <typename T>
+static void convertPacked(const std::byte* pIn, float* pOut, size_t numComponents, bool normalized)
+{
+    const float scale = normalizationScale<T>(normalized);
+    size_t i = 0;
+#ifdef GLTF_ACCESSOR_SSE
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 min4 = _mm_set1_ps(normalized ? -1.0f : std::numeric_limits<float>::lowest());
+    for (; i + 4 <= numComponents; i += 4) {
+        __m128i values;
+        if constexpr (sizeof(T) == 1)
+            values = _mm_cvtsi32_si128(loadUnaligned<int32_t>(&pIn[i]));
+        else
+            values = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&pIn[i * sizeof(T)]));
+
+        if constexpr (std::is_same_v<T, uint8_t>)
+            values = _mm_cvtepu8_epi32(values);
+        else if constexpr (std::is_same_v<T, int8_t>)
+            values = _mm_cvtepi8_epi32(values);
+        else if constexpr (std::is_same_v<T, uint16_t>)
+            values = _mm_cvtepu16_epi32(values);
+        else
+            values = _mm_cvtepi16_epi32(values);
+
+        __m128 result = _mm_mul_ps(_mm_cvtepi32_ps(values), scale4);
+        if constexpr (std::is_signed_v<T>)
+            result = _mm_max_ps(result, min4);
+        _mm_storeu_ps(&pOut[i], result);
+    }
+#endif
+    for (; i < numComponents; ++i)
+        pOut[i] = convertComponent(loadUnaligned<T>(&pIn[i * sizeof(T)]), scale, normalized);
+}
+
+// Convert interleaved (strided) elements of NumComponents components each to float.
+template <typename T, uint32_t NumComponents>
+static void convertStrided(const std::byte* pIn, size_t stride, float* pOut, size_t count, bool normalized)
+{
+    const float scale = normalizationScale<T>(normalized);
+    for (size_t i = 0; i < count; ++i, pIn += stride, pOut += NumComponents) {
+        if constexpr (std::is_same_v<T, float>) {
+            std::memcpy(pOut, pIn, NumComponents * sizeof(float));
+        } else {
+            for (uint32_t c = 0; c < NumComponents; ++c)
+                pOut[c] = convertComponent(loadUnaligned<T>(&pIn[c * sizeof(T)]), scale, normalized);
+        }
+    }
+}
+
+template <typename T>
+static void decodeFloat(const GLTFAccessor& accessor, std::span<float> out)
+{
+    const size_t stride = accessor.stride();
+    const uint32_t numComponents = accessor.numComponents;
+    const bool tightlyPacked = (stride == accessor.elementSize());
+
+    parallelForChunks(accessor.count, [&](size_t start, size_t end) {
+        const std::byte* pIn = &accessor.data[start * stride];
+        float* pOut = &out[start * numComponents];
+        if (tightlyPacked) {
+            if constexpr (std::is_same_v<T, float>)
+                std::memcpy(pOut, pIn, (end - start) * numComponents * sizeof(float));
+            else
+                convertPacked<T>(pIn, pOut, (end - start) * numComponents, accessor.normalized);
+        } else {
+            switch (numComponents) {
+            case 1:
+                convertStrided<T, 1>(pIn, stride, pOut, end - start, accessor.normalized);
+                break;
+            case 2:
+                convertStrided<T, 2>(pIn, stride, pOut, end - start, accessor.normalized);
+                break;
+            case 3:
+                convertStrided<T, 3>(pIn, stride, pOut, end - start, accessor.normalized);
+                break;
+            case 4:
+                convertStrided<T, 4>(pIn, stride, pOut, end - start, accessor.normalized);
+                break;
+            }
+        }
+    });
+}
+
+template <typename T>
+static void widenIndices(const std::byte* pIn, uint32_t* pOut, size_t count)
+{
+    size_t i = 0;
+#ifdef GLTF_ACCESSOR_SSE
+    if constexpr (sizeof(T) == 1) {
+        for (; i + 16 <= count; i += 16) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pIn[i]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 0]), _mm_cvtepu8_epi32(values));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 4]), _mm_cvtepu8_epi32(_mm_srli_si128(values, 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 8]), _mm_cvtepu8_epi32(_mm_srli_si128(values, 8)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 12]), _mm_cvtepu8_epi32(_mm_srli_si128(values, 12)));
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pIn[i * sizeof(T)]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 0]), _mm_cvtepu16_epi32(values));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&pOut[i + 4]), _mm_cvtepu16_epi32(_mm_srli_si128(values, 8)));
+        }
+    }
+#endif
+    for (; i < count; ++i)
+        pOut[i] = loadUnaligned<T>(&pIn[i * sizeof(T)]);
+}
+
+template <typename T>
+static void decodeIndices(const GLTFAccessor& accessor, std::span<uint32_t> out)
+{
+    const size_t stride = accessor.stride();
+    parallelForChunks(accessor.count, [&](size_t start, size_t end) {
+        const std::byte* pIn = &accessor.data[start * stride];
+        uint32_t* pOut = &out[start];
+        if (stride != sizeof(T)) {
+            for (size_t i = 0; i < end - start; ++i, pIn += stride)
+                pOut[i] = loadUnaligned<T>(pIn);
+        } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+            std::memcpy(pOut, pIn, (end - start) * sizeof(uint32_t));
+        } else {
+            widenIndices<T>(pIn, pOut, end - start);
+        }
+    });
+}
+
+size_t GLTFAccessor::componentSize() const
+{
+    switch (componentType) {
+    case GLTFComponentType::Byte:
+    case GLTFComponentType::UnsignedByte:
+        return 1;
+    case GLTFComponentType::Short:
+    case GLTFComponentType::UnsignedShort:
+        return 2;
+    case GLTFComponentType::UnsignedInt:
+    case GLTFComponentType::Float:
+        return 4;
+    default:
+        Tbx::assert_always(false);
+        return 0;
+    }
+}
+
+size_t GLTFAccessor::elementSize() const
+{
+    return componentSize() * numComponents;
+}
+
+size_t GLTFAccessor::stride() const
+{
+    return byteStride == 0 ? elementSize() : byteStride;
+}
+
+void decodeAccessor(const GLTFAccessor& accessor, std::span<float> out)
+{
+    Tbx::assert_always(accessor.numComponents >= 1 && accessor.numComponents <= 4);
+    Tbx::assert_always(out.size() >= accessor.count * accessor.numComponents);
+    if (accessor.count == 0)
+        return;
+    Tbx::assert_always(accessor.data.size() >= (accessor.count - 1) * accessor.stride() + accessor.elementSize());
+
+    switch (accessor.componentType) {
+    case GLTFComponentType::Byte:
+        decodeFloat<int8_t>(accessor, out);
+        break;
+    case GLTFComponentType::UnsignedByte:
+        decodeFloat<uint8_t>(accessor, out);
+        break;
+    case GLTFComponentType::Short:
+        decodeFloat<int16_t>(accessor, out);
+        break;
+    case GLTFComponentType::UnsignedShort:
+        decodeFloat<uint16_t>(accessor, out);
+        break;
+    case GLTFComponentType::Float:
+        decodeFloat<float>(accessor, out);
+        break;
+    default:
+        Tbx::assert_always(false);
+    }
+}
+
+void decodeAccessor(const GLTFAccessor& accessor, std::span<uint32_t> out)
+{
+    Tbx::assert_always(accessor.numComponents == 1);
+    Tbx::assert_always(out.size() >= accessor.count);
+    if (accessor.count == 0)
+        return;
+    Tbx::assert_always(accessor.data.size() >= (accessor.count - 1) * accessor.stride() + accessor.elementSize());
+
+    // Signed types are not allowed for indices by the GLTF specification but are accepted for backwards compatibility.
+    switch (accessor.componentType) {
+    case GLTFComponentType::Byte:
+    case GLTFComponentType::UnsignedByte:
+        decodeIndices<uint8_t>(accessor, out);
+        break;
+    case GLTFComponentType::Short:
+    case GLTFComponentType::UnsignedShort:
+        decodeIndices<uint16_t>(accessor, out);
+        break;
+    case GLTFComponentType::UnsignedInt:
+        decodeIndices<uint32_t>(accessor, out);
+        break;
+    default:
+        Tbx::assert_always(false);
+    }
+}
+
+}
@@ -15,6 +15,7 @@ DISABLE_WARNINGS_POP()
 #include <algorithm>
 #include <array>
 #include <numeric>
+#include <ranges>
 #include <string_view>
 
 namespace Render {
@@ -46,18 +47,30 @@ static const std::array s_colors {
     ImColor(55, 196, 84)
 };
 
-static double getSecondsPerTick(Render::RenderContext& renderContext)
+static double getSecondsPerTick(ID3D12CommandQueue* pCommandQueue)
 {
     uint64_t frequency;
-    RenderAPI::ThrowIfFailed(renderContext.pGraphicsQueue->GetTimestampFrequency(&frequency));
+    RenderAPI::ThrowIfFailed(pCommandQueue->GetTimestampFrequency(&frequency));
     return 1.0 / double(frequency);
 }
 
+// Same conversion as std::chrono::steady_clock (on Windows), without overflowing.
+static uint64_t performanceCounterToNanoseconds(uint64_t counter)
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    const uint64_t ticksPerSecond = frequency.QuadPart;
+    return (counter / ticksPerSecond) * 1'000'000'000 + (counter % ticksPerSecond) * 1'000'000'000 / ticksPerSecond;
+}
+
 GPUFrameProfiler::GPUFrameProfiler(Render::RenderContext& renderContext, uint32_t resolvedFrameStorage)
-    : m_parallelFrames(RenderAPI::SwapChain::s_parallelFrames)
+    : m_pCommandQueue(renderContext.pGraphicsQueue)
+    , m_pComputeQueue(renderContext.pComputeQueue)
+    , m_parallelFrames(RenderAPI::SwapChain::s_parallelFrames)
     , m_resolvedFrameStorage(resolvedFrameStorage)
     , m_cpuBuffer((size_t)queryHeapSize, 0)
-    , m_secondsPerTick(getSecondsPerTick(renderContext))
+    , m_secondsPerTick(getSecondsPerTick(renderContext.pGraphicsQueue.Get()))
+    , m_secondsPerTickCompute(getSecondsPerTick(renderContext.pComputeQueue.Get()))
 {
     D3D12_QUERY_HEAP_DESC heapDesc {};
     heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
@@ -82,18 +95,40 @@ void GPUFrameProfiler::startFrame(ID3D12GraphicsCommandList5* pCommandList)
             m_resolvedFrames.pop_back();
     }
 
-    m_inFlightFrames.push_front({ .startQueryIdx = addTimingQuery(pCommandList) });
+    // Every queue has its own GPU clock.
+    uint64_t calibrationTimestamp, calibrationCounter, computeCalibrationTimestamp, computeCalibrationCounter;
+    RenderAPI::ThrowIfFailed(m_pCommandQueue->GetClockCalibration(&calibrationTimestamp, &calibrationCounter));
+    RenderAPI::ThrowIfFailed(m_pComputeQueue->GetClockCalibration(&computeCalibrationTimestamp, &computeCalibrationCounter));
+    m_inFlightFrames.push_front({
+        .startQueryIdx = addTimingQuery(pCommandList),
+        .calibrationTimestamp = calibrationTimestamp,
+        .calibrationTime = performanceCounterToNanoseconds(calibrationCounter),
+        .computeCalibrationTimestamp = computeCalibrationTimestamp,
+        .computeCalibrationTime = performanceCounterToNanoseconds(computeCalibrationCounter),
+    });
 }
 
 uint32_t GPUFrameProfiler::startTask(ID3D12GraphicsCommandList5* pCommandList, std::string name)
+{
+    const uint32_t taskHandle = addTask(std::move(name));
+    startTask(pCommandList, taskHandle);
+    return taskHandle;
+}
+
+uint32_t GPUFrameProfiler::addTask(std::string name, bool asyncCompute)
 {
     auto& frame = m_inFlightFrames.front();
     const uint32_t taskHandle = (uint32_t)frame.tasks.size();
-    const uint32_t startQueryIdx = addTimingQuery(pCommandList);
-    frame.tasks.push_back({ .name = name, .startQueryIdx = startQueryIdx });
+    frame.tasks.push_back({ .name = std::move(name), .asyncCompute = asyncCompute });
     return taskHandle;
 }
 
+void GPUFrameProfiler::startTask(ID3D12GraphicsCommandList5* pCommandList, uint32_t taskHandle)
+{
+    auto& frame = m_inFlightFrames.front();
+    frame.tasks[taskHandle].startQueryIdx = addTimingQuery(pCommandList);
+}
+
 void GPUFrameProfiler::endTask(ID3D12GraphicsCommandList5* pCommandList, uint32_t taskHandle)
 {
     auto& frame = m_inFlightFrames.front();
@@ -111,9 +146,9 @@ void GPUFrameProfiler::endFrame(ID3D12GraphicsCommandList5* pCommandList)
 
 uint32_t GPUFrameProfiler::addTimingQuery(ID3D12GraphicsCommandList5* pCommandList)
 {
-    const uint32_t queryOffset = m_gpuQueryOffset;
-    pCommandList->EndQuery(m_pQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, m_gpuQueryOffset);
-    m_gpuQueryOffset = (m_gpuQueryOffset + 1) % queryHeapSize;
+    static_assert((uint64_t(1) << 32) % queryHeapSize == 0);
+    const uint32_t queryOffset = m_gpuQueryCounter.fetch_add(1, std::memory_order_relaxed) % queryHeapSize;
+    pCommandList->EndQuery(m_pQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, queryOffset);
     return queryOffset;
 }
 
@@ -162,6 +197,26 @@ void GPUFrameProfiler::resolveQueriesCPU(Frame& frame)
     }
 }
 
+std::vector<Core::ProfileTrack> GPUFrameProfiler::getTimeline() const
+{
+    Core::ProfileTrack graphicsTrack { .name = "GPU", .tasks = {} };
+    Core::ProfileTrack computeTrack { .name = "GPU async compute", .tasks = {} };
+    for (const auto& frame : m_resolvedFrames | std::views::reverse) {
+        const auto toCPUTime = [&](uint64_t timestamp, bool asyncCompute) {
+            const auto calibrationTimestamp = asyncCompute ? frame.computeCalibrationTimestamp : frame.calibrationTimestamp;
+            const auto calibrationTime = asyncCompute ? frame.computeCalibrationTime : frame.calibrationTime;
+            const double nanoseconds = ((double)timestamp - (double)calibrationTimestamp) * (asyncCompute ? m_secondsPerTickCompute : m_secondsPerTick) * 1e9;
+            return (uint64_t)((int64_t)calibrationTime + (int64_t)nanoseconds);
+        };
+        graphicsTrack.tasks.push_back({ .name = "Frame", .start = toCPUTime(frame.startTimestamp, false), .end = toCPUTime(frame.endTimestamp, false) });
+        for (const auto& task : frame.tasks) {
+            auto& track = task.asyncCompute ? computeTrack : graphicsTrack;
+            track.tasks.push_back({ .name = task.name, .start = toCPUTime(task.startTimestamp, task.asyncCompute), .end = toCPUTime(task.endTimestamp, task.asyncCompute) });
+        }
+    }
+    return { std::move(graphicsTrack), std::move(computeTrack) };
+}
+
 void GPUFrameProfiler::displayHorizontalGUI() const
 {
     // User interface modeled after LegitProfiler:
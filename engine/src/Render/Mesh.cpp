@@ -1,16 +1,28 @@
 #define _USE_MATH_DEFINES 1 // OpenMesh
 #include "Engine/Render/Mesh.h"
+#include "Engine/Render/MeshSimplification.h"
 #include "Engine/Util/BinaryReader.h"
 #include "Engine/Util/BinaryWriter.h"
+#include "Engine/Util/MappedBinaryReader.h"
 #include <tbx/disable_all_warnings.h>
 DISABLE_WARNINGS_PUSH()
 #include "Engine/RenderAPI/Internal/D3D12Includes.h"
 #include <DirectXMesh.h>
 #include <fmt/ranges.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
 DISABLE_WARNINGS_POP()
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
 #include <execution>
-#include <unordered_map>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <tuple>
 
 namespace Render {
 
@@ -37,9 +49,13 @@ void MeshCPU::writeTo(Util::BinaryWriter& writer) const
     writer.write(Meshlet::MaxNumPrimitives);
     writer.write(Meshlet::MaxNumVertices);
     writer.write(meshlets);
+    writer.write(meshletVertices);
+    writer.write(meshletPrimitives);
     writer.write(bounds);
     writer.write(subMeshes);
     writer.write(materials);
+    writer.write(lods);
+    writer.write(lodIndices);
 }
 
 void MeshCPU::readFrom(Util::BinaryReader& reader)
@@ -56,322 +72,660 @@ void MeshCPU::readFrom(Util::BinaryReader& reader)
     Tbx::assert_always(meshletMaxNumVertices == Meshlet::MaxNumVertices);
 
     reader.read(meshlets);
+    reader.read(meshletVertices);
+    reader.read(meshletPrimitives);
     reader.read(bounds);
     reader.read(subMeshes);
     reader.read(materials);
+    reader.read(lods);
+    reader.read(lodIndices);
 }
 
-void MeshCPU::removeDuplicateVertices()
+MeshCPU::operator MeshCPUView() const
 {
-    constexpr static float epsilon = 10e-6f; // Vertices closer than this distance will be merged into a single vertex.
+    return MeshCPUView {
+        .vertices = vertices,
+        .indices = indices,
+        .meshlets = meshlets,
+        .meshletVertices = meshletVertices,
+        .meshletPrimitives = meshletPrimitives,
+        .bounds = bounds,
+        .subMeshes = subMeshes,
+        .materials = materials,
+        .lods = lods,
+        .lodIndices = lodIndices
+    };
+}
 
-    std::vector<ShaderInputs::Vertex> newVertices;
-    std::vector<uint32_t> newIndices;
-    std::transform(std::begin(subMeshes), std::end(subMeshes), std::begin(subMeshes),
-        [&](const SubMesh& oldSubMesh) {
-            spdlog::debug("Gather vertex positions");
-            std::vector<uint32_t> subMeshIndices((size_t)oldSubMesh.numIndices);
-            for (uint32_t i = 0; i < oldSubMesh.numIndices; ++i)
-                subMeshIndices[i] = indices[oldSubMesh.indexStart + i];
-            std::vector<ShaderInputs::Vertex> subMeshVertices((size_t)oldSubMesh.numVertices);
-            for (uint32_t i = 0; i < oldSubMesh.numVertices; ++i)
-                subMeshVertices[i] = vertices[oldSubMesh.baseVertex + i];
-
-            const uint32_t numFaces = oldSubMesh.numIndices / 3;
-            std::vector<DirectX::XMFLOAT3> vertexPositions(subMeshVertices.size());
-            std::transform(
-                std::execution::par_unseq,
-                std::begin(subMeshVertices), std::end(subMeshVertices),
-                std::begin(vertexPositions),
-                [](const ShaderInputs::Vertex& vertex) -> DirectX::XMFLOAT3 {
-                    return DirectX::XMFLOAT3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
-                });
-
-            // https://github.com/microsoft/DirectXMesh/wiki/DirectXMesh
-            // 0. GenerateAdjacencyAndPointReps
-            // 1. WeldVertices
-            // 2. OptimizeVertices
-            // 3. FinalizeIB
-            // 4. CompactVB
-            spdlog::debug("0. GenerateAdjacencyAndPointReps");
-            std::vector<uint32_t> adjacency((size_t)oldSubMesh.numIndices);
-            std::vector<uint32_t> pointReps((size_t)oldSubMesh.numVertices);
-            RenderAPI::ThrowIfFailed(
-                DirectX::GenerateAdjacencyAndPointReps(subMeshIndices.data(), numFaces, vertexPositions.data(), vertexPositions.size(), epsilon, pointReps.data(), adjacency.data()));
-
-            spdlog::debug("1. WeldVertices");
-            RenderAPI::ThrowIfFailed(
-                DirectX::WeldVertices(subMeshIndices.data(), numFaces, subMeshVertices.size(),
-                    pointReps.data(), nullptr, [](uint32_t, uint32_t) { return true; }));
-
-            spdlog::debug("2. OptimizeVertices");
-            std::vector<uint32_t> vertexRemap(subMeshVertices.size());
-            size_t trailingUnused;
-            RenderAPI::ThrowIfFailed(
-                DirectX::OptimizeVertices(subMeshIndices.data(), numFaces, subMeshVertices.size(), vertexRemap.data(), &trailingUnused));
-
-            spdlog::debug("3. FinalizeIB");
-            RenderAPI::ThrowIfFailed(
-                DirectX::FinalizeIB(subMeshIndices.data(), numFaces, vertexRemap.data(), subMeshVertices.size()));
-
-            spdlog::debug("4. CompactVB");
-            std::vector<ShaderInputs::Vertex> newSubMeshVertices(subMeshVertices.size() - trailingUnused);
-            RenderAPI::ThrowIfFailed(
-                DirectX::CompactVB(subMeshVertices.data(), sizeof(ShaderInputs::Vertex), subMeshVertices.size(), trailingUnused, vertexRemap.data(), newSubMeshVertices.data()));
-
-
-            const SubMesh newSubMesh {
-                .indexStart = (uint32_t)newIndices.size(),
-                .numIndices = (uint32_t)subMeshIndices.size(),
-                .baseVertex = (uint32_t)newVertices.size(),
-                .numVertices = (uint32_t)newSubMeshVertices.size()
-            };
-            newIndices.resize(newIndices.size() + subMeshIndices.size());
-            std::copy(std::begin(subMeshIndices), std::end(subMeshIndices), std::begin(newIndices) + newSubMesh.indexStart);
-            newVertices.resize(newVertices.size() + newSubMeshVertices.size());
-            std::copy(std::begin(newSubMeshVertices), std::end(newSubMeshVertices), std::begin(newVertices) + newSubMesh.baseVertex);
-
-            return newSubMesh;
-        });
+size_t MeshCPU::sizeInBytes() const
+{
+    return vertices.size() * sizeof(ShaderInputs::Vertex) + indices.size() * sizeof(uint32_t) + meshlets.size() * sizeof(Meshlet)
+        + meshletVertices.size() * sizeof(uint32_t) + meshletPrimitives.size() + subMeshes.size() * sizeof(SubMesh) + materials.size() * sizeof(MaterialCPU)
+        + lods.size() * sizeof(SubMeshLOD) + lodIndices.size() * sizeof(uint32_t);
+}
 
-    spdlog::info("num indices {} -> {}", indices.size(), newIndices.size());
-    spdlog::info("num vertices {} -> {}", vertices.size(), newVertices.size());
-    this->indices = std::move(newIndices);
-    this->vertices = std::move(newVertices);
+size_t MeshCPUView::meshletSizeInBytes() const
+{
+    return meshlets.size_bytes() + meshletVertices.size_bytes() + meshletPrimitives.size_bytes();
 }
 
-void MeshCPU::optimizeIndexVertexOrder()
+size_t MeshCPUView::legacyMeshletSizeInBytes() const
 {
-    constexpr static float epsilon = 10e-3f; // Vertices closer than this distance will be merged into a single vertex.
-
-    std::vector<ShaderInputs::Vertex> newVertices;
-    std::vector<uint32_t> newIndices;
-    std::transform(std::begin(subMeshes), std::end(subMeshes), std::begin(subMeshes),
-        [&](const SubMesh& oldSubMesh) {
-            spdlog::debug("Gather vertex positions");
-            std::vector<uint32_t> subMeshIndices((size_t)oldSubMesh.numIndices);
-            for (uint32_t i = 0; i < oldSubMesh.numIndices; ++i)
-                subMeshIndices[i] = indices[oldSubMesh.indexStart + i];
-            std::vector<ShaderInputs::Vertex> subMeshVertices((size_t)oldSubMesh.numVertices);
-            for (uint32_t i = 0; i < oldSubMesh.numVertices; ++i)
-                subMeshVertices[i] = vertices[oldSubMesh.baseVertex + i];
-
-            const uint32_t numFaces = oldSubMesh.numIndices / 3;
-            std::vector<DirectX::XMFLOAT3> vertexPositions(subMeshVertices.size());
-            std::transform(
-                std::execution::par_unseq,
-                std::begin(subMeshVertices), std::end(subMeshVertices),
-                std::begin(vertexPositions),
-                [](const ShaderInputs::Vertex& vertex) -> DirectX::XMFLOAT3 {
-                    return DirectX::XMFLOAT3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
-                });
-
-            // https://github.com/microsoft/DirectXMesh/wiki/DirectXMesh
-            // 0. GenerateAdjacencyAndPointReps
-            // 1. Clean
-            // 2. AttributeSort
-            // 3. ReorderIBAndAdjacency
-            // 4. OptimizeFaces
-            // 5. ReorderIBAndAdjacency
-            // 6. OptimizeVertices
-            // 7. FinalizeIB
-            // 8. FinalizeVB
-            spdlog::debug("0. GenerateAdjacencyAndPointReps");
-            std::vector<uint32_t> adjacency((size_t)oldSubMesh.numIndices);
-            std::vector<uint32_t> pointReps((size_t)oldSubMesh.numVertices);
-            RenderAPI::ThrowIfFailed(
-                DirectX::GenerateAdjacencyAndPointReps(subMeshIndices.data(), numFaces, vertexPositions.data(), vertexPositions.size(), epsilon, pointReps.data(), adjacency.data()));
-
-            std::vector<uint32_t> duplicateVertices;
-            spdlog::debug("1. Clean");
-            RenderAPI::ThrowIfFailed(
-                DirectX::Clean(subMeshIndices.data(), (size_t)numFaces, vertexPositions.size(), adjacency.data(), nullptr, duplicateVertices));
-
-            // DirectX::AttributeSort();
-            // DirectX::ReorderIBAndAdjacency(subMeshIndices.data(), numFaces, adjacency.data(),
-
-            spdlog::debug("4. OptimizeFaces");
-            std::vector<uint32_t> faceRemap((size_t)numFaces * 3);
-            std::iota(std::begin(faceRemap), std::end(faceRemap), 0u);
-            RenderAPI::ThrowIfFailed(
-                DirectX::OptimizeFaces(subMeshIndices.data(), numFaces, adjacency.data(), faceRemap.data()));
-
-            spdlog::debug("5. ReorderIBAndAdjacency");
-            std::vector<uint32_t> newSubMeshIndices(subMeshIndices.size());
-            std::vector<uint32_t> newAdjacency(newSubMeshIndices.size());
-            RenderAPI::ThrowIfFailed(
-                DirectX::ReorderIBAndAdjacency(
-                    subMeshIndices.data(), numFaces, faceRemap.data(), faceRemap.data(), newSubMeshIndices.data(), newAdjacency.data()));
-
-            spdlog::debug("6. OptimizeVertices");
-            std::vector<uint32_t> vertexRemap(subMeshVertices.size());
-            RenderAPI::ThrowIfFailed(
-                DirectX::OptimizeVertices(newSubMeshIndices.data(), numFaces, subMeshVertices.size(), vertexRemap.data()));
-
-            spdlog::debug("7. FinalizeIB");
-            RenderAPI::ThrowIfFailed(
-                DirectX::FinalizeIB(newSubMeshIndices.data(), numFaces, vertexRemap.data(), subMeshVertices.size()));
-
-            spdlog::debug("8. FinalizeVB");
-            std::vector<ShaderInputs::Vertex> newSubMeshVertices(subMeshVertices.size() + duplicateVertices.size());
-            RenderAPI::ThrowIfFailed(
-                DirectX::FinalizeVB(
-                    subMeshVertices.data(), sizeof(ShaderInputs::Vertex), subMeshVertices.size(),
-                    duplicateVertices.data(), duplicateVertices.size(),
-                    vertexRemap.data(), newSubMeshVertices.data()));
-
-            const SubMesh newSubMesh {
-                .indexStart = (uint32_t)newIndices.size(),
-                .numIndices = (uint32_t)newSubMeshIndices.size(),
-                .baseVertex = (uint32_t)newVertices.size(),
-                .numVertices = (uint32_t)newSubMeshVertices.size()
-            };
-            newIndices.resize(newIndices.size() + newSubMeshIndices.size());
-            std::copy(std::begin(newSubMeshIndices), std::end(newSubMeshIndices), std::begin(newIndices) + newSubMesh.indexStart);
-            newVertices.resize(newVertices.size() + newSubMeshVertices.size());
-            std::copy(std::begin(newSubMeshVertices), std::end(newSubMeshVertices), std::begin(newVertices) + newSubMesh.baseVertex);
-
-            return newSubMesh;
-        });
+    return meshlets.size() * sizeof(LegacyMeshlet);
+}
 
-    spdlog::info("num indices {} -> {}", indices.size(), newIndices.size());
-    spdlog::info("num vertices {} -> {}", vertices.size(), newVertices.size());
-    this->indices = std::move(newIndices);
-    this->vertices = std::move(newVertices);
+size_t MeshCPUView::vertexSizeInBytes() const
+{
+    return vertices.size_bytes();
 }
 
-void MeshCPU::generateMeshlets()
+size_t MeshCPUView::compressedVertexSizeInBytes() const
+{
+    return vertices.size() * sizeof(CompressedVertex) + subMeshes.size() * sizeof(VertexQuantization);
+}
+
+void MeshCPUView::writeTo(Util::BinaryWriter& writer) const
+{
+    writer.write(Meshlet::MaxNumPrimitives);
+    writer.write(Meshlet::MaxNumVertices);
+    writer.write(bounds);
+    if (compressedVertices.empty()) {
+        writer.write(VertexFormat::Float);
+        writer.writeAligned(vertices);
+    } else {
+        writer.write(VertexFormat::Compressed);
+        writer.writeAligned(compressedVertices);
+        writer.writeAligned(vertexQuantizations);
+    }
+    writer.writeAligned(indices);
+    writer.writeAligned(meshlets);
+    writer.writeAligned(meshletVertices);
+    writer.writeAligned(meshletPrimitives);
+    writer.writeAligned(subMeshes);
+    writer.writeAligned(materials);
+    writer.writeAligned(lods);
+    writer.writeAligned(lodIndices);
+}
+
+void MeshCPUView::readFrom(Util::MappedBinaryReader& reader)
+{
+    // Verify that the file was generated with the same Meshlet size as we are using now.
+    const auto meshletMaxNumPrimitives = reader.read<uint32_t>();
+    const auto meshletMaxNumVertices = reader.read<uint32_t>();
+    Tbx::assert_always(meshletMaxNumPrimitives == Meshlet::MaxNumPrimitives);
+    Tbx::assert_always(meshletMaxNumVertices == Meshlet::MaxNumVertices);
+
+    reader.read(bounds);
+    if (reader.read<VertexFormat>() == VertexFormat::Float) {
+        vertices = reader.readAligned<ShaderInputs::Vertex>();
+    } else {
+        compressedVertices = reader.readAligned<CompressedVertex>();
+        vertexQuantizations = reader.readAligned<VertexQuantization>();
+    }
+    indices = reader.readAligned<uint32_t>();
+    meshlets = reader.readAligned<Meshlet>();
+    meshletVertices = reader.readAligned<uint32_t>();
+    meshletPrimitives = reader.readAligned<uint8_t>();
+    subMeshes = reader.readAligned<SubMesh>();
+    materials = reader.readAligned<MaterialCPU>();
+    lods = reader.readAligned<SubMeshLOD>();
+    lodIndices = reader.readAligned<uint32_t>();
+}
+
+MeshOptimizationStatistics& MeshOptimizationStatistics::operator+=(const MeshOptimizationStatistics& other)
+{
+    before += other.before;
+    after += other.after;
+    numVerticesBefore += other.numVerticesBefore;
+    numVerticesAfter += other.numVerticesAfter;
+    return *this;
+}
+
+void MeshCPU::removeDuplicateVertices()
+{
+    MeshCPU* pThis = this;
+    optimize(std::span(&pThis, 1), MeshOptimizationSettings { .weldVertices = true, .optimizeVertexCache = false, .optimizeOverdraw = false, .optimizeVertexFetch = false });
+}
+
+void MeshCPU::optimizeIndexVertexOrder()
+{
+    MeshCPU* pThis = this;
+    optimize(std::span(&pThis, 1), MeshOptimizationSettings { .weldVertices = false });
+}
+
+struct OptimizedSubMesh {
+    std::vector<uint32_t> indices;
+    std::vector<ShaderInputs::Vertex> vertices;
+    std::vector<uint32_t> vertexRemap; // Old vertex index -> new vertex index (both relative to the sub mesh).
+    MeshOptimizationStatistics statistics;
+};
+
+// Optimize a single sub mesh. Only reads from the mesh so it may run concurrently with other sub meshes.
+static OptimizedSubMesh optimizeSubMesh(const MeshCPU& mesh, uint32_t subMeshIdx, const MeshOptimizationSettings& settings)
 {
     constexpr static float epsilon = 10e-6f; // Vertices closer than this distance will be merged into a single vertex.
+    constexpr static float attributeEpsilon = 10e-4f; // Largest difference in normal & texture coordinates of merged vertices.
+    constexpr static uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+    const auto& subMesh = mesh.subMeshes[subMeshIdx];
+    const auto vertices = std::span(mesh.vertices).subspan(subMesh.baseVertex, subMesh.numVertices);
+    OptimizedSubMesh out;
+    out.indices.assign(std::begin(mesh.indices) + subMesh.indexStart, std::begin(mesh.indices) + subMesh.indexStart + subMesh.numIndices);
+    out.statistics.before = analyzeVertexProcessing(out.indices, vertices.size(), sizeof(ShaderInputs::Vertex));
+    out.statistics.numVerticesBefore = vertices.size();
+
+    std::vector<DirectX::XMFLOAT3> vertexPositions(vertices.size());
+    std::transform(std::begin(vertices), std::end(vertices), std::begin(vertexPositions),
+        [](const ShaderInputs::Vertex& vertex) -> DirectX::XMFLOAT3 {
+            return DirectX::XMFLOAT3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+        });
 
-    const auto numPrimitives = indices.size();
-    this->meshlets.clear();
-
-    for (uint32_t subMeshIdx = 0; subMeshIdx < subMeshes.size(); ++subMeshIdx) {
-        auto& subMesh = subMeshes[subMeshIdx];
-        subMesh.meshletStart = (uint32_t)this->meshlets.size();
-
-#if 1
-        spdlog::debug("Gather vertex positions");
-        assert(subMesh.numIndices % 3 == 0);
-        const uint32_t numFaces = subMesh.numIndices / 3;
-        std::vector<DirectX::XMFLOAT3> vertexPositions((size_t)subMesh.numVertices);
-        std::transform(
-            std::execution::par_unseq,
-            std::begin(vertices) + subMesh.baseVertex, std::begin(vertices) + subMesh.baseVertex + subMesh.numVertices,
-            std::begin(vertexPositions),
-            [](const ShaderInputs::Vertex& vertex) -> DirectX::XMFLOAT3 {
-                return DirectX::XMFLOAT3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
-            });
-
-        uint32_t const* pIndices = &indices[subMesh.indexStart];
-        spdlog::debug("GenerateAdjacencyAndPointReps");
-        std::vector<uint32_t> adjacency((size_t)subMesh.numIndices);
+    // Welding: vertices that share their position (point representative) and attributes are merged into the first of them.
+    std::vector<uint32_t> weldRemap(vertices.size());
+    std::iota(std::begin(weldRemap), std::end(weldRemap), 0u);
+    if (settings.weldVertices && !out.indices.empty()) {
+        std::vector<uint32_t> pointReps(vertices.size());
         RenderAPI::ThrowIfFailed(
-            DirectX::GenerateAdjacencyAndPointReps(pIndices, numFaces, vertexPositions.data(), vertexPositions.size(), epsilon, nullptr, adjacency.data()));
+            DirectX::GenerateAdjacencyAndPointReps(out.indices.data(), out.indices.size() / 3, vertexPositions.data(), vertexPositions.size(), epsilon, pointReps.data(), nullptr));
+
+        std::vector<uint32_t> sortedVertices(vertices.size());
+        std::iota(std::begin(sortedVertices), std::end(sortedVertices), 0u);
+        std::sort(std::begin(sortedVertices), std::end(sortedVertices),
+            [&](uint32_t lhs, uint32_t rhs) { return std::tie(pointReps[lhs], lhs) < std::tie(pointReps[rhs], rhs); });
+        const auto hasSameAttributes = [&](const ShaderInputs::Vertex& lhs, const ShaderInputs::Vertex& rhs) {
+            return glm::all(glm::lessThanEqual(glm::abs(lhs.normal - rhs.normal), glm::vec3(attributeEpsilon)))
+                && glm::all(glm::lessThanEqual(glm::abs(lhs.texCoord - rhs.texCoord), glm::vec2(attributeEpsilon)));
+        };
+        for (auto groupStart = std::begin(sortedVertices); groupStart != std::end(sortedVertices);) {
+            const auto groupEnd = std::find_if(groupStart, std::end(sortedVertices), [&](uint32_t v) { return pointReps[v] != pointReps[*groupStart]; });
+            for (auto iter = groupStart; iter != groupEnd; ++iter) {
+                const auto match = std::find_if(groupStart, iter,
+                    [&](uint32_t candidate) { return weldRemap[candidate] == candidate && hasSameAttributes(vertices[candidate], vertices[*iter]); });
+                if (match != iter)
+                    weldRemap[*iter] = *match;
+            }
+            groupStart = groupEnd;
+        }
+
+        // Remove the triangles that collapsed.
+        size_t numIndices = 0;
+        for (size_t i = 0; i < out.indices.size(); i += 3) {
+            const uint32_t i0 = weldRemap[out.indices[i + 0]], i1 = weldRemap[out.indices[i + 1]], i2 = weldRemap[out.indices[i + 2]];
+            if (i0 == i1 || i1 == i2 || i2 == i0)
+                continue;
+            out.indices[numIndices++] = i0;
+            out.indices[numIndices++] = i1;
+            out.indices[numIndices++] = i2;
+        }
+        out.indices.resize(numIndices);
+    }
+    const size_t numFaces = out.indices.size() / 3;
 
-        spdlog::debug("ComputeMeshlets");
-        std::vector<DirectX::Meshlet> dxMeshlets;
-        std::vector<uint8_t> uniqueVertexIB;
-        std::vector<DirectX::MeshletTriangle> primitiveIndices;
+    if (settings.optimizeVertexCache && numFaces > 0) {
+        std::vector<uint32_t> adjacency(out.indices.size());
         RenderAPI::ThrowIfFailed(
-            DirectX::ComputeMeshlets(
-                &indices[subMesh.indexStart], numFaces,
-                vertexPositions.data(), vertexPositions.size(),
-                adjacency.data(), dxMeshlets, uniqueVertexIB, primitiveIndices, Meshlet::MaxNumVertices, Meshlet::MaxNumPrimitives));
-        Tbx::assert_always(uniqueVertexIB.size() % sizeof(uint32_t) == 0);
-        uint32_t const* pUniqueVertexIB = reinterpret_cast<uint32_t const*>(uniqueVertexIB.data());
-
-        spdlog::debug("Transform meshlets to my format");
-        for (const DirectX::Meshlet& dxMeshlet : dxMeshlets) {
-            Meshlet meshlet {};
-            meshlet.numVertices = dxMeshlet.VertCount;
-            meshlet.numPrimitives = dxMeshlet.PrimCount;
-            meshlet.subMeshIdx = subMeshIdx;
-            for (uint32_t i = 0; i < dxMeshlet.VertCount; ++i) {
-                meshlet.vertices[i] = pUniqueVertexIB[dxMeshlet.VertOffset + i] + subMesh.baseVertex;
+            DirectX::GenerateAdjacencyAndPointReps(out.indices.data(), numFaces, vertexPositions.data(), vertexPositions.size(), epsilon, nullptr, adjacency.data()));
+        std::vector<uint32_t> faceRemap(numFaces);
+        RenderAPI::ThrowIfFailed(
+            DirectX::OptimizeFaces(out.indices.data(), numFaces, adjacency.data(), faceRemap.data()));
+        std::vector<uint32_t> newIndices(out.indices.size());
+        RenderAPI::ThrowIfFailed(
+            DirectX::ReorderIB(out.indices.data(), numFaces, faceRemap.data(), newIndices.data()));
+        out.indices = std::move(newIndices);
+    }
+
+    if (settings.optimizeOverdraw) {
+        std::vector<glm::vec3> positions(vertices.size());
+        std::transform(std::begin(vertices), std::end(vertices), std::begin(positions), [](const ShaderInputs::Vertex& vertex) { return vertex.pos; });
+        optimizeOverdraw(out.indices, positions, settings.overdrawThreshold);
+    }
+
+    // Vertex fetch: number the vertices in the order in which they are first referenced (or keep their order), which
+    // also drops the vertices that are no longer referenced.
+    std::vector<uint32_t> oldToNew(vertices.size(), unused);
+    uint32_t numNewVertices = 0;
+    if (settings.optimizeVertexFetch) {
+        for (uint32_t index : out.indices) {
+            if (oldToNew[index] == unused)
+                oldToNew[index] = numNewVertices++;
+        }
+    } else {
+        for (uint32_t index : out.indices)
+            oldToNew[index] = 0;
+        for (uint32_t& newIndex : oldToNew) {
+            if (newIndex != unused)
+                newIndex = numNewVertices++;
+        }
+    }
+    out.vertices.resize(numNewVertices);
+    for (uint32_t oldIndex = 0; oldIndex < vertices.size(); ++oldIndex) {
+        if (oldToNew[oldIndex] != unused)
+            out.vertices[oldToNew[oldIndex]] = vertices[oldIndex];
+    }
+    for (uint32_t& index : out.indices)
+        index = oldToNew[index];
+
+    // Vertices that are no longer referenced were only used by triangles that collapsed while welding. Any (valid)
+    // index keeps those triangles degenerate when remapping meshlets & LODs.
+    out.vertexRemap.resize(vertices.size());
+    std::transform(std::begin(weldRemap), std::end(weldRemap), std::begin(out.vertexRemap),
+        [&](uint32_t weldedIndex) { return oldToNew[weldedIndex] == unused ? 0 : oldToNew[weldedIndex]; });
+
+    out.statistics.after = analyzeVertexProcessing(out.indices, out.vertices.size(), sizeof(ShaderInputs::Vertex));
+    out.statistics.numVerticesAfter = out.vertices.size();
+    return out;
+}
+
+MeshOptimizationStatistics MeshCPU::optimize(std::span<MeshCPU* const> meshes, const MeshOptimizationSettings& settings)
+{
+    struct Task {
+        size_t meshIdx;
+        uint32_t subMeshIdx;
+        uint32_t oldBaseVertex;
+        OptimizedSubMesh result;
+    };
+    std::vector<Task> tasks;
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx) {
+        for (uint32_t subMeshIdx = 0; subMeshIdx < meshes[meshIdx]->subMeshes.size(); ++subMeshIdx)
+            tasks.push_back({ .meshIdx = meshIdx, .subMeshIdx = subMeshIdx, .oldBaseVertex = meshes[meshIdx]->subMeshes[subMeshIdx].baseVertex });
+    }
+    std::for_each(std::execution::par, std::begin(tasks), std::end(tasks),
+        [&](Task& task) { task.result = optimizeSubMesh(*meshes[task.meshIdx], task.subMeshIdx, settings); });
+
+    // Assign the output ranges in (mesh, sub mesh) order. All other fields of the sub meshes (meshlets) are kept.
+    MeshOptimizationStatistics out {};
+    std::vector<std::vector<ShaderInputs::Vertex>> newVertices(meshes.size());
+    std::vector<std::vector<uint32_t>> newIndices(meshes.size());
+    for (const Task& task : tasks) {
+        auto& subMesh = meshes[task.meshIdx]->subMeshes[task.subMeshIdx];
+        subMesh.indexStart = (uint32_t)newIndices[task.meshIdx].size();
+        subMesh.numIndices = (uint32_t)task.result.indices.size();
+        subMesh.baseVertex = (uint32_t)newVertices[task.meshIdx].size();
+        subMesh.numVertices = (uint32_t)task.result.vertices.size();
+        newIndices[task.meshIdx].resize(subMesh.indexStart + subMesh.numIndices);
+        newVertices[task.meshIdx].resize(subMesh.baseVertex + subMesh.numVertices);
+        out += task.result.statistics;
+    }
+
+    std::for_each(std::execution::par, std::begin(tasks), std::end(tasks),
+        [&](const Task& task) {
+            auto& mesh = *meshes[task.meshIdx];
+            const auto& subMesh = mesh.subMeshes[task.subMeshIdx];
+            std::copy(std::begin(task.result.indices), std::end(task.result.indices), std::begin(newIndices[task.meshIdx]) + subMesh.indexStart);
+            std::copy(std::begin(task.result.vertices), std::end(task.result.vertices), std::begin(newVertices[task.meshIdx]) + subMesh.baseVertex);
+
+            // Meshlet vertices are indices into the vertex array of the mesh; LOD indices are relative to the sub mesh.
+            for (uint32_t meshletIdx = subMesh.meshletStart; meshletIdx < subMesh.meshletStart + subMesh.numMeshlets; ++meshletIdx) {
+                const auto& meshlet = mesh.meshlets[meshletIdx];
+                for (uint32_t i = 0; i < meshlet.numVertices; ++i) {
+                    auto& meshletVertex = mesh.meshletVertices[meshlet.vertexOffset + i];
+                    meshletVertex = subMesh.baseVertex + task.result.vertexRemap[meshletVertex - task.oldBaseVertex];
+                }
             }
-            for (uint32_t i = 0; i < dxMeshlet.PrimCount; ++i) {
-                const auto primitive = primitiveIndices[dxMeshlet.PrimOffset + i];
-                meshlet.primitives[i] = Meshlet::encodePrimitive(primitive.i0, primitive.i1, primitive.i2);
+            for (const auto& lod : findSubMeshLODs(mesh.lods, task.subMeshIdx)) {
+                for (uint32_t i = lod.indexStart; i < lod.indexStart + lod.numIndices; ++i)
+                    mesh.lodIndices[i] = task.result.vertexRemap[mesh.lodIndices[i]];
             }
-            this->meshlets.push_back(meshlet);
+        });
+
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx) {
+        meshes[meshIdx]->vertices = std::move(newVertices[meshIdx]);
+        meshes[meshIdx]->indices = std::move(newIndices[meshIdx]);
+    }
+    return out;
+}
+
+// Compute the LOD chain of a single sub mesh. Every LOD is simplified from the previous one, so the error of a LOD is
+// the sum of the errors introduced by each simplification step. Only reads from the mesh so it may run concurrently.
+static std::vector<SimplifiedMesh> computeSubMeshLODs(const MeshCPU& mesh, uint32_t subMeshIdx, const LODGenerationSettings& settings)
+{
+    const auto& subMesh = mesh.subMeshes[subMeshIdx];
+    std::vector<glm::vec3> positions((size_t)subMesh.numVertices);
+    Core::Bounds3f bounds;
+    for (uint32_t i = 0; i < subMesh.numVertices; ++i) {
+        positions[i] = mesh.vertices[subMesh.baseVertex + i].pos;
+        bounds.grow(positions[i]);
+    }
+    const float maxError = settings.maxRelativeError * glm::length(bounds.extent());
+
+    std::vector<SimplifiedMesh> out;
+    std::span<const uint32_t> previousIndices = std::span(mesh.indices).subspan(subMesh.indexStart, subMesh.numIndices);
+    float previousError = 0.0f;
+    while (out.size() < settings.maxNumLODs) {
+        const size_t targetNumTriangles = size_t(float(previousIndices.size() / 3) * settings.reductionFactor);
+        if (targetNumTriangles < settings.minNumTriangles)
+            break;
+
+        auto lod = simplifyMesh(positions, previousIndices, targetNumTriangles * 3, std::max(maxError - previousError, 0.0f));
+        // Stop when the simplification gets stuck, for example because most vertices lie on borders or seams.
+        if (float(lod.indices.size()) > float(previousIndices.size()) * (1.0f + settings.reductionFactor) / 2.0f)
+            break;
+        lod.error += previousError;
+        previousError = lod.error;
+        out.push_back(std::move(lod));
+        previousIndices = out.back().indices;
+    }
+    return out;
+}
+
+void MeshCPU::generateSubMeshLODs(const LODGenerationSettings& settings)
+{
+    MeshCPU* pThis = this;
+    generateSubMeshLODs(std::span(&pThis, 1), settings);
+}
+
+void MeshCPU::generateSubMeshLODs(std::span<MeshCPU* const> meshes, const LODGenerationSettings& settings)
+{
+    struct Task {
+        MeshCPU* pMesh;
+        uint32_t subMeshIdx;
+        std::vector<SimplifiedMesh> lods;
+    };
+    std::vector<Task> tasks;
+    for (MeshCPU* pMesh : meshes) {
+        for (uint32_t subMeshIdx = 0; subMeshIdx < pMesh->subMeshes.size(); ++subMeshIdx)
+            tasks.push_back({ .pMesh = pMesh, .subMeshIdx = subMeshIdx });
+    }
+    std::for_each(std::execution::par, std::begin(tasks), std::end(tasks),
+        [&](Task& task) { task.lods = computeSubMeshLODs(*task.pMesh, task.subMeshIdx, settings); });
+
+    for (MeshCPU* pMesh : meshes) {
+        pMesh->lods.clear();
+        pMesh->lodIndices.clear();
+    }
+    for (const Task& task : tasks) {
+        auto& mesh = *task.pMesh;
+        for (const SimplifiedMesh& lod : task.lods) {
+            mesh.lods.push_back({ .subMeshIdx = task.subMeshIdx,
+                .indexStart = (uint32_t)mesh.lodIndices.size(),
+                .numIndices = (uint32_t)lod.indices.size(),
+                .error = lod.error });
+            mesh.lodIndices.insert(std::end(mesh.lodIndices), std::begin(lod.indices), std::end(lod.indices));
         }
+    }
+}
+
+std::span<const SubMeshLOD> findSubMeshLODs(std::span<const SubMeshLOD> lods, uint32_t subMeshIdx)
+{
+    const auto [first, last] = std::ranges::equal_range(lods, subMeshIdx, std::less {}, &SubMeshLOD::subMeshIdx);
+    return { first, last };
+}
+
+LODSelector::LODSelector(float fovY, uint32_t viewportHeight, float maxPixelError)
+    : m_pixelsPerUnit(float(viewportHeight) / (2.0f * std::tan(fovY / 2.0f)))
+    , m_maxPixelError(maxPixelError)
+{
+}
+
+float LODSelector::projectedError(float geometricError, float distance) const
+{
+    return geometricError / distance * m_pixelsPerUnit;
+}
+
+uint32_t LODSelector::selectLOD(std::span<const SubMeshLOD> subMeshLODs, float distance) const
+{
+    // The camera is inside (the bounds of) the object.
+    if (distance <= 0.0f)
+        return 0;
+
+    // LODs are ordered by increasing error.
+    uint32_t out = 0;
+    while (out < subMeshLODs.size() && projectedError(subMeshLODs[out].error, distance) <= m_maxPixelError)
+        ++out;
+    return out;
+}
+
+MeshletGenerationTimings& MeshletGenerationTimings::operator+=(const MeshletGenerationTimings& other)
+{
+    gatherPositions += other.gatherPositions;
+    generateAdjacency += other.generateAdjacency;
+    computeMeshlets += other.computeMeshlets;
+    convertMeshlets += other.convertMeshlets;
+    computeCullingData += other.computeCullingData;
+    concatenate += other.concatenate;
+    total += other.total;
+    return *this;
+}
+
+// Bounding sphere & normal cone (in object space) of a meshlet whose vertices & primitives have already been set.
+static void computeMeshletCullingData(std::span<const ShaderInputs::Vertex> vertices, std::span<const uint32_t> meshletVertices, std::span<const uint8_t> meshletPrimitives, Meshlet& meshlet)
+{
+    const auto getPosition = [&](uint32_t localIndex) { return vertices[meshletVertices[meshlet.vertexOffset + localIndex]].pos; };
+
+    // Sphere around the center of the axis aligned bounding box. Not the tightest sphere, but cheap to compute.
+    Core::Bounds3f bounds;
+    for (uint32_t i = 0; i < meshlet.numVertices; ++i)
+        bounds.grow(getPosition(i));
+    meshlet.boundingSphereCenter = bounds.center();
+    meshlet.boundingSphereRadius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.numVertices; ++i)
+        meshlet.boundingSphereRadius = std::max(meshlet.boundingSphereRadius, glm::distance(meshlet.boundingSphereCenter, getPosition(i)));
+
+    // Cone around the (unit length) normals of all non-degenerate triangles. Front faces are counter clockwise (GLTF).
+    std::array<glm::vec3, Meshlet::MaxNumPrimitives> normals;
+    uint32_t numNormals = 0;
+    glm::vec3 normalSum { 0.0f };
+    for (uint32_t i = 0; i < meshlet.numPrimitives; ++i) {
+        const uint32_t encodedPrimitive = Meshlet::loadPrimitive(meshletPrimitives, meshlet.primitiveOffset + i);
+        const glm::vec3 p0 = getPosition(encodedPrimitive & 0xFF), p1 = getPosition((encodedPrimitive >> 8) & 0xFF), p2 = getPosition((encodedPrimitive >> 16) & 0xFF);
+        const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(normal);
+        if (length == 0.0f)
+            continue;
+        normals[numNormals++] = normal / length;
+        normalSum += normal / length;
+    }
+
+    // Meshlets without a cone (cutoff of 1) are never considered back facing.
+    meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 1.0f;
+    if (numNormals == 0 || glm::length(normalSum) == 0.0f)
+        return;
+    const glm::vec3 coneAxis = glm::normalize(normalSum);
+    float minDot = 1.0f;
+    for (uint32_t i = 0; i < numNormals; ++i)
+        minDot = std::min(minDot, glm::dot(normals[i], coneAxis));
+    // Cones wider than ~84 degrees (half angle) are almost never back facing; skip the test for those.
+    if (minDot < 0.1f)
+        return;
+    meshlet.coneAxis = coneAxis;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+// Meshlets of a single sub mesh; offsets are relative to the vertices & primitives of this sub mesh.
+struct SubMeshMeshlets {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> primitives;
+};
+
+// Compute the meshlets of a single sub mesh. Only reads from the mesh so it may run concurrently with other sub meshes.
+static SubMeshMeshlets computeSubMeshMeshlets(const MeshCPU& mesh, uint32_t subMeshIdx, MeshletGenerationTimings& timings)
+{
+    using clock = std::chrono::high_resolution_clock;
+    constexpr static float epsilon = 10e-6f; // Vertices closer than this distance will be merged into a single vertex.
 
-#else
+    const auto& vertices = mesh.vertices;
+    const auto& indices = mesh.indices;
+    const auto& subMesh = mesh.subMeshes[subMeshIdx];
+    SubMeshMeshlets out;
+
+    auto stageStart = clock::now();
+    const auto endStage = [&](std::chrono::nanoseconds& stageTime) {
+        const auto now = clock::now();
+        stageTime += now - stageStart;
+        stageStart = now;
+    };
+
+    assert(subMesh.numIndices % 3 == 0);
+    const uint32_t numFaces = subMesh.numIndices / 3;
+    std::vector<DirectX::XMFLOAT3> vertexPositions((size_t)subMesh.numVertices);
+    std::transform(
+        std::begin(vertices) + subMesh.baseVertex, std::begin(vertices) + subMesh.baseVertex + subMesh.numVertices,
+        std::begin(vertexPositions),
+        [](const ShaderInputs::Vertex& vertex) -> DirectX::XMFLOAT3 {
+            return DirectX::XMFLOAT3(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+        });
+    endStage(timings.gatherPositions);
+
+    uint32_t const* pIndices = &indices[subMesh.indexStart];
+    std::vector<uint32_t> adjacency((size_t)subMesh.numIndices);
+    RenderAPI::ThrowIfFailed(
+        DirectX::GenerateAdjacencyAndPointReps(pIndices, numFaces, vertexPositions.data(), vertexPositions.size(), epsilon, nullptr, adjacency.data()));
+    endStage(timings.generateAdjacency);
+
+    std::vector<DirectX::Meshlet> dxMeshlets;
+    std::vector<uint8_t> uniqueVertexIB;
+    std::vector<DirectX::MeshletTriangle> primitiveIndices;
+    RenderAPI::ThrowIfFailed(
+        DirectX::ComputeMeshlets(
+            pIndices, numFaces,
+            vertexPositions.data(), vertexPositions.size(),
+            adjacency.data(), dxMeshlets, uniqueVertexIB, primitiveIndices, Meshlet::MaxNumVertices, Meshlet::MaxNumPrimitives));
+    Tbx::assert_always(uniqueVertexIB.size() % sizeof(uint32_t) == 0);
+    uint32_t const* pUniqueVertexIB = reinterpret_cast<uint32_t const*>(uniqueVertexIB.data());
+    endStage(timings.computeMeshlets);
+
+    out.meshlets.reserve(dxMeshlets.size());
+    out.vertices.reserve(uniqueVertexIB.size() / sizeof(uint32_t));
+    out.primitives.reserve(primitiveIndices.size() * 3);
+    for (const DirectX::Meshlet& dxMeshlet : dxMeshlets) {
         Meshlet meshlet {};
-        meshlet.numPrimitives = meshlet.numVertices = 0;
+        meshlet.vertexOffset = (uint32_t)out.vertices.size();
+        meshlet.primitiveOffset = (uint32_t)(out.primitives.size() / 3);
+        meshlet.numVertices = dxMeshlet.VertCount;
+        meshlet.numPrimitives = dxMeshlet.PrimCount;
         meshlet.subMeshIdx = subMeshIdx;
-        std::unordered_map<uint32_t, uint8_t> globalToLocalMapping;
-        const auto tryAddTriangleToMeshlet = [&](uint32_t firstIndexIndex) {
-            // If the primitive (index) buffer of the meshlet is full.
-            if (meshlet.numPrimitives == Meshlet::MaxNumPrimitives)
-                return false;
-
-            uint32_t primitive = 0;
-            for (uint32_t i = 0; i < 3; ++i) { // i = [0, 1, 2] -> vertex ID of the triangle.
-                const uint32_t globalIndex = subMesh.baseVertex + indices[firstIndexIndex + i]; // Index in the global index buffer
-
-                uint8_t localIndex; // Index into the meshlets vertex buffer (meshlet.vertices) which is an index into the global index buffer.
-                if (auto iter = globalToLocalMapping.find(globalIndex); iter != std::end(globalToLocalMapping)) {
-                    localIndex = iter->second;
-                } else {
-                    // If the vertex buffer of the meshlet is full.
-                    if (meshlet.numVertices == Meshlet::MaxNumVertices)
-                        return false;
-
-                    // Allocate a new vertex in the meshlet.
-                    localIndex = (uint8_t)meshlet.numVertices++;
-                    meshlet.vertices[localIndex] = globalIndex;
-                    globalToLocalMapping[globalIndex] = localIndex; // Store the mapping so it can be reused by other triangles in the meshlet.
-                }
-                primitive |= uint32_t(localIndex) << (i * 8);
-            }
-            meshlet.primitives[meshlet.numPrimitives++] = primitive;
-            return true;
-        };
+        for (uint32_t i = 0; i < dxMeshlet.VertCount; ++i) {
+            out.vertices.push_back(pUniqueVertexIB[dxMeshlet.VertOffset + i] + subMesh.baseVertex);
+        }
+        for (uint32_t i = 0; i < dxMeshlet.PrimCount; ++i) {
+            const auto primitive = primitiveIndices[dxMeshlet.PrimOffset + i];
+            Meshlet::appendPrimitive(out.primitives, Meshlet::encodePrimitive(primitive.i0, primitive.i1, primitive.i2));
+        }
+        out.meshlets.push_back(meshlet);
+    }
+    endStage(timings.convertMeshlets);
 
-        // Add all meshlets.
-        Tbx::assert_always(subMesh.numIndices % 3 == 0);
-        for (uint32_t triangleStart = subMesh.indexStart; triangleStart < subMesh.indexStart + subMesh.numIndices;) {
-            if (tryAddTriangleToMeshlet(triangleStart)) {
-                triangleStart += 3; // Successfully added triangle to current meshlet.
-            } else {
-                // Meshlet was full; add to the list of meshlets and start with a new empty meshlet.
-                this->meshlets.push_back(meshlet);
-                meshlet.numPrimitives = meshlet.numVertices = 0;
-                globalToLocalMapping.clear();
-            }
+    for (Meshlet& meshlet : out.meshlets)
+        computeMeshletCullingData(vertices, out.vertices, out.primitives, meshlet);
+    endStage(timings.computeCullingData);
+    return out;
+}
+
+void MeshCPU::generateMeshlets()
+{
+    MeshCPU* pThis = this;
+    generateMeshlets(std::span(&pThis, 1));
+}
+
+MeshletGenerationTimings MeshCPU::generateMeshlets(std::span<MeshCPU* const> meshes)
+{
+    using clock = std::chrono::high_resolution_clock;
+    const auto start = clock::now();
+
+    // Every sub mesh is an independent task. The tasks are distributed over the threads of the parallel
+    // algorithms' thread pool, which balances the load between threads when sub meshes differ in size.
+    struct Task {
+        MeshCPU* pMesh;
+        uint32_t subMeshIdx;
+        SubMeshMeshlets meshlets;
+        MeshletGenerationTimings timings;
+    };
+    std::vector<Task> tasks;
+    for (MeshCPU* pMesh : meshes) {
+        for (uint32_t subMeshIdx = 0; subMeshIdx < pMesh->subMeshes.size(); ++subMeshIdx)
+            tasks.push_back({ .pMesh = pMesh, .subMeshIdx = subMeshIdx });
+    }
+    std::for_each(std::execution::par, std::begin(tasks), std::end(tasks),
+        [](Task& task) { task.meshlets = computeSubMeshMeshlets(*task.pMesh, task.subMeshIdx, task.timings); });
+
+    // Concatenate the results in (mesh, sub mesh) order so the output does not depend on the scheduling.
+    const auto concatenateStart = clock::now();
+    MeshletGenerationTimings out {};
+    for (MeshCPU* pMesh : meshes) {
+        pMesh->meshlets.clear();
+        pMesh->meshletVertices.clear();
+        pMesh->meshletPrimitives.clear();
+    }
+    for (Task& task : tasks) {
+        auto& mesh = *task.pMesh;
+        auto& subMesh = mesh.subMeshes[task.subMeshIdx];
+        subMesh.meshletStart = (uint32_t)mesh.meshlets.size();
+        subMesh.numMeshlets = (uint32_t)task.meshlets.meshlets.size();
+
+        const auto vertexOffset = (uint32_t)mesh.meshletVertices.size();
+        const auto primitiveOffset = (uint32_t)(mesh.meshletPrimitives.size() / 3);
+        for (Meshlet meshlet : task.meshlets.meshlets) {
+            meshlet.vertexOffset += vertexOffset;
+            meshlet.primitiveOffset += primitiveOffset;
+            mesh.meshlets.push_back(meshlet);
         }
-        if (meshlet.numPrimitives > 0)
-            this->meshlets.push_back(meshlet);
-
-#endif
-        subMesh.numMeshlets = uint32_t(this->meshlets.size() - subMesh.meshletStart);
-
-        /* size_t j = subMesh.indexStart;
-        for (size_t i = subMesh.meshletStart; i < subMesh.meshletStart + subMesh.numMeshlets; ++i) {
-            const auto& meshlet2 = this->meshlets[i];
-            for (size_t prim = 0; prim < meshlet2.numPrimitives; ++prim) {
-                const uint32_t encodedPrimitive = meshlet2.primitives[prim];
-                const uint32_t v0 = meshlet2.vertices[(encodedPrimitive >> 0) & 0xFF];
-                const uint32_t v1 = meshlet2.vertices[(encodedPrimitive >> 8) & 0xFF];
-                const uint32_t v2 = meshlet2.vertices[(encodedPrimitive >> 16) & 0xFF];
-
-                const uint32_t v0_ref = indices[j++] + subMesh.baseVertex;
-                const uint32_t v1_ref = indices[j++] + subMesh.baseVertex;
-                const uint32_t v2_ref = indices[j++] + subMesh.baseVertex;
-
-                assert(v0 == v0_ref);
-                assert(v1 == v1_ref);
-                assert(v2 == v2_ref);
-            }
-        } */
+        mesh.meshletVertices.insert(std::end(mesh.meshletVertices), std::begin(task.meshlets.vertices), std::end(task.meshlets.vertices));
+        mesh.meshletPrimitives.insert(std::end(mesh.meshletPrimitives), std::begin(task.meshlets.primitives), std::end(task.meshlets.primitives));
+        out += task.timings;
+    }
+
+    const auto end = clock::now();
+    out.concatenate = end - concatenateStart;
+    out.total = end - start;
+    return out;
+}
+
+void MeshCPU::setMeshlets(std::span<const LegacyMeshlet> legacyMeshlets)
+{
+    meshlets.clear();
+    meshletVertices.clear();
+    meshletPrimitives.clear();
+    for (const LegacyMeshlet& legacyMeshlet : legacyMeshlets) {
+        Meshlet meshlet {};
+        meshlet.vertexOffset = (uint32_t)meshletVertices.size();
+        meshlet.primitiveOffset = (uint32_t)(meshletPrimitives.size() / 3);
+        meshlet.numVertices = legacyMeshlet.numVertices;
+        meshlet.numPrimitives = legacyMeshlet.numPrimitives;
+        meshlet.subMeshIdx = legacyMeshlet.subMeshIdx;
+        meshlets.push_back(meshlet);
+
+        meshletVertices.insert(std::end(meshletVertices), legacyMeshlet.vertices, legacyMeshlet.vertices + legacyMeshlet.numVertices);
+        for (uint32_t i = 0; i < legacyMeshlet.numPrimitives; ++i)
+            Meshlet::appendPrimitive(meshletPrimitives, legacyMeshlet.primitives[i]);
+    }
+    // Legacy meshlets did not store any culling data.
+    for (Meshlet& meshlet : meshlets)
+        computeMeshletCullingData(vertices, meshletVertices, meshletPrimitives, meshlet);
+}
+
+std::vector<LegacyMeshlet> MeshCPU::legacyMeshlets() const
+{
+    std::vector<LegacyMeshlet> out(meshlets.size());
+    for (size_t meshletIdx = 0; meshletIdx < meshlets.size(); ++meshletIdx) {
+        const Meshlet& meshlet = meshlets[meshletIdx];
+        LegacyMeshlet& legacyMeshlet = out[meshletIdx];
+        legacyMeshlet.numVertices = meshlet.numVertices;
+        legacyMeshlet.numPrimitives = meshlet.numPrimitives;
+        legacyMeshlet.subMeshIdx = meshlet.subMeshIdx;
+        std::copy_n(std::begin(meshletVertices) + meshlet.vertexOffset, meshlet.numVertices, legacyMeshlet.vertices);
+        for (uint32_t i = 0; i < meshlet.numPrimitives; ++i)
+            legacyMeshlet.primitives[i] = Meshlet::loadPrimitive(meshletPrimitives, meshlet.primitiveOffset + i);
     }
+    return out;
 }
 
 uint32_t Meshlet::encodePrimitive(uint32_t i0, uint32_t i1, uint32_t i2)
 {
     return i0 | (i1 << 8) | (i2 << 16);
 }
+
+void Meshlet::appendPrimitive(std::vector<uint8_t>& packedPrimitives, uint32_t encodedPrimitive)
+{
+    packedPrimitives.push_back((uint8_t)(encodedPrimitive & 0xFF));
+    packedPrimitives.push_back((uint8_t)((encodedPrimitive >> 8) & 0xFF));
+    packedPrimitives.push_back((uint8_t)((encodedPrimitive >> 16) & 0xFF));
+}
+
+uint32_t Meshlet::loadPrimitive(std::span<const uint8_t> packedPrimitives, uint32_t primitiveIdx)
+{
+    const size_t byteOffset = 3 * (size_t)primitiveIdx;
+    return encodePrimitive(packedPrimitives[byteOffset], packedPrimitives[byteOffset + 1], packedPrimitives[byteOffset + 2]);
+}
 }
@@ -0,0 +1,199 @@
+#include "Engine/Render/MeshOptimization.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/geometric.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <tbx/error_handling.h>
+#include <vector>
+
+namespace Render {
+
+// Simulated vertex fetch cache: 128 lines of 64 bytes (8KiB).
+static constexpr size_t vertexFetchCacheLineSize = 64;
+static constexpr uint32_t vertexFetchCacheNumLines = 128;
+
+float VertexProcessingStatistics::acmr() const
+{
+    return numTriangles ? float(numTransformedVertices) / float(numTriangles) : 0.0f;
+}
+
+float VertexProcessingStatistics::atvr() const
+{
+    return numVertices ? float(numTransformedVertices) / float(numVertices) : 0.0f;
+}
+
+float VertexProcessingStatistics::overfetch() const
+{
+    return numVertexBytes ? float(numFetchedBytes) / float(numVertexBytes) : 0.0f;
+}
+
+VertexProcessingStatistics& VertexProcessingStatistics::operator+=(const VertexProcessingStatistics& other)
+{
+    numTriangles += other.numTriangles;
+    numVertices += other.numVertices;
+    numTransformedVertices += other.numTransformedVertices;
+    numVertexBytes += other.numVertexBytes;
+    numFetchedBytes += other.numFetchedBytes;
+    return *this;
+}
+
+// FIFO cache; an item is cached if fewer than cacheSize items were inserted since it was inserted itself.
+class FIFOCacheSimulator {
+public:
+    FIFOCacheSimulator(size_t numItems, uint32_t cacheSize)
+        : m_timestamps(numItems, 0)
+        , m_cacheSize(cacheSize)
+    {
+    }
+
+    // Returns whether the item was a cache miss.
+    bool access(size_t item)
+    {
+        if (m_timestamps[item] != 0 && m_time - m_timestamps[item] < m_cacheSize)
+            return false;
+        m_timestamps[item] = ++m_time;
+        return true;
+    }
+    void flush()
+    {
+        m_time += m_cacheSize;
+    }
+
+private:
+    std::vector<uint64_t> m_timestamps;
+    uint64_t m_time = 0;
+    uint32_t m_cacheSize;
+};
+
+VertexProcessingStatistics analyzeVertexProcessing(std::span<const uint32_t> indices, size_t numVertices, size_t vertexSize, uint32_t cacheSize)
+{
+    Tbx::assert_always(indices.size() % 3 == 0);
+    VertexProcessingStatistics out {};
+    out.numTriangles = indices.size() / 3;
+
+    std::vector<uint8_t> isReferenced(numVertices, false);
+    FIFOCacheSimulator transformCache { numVertices, cacheSize };
+    FIFOCacheSimulator fetchCache { (numVertices * vertexSize + vertexFetchCacheLineSize - 1) / vertexFetchCacheLineSize, vertexFetchCacheNumLines };
+    for (uint32_t index : indices) {
+        Tbx::assert_always(index < numVertices);
+        if (!isReferenced[index]) {
+            isReferenced[index] = true;
+            ++out.numVertices;
+        }
+        if (!transformCache.access(index))
+            continue;
+
+        ++out.numTransformedVertices;
+        const size_t firstLine = index * vertexSize / vertexFetchCacheLineSize;
+        const size_t lastLine = ((index + 1) * vertexSize - 1) / vertexFetchCacheLineSize;
+        for (size_t line = firstLine; line <= lastLine; ++line) {
+            if (fetchCache.access(line))
+                out.numFetchedBytes += vertexFetchCacheLineSize;
+        }
+    }
+    out.numVertexBytes = out.numVertices * vertexSize;
+    return out;
+}
+
+void optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold, uint32_t cacheSize)
+{
+    Tbx::assert_always(indices.size() % 3 == 0);
+    const size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0)
+        return;
+
+    const auto countMisses = [&](FIFOCacheSimulator& cache, size_t triangleIdx) {
+        uint32_t out = 0;
+        for (size_t i = 0; i < 3; ++i)
+            out += cache.access(indices[3 * triangleIdx + i]);
+        return out;
+    };
+
+    // Hard boundaries: triangles at which the vertex cache optimizer started a new strip (all vertices miss the cache).
+    std::vector<size_t> hardBoundaries;
+    std::vector<uint32_t> triangleMisses(numTriangles);
+    {
+        FIFOCacheSimulator cache { positions.size(), cacheSize };
+        for (size_t triangleIdx = 0; triangleIdx < numTriangles; ++triangleIdx) {
+            triangleMisses[triangleIdx] = countMisses(cache, triangleIdx);
+            if (triangleIdx == 0 || triangleMisses[triangleIdx] == 3)
+                hardBoundaries.push_back(triangleIdx);
+        }
+        hardBoundaries.push_back(numTriangles);
+    }
+
+    // Soft boundaries: split each hard cluster wherever the ACMR of the (cold cache) partial cluster drops below the
+    // threshold; drawing the clusters in any order then costs at most that much vertex cache efficiency.
+    std::vector<size_t> clusterStarts;
+    {
+        FIFOCacheSimulator cache { positions.size(), cacheSize };
+        for (size_t hardClusterIdx = 0; hardClusterIdx + 1 < hardBoundaries.size(); ++hardClusterIdx) {
+            const size_t start = hardBoundaries[hardClusterIdx], end = hardBoundaries[hardClusterIdx + 1];
+            uint32_t hardClusterMisses = 0;
+            for (size_t triangleIdx = start; triangleIdx < end; ++triangleIdx)
+                hardClusterMisses += triangleMisses[triangleIdx];
+            const float maxACMR = threshold * float(hardClusterMisses) / float(end - start);
+
+            cache.flush();
+            size_t clusterStart = start;
+            uint32_t clusterMisses = 0;
+            clusterStarts.push_back(start);
+            for (size_t triangleIdx = start; triangleIdx < end; ++triangleIdx) {
+                clusterMisses += countMisses(cache, triangleIdx);
+                if (triangleIdx + 1 < end && float(clusterMisses) <= maxACMR * float(triangleIdx + 1 - clusterStart)) {
+                    cache.flush();
+                    clusterStart = triangleIdx + 1;
+                    clusterMisses = 0;
+                    clusterStarts.push_back(clusterStart);
+                }
+            }
+        }
+        clusterStarts.push_back(numTriangles);
+    }
+
+    // Sort the clusters by how much they face away from the (area weighted) center of the mesh.
+    struct Cluster {
+        size_t start, end;
+        glm::vec3 centroid { 0.0f };
+        glm::vec3 normal { 0.0f };
+        float area = 0.0f;
+        float sortKey = 0.0f;
+    };
+    std::vector<Cluster> clusters;
+    glm::vec3 meshCentroid { 0.0f };
+    float meshArea = 0.0f;
+    for (size_t clusterIdx = 0; clusterIdx + 1 < clusterStarts.size(); ++clusterIdx) {
+        Cluster cluster { .start = clusterStarts[clusterIdx], .end = clusterStarts[clusterIdx + 1] };
+        for (size_t triangleIdx = cluster.start; triangleIdx < cluster.end; ++triangleIdx) {
+            const glm::vec3 p0 = positions[indices[3 * triangleIdx + 0]];
+            const glm::vec3 p1 = positions[indices[3 * triangleIdx + 1]];
+            const glm::vec3 p2 = positions[indices[3 * triangleIdx + 2]];
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal);
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f)
+            cluster.centroid /= cluster.area;
+        clusters.push_back(cluster);
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+    for (Cluster& cluster : clusters) {
+        if (const float length = glm::length(cluster.normal); length > 0.0f)
+            cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal / length);
+    }
+    std::stable_sort(std::begin(clusters), std::end(clusters), [](const Cluster& lhs, const Cluster& rhs) { return lhs.sortKey > rhs.sortKey; });
+
+    std::vector<uint32_t> newIndices;
+    newIndices.reserve(indices.size());
+    for (const Cluster& cluster : clusters)
+        newIndices.insert(std::end(newIndices), std::begin(indices) + 3 * cluster.start, std::begin(indices) + 3 * cluster.end);
+    std::copy(std::begin(newIndices), std::end(newIndices), std::begin(indices));
+}
+
+}
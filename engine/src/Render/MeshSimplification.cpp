@@ -0,0 +1,241 @@
+#include "Engine/Render/MeshSimplification.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/geometric.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <tbx/error_handling.h>
+#include <tuple>
+
+namespace Render {
+
+// Symmetric 4x4 matrix representing the sum of squared distances to a set of (area weighted) planes.
+// The error at position p is p^T A p + 2 b^T p + c, where A is the upper left 3x3 block.
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+    double weight = 0;
+
+    static Quadric fromTriangle(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2)
+    {
+        const glm::dvec3 normal = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+        const double length = glm::length(normal);
+        if (length == 0.0)
+            return {};
+
+        const glm::dvec3 n = normal / length;
+        const double d = -glm::dot(n, glm::dvec3(p0));
+        const double area = 0.5 * length;
+        return Quadric {
+            .a00 = area * n.x * n.x, .a01 = area * n.x * n.y, .a02 = area * n.x * n.z,
+            .a11 = area * n.y * n.y, .a12 = area * n.y * n.z, .a22 = area * n.z * n.z,
+            .b0 = area * n.x * d, .b1 = area * n.y * d, .b2 = area * n.z * d,
+            .c = area * d * d,
+            .weight = area
+        };
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    // Squared distance to the planes, averaged over their area.
+    double error(const glm::vec3& position) const
+    {
+        if (weight == 0.0)
+            return 0.0;
+        const double x = position.x, y = position.y, z = position.z;
+        const double error = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+            + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return std::max(error, 0.0) / weight;
+    }
+};
+
+// Vertices that may not be moved: vertices on open (or non-manifold) edges and vertices that share their position
+// with another vertex. The latter are the seams between different normals/texture coordinates.
+static std::vector<uint8_t> findLockedVertices(std::span<const glm::vec3> positions, std::span<const uint32_t> indices)
+{
+    std::vector<uint8_t> out(positions.size(), false);
+
+    std::vector<uint32_t> sortedVertices(positions.size());
+    std::iota(std::begin(sortedVertices), std::end(sortedVertices), 0u);
+    const auto lessPosition = [&](uint32_t lhs, uint32_t rhs) {
+        const auto& a = positions[lhs];
+        const auto& b = positions[rhs];
+        return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+    };
+    std::sort(std::begin(sortedVertices), std::end(sortedVertices), lessPosition);
+    for (size_t i = 1; i < sortedVertices.size(); ++i) {
+        if (positions[sortedVertices[i - 1]] == positions[sortedVertices[i]])
+            out[sortedVertices[i - 1]] = out[sortedVertices[i]] = true;
+    }
+
+    // Every edge of a closed manifold is shared by exactly two triangles.
+    std::vector<uint64_t> edges;
+    edges.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (uint32_t j = 0; j < 3; ++j) {
+            const uint64_t v0 = indices[i + j], v1 = indices[i + (j + 1) % 3];
+            edges.push_back(std::min(v0, v1) << 32 | std::max(v0, v1));
+        }
+    }
+    std::sort(std::begin(edges), std::end(edges));
+    for (size_t runStart = 0; runStart < edges.size();) {
+        size_t runEnd = runStart + 1;
+        while (runEnd < edges.size() && edges[runEnd] == edges[runStart])
+            ++runEnd;
+        if (runEnd - runStart != 2)
+            out[edges[runStart] >> 32] = out[edges[runStart] & 0xFFFFFFFF] = true;
+        runStart = runEnd;
+    }
+    return out;
+}
+
+static bool isDegenerate(const uint32_t* pTriangle)
+{
+    return pTriangle[0] == pTriangle[1] || pTriangle[1] == pTriangle[2] || pTriangle[2] == pTriangle[0];
+}
+
+SimplifiedMesh simplifyMesh(std::span<const glm::vec3> positions, std::span<const uint32_t> indices, size_t targetNumIndices, float maxError)
+{
+    Tbx::assert_always(indices.size() % 3 == 0);
+    SimplifiedMesh out {};
+    out.indices.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        if (!isDegenerate(&indices[i]))
+            out.indices.insert(std::end(out.indices), &indices[i], &indices[i] + 3);
+    }
+    const auto numVertices = (uint32_t)positions.size();
+
+    const auto isLocked = findLockedVertices(positions, out.indices);
+    std::vector<Quadric> quadrics(numVertices);
+    for (size_t i = 0; i < out.indices.size(); i += 3) {
+        const uint32_t* pTriangle = &out.indices[i];
+        const auto quadric = Quadric::fromTriangle(positions[pTriangle[0]], positions[pTriangle[1]], positions[pTriangle[2]]);
+        for (uint32_t j = 0; j < 3; ++j)
+            quadrics[pTriangle[j]] += quadric;
+    }
+
+    struct Collapse {
+        uint32_t from = 0, to = 0;
+        double error = std::numeric_limits<double>::infinity();
+    };
+    std::vector<Collapse> collapses, bestCollapses;
+    std::vector<uint32_t> triangleOffsets, vertexTriangles, cursors;
+    std::vector<uint8_t> isTouched;
+    const double maxErrorSquared = double(maxError) * double(maxError);
+    double largestError = 0.0;
+
+    // Each pass performs the cheapest collapses that do not touch any of the triangles changed earlier in the same
+    // pass, such that the collapse errors (computed at the start of the pass) remain valid.
+    while (out.indices.size() > targetNumIndices) {
+        // Triangles around each vertex (compressed sparse rows).
+        triangleOffsets.assign(numVertices + 1, 0);
+        for (uint32_t index : out.indices)
+            ++triangleOffsets[index + 1];
+        std::partial_sum(std::begin(triangleOffsets), std::end(triangleOffsets), std::begin(triangleOffsets));
+        vertexTriangles.resize(out.indices.size());
+        cursors.assign(std::begin(triangleOffsets), std::end(triangleOffsets) - 1);
+        for (size_t i = 0; i < out.indices.size(); ++i)
+            vertexTriangles[cursors[out.indices[i]]++] = (uint32_t)(i / 3);
+
+        // Every vertex considers collapsing onto each of its neighbours and keeps the cheapest option. Each half edge
+        // (v0 -> v1) of a closed surface has a twin (v1 -> v0) in the adjacent triangle, so both directions are covered.
+        bestCollapses.assign(numVertices, Collapse {});
+        for (size_t i = 0; i < out.indices.size(); i += 3) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                const uint32_t from = out.indices[i + j], to = out.indices[i + (j + 1) % 3];
+                if (isLocked[from])
+                    continue;
+                Quadric quadric = quadrics[from];
+                quadric += quadrics[to];
+                if (const double error = quadric.error(positions[to]); error < bestCollapses[from].error)
+                    bestCollapses[from] = { .from = from, .to = to, .error = error };
+            }
+        }
+        collapses.clear();
+        std::copy_if(std::begin(bestCollapses), std::end(bestCollapses), std::back_inserter(collapses),
+            [](const Collapse& collapse) { return collapse.error != std::numeric_limits<double>::infinity(); });
+        std::sort(std::begin(collapses), std::end(collapses), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+        const size_t numTrianglesToRemove = (out.indices.size() - targetNumIndices + 2) / 3;
+        size_t numRemovedTriangles = 0;
+        isTouched.assign(numVertices, false);
+        for (const Collapse& collapse : collapses) {
+            if (collapse.error > maxErrorSquared || numRemovedTriangles >= numTrianglesToRemove)
+                break;
+            if (isTouched[collapse.from] || isTouched[collapse.to])
+                continue;
+
+            // Reject collapses that flip (or strongly rotate) any of the remaining triangles around the vertex.
+            const auto triangles = std::span(vertexTriangles).subspan(triangleOffsets[collapse.from], triangleOffsets[collapse.from + 1] - triangleOffsets[collapse.from]);
+            const bool flipsTriangle = std::any_of(std::begin(triangles), std::end(triangles),
+                [&](uint32_t triangleIdx) {
+                    const uint32_t* pTriangle = &out.indices[3 * triangleIdx];
+                    if (std::find(pTriangle, pTriangle + 3, collapse.to) != pTriangle + 3)
+                        return false;
+                    std::array<glm::vec3, 3> corners;
+                    for (uint32_t j = 0; j < 3; ++j)
+                        corners[j] = positions[pTriangle[j]];
+                    const glm::vec3 normalBefore = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                    for (uint32_t j = 0; j < 3; ++j) {
+                        if (pTriangle[j] == collapse.from)
+                            corners[j] = positions[collapse.to];
+                    }
+                    const glm::vec3 normalAfter = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                    return glm::dot(normalBefore, normalAfter) < 0.25f * glm::length(normalBefore) * glm::length(normalAfter);
+                });
+            if (flipsTriangle)
+                continue;
+
+            for (uint32_t triangleIdx : triangles) {
+                uint32_t* pTriangle = &out.indices[3 * triangleIdx];
+                for (uint32_t j = 0; j < 3; ++j) {
+                    if (pTriangle[j] == collapse.from)
+                        pTriangle[j] = collapse.to;
+                    isTouched[pTriangle[j]] = true;
+                }
+                if (isDegenerate(pTriangle))
+                    ++numRemovedTriangles;
+            }
+            isTouched[collapse.from] = true;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            largestError = std::max(largestError, collapse.error);
+        }
+        if (numRemovedTriangles == 0)
+            break;
+
+        // Remove the triangles that collapsed into a line.
+        size_t numIndices = 0;
+        for (size_t i = 0; i < out.indices.size(); i += 3) {
+            if (isDegenerate(&out.indices[i]))
+                continue;
+            std::copy_n(&out.indices[i], 3, &out.indices[numIndices]);
+            numIndices += 3;
+        }
+        out.indices.resize(numIndices);
+    }
+
+    out.error = (float)std::sqrt(largestError);
+    return out;
+}
+
+}
@@ -0,0 +1,82 @@
+#include "Engine/Render/MeshletCulling.h"
+#include "Engine/Render/Mesh.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_access.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+
+namespace Render {
+
+uint32_t MeshletCullingStats::numVisible() const
+{
+    return numMeshlets - numOutsideFrustum - numBackFacing;
+}
+
+MeshletCullingStats& MeshletCullingStats::operator+=(const MeshletCullingStats& other)
+{
+    numMeshlets += other.numMeshlets;
+    numOutsideFrustum += other.numOutsideFrustum;
+    numBackFacing += other.numBackFacing;
+    return *this;
+}
+
+MeshletCuller::MeshletCuller(const glm::mat4& viewProjectionMatrix, const glm::vec3& cameraPosition)
+    : m_cameraPosition(cameraPosition)
+{
+    // Gribb & Hartmann plane extraction for a [0, 1] depth range (GLM_FORCE_DEPTH_ZERO_TO_ONE).
+    const auto row = [&](int i) { return glm::row(viewProjectionMatrix, i); };
+    m_frustumPlanes = {
+        row(3) + row(0), // Left
+        row(3) - row(0), // Right
+        row(3) + row(1), // Bottom
+        row(3) - row(1), // Top
+        row(2), // Near
+        row(3) - row(2) // Far
+    };
+    for (auto& plane : m_frustumPlanes)
+        plane /= glm::length(glm::vec3(plane));
+}
+
+MeshletVisibility MeshletCuller::test(const Meshlet& meshlet, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix) const
+{
+    const glm::vec3 center = modelMatrix * glm::vec4(meshlet.boundingSphereCenter, 1.0f);
+    const float scale = std::max({ glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])) });
+    const float radius = meshlet.boundingSphereRadius * scale;
+    for (const auto& plane : m_frustumPlanes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return MeshletVisibility::OutsideFrustum;
+    }
+
+    if (meshlet.coneCutoff < 1.0f) {
+        const glm::vec3 coneAxis = glm::normalize(normalMatrix * meshlet.coneAxis);
+        const glm::vec3 cameraToCenter = center - m_cameraPosition;
+        if (glm::dot(cameraToCenter, coneAxis) >= meshlet.coneCutoff * glm::length(cameraToCenter) + radius)
+            return MeshletVisibility::BackFacing;
+    }
+    return MeshletVisibility::Visible;
+}
+
+MeshletCullingStats MeshletCuller::cull(std::span<const Meshlet> meshlets, const glm::mat4& modelMatrix, const glm::mat3& normalMatrix, std::vector<uint32_t>* pVisibleMeshlets) const
+{
+    MeshletCullingStats out {};
+    out.numMeshlets = (uint32_t)meshlets.size();
+    for (uint32_t meshletIdx = 0; meshletIdx < meshlets.size(); ++meshletIdx) {
+        switch (test(meshlets[meshletIdx], modelMatrix, normalMatrix)) {
+        case MeshletVisibility::Visible: {
+            if (pVisibleMeshlets)
+                pVisibleMeshlets->push_back(meshletIdx);
+        } break;
+        case MeshletVisibility::OutsideFrustum: {
+            ++out.numOutsideFrustum;
+        } break;
+        case MeshletVisibility::BackFacing: {
+            ++out.numBackFacing;
+        } break;
+        }
+    }
+    return out;
+}
+
+}
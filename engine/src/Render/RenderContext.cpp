@@ -1,4 +1,5 @@
 #include "Engine/Render/RenderContext.h"
+#include "Engine/Core/Profiling.h"
 #include "Engine/Core/Window.h"
 #include "Engine/RenderAPI/ImGui.h"
 #include "Engine/RenderAPI/MemoryAliasing.h"
@@ -12,6 +13,9 @@ namespace Render {
 
 static constexpr uint32_t descriptorAllocBlockSize = 2048;
 static constexpr uint32_t dsvRtvDescriptorAllocBlockSize = 32;
+// Cached descriptor tables are released when evicted, so the GPU must have finished all frames that (may have) used them.
+static constexpr uint32_t descriptorTableCacheMaxUnusedFrames = 8;
+static_assert(descriptorTableCacheMaxUnusedFrames >= RenderAPI::SwapChain::s_parallelFrames);
 
 static RenderAPI::D3D12MAWrapper<D3D12MA::Allocator> createGpuMemoryAllocator(IDXGIAdapter4* pAdapter, ID3D12Device5* pDevice);
 
@@ -21,7 +25,10 @@ RenderContext::RenderContext()
     , pResourceAllocator(createGpuMemoryAllocator(pAdapter.Get(), pDevice.Get()))
     , pGraphicsQueue(RenderAPI::createCommandQueue(pDevice.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT))
     , graphicsFence(RenderAPI::createFence(pDevice.Get()))
+    , pComputeQueue(RenderAPI::createCommandQueue(pDevice.Get(), D3D12_COMMAND_LIST_TYPE_COMPUTE))
+    , computeFence(RenderAPI::createFence(pDevice.Get()))
     , commandListManager(pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT)
+    , computeCommandListManager(pDevice, D3D12_COMMAND_LIST_TYPE_COMPUTE)
     , pCbvSrvUavDescriptorBaseAllocatorCPU(std::make_unique<RenderAPI::DescriptorBlockAllocator>(
           pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, false, descriptorAllocBlockSize, 20))
     , pCbvSrvUavDescriptorBaseAllocatorGPU(std::make_unique<RenderAPI::DescriptorBlockAllocator>(
@@ -34,7 +41,9 @@ RenderContext::RenderContext()
           pDevice, pCbvSrvUavDescriptorBaseAllocatorCPU.get(), pCbvSrvUavDescriptorBaseAllocatorGPU.get())
     , rtvDescriptorAllocator(pRtvDescriptorBaseAllocatorCPU.get())
     , dsvDescriptorAllocator(pDsvDescriptorBaseAllocatorCPU.get())
+    , descriptorTableCache(pDevice, pCbvSrvUavDescriptorBaseAllocatorCPU.get(), pCbvSrvUavDescriptorBaseAllocatorGPU.get(), descriptorTableCacheMaxUnusedFrames)
     , singleFrameBufferAllocator(pDevice, 8 * 1024 * 1024, RenderAPI::SwapChain::s_parallelFrames)
+    , uploadManager(this, 64 * 1024 * 1024)
 {
     for (auto& frameFenceValue : frameFenceValues) {
         frameFenceValue = RenderAPI::insertFence(graphicsFence, pGraphicsQueue.Get());
@@ -67,9 +76,9 @@ RenderContext::~RenderContext()
     spdlog::debug("pResourceAllocator has {} used bytes at shutdown", stats.Total.Stats.AllocationBytes);
 }
 
-RenderAPI::ResourceAliasManager RenderContext::createResourceAliasManager(size_t size)
+RenderAPI::ResourceAliasManager RenderContext::createResourceAliasManager(std::span<const size_t> heapSizes)
 {
-    return RenderAPI::ResourceAliasManager(pDevice, pResourceAllocator, size, RenderAPI::SwapChain::s_parallelFrames);
+    return RenderAPI::ResourceAliasManager(pDevice, pResourceAllocator, heapSizes);
 }
 
 RenderAPI::D3D12MAResource RenderContext::createResource(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState)
@@ -93,11 +102,14 @@ RenderAPI::D3D12MAResource RenderContext::createResource(D3D12_HEAP_TYPE heapTyp
 
 void RenderContext::waitForIdle()
 {
+    uploadManager.flush();
     RenderAPI::waitForFence(graphicsFence, RenderAPI::insertFence(graphicsFence, pGraphicsQueue.Get()));
+    RenderAPI::waitForFence(computeFence, RenderAPI::insertFence(computeFence, pComputeQueue.Get()));
 }
 
 void RenderContext::waitForNextFrame() const
 {
+    PROFILE_FUNCTION();
     const uint64_t fenceValue = frameFenceValues[backBufferIndex];
     RenderAPI::waitForFence(graphicsFence, fenceValue);
 }
@@ -105,14 +117,18 @@ void RenderContext::waitForNextFrame() const
 void RenderContext::resetFrameAllocators()
 {
     getCurrentCbvSrvUavDescriptorTransientAllocator().reset();
+    cbvSrvUavDescriptorStaticAllocator.retire(graphicsFence.pFence->GetCompletedValue());
     rtvDescriptorAllocator.reset();
     dsvDescriptorAllocator.reset();
+    descriptorTableCache.newFrame();
     // getCurrentConstantsLinearBufferAllocator().reset();
     singleFrameBufferAllocator.newFrame();
+    frameAllocator.reset();
 }
 
 void RenderContext::present()
 {
+    PROFILE_FUNCTION();
     auto& outFenceValue = frameFenceValues[backBufferIndex];
     outFenceValue = RenderAPI::insertFence(graphicsFence, pGraphicsQueue.Get());
     if (optSwapChain) {
@@ -138,6 +154,8 @@ void RenderContext::resizeSwapChain(const glm::uvec2& resolution)
 void RenderContext::submitGraphicsQueue(const WRL::ComPtr<ID3D12GraphicsCommandList6>& pCommandList)
 {
     pCommandList->Close();
+    uploadManager.flush();
+    descriptorTableCache.flush();
     std::array<ID3D12CommandList*, 1> commandLists { pCommandList.Get() };
     pGraphicsQueue->ExecuteCommandLists((UINT)commandLists.size(), commandLists.data());
     commandListManager.recycleCommandList(pGraphicsQueue.Get(), pCommandList);
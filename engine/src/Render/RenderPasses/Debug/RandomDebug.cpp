@@ -33,7 +33,6 @@ void RandomDebugPass::initialize(const Render::RenderContext& renderContext)
     const auto shader = Render::loadEngineShader(renderContext.pDevice.Get(), "Engine/Debug/debug_random_cs.dxil");
     m_pRootSignature = ShaderInputs::ComputeLayout::getRootSignature(renderContext.pDevice.Get());
     const D3D12_COMPUTE_PIPELINE_STATE_DESC pipelineStateDesc { .pRootSignature = m_pRootSignature.Get(), .CS = shader };
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createComputePipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
 }
 }
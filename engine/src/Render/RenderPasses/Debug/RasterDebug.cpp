@@ -31,8 +31,7 @@ void RasterDebugPass::initialize(const Render::RenderContext& renderContext, D3D
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
 }
 
 void RasterDebugPass::execute(const FrameGraphRegistry<RasterDebugPass>& resources, const FrameGraphExecuteArgs& args)
@@ -42,7 +41,7 @@ void RasterDebugPass::execute(const FrameGraphRegistry<RasterDebugPass>& resourc
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     ShaderInputs::RasterDebug passInputs {};
     if (settings.pVisualDebugPass) {
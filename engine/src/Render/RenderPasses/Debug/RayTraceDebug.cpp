@@ -12,7 +12,7 @@ namespace Render {
 
 void RayTraceDebugPass::execute(const FrameGraphRegistry<RayTraceDebugPass>& registry, const FrameGraphExecuteArgs& args)
 {
-    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, args.pMemoryResource);
 
     ShaderInputs::RayTraceDebug inputs;
     inputs.setCamera(getRayTracingCamera(settings.pScene->camera));
@@ -37,8 +37,7 @@ void RayTraceDebugPass::initialize(const Render::RenderContext& renderContext)
         .pRootSignature = m_pRootSignature.Get(),
         .CS = shader
     };
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createComputePipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO RayTraceDebugPass");
 }
 
@@ -16,7 +16,7 @@ namespace Render {
 
 void RayTracePipelineDebugPass::execute(const FrameGraphRegistry<RayTracePipelineDebugPass>& resources, const FrameGraphExecuteArgs& args)
 {
-    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, args.pMemoryResource);
 
     ShaderInputs::RayTracePipelineDebug inputs;
     inputs.setCamera(getRayTracingCamera(settings.pScene->camera));
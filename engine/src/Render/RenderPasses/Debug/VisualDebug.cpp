@@ -160,8 +160,7 @@ void VisualDebugPass::initialize(RenderContext& renderContext, D3D12_GRAPHICS_PI
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
 
     std::array<D3D12_INDIRECT_ARGUMENT_DESC, 2> commandArguments;
     commandArguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
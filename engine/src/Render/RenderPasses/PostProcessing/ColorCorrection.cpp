@@ -52,8 +52,7 @@ void ColorCorrectionPass::initialize(const Render::RenderContext& renderContext,
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Color Correction");
 }
 
@@ -320,8 +320,7 @@ void NvidiaDenoiseDecodePass::initialize(Render::RenderContext& renderContext)
         .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
     };
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createComputePipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"Nvidia Denoise Decode");
 }
 
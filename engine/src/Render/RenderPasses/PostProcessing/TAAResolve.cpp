@@ -55,8 +55,7 @@ void TAAResolvePass::initialize(const Render::RenderContext& renderContext, D3D1
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO TAA Resolve");
 }
 
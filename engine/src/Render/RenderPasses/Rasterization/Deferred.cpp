@@ -31,7 +31,7 @@ void DeferredRenderPass::execute(const FrameGraphRegistry<DeferredRenderPass>& r
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     const auto viewProjectionMatrix = settings.pScene->camera.projectionMatrix() * settings.pScene->camera.transform.viewMatrix();
     pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -72,8 +72,7 @@ void DeferredRenderPass::initialize(Render::RenderContext& renderContext, D3D12_
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Deferred Render");
 }
 
@@ -106,8 +105,7 @@ void DeferredShadingPass::initialize(Render::RenderContext& renderContext, D3D12
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Deferred Shading");
 }
 
@@ -137,8 +135,7 @@ void SunVisibilityRTPass::initialize(Render::RenderContext& renderContext)
         .pRootSignature = m_pRootSignature.Get(),
         .CS = shader
     };
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createComputePipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO DeferredShadowsRTPass");
 }
 
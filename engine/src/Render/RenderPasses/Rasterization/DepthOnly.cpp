@@ -17,7 +17,7 @@ void DepthOnlyPass::execute(const FrameGraphRegistry<DepthOnlyPass>& resources,
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     const auto viewProjectionMatrix = settings.pScene->camera.projectionMatrix() * settings.pScene->camera.transform.viewMatrix();
     const auto lastFrameViewProjectionMatrix = settings.pScene->camera.projectionMatrix() * settings.pScene->camera.previousTransform.viewMatrix();
@@ -57,8 +57,7 @@ void DepthOnlyPass::initialize(Render::RenderContext& renderContext, D3D12_GRAPH
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     // pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
 }
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Engine/Render/RenderPasses/Rasterization/Forward.h"
 #include "Engine/Render/Camera.h"
 #include "Engine/Render/FrameGraph/FrameGraphRegistry.h"
+#include "Engine/Render/Mesh.h"
 #include "Engine/Render/RenderContext.h"
 #include "Engine/Render/RenderPasses/Shared.h"
 #include "Engine/Render/Scene.h"
@@ -12,10 +13,13 @@
 #include "Engine/RenderAPI/RenderAPI.h"
 #include <tbx/disable_all_warnings.h>
 DISABLE_WARNINGS_PUSH()
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/vec3.hpp>
 #include <imgui.h>
 DISABLE_WARNINGS_POP()
+#include <algorithm>
 #include <array>
 #include <vector>
 
@@ -30,7 +34,7 @@ void ForwardPass<SupportTAA>::execute(const FrameGraphRegistry<ForwardPass<Suppo
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     ShaderInputs::Forward forwardInputs;
     forwardInputs.setCameraPosition(settings.pScene->camera.transform.position);
@@ -44,6 +48,7 @@ void ForwardPass<SupportTAA>::execute(const FrameGraphRegistry<ForwardPass<Suppo
     const auto viewProjectionMatrix = settings.pScene->camera.projectionMatrix() * settings.pScene->camera.transform.viewMatrix();
     const auto jitteredViewProjectionMatrix = jitterMatrix * viewProjectionMatrix;
     const auto lastFrameViewProjectionMatrix = settings.pScene->camera.projectionMatrix() * settings.pScene->camera.previousTransform.viewMatrix();
+    const LODSelector lodSelector { settings.pScene->camera.fovY, (uint32_t)resolution.y, m_lodMaxPixelError };
     pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     for (const auto& instance : settings.pScene->meshInstances) {
         const auto modelMatrix = instance.transform.matrix();
@@ -69,11 +74,35 @@ void ForwardPass<SupportTAA>::execute(const FrameGraphRegistry<ForwardPass<Suppo
         pCommandList->IASetIndexBuffer(&mesh.indexBufferView);
         pCommandList->IASetVertexBuffers(0, 1, &mesh.vertexBufferView);
 
-        for (size_t i = 0; i < mesh.subMeshes.size(); ++i) {
+        // Distance from the camera to the bounds of the mesh, in the object space of the mesh (in which the LOD errors are expressed).
+        float lodDistance = 0.0f;
+        if (!mesh.lods.empty() && m_lodMaxPixelError > 0.0f) {
+            const auto bounds = instance.transform * mesh.bounds;
+            const auto cameraPosition = settings.pScene->camera.transform.position;
+            const auto offset = glm::max(glm::max(bounds.lower - cameraPosition, cameraPosition - bounds.upper), glm::vec3(0.0f));
+            const auto& scale = instance.transform.scale;
+            lodDistance = glm::length(offset) / std::max(scale.x, std::max(scale.y, scale.z));
+        }
+
+        bool isLODIndexBufferBound = false;
+        for (uint32_t i = 0; i < mesh.subMeshes.size(); ++i) {
             const auto& subMesh = mesh.subMeshes[i];
             const auto& material = mesh.materials[i];
             ShaderInputs::DefaultLayout::bindMaterialGraphics(pCommandList, material.shaderInputs);
-            pCommandList->DrawIndexedInstanced(subMesh.numIndices, 1, subMesh.indexStart, subMesh.baseVertex, 0);
+
+            const auto subMeshLODs = findSubMeshLODs(mesh.lods, i);
+            if (const uint32_t lod = lodSelector.selectLOD(subMeshLODs, lodDistance); lod > 0) {
+                const auto& subMeshLOD = subMeshLODs[lod - 1];
+                if (!isLODIndexBufferBound)
+                    pCommandList->IASetIndexBuffer(&mesh.lodIndexBufferView);
+                pCommandList->DrawIndexedInstanced(subMeshLOD.numIndices, 1, subMeshLOD.indexStart, subMesh.baseVertex, 0);
+                isLODIndexBufferBound = true;
+            } else {
+                if (isLODIndexBufferBound)
+                    pCommandList->IASetIndexBuffer(&mesh.indexBufferView);
+                pCommandList->DrawIndexedInstanced(subMesh.numIndices, 1, subMesh.indexStart, subMesh.baseVertex, 0);
+                isLODIndexBufferBound = false;
+            }
         }
     }
 }
@@ -94,8 +123,7 @@ void ForwardPass<SupportTAA>::initialize(Render::RenderContext& renderContext, D
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Forward");
 }
 
@@ -104,6 +132,7 @@ void ForwardPass<SupportTAA>::displayGUI()
 {
     if constexpr (SupportTAA)
         ImGui::SliderFloat("TAA Jitter Amplitude", &m_taaJitter, 0.0f, 1.0f);
+    ImGui::SliderFloat("LOD max pixel error", &m_lodMaxPixelError, 0.0f, 8.0f);
 }
 
 template class ForwardPass<true>;
@@ -27,7 +27,7 @@ void ForwardShadowRTPass::execute(const FrameGraphRegistry<ForwardShadowRTPass>&
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     const auto resolution = resources.getTextureResolution<"framebuffer">();
     ShaderInputs::ForwardShadowRT forwardInputs;
@@ -86,8 +86,7 @@ void ForwardShadowRTPass::initialize(Render::RenderContext& renderContext, D3D12
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Forward Shadow RT");
 }
 
@@ -38,18 +38,36 @@ void MeshShadingPass::execute(const FrameGraphRegistry<MeshShadingPass>& resourc
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, args.pMemoryResource);
 
     const auto viewMatrix = settings.pScene->camera.transform.viewMatrix();
     const auto viewProjectionMatrix = settings.pScene->camera.projectionMatrix() * viewMatrix;
     if (settings.bindless) {
         ShaderInputs::MeshShadingBindless passInput;
         passInput.setViewProjectionMatrix(viewProjectionMatrix);
-        const auto compiledInputs = passInput.generateTransientBindings(*args.pRenderContext);
-        ShaderInputs::DefaultLayout::bindInstanceGraphics(pCommandList, compiledInputs);
+        passInput.setCameraPosition(settings.pScene->camera.transform.position);
+        passInput.setMeshletCulling(settings.meshletCulling);
         ShaderInputs::DefaultLayout::bindPassGraphics(pCommandList, settings.pScene->bindlessScene);
 
-        pCommandList->DispatchMesh((uint32_t)settings.pScene->meshes.size(), 1, 1);
+        // One amplification shader group per MESHLET_CULLING_GROUP_SIZE meshlets (x) of each mesh instance (y).
+        uint32_t maxNumMeshlets = 0;
+        for (const auto& mesh : settings.pScene->meshes)
+            maxNumMeshlets = std::max(maxNumMeshlets, mesh.numMeshlets);
+        const uint32_t numMeshletGroups = (maxNumMeshlets + MESHLET_CULLING_GROUP_SIZE - 1) / MESHLET_CULLING_GROUP_SIZE;
+        const auto numMeshInstances = (uint32_t)settings.pScene->meshInstances.size();
+        Tbx::assert_always(numMeshletGroups <= 65535);
+        if (numMeshletGroups == 0)
+            return;
+
+        // D3D12 limits a dispatch to 65535 thread groups per dimension and 2^22 thread groups in total.
+        const uint32_t maxBatchSize = std::min(65535u, (1u << 22) / numMeshletGroups);
+        for (uint32_t batchStart = 0; batchStart < numMeshInstances; batchStart += maxBatchSize) {
+            const uint32_t batchSize = std::min(maxBatchSize, numMeshInstances - batchStart);
+            passInput.setBaseMeshInstance(batchStart);
+            const auto compiledInputs = passInput.generateTransientBindings(*args.pRenderContext);
+            ShaderInputs::DefaultLayout::bindInstanceGraphics(pCommandList, compiledInputs);
+            pCommandList->DispatchMesh(numMeshletGroups, batchSize, 1);
+        }
     } else {
         for (const auto& instance : settings.pScene->meshInstances) {
             const auto modelMatrix = instance.transform.matrix();
@@ -58,6 +76,8 @@ void MeshShadingPass::execute(const FrameGraphRegistry<MeshShadingPass>& resourc
 
             ShaderInputs::MeshShading instanceInput {};
             instanceInput.setMeshlets(RenderAPI::createSRVDesc<Render::Meshlet>(mesh.meshletBuffer, 0, mesh.numMeshlets));
+            instanceInput.setMeshletVertices(RenderAPI::createSRVDesc<uint32_t>(mesh.meshletVertexBuffer, 0, mesh.numMeshletVertices));
+            instanceInput.setMeshletPrimitives(RenderAPI::createSRVDesc<uint32_t>(mesh.meshletPrimitiveBuffer, 0, mesh.numMeshletPrimitiveWords));
             instanceInput.setVertices(RenderAPI::createSRVDesc<ShaderInputs::Vertex>(mesh.vertexBuffer, 0, mesh.numVertices));
             instanceInput.setModelViewProjectionMatrix(viewProjectionMatrix * modelMatrix);
             instanceInput.setModelMatrix(modelMatrix);
@@ -103,11 +123,6 @@ void MeshShadingPass::initialize(const Render::RenderContext& renderContext, D3D
     pipelineStateDesc.MS = meshShader;
     pipelineStateDesc.PS = pixelShader;
 
-    auto psoStream = CD3DX12_PIPELINE_MESH_STATE_STREAM(pipelineStateDesc);
-    D3D12_PIPELINE_STATE_STREAM_DESC streamDesc;
-    streamDesc.pPipelineStateSubobjectStream = &psoStream;
-    streamDesc.SizeInBytes = sizeof(psoStream);
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createMeshShaderPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
 }
 }
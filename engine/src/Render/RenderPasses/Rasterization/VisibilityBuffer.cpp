@@ -41,8 +41,7 @@ void VisiblityBufferRenderPass::initialize(RenderContext& renderContext, D3D12_G
     pipelineStateDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO VisiblityBufferRender");
 }
 
@@ -53,7 +52,7 @@ void VisiblityBufferRenderPass::execute(const FrameGraphRegistry<VisiblityBuffer
     pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
     pCommandList->SetPipelineState(m_pPipelineState.Get());
 
-    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    settings.pScene->transitionVertexBuffers(pCommandList, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, args.pMemoryResource);
 
     ShaderInputs::VisiblityRender passInputs;
     passInputs.setPrintSink(settings.pDebugPrintPass->getShaderInputs());
@@ -99,8 +98,7 @@ void VisiblityToGBufferPass::initialize(const Render::RenderContext& renderConte
     pipelineStateDesc.VS = vertexShader;
     pipelineStateDesc.PS = pixelShader;
 
-    RenderAPI::ThrowIfFailed(
-        renderContext.pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_pPipelineState)));
+    m_pPipelineState = renderContext.pipelineStateCache.createGraphicsPipelineState(renderContext.pDevice.Get(), pipelineStateDesc);
     m_pPipelineState->SetName(L"PSO Visibility To GBuffer");
 }
 
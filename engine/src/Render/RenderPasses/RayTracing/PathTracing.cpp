@@ -21,7 +21,7 @@ void PathTracingPass::execute(const FrameGraphRegistry<PathTracingPass>& resourc
 {
     const auto& scene = *settings.pScene;
 
-    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    settings.pScene->transitionVertexBuffers(args.pCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, args.pMemoryResource);
 
     const auto rtCamera = getRayTracingCamera(scene.camera);
 
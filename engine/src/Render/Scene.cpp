@@ -1,8 +1,11 @@
 #include "Engine/Render/Scene.h"
 #include "Engine/Render/Camera.h"
+#include "Engine/Render/GLTFAccessor.h"
 #include "Engine/Render/GPUProfiler.h"
 #include "Engine/Render/Mesh.h"
 #include "Engine/Render/RenderContext.h"
+#include "Engine/Render/SceneBinary.h"
+#include "Engine/Render/SceneConversionCache.h"
 #include "Engine/Render/ShaderInputs/inputgroups/BindlessScene.h"
 #include "Engine/Render/ShaderInputs/inputgroups/RTMesh.h"
 #include "Engine/Render/ShaderInputs/inputgroups/SinglePBRMaterial.h"
@@ -14,8 +17,8 @@
 #include "Engine/RenderAPI/Internal/D3D12Includes.h"
 #include "Engine/RenderAPI/Internal/D3D12MAHelpers.h"
 #include "Engine/RenderAPI/ShaderInput.h"
-#include "Engine/Util/BinaryReader.h"
-#include "Engine/Util/BinaryWriter.h"
+#include "Engine/Util/Align.h"
+#include "Engine/Util/ContentHash.h"
 #include "Engine/Util/IsOfType.h"
 #include "Engine/Util/Math.h"
 #include <tbx/disable_all_warnings.h>
@@ -29,11 +32,14 @@ DISABLE_WARNINGS_PUSH()
 DISABLE_WARNINGS_POP()
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstring>
 #include <exception>
 #include <execution>
 #include <fstream>
 #include <functional>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <span>
 #include <string>
@@ -45,8 +51,6 @@ DISABLE_WARNINGS_POP()
 #include <unordered_map>
 #include <unordered_set>
 
-static constexpr uint64_t binaryFileVersionNumber = 6;
-
 namespace Render {
 
 template <size_t W, size_t H>
@@ -68,12 +72,12 @@ static std::array<glm::vec2, W * H> generateTAAJitterArray()
 
 static auto taaJitterArray = generateTAAJitterArray<3, 3>();
 
-void Scene::transitionVertexBuffers(ID3D12GraphicsCommandList6* pCommandList, D3D12_RESOURCE_STATES desiredState)
+void Scene::transitionVertexBuffers(ID3D12GraphicsCommandList6* pCommandList, D3D12_RESOURCE_STATES desiredState, std::pmr::memory_resource* pMemoryResource)
 {
-    if (vertexBufferState == desiredState)
+    if ((vertexBufferState & desiredState) == desiredState)
         return;
 
-    std::vector<D3D12_RESOURCE_BARRIER> barriers(meshes.size());
+    std::pmr::vector<D3D12_RESOURCE_BARRIER> barriers(meshes.size(), pMemoryResource);
     std::transform(std::begin(meshes), std::end(meshes), std::begin(barriers),
         [&](const Mesh& mesh) {
             return CD3DX12_RESOURCE_BARRIER::Transition(mesh.vertexBuffer.Get(), vertexBufferState, desiredState);
@@ -103,7 +107,7 @@ void Scene::buildRayTracingAccelerationStructure(Render::RenderContext& renderCo
     uint32_t instanceContributionToHitGroupIndex = 0;
     std::vector<RenderAPI::D3D12MAResource> scratchBuffers;
     for (auto& mesh : meshes) {
-        std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometries;
+        std::pmr::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometries { &renderContext.frameAllocator };
         for (size_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
             const auto& subMesh = mesh.subMeshes[subMeshIdx];
             const auto& material = mesh.materials[subMeshIdx];
@@ -183,7 +187,7 @@ void Scene::buildRayTracingAccelerationStructure(Render::RenderContext& renderCo
     }
     gpuProfiler.endTask(pCommandList.Get(), buildBotLevelTask);
 
-    std::vector<D3D12_RAYTRACING_INSTANCE_DESC> instances;
+    std::pmr::vector<D3D12_RAYTRACING_INSTANCE_DESC> instances { &renderContext.frameAllocator };
     for (uint32_t instanceID = 0; instanceID < meshInstances.size(); ++instanceID) {
         auto& instance = meshInstances[instanceID];
         const auto& mesh = meshes[instance.meshIdx];
@@ -310,55 +314,11 @@ static T readJson(const nlohmann::json& json, const char* name, T defaultValue)
         return defaultValue;
 }
 
-static constexpr uint32_t GLTF_Byte = 5120;
-static constexpr uint32_t GLTF_UnsignedByte = 5121;
-static constexpr uint32_t GLTF_SignedShort = 5122;
-static constexpr uint32_t GLTF_UnsignedShort = 5123;
-static constexpr uint32_t GLTF_UnsignedInt = 5125;
-static constexpr uint32_t GLTF_Float = 5126;
-
 struct GLTFBuffers {
     std::vector<mio::mmap_source> mappedFiles;
     std::vector<std::span<const std::byte>> buffers;
 };
 
-template <typename T>
-class Iterator {
-public:
-    Iterator(const T& defaultValue)
-        : m_defaultValue(defaultValue)
-        , m_count(std::numeric_limits<size_t>::max())
-        , m_stride(0)
-    {
-    }
-    Iterator(std::span<const std::byte> data, size_t count, size_t stride, size_t sourceItemSize = sizeof(T))
-        : m_data(data)
-        , m_count(count)
-        , m_stride(stride == 0 ? sourceItemSize : stride)
-        , m_sourceItemSize(sourceItemSize)
-    {
-    }
-
-    T nextValue()
-    {
-        if (m_stride == 0) {
-            return m_defaultValue;
-        } else {
-            T out {};
-            std::memcpy(&out, &m_data[m_current * m_stride], m_sourceItemSize);
-            ++m_current;
-            return out;
-        }
-    }
-    bool isValid() const { return m_current < m_count; }
-    size_t count() const { return m_count; }
-
-private:
-    T m_defaultValue;
-    std::span<const std::byte> m_data;
-    size_t m_current = 0, m_count, m_stride, m_sourceItemSize;
-};
-
 struct BufferView {
     std::span<const std::byte> buffer;
     size_t stride = 0;
@@ -377,8 +337,7 @@ BufferView readBufferView(const nlohmann::json& jsonBufferView, const GLTFBuffer
     };
 }
 
-template <typename T>
-static Iterator<T> readAccessor(const nlohmann::json& jsonData, const GLTFBuffers& buffers, int accessorIdx, const std::filesystem::path& basePath)
+static GLTFAccessor readAccessor(const nlohmann::json& jsonData, const GLTFBuffers& buffers, int accessorIdx)
 {
     const auto& jsonAccessor = jsonData["accessors"][accessorIdx];
 
@@ -389,72 +348,54 @@ static Iterator<T> readAccessor(const nlohmann::json& jsonData, const GLTFBuffer
 
     // Parse the accessor.
     const size_t accessorByteOffset = jsonAccessor.value<size_t>("byteOffset", 0);
-    const int componentType = jsonAccessor["componentType"];
-    const bool normalized = jsonAccessor.value<bool>("normalized", false);
-    Tbx::assert_always(!normalized); // Normalization not supported yet.
-    const size_t count = jsonAccessor["count"];
-    const std::string type = jsonAccessor["type"];
     // Sparse not supported yet.
     Tbx::assert_always(jsonAccessor.find("sparse") == std::end(jsonAccessor));
 
-    // Get the subset of the buffer.
-    const auto subBuffer = bufferView.buffer.subspan(accessorByteOffset);
-
-    if constexpr (std::is_same_v<T, glm::vec2>) {
-        Tbx::assert_always(type == "VEC2");
-        Tbx::assert_always(componentType == GLTF_Float);
-        return Iterator<T>(subBuffer, count, bufferView.stride);
-    } else if constexpr (std::is_same_v<T, glm::vec3>) {
-        Tbx::assert_always(type == "VEC3");
-        Tbx::assert_always(componentType == GLTF_Float);
-        return Iterator<T>(subBuffer, count, bufferView.stride);
-    } else if constexpr (std::is_same_v<T, glm::vec4>) {
-        Tbx::assert_always(type == "VEC4");
-        Tbx::assert_always(componentType == GLTF_Float);
-        return Iterator<T>(subBuffer, count, bufferView.stride);
-    } else if constexpr (std::is_same_v<T, float>) {
-        Tbx::assert_always(type == "SCALAR");
-        Tbx::assert_always(componentType == GLTF_Float);
-        return Iterator<T>(subBuffer, count, bufferView.stride);
-    } else if constexpr (std::is_same_v<T, unsigned int>) {
-        Tbx::assert_always(type == "SCALAR");
-        if (componentType == GLTF_Byte) {
-            return Iterator<T>(subBuffer, count, bufferView.stride, sizeof(char));
-        } else if (componentType == GLTF_UnsignedByte) {
-            return Iterator<T>(subBuffer, count, bufferView.stride, sizeof(unsigned char));
-        } else if (componentType == GLTF_SignedShort) {
-            return Iterator<T>(subBuffer, count, bufferView.stride, sizeof(short));
-        } else if (componentType == GLTF_UnsignedShort) {
-            return Iterator<T>(subBuffer, count, bufferView.stride, sizeof(unsigned short));
-        } else if (componentType == GLTF_UnsignedInt) {
-            return Iterator<T>(subBuffer, count, bufferView.stride, sizeof(unsigned));
-        } else {
-            spdlog::error("Unknown GLTF component type {}", componentType);
-            return Iterator<T>({});
-        }
-    } else {
+    const std::string type = jsonAccessor["type"];
+    uint32_t numComponents = 0;
+    if (type == "SCALAR")
+        numComponents = 1;
+    else if (type == "VEC2")
+        numComponents = 2;
+    else if (type == "VEC3")
+        numComponents = 3;
+    else if (type == "VEC4")
+        numComponents = 4;
+    else
         spdlog::error("Unknown GLTF type {}", type);
-        return {};
-    }
+    Tbx::assert_always(numComponents != 0);
+
+    return GLTFAccessor {
+        .data = bufferView.buffer.subspan(accessorByteOffset),
+        .count = jsonAccessor["count"],
+        .byteStride = bufferView.stride,
+        .componentType = GLTFComponentType((int)jsonAccessor["componentType"]),
+        .numComponents = numComponents,
+        .normalized = jsonAccessor.value<bool>("normalized", false)
+    };
 }
 
-static MeshCPU readMeshCPU(const nlohmann::json& jsonData, const GLTFBuffers& buffers, const nlohmann::json& jsonMesh, const std::filesystem::path& basePath, int dummyTextureIdx)
+static MeshCPU readMeshCPU(const nlohmann::json& jsonData, const GLTFBuffers& buffers, const nlohmann::json& jsonMesh, int dummyTextureIdx)
 {
     Render::MeshCPU out {};
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
     for (const auto& jsonSubMesh : jsonMesh["primitives"]) {
         const auto& jsonAttributes = jsonSubMesh["attributes"];
-        auto indices = readAccessor<uint32_t>(jsonData, buffers, (int)jsonSubMesh["indices"], basePath);
-        auto positions = readAccessor<glm::vec3>(jsonData, buffers, (int)jsonAttributes["POSITION"], basePath);
-        auto normals = readAccessor<glm::vec3>(jsonData, buffers, (int)jsonAttributes["NORMAL"], basePath);
-        Iterator<glm::vec2> texCoords { glm::vec2(0) };
-        if (auto iterTexCoordsIdx = jsonAttributes.find("TEXCOORD_0"); iterTexCoordsIdx != std::end(jsonAttributes))
-            texCoords = readAccessor<glm::vec2>(jsonData, buffers, (int)jsonAttributes["TEXCOORD_0"], basePath);
+        const auto indicesAccessor = readAccessor(jsonData, buffers, (int)jsonSubMesh["indices"]);
+        const auto positionsAccessor = readAccessor(jsonData, buffers, (int)jsonAttributes["POSITION"]);
+        const auto normalsAccessor = readAccessor(jsonData, buffers, (int)jsonAttributes["NORMAL"]);
+        Tbx::assert_always(indicesAccessor.numComponents == 1);
+        Tbx::assert_always(positionsAccessor.numComponents == 3);
+        Tbx::assert_always(normalsAccessor.numComponents == 3);
+        const size_t numVertices = positionsAccessor.count;
+        Tbx::assert_always(normalsAccessor.count == numVertices);
 
         out.subMeshes.push_back(SubMesh {
             .indexStart = (uint32_t)out.indices.size(),
-            .numIndices = (uint32_t)indices.count(),
+            .numIndices = (uint32_t)indicesAccessor.count,
             .baseVertex = (uint32_t)out.vertices.size(),
-            .numVertices = (uint32_t)positions.count() });
+            .numVertices = (uint32_t)numVertices });
 
         const int materialIdx = jsonSubMesh.value<int>("material", -1);
         MaterialCPU material;
@@ -480,16 +421,31 @@ static MeshCPU readMeshCPU(const nlohmann::json& jsonData, const GLTFBuffers& bu
         material.alpha = roughnessFactor * roughnessFactor;
         out.materials.push_back(material);
 
+        // Decode the attributes in bulk and interleave them into the vertex array afterwards.
         const auto indexStart = out.indices.size();
-        out.indices.reserve(out.indices.size() + indices.count());
-        while (indices.isValid())
-            out.indices.push_back(indices.nextValue());
-        out.vertices.reserve(out.vertices.size() + positions.count());
-        while (positions.isValid()) {
+        out.indices.resize(indexStart + indicesAccessor.count);
+        decodeAccessor(indicesAccessor, std::span(out.indices).subspan(indexStart));
+
+        positions.resize(numVertices);
+        normals.resize(numVertices);
+        texCoords.resize(numVertices);
+        decodeAccessor(positionsAccessor, std::span(reinterpret_cast<float*>(positions.data()), numVertices * 3));
+        decodeAccessor(normalsAccessor, std::span(reinterpret_cast<float*>(normals.data()), numVertices * 3));
+        if (auto iterTexCoordsIdx = jsonAttributes.find("TEXCOORD_0"); iterTexCoordsIdx != std::end(jsonAttributes)) {
+            const auto texCoordsAccessor = readAccessor(jsonData, buffers, (int)*iterTexCoordsIdx);
+            Tbx::assert_always(texCoordsAccessor.numComponents == 2 && texCoordsAccessor.count == numVertices);
+            decodeAccessor(texCoordsAccessor, std::span(reinterpret_cast<float*>(texCoords.data()), numVertices * 2));
+        } else {
+            std::fill(std::begin(texCoords), std::end(texCoords), glm::vec2(0));
+        }
+
+        out.vertices.reserve(out.vertices.size() + numVertices);
+        for (size_t i = 0; i < numVertices; ++i) {
             out.vertices.push_back({ 
-                .pos = positions.nextValue(),
-                .normal = normals.nextValue(),
-                .texCoord = texCoords.nextValue() });
+                .pos = positions[i],
+                .normal = normals[i],
+                .texCoord = texCoords[i] });
+            out.bounds.grow(positions[i]);
         }
     }
     return out;
@@ -553,8 +509,90 @@ static void validateGLTF(const nlohmann::json& jsonData)
     }
 }
 
-static void loadFromGLX(const nlohmann::json& jsonData, std::span<const std::byte> embeddedBuffer, const std::filesystem::path& baseFilePath, Scene& scene, std::vector<MeshCPU>& meshes, std::vector<TextureCPU>& textures)
+// Estimate the size of a mesh in CPU memory (after decoding) from the GLTF accessor counts.
+static size_t estimateMeshSizeInBytes(const nlohmann::json& jsonData, const nlohmann::json& jsonMesh)
 {
+    size_t out = 0;
+    for (const auto& jsonSubMesh : jsonMesh["primitives"]) {
+        const size_t numIndices = jsonData["accessors"][(int)jsonSubMesh["indices"]]["count"];
+        const size_t numVertices = jsonData["accessors"][(int)jsonSubMesh["attributes"]["POSITION"]]["count"];
+        const size_t numMeshlets = numIndices / 3 / Meshlet::MaxNumPrimitives + 1;
+        // Meshlet vertices: the vertices of the sub mesh plus (roughly) those duplicated on meshlet boundaries. Packed primitives take one byte per index.
+        const size_t numMeshletVertices = numVertices + numMeshlets * Meshlet::MaxNumVertices / 2;
+        out += numIndices * sizeof(uint32_t) + numVertices * sizeof(ShaderInputs::Vertex) + numMeshlets * sizeof(Meshlet) + numMeshletVertices * sizeof(uint32_t) + numIndices
+            + sizeof(SubMesh) + sizeof(MaterialCPU);
+    }
+    return out;
+}
+
+// The cache key of a texture covers the encoded image and the settings used to decode it.
+static uint64_t computeTextureCacheKey(std::span<const std::byte> encodedImage, const TextureCPU::TextureReadSettings& readSettings)
+{
+    Util::ContentHasher hasher { SceneConversionCache::versionNumber };
+    hasher.add(encodedImage);
+    hasher.add(readSettings.fileType);
+    hasher.add(readSettings.colorSpaceHint);
+    hasher.add(readSettings.generateMipMaps);
+    return hasher.digest();
+}
+
+template <typename F>
+static TextureCPU readTextureCached(SceneConversionCache* pCache, std::span<const std::byte> encodedImage, const TextureCPU::TextureReadSettings& readSettings, F&& readTexture)
+{
+    if (!pCache)
+        return readTexture();
+
+    const uint64_t cacheKey = computeTextureCacheKey(encodedImage, readSettings);
+    if (auto optTexture = pCache->loadTexture(cacheKey))
+        return std::move(*optTexture);
+
+    auto texture = readTexture();
+    pCache->storeTexture(cacheKey, texture);
+    return texture;
+}
+
+// The cache key of a mesh covers the contents of the accessors & materials that it references (but not their indices
+// within the GLTF file), the meshlet settings and whether the mesh is optimized.
+static uint64_t computeMeshCacheKey(const nlohmann::json& jsonData, const GLTFBuffers& buffers, const nlohmann::json& jsonMesh, int dummyTextureIdx, bool optimizeMesh)
+{
+    Util::ContentHasher hasher { SceneConversionCache::versionNumber };
+    hasher.add(Meshlet::MaxNumVertices);
+    hasher.add(Meshlet::MaxNumPrimitives);
+    hasher.add(dummyTextureIdx);
+    hasher.add(optimizeMesh);
+
+    const auto addAccessor = [&](int accessorIdx) {
+        const auto accessor = readAccessor(jsonData, buffers, accessorIdx);
+        hasher.add(accessor.count);
+        hasher.add(accessor.byteStride);
+        hasher.add(accessor.componentType);
+        hasher.add(accessor.numComponents);
+        hasher.add(accessor.normalized);
+        if (accessor.count > 0)
+            hasher.add(accessor.data.subspan(0, (accessor.count - 1) * accessor.stride() + accessor.elementSize()));
+    };
+    for (const auto& jsonSubMesh : jsonMesh["primitives"]) {
+        const auto& jsonAttributes = jsonSubMesh["attributes"];
+        addAccessor(jsonSubMesh["indices"]);
+        addAccessor(jsonAttributes["POSITION"]);
+        addAccessor(jsonAttributes["NORMAL"]);
+        const bool hasTexCoords = jsonAttributes.contains("TEXCOORD_0");
+        hasher.add(hasTexCoords);
+        if (hasTexCoords)
+            addAccessor(jsonAttributes["TEXCOORD_0"]);
+
+        const int materialIdx = jsonSubMesh.value<int>("material", -1);
+        hasher.add(materialIdx == -1 ? std::string() : jsonData["materials"][materialIdx].dump());
+    }
+    return hasher.digest();
+}
+
+static StreamingLoadStats loadFromGLX(const nlohmann::json& jsonData, std::span<const std::byte> embeddedBuffer, const std::filesystem::path& baseFilePath, Scene& scene, SceneUploadSink& sink, const StreamingLoadSettings& settings)
+{
+    Tbx::assert_always(settings.maxParallelTextureDecodes > 0);
+    StreamingLoadStats stats {};
+    SceneConversionCache* pCache = settings.pConversionCache;
+
     spdlog::info("Scene load starting");
     validateGLTF(jsonData);
 
@@ -608,54 +646,131 @@ static void loadFromGLX(const nlohmann::json& jsonData, std::span<const std::byt
                 if (auto iterURI = jsonImage.find("uri"); iterURI != std::end(jsonImage)) {
                     const auto imagePath = baseFilePath / std::string(*iterURI);
                     textureLoadFuncs.emplace_back([=]() {
-                        return TextureCPU::readFromFile(imagePath, readSettings);
+                        const auto readTexture = [&]() { return TextureCPU::readFromFile(imagePath, readSettings); };
+                        if (!pCache)
+                            return readTexture();
+
+                        const mio::mmap_source mappedFile { imagePath.c_str() };
+                        return readTextureCached(pCache, { (const std::byte*)mappedFile.data(), mappedFile.size() }, readSettings, readTexture);
                     });
                 } else {
                     const int bufferViewIdx = jsonImage["bufferView"];
                     const auto bufferView = readBufferView(jsonData["bufferViews"][bufferViewIdx], buffers);
                     Tbx::assert_always(bufferView.stride == 0);
                     textureLoadFuncs.emplace_back([=]() {
-                        return TextureCPU::readFromBuffer(bufferView.buffer, readSettings);
+                        return readTextureCached(pCache, bufferView.buffer, readSettings,
+                            [&]() { return TextureCPU::readFromBuffer(bufferView.buffer, readSettings); });
                     });
                 }
             }
         }
-        // Load the textures in parallel on multiple threads.
-        textures.resize(textureLoadFuncs.size());
-        std::transform(std::execution::par, std::begin(textureLoadFuncs), std::end(textureLoadFuncs), std::begin(textures), [](const auto& func) { return func(); });
-
         // Add a final "dummy" white texture which can be used by materials that do not have a diffuse texture.
-        TextureCPU dummyTexture;
-        dummyTexture.resolution = glm::ivec2(8);
-        dummyTexture.isOpague = true;
-        dummyTexture.textureFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
-        dummyTexture.pixelData.resize(8 * 8 * sizeof(uint32_t), (std::byte)0xFF);
-        dummyTexture.mipLevels.push_back({ .mipLevelStart = 0, .rowPitch = 8 * sizeof(uint32_t) });
-        dummyTextureIdx = (int)textures.size();
-        textures.push_back(dummyTexture);
+        dummyTextureIdx = (int)textureLoadFuncs.size();
+        textureLoadFuncs.emplace_back([]() {
+            TextureCPU dummyTexture;
+            dummyTexture.resolution = glm::ivec2(8);
+            dummyTexture.isOpague = true;
+            dummyTexture.textureFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+            dummyTexture.pixelData.resize(8 * 8 * sizeof(uint32_t), (std::byte)0xFF);
+            dummyTexture.mipLevels.push_back({ .mipLevelStart = 0, .rowPitch = 8 * sizeof(uint32_t) });
+            return dummyTexture;
+        });
+
+        // Load groups of textures in parallel on multiple threads, handing them to the sink once the budget is reached.
+        std::vector<TextureCPU> batch;
+        size_t batchSize = 0;
+        uint32_t batchStart = 0;
+        const auto flushBatch = [&]() {
+            sink.uploadTextures(batchStart, batch);
+            ++stats.numTextureBatches;
+            batchStart += (uint32_t)batch.size();
+            batch.clear();
+            batchSize = 0;
+        };
+        for (size_t groupStart = 0; groupStart < textureLoadFuncs.size(); groupStart += settings.maxParallelTextureDecodes) {
+            const size_t groupEnd = std::min(groupStart + settings.maxParallelTextureDecodes, textureLoadFuncs.size());
+            const size_t groupOffset = batch.size();
+            batch.resize(groupOffset + (groupEnd - groupStart));
+            std::transform(std::execution::par, std::begin(textureLoadFuncs) + groupStart, std::begin(textureLoadFuncs) + groupEnd, std::begin(batch) + groupOffset, [](const auto& func) { return func(); });
+
+            for (size_t i = groupOffset; i < batch.size(); ++i)
+                batchSize += batch[i].sizeInBytes();
+            stats.peakStreamedBytes = std::max(stats.peakStreamedBytes, batchSize);
+            if (batchSize >= settings.memoryBudget)
+                flushBatch();
+        }
+        if (!batch.empty())
+            flushBatch();
     }
 
     spdlog::info("Loading meshes");
-    // Read all meshes into CPU memory so that the memory remains valid until the end of the function.
     if (const auto iterJsonMeshes = jsonData.find("meshes"); iterJsonMeshes != std::end(jsonData)) {
         std::vector<nlohmann::json> jsonMeshes(std::begin(*iterJsonMeshes), std::end(*iterJsonMeshes));
-        meshes.resize(jsonMeshes.size());
-        std::transform(std::execution::par, std::begin(jsonMeshes), std::end(jsonMeshes), std::begin(meshes),
-            [&](const nlohmann::json& jsonMesh) {
-                return readMeshCPU(jsonData, buffers, jsonMesh, baseFilePath, dummyTextureIdx);
-            });
-    }
+        std::vector<size_t> estimatedMeshSizes(jsonMeshes.size());
+        std::transform(std::begin(jsonMeshes), std::end(jsonMeshes), std::begin(estimatedMeshSizes),
+            [&](const nlohmann::json& jsonMesh) { return estimateMeshSizeInBytes(jsonData, jsonMesh); });
+
+        // The decoded size of each mesh is known up front, so batches can be formed before decoding them.
+        size_t batchStart = 0;
+        while (batchStart < jsonMeshes.size()) {
+            size_t batchEnd = batchStart + 1, estimatedBatchSize = estimatedMeshSizes[batchStart];
+            while (batchEnd < jsonMeshes.size() && estimatedBatchSize + estimatedMeshSizes[batchEnd] <= settings.memoryBudget)
+                estimatedBatchSize += estimatedMeshSizes[batchEnd++];
+
+            // Meshes that are found in the conversion cache already contain meshlets and skip the processing below.
+            std::vector<MeshCPU> batch(batchEnd - batchStart);
+            std::vector<uint64_t> cacheKeys(batch.size());
+            std::vector<size_t> uncachedMeshes(batch.size());
+            std::iota(std::begin(uncachedMeshes), std::end(uncachedMeshes), size_t(0));
+            std::vector<uint8_t> isCached(batch.size(), false);
+            std::for_each(std::execution::par, std::begin(uncachedMeshes), std::end(uncachedMeshes),
+                [&](size_t i) {
+                    const auto& jsonMesh = jsonMeshes[batchStart + i];
+                    if (pCache) {
+                        cacheKeys[i] = computeMeshCacheKey(jsonData, buffers, jsonMesh, dummyTextureIdx, settings.optimizeMeshes);
+                        if (auto optMesh = pCache->loadMesh(cacheKeys[i])) {
+                            batch[i] = std::move(*optMesh);
+                            isCached[i] = true;
+                            return;
+                        }
+                    }
+                    batch[i] = readMeshCPU(jsonData, buffers, jsonMesh, dummyTextureIdx);
+                });
+            std::erase_if(uncachedMeshes, [&](size_t i) { return isCached[i]; });
+
+            std::vector<MeshCPU*> meshletInputs(uncachedMeshes.size());
+            std::transform(std::begin(uncachedMeshes), std::end(uncachedMeshes), std::begin(meshletInputs), [&](size_t i) { return &batch[i]; });
+            if (settings.optimizeMeshes) {
+                const auto optimizeStart = std::chrono::high_resolution_clock::now();
+                stats.meshOptimization += MeshCPU::optimize(meshletInputs);
+                stats.meshOptimizationTime += std::chrono::high_resolution_clock::now() - optimizeStart;
+            }
+            const auto lodStart = std::chrono::high_resolution_clock::now();
+            MeshCPU::generateSubMeshLODs(meshletInputs);
+            stats.lodGenerationTime += std::chrono::high_resolution_clock::now() - lodStart;
+            stats.meshletTimings += MeshCPU::generateMeshlets(meshletInputs);
+            if (pCache) {
+                std::for_each(std::execution::par, std::begin(uncachedMeshes), std::end(uncachedMeshes),
+                    [&](size_t i) { pCache->storeMesh(cacheKeys[i], batch[i]); });
+            }
 
-    spdlog::info("Optimize mesh");
-    // std::for_each(std::execution::seq, std::begin(meshes), std::end(meshes), [](MeshCPU& mesh) {
-    //     mesh.removeDuplicateVertices();
-    //     mesh.optimizeIndexVertexOrder();
-    // });
+            size_t batchSize = 0;
+            for (const auto& mesh : batch) {
+                batchSize += mesh.sizeInBytes();
+                stats.meshletMemoryUsage += MeshCPUView(mesh).meshletSizeInBytes();
+                stats.legacyMeshletMemoryUsage += MeshCPUView(mesh).legacyMeshletSizeInBytes();
+                stats.numLODs += mesh.lods.size();
+                stats.lodMemoryUsage += mesh.lodIndices.size() * sizeof(uint32_t);
+                stats.vertexMemoryUsage += MeshCPUView(mesh).vertexSizeInBytes();
+                stats.compressedVertexMemoryUsage += MeshCPUView(mesh).compressedVertexSizeInBytes();
+            }
+            stats.peakStreamedBytes = std::max(stats.peakStreamedBytes, batchSize);
 
-    // spdlog::info("Generating LODs");
-    // std::for_each(std::execution::seq, std::begin(meshes), std::end(meshes), [](MeshCPU& mesh) { mesh.generateSubMeshLODs(); });
-    spdlog::info("Generating meshlets");
-    std::for_each(std::execution::seq, std::begin(meshes), std::end(meshes), [](MeshCPU& mesh) { mesh.generateMeshlets(); });
+            sink.uploadMeshes((uint32_t)batchStart, batch);
+            ++stats.numMeshBatches;
+            batchStart = batchEnd;
+        }
+    }
 
     // Recursively visit the GLTF scene graph and flatten it into a one-dimensional array.
     scene.sun.intensity = glm::vec3(1.0f);
@@ -713,18 +828,39 @@ static void loadFromGLX(const nlohmann::json& jsonData, std::span<const std::byt
     for (const int nodeIdx : jsonScene["nodes"]) {
         traverseNodes(nodeIdx, Core::Transform());
     }
-    spdlog::info("Scene load finished");
+    if (pCache) {
+        const auto cacheStats = pCache->stats();
+        spdlog::info("Conversion cache: {} mesh hits, {} mesh misses, {} texture hits, {} texture misses",
+            cacheStats.meshHits, cacheStats.meshMisses, cacheStats.textureHits, cacheStats.textureMisses);
+    }
+    const auto toMilliseconds = [](std::chrono::nanoseconds duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    spdlog::info("Meshlet generation took {:.1f}ms (summed over threads: gather {:.1f}ms, adjacency {:.1f}ms, meshlets {:.1f}ms, convert {:.1f}ms, culling data {:.1f}ms; concatenate {:.1f}ms)",
+        toMilliseconds(stats.meshletTimings.total), toMilliseconds(stats.meshletTimings.gatherPositions), toMilliseconds(stats.meshletTimings.generateAdjacency),
+        toMilliseconds(stats.meshletTimings.computeMeshlets), toMilliseconds(stats.meshletTimings.convertMeshlets), toMilliseconds(stats.meshletTimings.computeCullingData),
+        toMilliseconds(stats.meshletTimings.concatenate));
+    spdlog::info("Meshlet memory usage: {}KiB ({}KiB with fixed size meshlets)", stats.meshletMemoryUsage >> 10, stats.legacyMeshletMemoryUsage >> 10);
+    spdlog::info("Vertex memory usage: {}KiB ({}KiB with compressed vertices)", stats.vertexMemoryUsage >> 10, stats.compressedVertexMemoryUsage >> 10);
+    if (settings.optimizeMeshes) {
+        const auto& before = stats.meshOptimization.before;
+        const auto& after = stats.meshOptimization.after;
+        spdlog::info("Mesh optimization took {:.1f}ms (vertices: {} -> {}, ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}, overfetch: {:.3f} -> {:.3f})",
+            toMilliseconds(stats.meshOptimizationTime), stats.meshOptimization.numVerticesBefore, stats.meshOptimization.numVerticesAfter,
+            before.acmr(), after.acmr(), before.atvr(), after.atvr(), before.overfetch(), after.overfetch());
+    }
+    spdlog::info("LOD generation took {:.1f}ms ({} LODs, {}KiB of indices)", toMilliseconds(stats.lodGenerationTime), stats.numLODs, stats.lodMemoryUsage >> 10);
+    spdlog::info("Scene load finished (peak streamed data: {}MiB)", stats.peakStreamedBytes >> 20);
+    return stats;
 }
 
-static void loadFromGLTF_CPU(const std::filesystem::path& filePath, Scene& scene, std::vector<MeshCPU>& meshes, std::vector<TextureCPU>& textures)
+StreamingLoadStats Scene::streamFromGLTF(const std::filesystem::path& filePath, SceneUploadSink& sink, const StreamingLoadSettings& settings)
 {
     Tbx::assert_always(std::filesystem::exists(filePath));
     std::ifstream file { filePath };
     const auto jsonData = nlohmann::json::parse(file);
 
-    loadFromGLX(jsonData, {}, filePath.parent_path(), scene, meshes, textures);
+    return loadFromGLX(jsonData, {}, filePath.parent_path(), *this, sink, settings);
 }
-static void loadFromGLB_CPU(const std::filesystem::path& filePath, Scene& scene, std::vector<MeshCPU>& meshes, std::vector<TextureCPU>& textures)
+StreamingLoadStats Scene::streamFromGLB(const std::filesystem::path& filePath, SceneUploadSink& sink, const StreamingLoadSettings& settings)
 {
     struct GLBHeader {
         uint32_t magic;
@@ -764,105 +900,27 @@ static void loadFromGLB_CPU(const std::filesystem::path& filePath, Scene& scene,
         }
     }
 
-    loadFromGLX(jsonData, buffer, filePath.parent_path(), scene, meshes, textures);
+    return loadFromGLX(jsonData, buffer, filePath.parent_path(), *this, sink, settings);
 }
 
-static void uploadToGPU(Scene& scene, std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, RenderContext& renderContext);
-
-void Scene::loadFromGLTF(const std::filesystem::path& filePath, RenderContext& renderContext)
+static void createBindlessScene(Scene& scene, std::span<const std::vector<MaterialCPU>> meshMaterials, RenderContext& renderContext)
 {
-    std::vector<MeshCPU> meshesCPU;
-    std::vector<TextureCPU> texturesCPU;
-    loadFromGLTF_CPU(filePath, *this, meshesCPU, texturesCPU);
-    uploadToGPU(*this, meshesCPU, texturesCPU, renderContext);
-}
-
-void Scene::loadFromGLB(const std::filesystem::path& filePath, RenderContext& renderContext)
-{
-    std::vector<MeshCPU> meshesCPU;
-    std::vector<TextureCPU> texturesCPU;
-    loadFromGLB_CPU(filePath, *this, meshesCPU, texturesCPU);
-    uploadToGPU(*this, meshesCPU, texturesCPU, renderContext);
-}
-
-void Scene::loadFromBinary(const std::filesystem::path& filePath, RenderContext& renderContext)
-{
-    Util::BinaryReader reader { filePath };
-
-    uint64_t binaryFileVersionNumberCheck;
-    reader.read(binaryFileVersionNumberCheck);
-    Tbx::assert_always(binaryFileVersionNumberCheck == binaryFileVersionNumber);
-
-    reader.read(this->sun);
-    reader.read(this->meshInstances);
-    reader.read(this->camera);
-
-    std::vector<MeshCPU> meshesCPU;
-    std::vector<TextureCPU> texturesCPU;
-    reader.read(meshesCPU);
-    reader.read(texturesCPU);
-    uploadToGPU(*this, meshesCPU, texturesCPU, renderContext);
-}
-
-void Scene::loadFromMeshes(std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, RenderContext& renderContext)
-{
-    uploadToGPU(*this, meshesCPU, texturesCPU, renderContext);
-}
-
-static void storeBinary(Util::BinaryWriter& writer, const Scene& scene, std::span<const MeshCPU> meshes, std::span<const TextureCPU> textures)
-{
-    writer.write(binaryFileVersionNumber);
-
-    writer.write(scene.sun);
-    writer.write(scene.meshInstances);
-    writer.write(scene.camera);
-
-    writer.write(meshes);
-    writer.write(textures);
-}
-
-void Scene::glb2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath)
-{
-    Tbx::assert_always(std::filesystem::exists(inFilePath));
-
-    Scene scene;
-    std::vector<MeshCPU> meshes;
-    std::vector<TextureCPU> textures;
-    loadFromGLB_CPU(inFilePath, scene, meshes, textures);
-
-    Util::BinaryWriter writer { outFilePath };
-    storeBinary(writer, scene, meshes, textures);
-}
-
-void Scene::gltf2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath)
-{
-    Tbx::assert_always(std::filesystem::exists(inFilePath));
-
-    Scene scene;
-    std::vector<MeshCPU> meshes;
-    std::vector<TextureCPU> textures;
-    loadFromGLTF_CPU(inFilePath, scene, meshes, textures);
-
-    Util::BinaryWriter writer { outFilePath };
-    storeBinary(writer, scene, meshes, textures);
-}
-
-static void createBindlessScene(Scene& scene, std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, RenderContext& renderContext)
-{
-    Tbx::assert_always(scene.meshes.size() == meshesCPU.size());
-    Tbx::assert_always(scene.textures.size() == texturesCPU.size());
+    Tbx::assert_always(scene.meshes.size() == meshMaterials.size());
 
     std::vector<RenderAPI::SRVDesc> indexBuffers;
     std::vector<RenderAPI::SRVDesc> meshletBuffers;
+    std::vector<RenderAPI::SRVDesc> meshletVertexBuffers;
+    std::vector<RenderAPI::SRVDesc> meshletPrimitiveBuffers;
     std::vector<RenderAPI::SRVDesc> vertexBuffers;
     std::vector<ShaderInputs::BindlessMesh> meshes;
     std::vector<ShaderInputs::BindlessSubMesh> subMeshes;
     for (size_t meshIdx = 0; meshIdx < scene.meshes.size(); ++meshIdx) {
         const auto& mesh = scene.meshes[meshIdx];
-        const auto& meshCPU = meshesCPU[meshIdx];
 
         indexBuffers.push_back(RenderAPI::createSRVDesc<uint32_t>(mesh.indexBuffer, 0, mesh.numIndices));
         meshletBuffers.push_back(RenderAPI::createSRVDesc<Meshlet>(mesh.meshletBuffer, 0, mesh.numMeshlets));
+        meshletVertexBuffers.push_back(RenderAPI::createSRVDesc<uint32_t>(mesh.meshletVertexBuffer, 0, mesh.numMeshletVertices));
+        meshletPrimitiveBuffers.push_back(RenderAPI::createSRVDesc<uint32_t>(mesh.meshletPrimitiveBuffer, 0, mesh.numMeshletPrimitiveWords));
         vertexBuffers.push_back(RenderAPI::createSRVDesc<ShaderInputs::Vertex>(mesh.vertexBuffer, 0, mesh.numVertices));
 
         ShaderInputs::BindlessMesh bindlessMesh {
@@ -874,7 +932,7 @@ static void createBindlessScene(Scene& scene, std::span<const MeshCPU> meshesCPU
 
         for (size_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
             const auto& subMesh = mesh.subMeshes[subMeshIdx];
-            const auto& material = meshCPU.materials[subMeshIdx];
+            const auto& material = meshMaterials[meshIdx][subMeshIdx];
 
             ShaderInputs::BindlessSubMesh bindlessSubMesh {
                 .indexStart = subMesh.indexStart,
@@ -913,6 +971,8 @@ static void createBindlessScene(Scene& scene, std::span<const MeshCPU> meshesCPU
     ShaderInputs::BindlessScene inputs;
     inputs.setIndexBuffers(indexBuffers);
     inputs.setMeshlets(meshletBuffers);
+    inputs.setMeshletVertices(meshletVertexBuffers);
+    inputs.setMeshletPrimitives(meshletPrimitiveBuffers);
     inputs.setVertexBuffers(vertexBuffers);
     inputs.setSubMeshes(RenderAPI::createSRVDesc<ShaderInputs::BindlessSubMesh>(scene.bindlessSubMeshes, 0, (uint32_t)subMeshes.size()));
     inputs.setMeshes(RenderAPI::createSRVDesc<ShaderInputs::BindlessMesh>(scene.bindlessMeshes, 0, (uint32_t)meshes.size()));
@@ -921,88 +981,212 @@ static void createBindlessScene(Scene& scene, std::span<const MeshCPU> meshesCPU
     scene.bindlessScene = inputs.generatePersistentBindings(renderContext);
 }
 
-static void uploadToGPU(Scene& scene, std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, RenderContext& renderContext)
-{
-    // Upload all textures to the GPU.
-    spdlog::info("Uploading textures");
-    size_t textureMemoryUsage = 0;
-    scene.textures.clear();
-    for (const auto& textureCPU : texturesCPU) {
-        if (textureCPU.pixelData.empty()) {
-            scene.textures.emplace_back();
-            continue;
+// Uploads meshes & textures to the GPU as they arrive and creates the bindless scene once all meshes are uploaded.
+class GPUSceneUploadSink : public SceneUploadSink {
+public:
+    GPUSceneUploadSink(Scene& scene, RenderContext& renderContext)
+        : m_scene(scene)
+        , m_renderContext(renderContext)
+    {
+        m_scene.textures.clear();
+    }
+
+    void uploadTextures(uint32_t firstTextureIdx, std::span<TextureCPU> texturesCPU) override
+    {
+        const std::vector<TextureCPUView> textureViews(std::begin(texturesCPU), std::end(texturesCPU));
+        uploadTextureViews(firstTextureIdx, textureViews);
+    }
+    void uploadMeshes(uint32_t firstMeshIdx, std::span<MeshCPU> meshesCPU) override
+    {
+        const std::vector<MeshCPUView> meshViews(std::begin(meshesCPU), std::end(meshesCPU));
+        uploadMeshViews(firstMeshIdx, meshViews);
+    }
+
+    void uploadTextureViews(uint32_t firstTextureIdx, std::span<const TextureCPUView> texturesCPU)
+    {
+        Tbx::assert_always(firstTextureIdx == m_scene.textures.size());
+        for (const auto& textureCPU : texturesCPU) {
+            m_textureIsOpague.push_back(textureCPU.isOpague);
+            if (textureCPU.pixelData.empty()) {
+                m_scene.textures.emplace_back();
+                continue;
+            }
+
+            m_textureMemoryUsage += textureCPU.pixelData.size();
+            m_scene.textures.push_back(Texture::uploadToGPU(textureCPU, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, m_renderContext));
         }
 
-        textureMemoryUsage += textureCPU.pixelData.size();
-        scene.textures.push_back(Texture::uploadToGPU(textureCPU, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, renderContext));
+        // Ensure all material descriptors have been copied to the GPU. Start copying the textures while the CPU continues
+        // with the next batch; finish() waits for all uploads.
+        m_renderContext.cbvSrvUavDescriptorStaticAllocator.flush();
+        m_renderContext.uploadManager.flush();
     }
-    spdlog::info("Texture memory usage: {}MiB", textureMemoryUsage >> 20);
 
-    // Ensure all material descriptors have been copied to the GPU.
-    renderContext.cbvSrvUavDescriptorStaticAllocator.flush();
-    renderContext.waitForIdle();
+    void uploadMeshViews(uint32_t firstMeshIdx, std::span<const MeshCPUView> meshesCPU)
+    {
+        Tbx::assert_always(firstMeshIdx == m_meshMaterials.size());
+        for (const auto& meshCPU : meshesCPU) {
+            Render::Mesh meshGPU;
+            meshGPU.indexBuffer = m_renderContext.createBufferWithArrayData<uint32_t>(meshCPU.indices, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+            meshGPU.indexBuffer->SetName(L"IndexBuffer");
+            meshGPU.indexBufferView = D3D12_INDEX_BUFFER_VIEW {
+                .BufferLocation = meshGPU.indexBuffer->GetGPUVirtualAddress(),
+                .SizeInBytes = (unsigned)(meshCPU.indices.size() * sizeof(uint32_t)),
+                .Format = DXGI_FORMAT_R32_UINT
+            };
+            meshGPU.vertexBuffer = m_renderContext.createBufferWithArrayData<ShaderInputs::Vertex>(meshCPU.vertices, D3D12_RESOURCE_FLAG_NONE, Scene::vertexBufferReadState);
+            meshGPU.vertexBuffer->SetName(L"VertexBuffer");
+            meshGPU.vertexBufferView = D3D12_VERTEX_BUFFER_VIEW {
+                .BufferLocation = meshGPU.vertexBuffer->GetGPUVirtualAddress(),
+                .SizeInBytes = (unsigned)(meshCPU.vertices.size() * sizeof(ShaderInputs::Vertex)),
+                .StrideInBytes = sizeof(ShaderInputs::Vertex)
+            };
 
-    // Upload all meshes to the GPU.
-    spdlog::info("Uploading meshes");
-    size_t numOpague = 0, numTransparent = 0;
-    size_t meshMemoryUsage = 0;
-    for (const auto& meshCPU : meshesCPU) {
-        Render::Mesh meshGPU;
-        meshGPU.indexBuffer = renderContext.createBufferWithArrayData<uint32_t>(meshCPU.indices, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_INDEX_BUFFER);
-        meshGPU.indexBuffer->SetName(L"IndexBuffer");
-        meshGPU.indexBufferView = D3D12_INDEX_BUFFER_VIEW {
-            .BufferLocation = meshGPU.indexBuffer->GetGPUVirtualAddress(),
-            .SizeInBytes = (unsigned)(meshCPU.indices.size() * sizeof(uint32_t)),
-            .Format = DXGI_FORMAT_R32_UINT
-        };
-        meshGPU.vertexBuffer = renderContext.createBufferWithArrayData<ShaderInputs::Vertex>(meshCPU.vertices, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
-        meshGPU.vertexBuffer->SetName(L"VertexBuffer");
-        meshGPU.vertexBufferView = D3D12_VERTEX_BUFFER_VIEW {
-            .BufferLocation = meshGPU.vertexBuffer->GetGPUVirtualAddress(),
-            .SizeInBytes = (unsigned)(meshCPU.vertices.size() * sizeof(ShaderInputs::Vertex)),
-            .StrideInBytes = sizeof(ShaderInputs::Vertex)
-        };
+            if (!meshCPU.lodIndices.empty()) {
+                meshGPU.lodIndexBuffer = m_renderContext.createBufferWithArrayData<uint32_t>(meshCPU.lodIndices, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+                meshGPU.lodIndexBuffer->SetName(L"LODIndexBuffer");
+                meshGPU.lodIndexBufferView = D3D12_INDEX_BUFFER_VIEW {
+                    .BufferLocation = meshGPU.lodIndexBuffer->GetGPUVirtualAddress(),
+                    .SizeInBytes = (unsigned)(meshCPU.lodIndices.size() * sizeof(uint32_t)),
+                    .Format = DXGI_FORMAT_R32_UINT
+                };
+            }
 
-        meshGPU.meshletBuffer = renderContext.createBufferWithArrayData<Meshlet>(meshCPU.meshlets, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-        meshGPU.meshletBuffer->SetName(L"MeshletBuffer");
-
-        meshGPU.numIndices = (uint32_t)meshCPU.indices.size();
-        meshGPU.numMeshlets = (uint32_t)meshCPU.meshlets.size();
-        meshGPU.numVertices = (uint32_t)meshCPU.vertices.size();
-        meshGPU.vertexStride = (uint32_t)sizeof(ShaderInputs::Vertex);
-        // meshGPU.bounds = meshCPU.bounds;
-        meshGPU.subMeshes = meshCPU.subMeshes;
-        meshMemoryUsage += meshGPU.indexBufferView.SizeInBytes + meshGPU.vertexBufferView.SizeInBytes;
-
-        for (const MaterialCPU& materialCPU : meshCPU.materials) {
-            const auto isOpague = texturesCPU[materialCPU.baseColorTextureIdx].isOpague;
-
-            if (isOpague)
-                ++numOpague;
-            else
-                ++numTransparent;
-
-            ShaderInputs::SinglePBRMaterial shaderMaterial;
-            shaderMaterial.setMaterial(materialCPU);
-            shaderMaterial.setBaseColorTexture(scene.textures[materialCPU.baseColorTextureIdx]);
-            meshGPU.materials.push_back(Material {
-                .shaderInputs = shaderMaterial.generatePersistentBindings(renderContext),
-                .isOpague = isOpague });
+            meshGPU.meshletBuffer = m_renderContext.createBufferWithArrayData<Meshlet>(meshCPU.meshlets, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            meshGPU.meshletBuffer->SetName(L"MeshletBuffer");
+            meshGPU.meshletVertexBuffer = m_renderContext.createBufferWithArrayData<uint32_t>(meshCPU.meshletVertices, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            meshGPU.meshletVertexBuffer->SetName(L"MeshletVertexBuffer");
+            // The shaders read the packed primitives as 32-bit words and always load the word after the one containing
+            // the first byte of a triangle, so pad the buffer with one extra word.
+            std::vector<uint32_t> meshletPrimitiveWords(Util::roundUpToClosestMultiple(meshCPU.meshletPrimitives.size(), sizeof(uint32_t)) / sizeof(uint32_t) + 1, 0);
+            std::memcpy(meshletPrimitiveWords.data(), meshCPU.meshletPrimitives.data(), meshCPU.meshletPrimitives.size());
+            meshGPU.meshletPrimitiveBuffer = m_renderContext.createBufferWithArrayData<uint32_t>(meshletPrimitiveWords, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            meshGPU.meshletPrimitiveBuffer->SetName(L"MeshletPrimitiveBuffer");
+
+            meshGPU.numIndices = (uint32_t)meshCPU.indices.size();
+            meshGPU.numMeshlets = (uint32_t)meshCPU.meshlets.size();
+            meshGPU.numMeshletVertices = (uint32_t)meshCPU.meshletVertices.size();
+            meshGPU.numMeshletPrimitiveWords = (uint32_t)meshletPrimitiveWords.size();
+            meshGPU.numVertices = (uint32_t)meshCPU.vertices.size();
+            meshGPU.vertexStride = (uint32_t)sizeof(ShaderInputs::Vertex);
+            meshGPU.bounds = meshCPU.bounds;
+            meshGPU.subMeshes.assign(std::begin(meshCPU.subMeshes), std::end(meshCPU.subMeshes));
+            meshGPU.lods.assign(std::begin(meshCPU.lods), std::end(meshCPU.lods));
+            m_meshMemoryUsage += meshGPU.indexBufferView.SizeInBytes + meshGPU.vertexBufferView.SizeInBytes + meshCPU.lodIndices.size_bytes();
+            m_meshletMemoryUsage += meshCPU.meshletSizeInBytes();
+            m_legacyMeshletMemoryUsage += meshCPU.legacyMeshletSizeInBytes();
+
+            for (const MaterialCPU& materialCPU : meshCPU.materials) {
+                const bool isOpague = m_textureIsOpague[materialCPU.baseColorTextureIdx];
+
+                if (isOpague)
+                    ++m_numOpague;
+                else
+                    ++m_numTransparent;
+
+                ShaderInputs::SinglePBRMaterial shaderMaterial;
+                shaderMaterial.setMaterial(materialCPU);
+                shaderMaterial.setBaseColorTexture(m_scene.textures[materialCPU.baseColorTextureIdx]);
+                meshGPU.materials.push_back(Material {
+                    .shaderInputs = shaderMaterial.generatePersistentBindings(m_renderContext),
+                    .isOpague = isOpague });
+            }
+            m_meshMaterials.emplace_back(std::begin(meshCPU.materials), std::end(meshCPU.materials));
+            m_scene.meshes.push_back(std::move(meshGPU));
         }
-        scene.meshes.push_back(std::move(meshGPU));
     }
-    scene.vertexBufferState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
 
-    // Create a bindless version of the scene
-    createBindlessScene(scene, meshesCPU, texturesCPU, renderContext);
+    void finish()
+    {
+        m_scene.vertexBufferState = Scene::vertexBufferReadState;
 
-    spdlog::info("Mesh memory usage: {}MiB", meshMemoryUsage >> 20);
-    Tbx::assert_always(scene.meshes.size() == meshesCPU.size());
-    spdlog::info("{} opague; {} transparent", numOpague, numTransparent);
+        // Create a bindless version of the scene
+        createBindlessScene(m_scene, m_meshMaterials, m_renderContext);
 
-    // Ensure all material descriptors have been copied to the GPU.
-    renderContext.cbvSrvUavDescriptorStaticAllocator.flush();
-    renderContext.waitForIdle();
+        spdlog::info("Texture memory usage: {}MiB", m_textureMemoryUsage >> 20);
+        spdlog::info("Mesh memory usage: {}MiB", m_meshMemoryUsage >> 20);
+        spdlog::info("Meshlet memory usage: {}MiB ({}MiB with fixed size meshlets)", m_meshletMemoryUsage >> 20, m_legacyMeshletMemoryUsage >> 20);
+        spdlog::info("{} opague; {} transparent", m_numOpague, m_numTransparent);
+
+        // Ensure all material descriptors have been copied to the GPU.
+        m_renderContext.cbvSrvUavDescriptorStaticAllocator.flush();
+        m_renderContext.waitForIdle();
+    }
+
+private:
+    Scene& m_scene;
+    RenderContext& m_renderContext;
+
+    std::vector<bool> m_textureIsOpague;
+    std::vector<std::vector<MaterialCPU>> m_meshMaterials;
+    size_t m_textureMemoryUsage = 0, m_meshMemoryUsage = 0;
+    size_t m_meshletMemoryUsage = 0, m_legacyMeshletMemoryUsage = 0;
+    size_t m_numOpague = 0, m_numTransparent = 0;
+};
+
+static void uploadToGPU(Scene& scene, std::span<const MeshCPUView> meshesCPU, std::span<const TextureCPUView> texturesCPU, RenderContext& renderContext)
+{
+    GPUSceneUploadSink sink { scene, renderContext };
+    spdlog::info("Uploading textures");
+    sink.uploadTextureViews(0, texturesCPU);
+    spdlog::info("Uploading meshes");
+    sink.uploadMeshViews(0, meshesCPU);
+    sink.finish();
+}
+
+void Scene::loadFromGLTF(const std::filesystem::path& filePath, RenderContext& renderContext, const StreamingLoadSettings& settings)
+{
+    GPUSceneUploadSink sink { *this, renderContext };
+    streamFromGLTF(filePath, sink, settings);
+    sink.finish();
+}
+
+void Scene::loadFromGLB(const std::filesystem::path& filePath, RenderContext& renderContext, const StreamingLoadSettings& settings)
+{
+    GPUSceneUploadSink sink { *this, renderContext };
+    streamFromGLB(filePath, sink, settings);
+    sink.finish();
+}
+
+void Scene::loadFromBinary(const std::filesystem::path& filePath, RenderContext& renderContext)
+{
+    // Meshes & textures point directly into the memory mapped file, which stays mapped until the upload has finished.
+    const auto sceneBinary = SceneBinary::load(filePath);
+    this->sun = sceneBinary.sun;
+    this->meshInstances = sceneBinary.meshInstances;
+    this->camera = sceneBinary.camera;
+    uploadToGPU(*this, sceneBinary.meshes, sceneBinary.textures, renderContext);
+}
+
+void Scene::loadFromMeshes(std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, RenderContext& renderContext)
+{
+    const std::vector<MeshCPUView> meshViews(std::begin(meshesCPU), std::end(meshesCPU));
+    const std::vector<TextureCPUView> textureViews(std::begin(texturesCPU), std::end(texturesCPU));
+    uploadToGPU(*this, meshViews, textureViews, renderContext);
+}
+
+StreamingLoadStats Scene::glb2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath, const StreamingLoadSettings& settings, VertexFormat vertexFormat)
+{
+    Tbx::assert_always(std::filesystem::exists(inFilePath));
+
+    Scene scene;
+    CPUSceneUploadSink sink {};
+    const auto stats = scene.streamFromGLB(inFilePath, sink, settings);
+
+    SceneBinary::store(outFilePath, scene, sink.meshes, sink.textures, vertexFormat);
+    return stats;
+}
+
+StreamingLoadStats Scene::gltf2binary(const std::filesystem::path& inFilePath, const std::filesystem::path& outFilePath, const StreamingLoadSettings& settings, VertexFormat vertexFormat)
+{
+    Tbx::assert_always(std::filesystem::exists(inFilePath));
+
+    Scene scene;
+    CPUSceneUploadSink sink {};
+    const auto stats = scene.streamFromGLTF(inFilePath, sink, settings);
+
+    SceneBinary::store(outFilePath, scene, sink.meshes, sink.textures, vertexFormat);
+    return stats;
 }
 
 }
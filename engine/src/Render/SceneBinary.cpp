@@ -0,0 +1,191 @@
+#include "Engine/Render/SceneBinary.h"
+#include "Engine/Util/BinaryReader.h"
+#include "Engine/Util/BinaryWriter.h"
+#include "Engine/Util/ErrorHandling.h"
+#include "Engine/Util/MappedBinaryReader.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <tbx/error_handling.h>
+
+namespace Render {
+
+// Version 6: MeshCPU as written by the stream based BinaryWriter, using fixed size meshlets.
+static MeshCPU readLegacyMesh(Util::BinaryReader& reader)
+{
+    MeshCPU out {};
+    reader.read(out.vertices);
+    reader.read(out.indices);
+    Tbx::assert_always(reader.read<uint32_t>() == Meshlet::MaxNumPrimitives);
+    Tbx::assert_always(reader.read<uint32_t>() == Meshlet::MaxNumVertices);
+    out.setMeshlets(reader.read<std::vector<LegacyMeshlet>>());
+    reader.read(out.bounds);
+    reader.read(out.subMeshes);
+    reader.read(out.materials);
+    return out;
+}
+
+// Version 7: MeshCPUView with aligned payloads, using fixed size meshlets.
+static MeshCPU readLegacyMesh(Util::MappedBinaryReader& reader)
+{
+    Tbx::assert_always(reader.read<uint32_t>() == Meshlet::MaxNumPrimitives);
+    Tbx::assert_always(reader.read<uint32_t>() == Meshlet::MaxNumVertices);
+
+    MeshCPU out {};
+    reader.read(out.bounds);
+    const auto vertices = reader.readAligned<ShaderInputs::Vertex>();
+    const auto indices = reader.readAligned<uint32_t>();
+    const auto legacyMeshlets = reader.readAligned<LegacyMeshlet>();
+    const auto subMeshes = reader.readAligned<SubMesh>();
+    const auto materials = reader.readAligned<MaterialCPU>();
+    out.vertices.assign(std::begin(vertices), std::end(vertices));
+    out.indices.assign(std::begin(indices), std::end(indices));
+    out.setMeshlets(legacyMeshlets);
+    out.subMeshes.assign(std::begin(subMeshes), std::end(subMeshes));
+    out.materials.assign(std::begin(materials), std::end(materials));
+    return out;
+}
+
+// MeshCPUView and TextureCPUView only contain spans & PODs, so they are trivially copyable. Writing/reading a vector of
+// them directly would copy the (heap) pointers; call writeTo/readFrom explicitly such that the payloads are stored instead.
+template <typename T>
+static void writeViews(Util::BinaryWriter& writer, std::span<const T> items)
+{
+    writer.write(items.size());
+    for (const auto& item : items)
+        item.writeTo(writer);
+}
+
+template <typename T>
+static std::vector<T> readViews(Util::MappedBinaryReader& reader)
+{
+    std::vector<T> out(reader.read<size_t>());
+    for (auto& item : out)
+        item.readFrom(reader);
+    return out;
+}
+
+template <typename Reader>
+static std::vector<MeshCPU> readLegacyMeshes(Reader& reader)
+{
+    std::vector<MeshCPU> out(reader.template read<size_t>());
+    for (auto& mesh : out)
+        mesh = readLegacyMesh(reader);
+    return out;
+}
+
+// Every sub mesh gets its own quantization grid, such that small sub meshes of large meshes keep their precision.
+static void compressVertices(const MeshCPU& mesh, std::vector<CompressedVertex>& compressedVertices, std::vector<VertexQuantization>& vertexQuantizations)
+{
+    compressedVertices.resize(mesh.vertices.size());
+    vertexQuantizations.resize(mesh.subMeshes.size());
+    for (size_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+        const auto& subMesh = mesh.subMeshes[subMeshIdx];
+        const auto vertices = std::span(mesh.vertices).subspan(subMesh.baseVertex, subMesh.numVertices);
+        vertexQuantizations[subMeshIdx] = VertexQuantization::fromVertices(vertices);
+        encodeVertices(vertices, vertexQuantizations[subMeshIdx], std::span(compressedVertices).subspan(subMesh.baseVertex, subMesh.numVertices));
+    }
+}
+
+static std::vector<ShaderInputs::Vertex> decompressVertices(const MeshCPUView& mesh)
+{
+    Tbx::assert_always(mesh.vertexQuantizations.size() == mesh.subMeshes.size());
+    std::vector<ShaderInputs::Vertex> out(mesh.compressedVertices.size());
+    for (size_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+        const auto& subMesh = mesh.subMeshes[subMeshIdx];
+        decodeVertices(mesh.compressedVertices.subspan(subMesh.baseVertex, subMesh.numVertices), mesh.vertexQuantizations[subMeshIdx],
+            std::span(out).subspan(subMesh.baseVertex, subMesh.numVertices));
+    }
+    return out;
+}
+
+SceneBinary SceneBinary::load(const std::filesystem::path& filePath)
+{
+    Tbx::assert_always(std::filesystem::exists(filePath));
+
+    SceneBinary out {};
+    auto& mappedFile = out.m_optMappedFile.emplace(filePath);
+    mappedFile.read(out.fileVersionNumber);
+
+    if (out.fileVersionNumber == versionNumber) {
+        mappedFile.read(out.sun);
+        mappedFile.read(out.meshInstances);
+        mappedFile.read(out.camera);
+        out.meshes = readViews<MeshCPUView>(mappedFile);
+        out.textures = readViews<TextureCPUView>(mappedFile);
+
+        out.m_decodedVertices.resize(out.meshes.size());
+        std::vector<size_t> meshIndices(out.meshes.size());
+        std::iota(std::begin(meshIndices), std::end(meshIndices), size_t(0));
+        std::for_each(std::execution::par, std::begin(meshIndices), std::end(meshIndices),
+            [&](size_t meshIdx) {
+                auto& mesh = out.meshes[meshIdx];
+                if (mesh.compressedVertices.empty())
+                    return;
+                out.m_decodedVertices[meshIdx] = decompressVertices(mesh);
+                mesh.vertices = out.m_decodedVertices[meshIdx];
+            });
+    } else if (out.fileVersionNumber == legacyMeshletVersionNumber) {
+        spdlog::warn("Loading scene binary with legacy meshlets (version {}); regenerate the file for faster loading", legacyMeshletVersionNumber);
+        mappedFile.read(out.sun);
+        mappedFile.read(out.meshInstances);
+        mappedFile.read(out.camera);
+        out.m_legacyMeshes = readLegacyMeshes(mappedFile);
+        out.textures = readViews<TextureCPUView>(mappedFile);
+
+        out.meshes.assign(std::begin(out.m_legacyMeshes), std::end(out.m_legacyMeshes));
+    } else if (out.fileVersionNumber == legacyVersionNumber) {
+        spdlog::warn("Loading legacy scene binary (version {}); regenerate the file for faster loading", legacyVersionNumber);
+        out.m_optMappedFile.reset();
+
+        Util::BinaryReader reader { filePath };
+        reader.read<uint64_t>();
+        reader.read(out.sun);
+        reader.read(out.meshInstances);
+        reader.read(out.camera);
+        out.m_legacyMeshes = readLegacyMeshes(reader);
+        reader.read(out.m_legacyTextures);
+
+        out.meshes.assign(std::begin(out.m_legacyMeshes), std::end(out.m_legacyMeshes));
+        out.textures.assign(std::begin(out.m_legacyTextures), std::end(out.m_legacyTextures));
+    } else {
+        Util::ThrowError(fmt::format("Unsupported scene binary version {}", out.fileVersionNumber));
+    }
+    return out;
+}
+
+void SceneBinary::store(const std::filesystem::path& filePath, const Scene& scene, std::span<const MeshCPU> meshesCPU, std::span<const TextureCPU> texturesCPU, VertexFormat vertexFormat)
+{
+    std::vector<MeshCPUView> meshes(std::begin(meshesCPU), std::end(meshesCPU));
+    const std::vector<TextureCPUView> textures(std::begin(texturesCPU), std::end(texturesCPU));
+
+    std::vector<std::vector<CompressedVertex>> compressedVertices(meshes.size());
+    std::vector<std::vector<VertexQuantization>> vertexQuantizations(meshes.size());
+    if (vertexFormat == VertexFormat::Compressed) {
+        std::vector<size_t> meshIndices(meshes.size());
+        std::iota(std::begin(meshIndices), std::end(meshIndices), size_t(0));
+        std::for_each(std::execution::par, std::begin(meshIndices), std::end(meshIndices),
+            [&](size_t meshIdx) {
+                compressVertices(meshesCPU[meshIdx], compressedVertices[meshIdx], vertexQuantizations[meshIdx]);
+                meshes[meshIdx].compressedVertices = compressedVertices[meshIdx];
+                meshes[meshIdx].vertexQuantizations = vertexQuantizations[meshIdx];
+            });
+    }
+
+    Util::BinaryWriter writer { filePath };
+    writer.write(versionNumber);
+
+    writer.write(scene.sun);
+    writer.write(scene.meshInstances);
+    writer.write(scene.camera);
+
+    writeViews<MeshCPUView>(writer, meshes);
+    writeViews<TextureCPUView>(writer, textures);
+}
+
+}
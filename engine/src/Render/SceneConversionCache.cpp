@@ -0,0 +1,94 @@
+#include "Engine/Render/SceneConversionCache.h"
+#include "Engine/Render/Mesh.h"
+#include "Engine/Render/Texture.h"
+#include "Engine/Util/BinaryReader.h"
+#include "Engine/Util/BinaryWriter.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+DISABLE_WARNINGS_POP()
+#include <system_error>
+
+namespace Render {
+
+SceneConversionCache::SceneConversionCache(const std::filesystem::path& cacheDirectory)
+    : m_cacheDirectory(cacheDirectory)
+{
+    std::filesystem::create_directories(m_cacheDirectory);
+}
+
+std::optional<MeshCPU> SceneConversionCache::loadMesh(uint64_t key)
+{
+    auto optMesh = load<MeshCPU>(key, ".mesh");
+    (optMesh ? m_meshHits : m_meshMisses).fetch_add(1, std::memory_order_relaxed);
+    return optMesh;
+}
+
+void SceneConversionCache::storeMesh(uint64_t key, const MeshCPU& mesh)
+{
+    store(key, ".mesh", mesh);
+}
+
+std::optional<TextureCPU> SceneConversionCache::loadTexture(uint64_t key)
+{
+    auto optTexture = load<TextureCPU>(key, ".texture");
+    (optTexture ? m_textureHits : m_textureMisses).fetch_add(1, std::memory_order_relaxed);
+    return optTexture;
+}
+
+void SceneConversionCache::storeTexture(uint64_t key, const TextureCPU& texture)
+{
+    store(key, ".texture", texture);
+}
+
+SceneConversionCacheStats SceneConversionCache::stats() const
+{
+    return SceneConversionCacheStats {
+        .meshHits = m_meshHits.load(),
+        .meshMisses = m_meshMisses.load(),
+        .textureHits = m_textureHits.load(),
+        .textureMisses = m_textureMisses.load()
+    };
+}
+
+std::filesystem::path SceneConversionCache::entryFilePath(uint64_t key, const char* extension) const
+{
+    return m_cacheDirectory / fmt::format("{:016x}{}", key, extension);
+}
+
+template <typename T>
+std::optional<T> SceneConversionCache::load(uint64_t key, const char* extension)
+{
+    const auto filePath = entryFilePath(key, extension);
+    if (!std::filesystem::exists(filePath))
+        return {};
+
+    Util::BinaryReader reader { filePath };
+    if (reader.read<uint32_t>() != versionNumber)
+        return {};
+    return reader.read<T>();
+}
+
+template <typename T>
+void SceneConversionCache::store(uint64_t key, const char* extension, const T& item)
+{
+    // Write to a temporary file first so that other threads/processes never observe a partially written entry.
+    const auto filePath = entryFilePath(key, extension);
+    auto tmpFilePath = filePath;
+    tmpFilePath += fmt::format(".{}.tmp", m_tmpFileCounter.fetch_add(1));
+    {
+        Util::BinaryWriter writer { tmpFilePath };
+        writer.write(versionNumber);
+        writer.write(item);
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(tmpFilePath, filePath, errorCode);
+    if (errorCode) {
+        spdlog::warn("Failed to store conversion cache entry {}: {}", filePath.string(), errorCode.message());
+        std::filesystem::remove(tmpFilePath, errorCode);
+    }
+}
+
+}
@@ -0,0 +1,33 @@
+#include "Engine/Render/SceneStreaming.h"
+#include <tbx/error_handling.h>
+
+namespace Render {
+
+CPUSceneUploadSink::CPUSceneUploadSink(bool keepItems)
+    : m_keepItems(keepItems)
+{
+}
+
+void CPUSceneUploadSink::uploadTextures(uint32_t firstTextureIdx, std::span<TextureCPU> texturesCPU)
+{
+    Tbx::assert_always(firstTextureIdx == numTextures);
+    for (auto& texture : texturesCPU) {
+        numTextureBytes += texture.sizeInBytes();
+        if (m_keepItems)
+            textures.emplace_back(std::move(texture));
+    }
+    numTextures += (uint32_t)texturesCPU.size();
+}
+
+void CPUSceneUploadSink::uploadMeshes(uint32_t firstMeshIdx, std::span<MeshCPU> meshesCPU)
+{
+    Tbx::assert_always(firstMeshIdx == numMeshes);
+    for (auto& mesh : meshesCPU) {
+        numMeshBytes += mesh.sizeInBytes();
+        if (m_keepItems)
+            meshes.emplace_back(std::move(mesh));
+    }
+    numMeshes += (uint32_t)meshesCPU.size();
+}
+
+}
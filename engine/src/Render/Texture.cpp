@@ -4,6 +4,7 @@
 #include "Engine/Util/BinaryReader.h"
 #include "Engine/Util/BinaryWriter.h"
 #include "Engine/Util/ErrorHandling.h"
+#include "Engine/Util/MappedBinaryReader.h"
 #include "VkFormat.h"
 #include <tbx/disable_all_warnings.h>
 #include <tbx/error_handling.h>
@@ -26,10 +27,8 @@ DISABLE_WARNINGS_POP()
 
 namespace Render {
 
-Texture Texture::uploadToGPU(const TextureCPU& textureCPU, D3D12_RESOURCE_STATES desiredResourceState, RenderContext& renderContext)
+Texture Texture::uploadToGPU(const TextureCPUView& textureCPU, D3D12_RESOURCE_STATES desiredResourceState, RenderContext& renderContext)
 {
-    auto pCommandList = renderContext.commandListManager.acquireCommandList();
-
     // See:
     // https://stackoverflow.com/questions/35568302/what-is-the-d3d12-equivalent-of-d3d11-createtexture2d
     // const auto resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(image.textureFormat, image.resolution.x, image.resolution.y, 1, 1);
@@ -44,10 +43,11 @@ Texture Texture::uploadToGPU(const TextureCPU& textureCPU, D3D12_RESOURCE_STATES
     textureDesc.SampleDesc.Quality = 0;
     textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
     textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    auto pResource = renderContext.createResource(D3D12_HEAP_TYPE_DEFAULT, textureDesc, D3D12_RESOURCE_STATE_COPY_DEST);
+    // The upload manager expects the COMMON state (the copy queue implicitly promotes it to COPY_DEST).
+    auto pResource = renderContext.createResource(D3D12_HEAP_TYPE_DEFAULT, textureDesc, D3D12_RESOURCE_STATE_COMMON);
     pResource->SetName(L"Texture");
 
-    // Create the GPU upload buffer
+    // The pixel data is tightly packed; the row sizes are used as the pitches of the source data.
     constexpr size_t maxMipLevel = 20;
     Tbx::assert_always(textureDesc.MipLevels < maxMipLevel);
     std::array<uint32_t, maxMipLevel> numRows;
@@ -56,10 +56,6 @@ Texture Texture::uploadToGPU(const TextureCPU& textureCPU, D3D12_RESOURCE_STATES
     uint64_t totalBytes = 0;
     renderContext.pDevice->GetCopyableFootprints(&textureDesc, 0, textureDesc.MipLevels, 0, layouts.data(), numRows.data(), bytesPerRow.data(), &totalBytes);
 
-    const auto stagingResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(totalBytes, D3D12_RESOURCE_FLAG_NONE);
-    const auto pStagingResource = renderContext.createResource(D3D12_HEAP_TYPE_UPLOAD, stagingResourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ);
-    pStagingResource->SetName(L"StagingTexture");
-
     std::vector<D3D12_SUBRESOURCE_DATA> mipsResourceData;
     for (uint32_t mipLevel = 0; mipLevel < textureDesc.MipLevels; ++mipLevel) {
         auto& textureData = mipsResourceData.emplace_back();
@@ -67,17 +63,8 @@ Texture Texture::uploadToGPU(const TextureCPU& textureCPU, D3D12_RESOURCE_STATES
         textureData.RowPitch = bytesPerRow[mipLevel];
         textureData.SlicePitch = bytesPerRow[mipLevel] * textureCPU.resolution.y;
     }
-    UpdateSubresources(pCommandList.Get(), pResource, pStagingResource.Get(), 0, 0, textureDesc.MipLevels, mipsResourceData.data());
-
-    const auto transition = CD3DX12_RESOURCE_BARRIER::Transition(pResource, D3D12_RESOURCE_STATE_COPY_DEST, desiredResourceState);
-    pCommandList->ResourceBarrier(1, &transition);
-
-    pCommandList->Close();
-    std::array<ID3D12CommandList*, 1> commandLists { pCommandList.Get() };
-    renderContext.pGraphicsQueue->ExecuteCommandLists((UINT)commandLists.size(), commandLists.data());
-    renderContext.commandListManager.recycleCommandList(renderContext.pGraphicsQueue.Get(), pCommandList);
-    // Wait for the GPU to finish copying before deleting the CPU buffer.
-    renderContext.waitForIdle();
+    // The pixel data is copied into the staging ring immediately, so textureCPU may be released after this call.
+    renderContext.uploadManager.uploadTexture(pResource, mipsResourceData, desiredResourceState);
 
     const D3D12_SHADER_RESOURCE_VIEW_DESC resourceView {
         .Format = textureCPU.textureFormat,
@@ -385,4 +372,38 @@ void TextureCPU::readFrom(Util::BinaryReader& reader)
     reader.read(mipLevels);
     reader.read(isOpague);
 }
+
+TextureCPU::operator TextureCPUView() const
+{
+    return TextureCPUView {
+        .resolution = resolution,
+        .textureFormat = textureFormat,
+        .pixelData = pixelData,
+        .mipLevels = mipLevels,
+        .isOpague = isOpague
+    };
+}
+
+size_t TextureCPU::sizeInBytes() const
+{
+    return pixelData.size() + mipLevels.size() * sizeof(MipLevel);
+}
+
+void TextureCPUView::writeTo(Util::BinaryWriter& writer) const
+{
+    writer.write(resolution);
+    writer.write(textureFormat);
+    writer.write(isOpague);
+    writer.writeAligned(mipLevels);
+    writer.writeAligned(pixelData);
+}
+
+void TextureCPUView::readFrom(Util::MappedBinaryReader& reader)
+{
+    reader.read(resolution);
+    reader.read(textureFormat);
+    reader.read(isOpague);
+    mipLevels = reader.readAligned<TextureCPU::MipLevel>();
+    pixelData = reader.readAligned<std::byte>();
+}
 }
@@ -0,0 +1,187 @@
+#include "Engine/Render/UploadManager.h"
+#include "Engine/Core/Profiling.h"
+#include "Engine/Render/RenderContext.h"
+#include "Engine/RenderAPI/CommandQueue.h"
+#include <tbx/error_handling.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Render {
+
+// CopyBufferRegion does not have any alignment requirements, but keep the source data aligned for the memcpy.
+static constexpr size_t bufferUploadAlignment = 16;
+
+UploadManager::UploadManager(RenderContext* pRenderContext, size_t stagingBufferSize, bool useCopyQueue)
+    : m_pRenderContext(pRenderContext)
+    , m_stagingRing(stagingBufferSize)
+{
+    if (useCopyQueue) {
+        auto* pDevice = m_pRenderContext->pDevice.Get();
+        m_pCopyQueue = RenderAPI::createCommandQueue(pDevice, D3D12_COMMAND_LIST_TYPE_COPY);
+        m_copyFence = RenderAPI::createFence(pDevice);
+        m_optCopyCommandListManager.emplace(m_pRenderContext->pDevice, D3D12_COMMAND_LIST_TYPE_COPY);
+        m_pQueue = m_pCopyQueue.Get();
+        m_pFence = &m_copyFence;
+        m_pCommandListManager = &m_optCopyCommandListManager.value();
+    } else {
+        m_pQueue = m_pRenderContext->pGraphicsQueue.Get();
+        m_pFence = &m_pRenderContext->graphicsFence;
+        m_pCommandListManager = &m_pRenderContext->commandListManager;
+    }
+
+    m_stagingBuffer = m_pRenderContext->createResource(
+        D3D12_HEAP_TYPE_UPLOAD, CD3DX12_RESOURCE_DESC::Buffer(stagingBufferSize, D3D12_RESOURCE_FLAG_NONE), D3D12_RESOURCE_STATE_GENERIC_READ);
+    m_stagingBuffer->SetName(L"UploadManager staging buffer");
+    // Upload heaps may stay mapped for the lifetime of the resource.
+    const D3D12_RANGE readRange { 0, 0 };
+    RenderAPI::ThrowIfFailed(m_stagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pMappedStagingBuffer)));
+}
+
+UploadManager::~UploadManager()
+{
+    waitForIdle();
+    m_stagingBuffer->Unmap(0, nullptr);
+}
+
+void UploadManager::uploadBuffer(ID3D12Resource* pDestination, std::span<const std::byte> data, D3D12_RESOURCE_STATES finalState)
+{
+    Tbx::assert_always(!data.empty());
+    const auto staging = allocateStaging(data.size(), bufferUploadAlignment);
+    std::memcpy(staging.pMappedMemory, data.data(), data.size());
+
+    getCommandList()->CopyBufferRegion(pDestination, 0, staging.pResource, staging.offset, data.size());
+    m_pendingTransitions.push_back({ .pResource = pDestination, .finalState = finalState });
+}
+
+void UploadManager::uploadTexture(ID3D12Resource* pDestination, std::span<const D3D12_SUBRESOURCE_DATA> subresources, D3D12_RESOURCE_STATES finalState)
+{
+    const auto textureDesc = pDestination->GetDesc();
+    const UINT numSubresources = (UINT)subresources.size();
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(numSubresources);
+    std::vector<UINT> numRows(numSubresources);
+    std::vector<UINT64> rowSizesInBytes(numSubresources);
+    UINT64 totalBytes = 0;
+    m_pRenderContext->pDevice->GetCopyableFootprints(&textureDesc, 0, numSubresources, 0, layouts.data(), numRows.data(), rowSizesInBytes.data(), &totalBytes);
+
+    const auto staging = allocateStaging(totalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+    auto* pCommandList = getCommandList();
+    for (UINT subresource = 0; subresource < numSubresources; ++subresource) {
+        // Copy row by row; the rows in the staging buffer are padded to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
+        auto layout = layouts[subresource];
+        const auto& subresourceData = subresources[subresource];
+        for (UINT z = 0; z < layout.Footprint.Depth; ++z) {
+            std::byte* pDestinationSlice = staging.pMappedMemory + layout.Offset + z * layout.Footprint.RowPitch * numRows[subresource];
+            const auto* pSourceSlice = static_cast<const std::byte*>(subresourceData.pData) + z * subresourceData.SlicePitch;
+            for (UINT row = 0; row < numRows[subresource]; ++row)
+                std::memcpy(pDestinationSlice + row * layout.Footprint.RowPitch, pSourceSlice + row * subresourceData.RowPitch, rowSizesInBytes[subresource]);
+        }
+
+        layout.Offset += staging.offset;
+        const CD3DX12_TEXTURE_COPY_LOCATION destinationLocation { pDestination, subresource };
+        const CD3DX12_TEXTURE_COPY_LOCATION sourceLocation { staging.pResource, layout };
+        pCommandList->CopyTextureRegion(&destinationLocation, 0, 0, 0, &sourceLocation, nullptr);
+    }
+    m_pendingTransitions.push_back({ .pResource = pDestination, .finalState = finalState });
+}
+
+void UploadManager::flush()
+{
+    if (!m_pCommandList)
+        return;
+    PROFILE_FUNCTION();
+
+    // Resources are implicitly promoted to COPY_DEST by the copies. On the copy queue they decay back to the COMMON state once
+    // the command list has finished executing, and only the graphics queue can transition them to their final state.
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    const D3D12_RESOURCE_STATES stateBefore = m_pCopyQueue ? D3D12_RESOURCE_STATE_COMMON : D3D12_RESOURCE_STATE_COPY_DEST;
+    for (const auto& [pResource, finalState] : m_pendingTransitions) {
+        if (finalState != stateBefore)
+            barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(pResource, stateBefore, finalState));
+    }
+    m_pendingTransitions.clear();
+    if (!m_pCopyQueue && !barriers.empty())
+        m_pCommandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+
+    m_pCommandList->Close();
+    ID3D12CommandList* const pRawCommandList = m_pCommandList.Get();
+    m_pQueue->ExecuteCommandLists(1, &pRawCommandList);
+    m_pCommandListManager->recycleCommandList(m_pQueue, m_pCommandList);
+    m_pCommandList = nullptr;
+
+    const uint64_t fenceValue = RenderAPI::insertFence(*m_pFence, m_pQueue);
+    m_stagingRing.closeBatch(fenceValue);
+    for (auto& stagingBuffer : m_pendingStagingBuffers)
+        m_inFlightStagingBuffers.push_back({ .stagingBuffer = std::move(stagingBuffer), .fenceValue = fenceValue });
+    m_pendingStagingBuffers.clear();
+
+    // The queues that may read from the uploaded resources wait (on the GPU) for the copies to complete.
+    RenderAPI::insertWait(*m_pFence, fenceValue, m_pRenderContext->pComputeQueue.Get());
+    if (m_pCopyQueue) {
+        auto* pGraphicsQueue = m_pRenderContext->pGraphicsQueue.Get();
+        RenderAPI::insertWait(*m_pFence, fenceValue, pGraphicsQueue);
+        if (!barriers.empty()) {
+            auto& graphicsCommandListManager = m_pRenderContext->commandListManager;
+            auto pGraphicsCommandList = graphicsCommandListManager.acquireCommandList();
+            pGraphicsCommandList->ResourceBarrier((UINT)barriers.size(), barriers.data());
+            pGraphicsCommandList->Close();
+            ID3D12CommandList* const pRawGraphicsCommandList = pGraphicsCommandList.Get();
+            pGraphicsQueue->ExecuteCommandLists(1, &pRawGraphicsCommandList);
+            graphicsCommandListManager.recycleCommandList(pGraphicsQueue, pGraphicsCommandList);
+        }
+    }
+}
+
+void UploadManager::waitForIdle()
+{
+    flush();
+    RenderAPI::waitForFence(*m_pFence, m_pFence->fenceValue);
+    retire();
+}
+
+UploadManager::StagingAllocation UploadManager::allocateStaging(size_t size, size_t alignment)
+{
+    retire();
+
+    if (size > m_stagingRing.size()) {
+        auto stagingBuffer = m_pRenderContext->createResource(
+            D3D12_HEAP_TYPE_UPLOAD, CD3DX12_RESOURCE_DESC::Buffer(size, D3D12_RESOURCE_FLAG_NONE), D3D12_RESOURCE_STATE_GENERIC_READ);
+        std::byte* pMappedMemory;
+        const D3D12_RANGE readRange { 0, 0 };
+        RenderAPI::ThrowIfFailed(stagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pMappedMemory)));
+        const StagingAllocation out { .pResource = stagingBuffer.Get(), .offset = 0, .pMappedMemory = pMappedMemory };
+        m_pendingStagingBuffers.push_back(std::move(stagingBuffer));
+        return out;
+    }
+
+    while (true) {
+        if (const auto optOffset = m_stagingRing.tryAllocate(size, alignment)) {
+            return StagingAllocation {
+                .pResource = m_stagingBuffer.Get(),
+                .offset = *optOffset,
+                .pMappedMemory = m_pMappedStagingBuffer + *optOffset
+            };
+        }
+
+        // The staging ring is full: submit the pending uploads (if any) and wait for the oldest batch to complete.
+        flush();
+        RenderAPI::waitForFence(*m_pFence, *m_stagingRing.oldestBatchFenceValue());
+        retire();
+    }
+}
+
+ID3D12GraphicsCommandList6* UploadManager::getCommandList()
+{
+    if (!m_pCommandList)
+        m_pCommandList = m_pCommandListManager->acquireCommandList();
+    return m_pCommandList.Get();
+}
+
+void UploadManager::retire()
+{
+    const uint64_t completedFenceValue = m_pFence->pFence->GetCompletedValue();
+    m_stagingRing.retire(completedFenceValue);
+    while (!m_inFlightStagingBuffers.empty() && m_inFlightStagingBuffers.front().fenceValue <= completedFenceValue)
+        m_inFlightStagingBuffers.pop_front();
+}
+
+}
@@ -0,0 +1,80 @@
+#include "Engine/Render/UploadRing.h"
+#include "Engine/Util/Align.h"
+#include <cassert>
+
+namespace Render {
+
+UploadRing::UploadRing(size_t size)
+    : m_size(size)
+{
+}
+
+std::optional<size_t> UploadRing::tryAllocate(size_t size, size_t alignment)
+{
+    if (m_usedSize == 0)
+        m_head = m_tail = 0;
+
+    size_t offset = Util::roundUpToClosestMultiple(m_head, alignment);
+    if (m_usedSize == 0 || m_head > m_tail) {
+        // The free space is [m_head, m_size) followed by [0, m_tail).
+        if (offset + size > m_size) {
+            if (size > m_tail)
+                return {};
+            offset = 0; // Skip the remainder of the ring.
+        }
+    } else {
+        // The free space is [m_head, m_tail); empty if the ring is full.
+        if (offset + size > m_tail)
+            return {};
+    }
+
+    // Padding is counted towards the batch so that it is freed together with it.
+    const size_t allocatedSize = offset >= m_head ? offset + size - m_head : (m_size - m_head) + offset + size;
+    m_head = offset + size;
+    m_usedSize += allocatedSize;
+    m_openBatchSize += allocatedSize;
+    return offset;
+}
+
+void UploadRing::closeBatch(uint64_t fenceValue)
+{
+    if (m_openBatchSize == 0)
+        return;
+    assert(m_batches.empty() || m_batches.back().fenceValue <= fenceValue);
+    m_batches.push_back({ .fenceValue = fenceValue, .end = m_head, .size = m_openBatchSize });
+    m_openBatchSize = 0;
+}
+
+void UploadRing::retire(uint64_t completedFenceValue)
+{
+    while (!m_batches.empty() && m_batches.front().fenceValue <= completedFenceValue) {
+        const auto& batch = m_batches.front();
+        m_tail = batch.end;
+        m_usedSize -= batch.size;
+        m_batches.pop_front();
+    }
+}
+
+size_t UploadRing::size() const
+{
+    return m_size;
+}
+
+size_t UploadRing::usedSize() const
+{
+    return m_usedSize;
+}
+
+bool UploadRing::hasOpenBatch() const
+{
+    return m_openBatchSize > 0;
+}
+
+std::optional<uint64_t> UploadRing::oldestBatchFenceValue() const
+{
+    if (m_batches.empty())
+        return {};
+    return m_batches.front().fenceValue;
+}
+
+}
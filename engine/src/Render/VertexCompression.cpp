@@ -0,0 +1,118 @@
+#include "Engine/Render/VertexCompression.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tbx/error_handling.h>
+
+namespace Render {
+
+VertexQuantization VertexQuantization::fromVertices(std::span<const ShaderInputs::Vertex> vertices)
+{
+    if (vertices.empty())
+        return { .offset = glm::vec3(0.0f), .scale = glm::vec3(0.0f) };
+
+    glm::vec3 minPos { std::numeric_limits<float>::max() }, maxPos { std::numeric_limits<float>::lowest() };
+    for (const auto& vertex : vertices) {
+        minPos = glm::min(minPos, vertex.pos);
+        maxPos = glm::max(maxPos, vertex.pos);
+    }
+    return { .offset = minPos, .scale = (maxPos - minPos) / 65535.0f };
+}
+
+glm::vec3 VertexQuantization::maxPositionError() const
+{
+    // Half a quantization step, plus the rounding errors of the floating point encode/decode.
+    return 0.5f * scale + (glm::abs(offset) + 65535.0f * scale) * (2.0f * std::numeric_limits<float>::epsilon());
+}
+
+static float signNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3& normal)
+{
+    const float l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1Norm == 0.0f)
+        return glm::vec2(0.0f);
+
+    // Project onto the octahedron and fold the lower hemisphere over the diagonals.
+    const glm::vec2 projected = glm::vec2(normal.x, normal.y) / l1Norm;
+    if (normal.z >= 0.0f)
+        return projected;
+    return glm::vec2(
+        (1.0f - std::abs(projected.y)) * signNotZero(projected.x),
+        (1.0f - std::abs(projected.x)) * signNotZero(projected.y));
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2& encodedNormal)
+{
+    glm::vec3 normal { encodedNormal.x, encodedNormal.y, 1.0f - std::abs(encodedNormal.x) - std::abs(encodedNormal.y) };
+    if (normal.z < 0.0f) {
+        normal.x = (1.0f - std::abs(encodedNormal.y)) * signNotZero(encodedNormal.x);
+        normal.y = (1.0f - std::abs(encodedNormal.x)) * signNotZero(encodedNormal.y);
+    }
+    return glm::normalize(normal);
+}
+
+static uint16_t quantizeUnorm16(float value, float offset, float scale)
+{
+    if (scale == 0.0f)
+        return 0;
+    return (uint16_t)std::clamp(std::round((value - offset) / scale), 0.0f, 65535.0f);
+}
+
+static int16_t quantizeSnorm16(float value)
+{
+    return (int16_t)std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+static float dequantizeSnorm16(int16_t value)
+{
+    return std::max(float(value) / 32767.0f, -1.0f);
+}
+
+CompressedVertex encodeVertex(const ShaderInputs::Vertex& vertex, const VertexQuantization& quantization)
+{
+    const glm::vec2 octahedralNormal = encodeOctahedral(vertex.normal);
+    return CompressedVertex {
+        .pos = glm::u16vec4(
+            quantizeUnorm16(vertex.pos.x, quantization.offset.x, quantization.scale.x),
+            quantizeUnorm16(vertex.pos.y, quantization.offset.y, quantization.scale.y),
+            quantizeUnorm16(vertex.pos.z, quantization.offset.z, quantization.scale.z),
+            0),
+        .normal = glm::i16vec2(quantizeSnorm16(octahedralNormal.x), quantizeSnorm16(octahedralNormal.y)),
+        .texCoord = glm::u16vec2(glm::packHalf1x16(vertex.texCoord.x), glm::packHalf1x16(vertex.texCoord.y))
+    };
+}
+
+ShaderInputs::Vertex decodeVertex(const CompressedVertex& vertex, const VertexQuantization& quantization)
+{
+    return ShaderInputs::Vertex {
+        .pos = quantization.offset + glm::vec3(vertex.pos) * quantization.scale,
+        .normal = decodeOctahedral(glm::vec2(dequantizeSnorm16(vertex.normal.x), dequantizeSnorm16(vertex.normal.y))),
+        .texCoord = glm::vec2(glm::unpackHalf1x16(vertex.texCoord.x), glm::unpackHalf1x16(vertex.texCoord.y))
+    };
+}
+
+void encodeVertices(std::span<const ShaderInputs::Vertex> vertices, const VertexQuantization& quantization, std::span<CompressedVertex> out)
+{
+    Tbx::assert_always(vertices.size() == out.size());
+    std::transform(std::begin(vertices), std::end(vertices), std::begin(out),
+        [&](const ShaderInputs::Vertex& vertex) { return encodeVertex(vertex, quantization); });
+}
+
+void decodeVertices(std::span<const CompressedVertex> vertices, const VertexQuantization& quantization, std::span<ShaderInputs::Vertex> out)
+{
+    Tbx::assert_always(vertices.size() == out.size());
+    std::transform(std::begin(vertices), std::end(vertices), std::begin(out),
+        [&](const CompressedVertex& vertex) { return decodeVertex(vertex, quantization); });
+}
+
+}
@@ -1,4 +1,6 @@
 #include "Engine/RenderAPI/Descriptor/DescriptorBlockAllocator.h"
+#include <tbx/error_handling.h>
+#include <bit>
 #include <cassert>
 
 namespace RenderAPI {
@@ -16,6 +18,8 @@ DescriptorBlockAllocator::DescriptorBlockAllocator(const WRL::ComPtr<ID3D12Devic
     ThrowIfFailed(pDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&pDescriptorHeap)));
     pDescriptorHeap->SetName(L"DescriptorBlockAllocator");
 
+    Tbx::assert_always(heapSizeInBlocks <= 64 * 64, "DescriptorBlockAllocator supports at most 4096 blocks");
+    m_freeBlocks.resize((heapSizeInBlocks + 63) / 64, 0);
     CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptor { pDescriptorHeap->GetCPUDescriptorHandleForHeapStart() };
     CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptor { shaderVisible ? pDescriptorHeap->GetGPUDescriptorHandleForHeapStart() : CD3DX12_GPU_DESCRIPTOR_HANDLE {} };
     for (int i = 0; i < (int)heapSizeInBlocks; i++) {
@@ -23,7 +27,8 @@ DescriptorBlockAllocator::DescriptorBlockAllocator(const WRL::ComPtr<ID3D12Devic
         block.firstCPUDescriptor = cpuDescriptor;
         block.firstGPUDescriptor = gpuDescriptor;
         block.blockIdx = (uint32_t)m_blocks.size();
-        m_freeBlocks.push_back(block.blockIdx);
+        m_freeBlocks[block.blockIdx / 64] |= 1llu << (block.blockIdx % 64);
+        m_freeBlocksSummary |= 1llu << (block.blockIdx / 64);
         m_blocks.push_back(block);
 
         cpuDescriptor.Offset(descriptorsPerBlock, descriptorIncrementSize);
@@ -33,16 +38,25 @@ DescriptorBlockAllocator::DescriptorBlockAllocator(const WRL::ComPtr<ID3D12Devic
 
 DescriptorBlockAllocator::Block DescriptorBlockAllocator::allocate()
 {
-    assert(!m_freeBlocks.empty());
-    auto blockIdx = m_freeBlocks.front();
-    m_freeBlocks.pop_front();
-    return m_blocks[blockIdx];
+    // Prefer the first free block, which keeps the used part of the descriptor heap compact.
+    Tbx::assert_always(m_freeBlocksSummary != 0, "DescriptorBlockAllocator is out of blocks");
+    const auto wordIdx = std::countr_zero(m_freeBlocksSummary);
+    uint64_t& word = m_freeBlocks[wordIdx];
+    const auto bitIdx = std::countr_zero(word);
+    word &= word - 1;
+    if (word == 0)
+        m_freeBlocksSummary &= ~(1llu << wordIdx);
+    return m_blocks[wordIdx * 64 + bitIdx];
 }
 
 void DescriptorBlockAllocator::release(const Block& descriptorBlock)
 {
     assert(descriptorBlock.blockIdx < m_blocks.size());
-    m_freeBlocks.push_front(descriptorBlock.blockIdx);
+    uint64_t& word = m_freeBlocks[descriptorBlock.blockIdx / 64];
+    const uint64_t mask = 1llu << (descriptorBlock.blockIdx % 64);
+    assert((word & mask) == 0);
+    word |= mask;
+    m_freeBlocksSummary |= 1llu << (descriptorBlock.blockIdx / 64);
 }
 
 }
@@ -0,0 +1,82 @@
+#include "Engine/RenderAPI/Descriptor/DescriptorTableCache.h"
+
+namespace RenderAPI {
+
+float DescriptorTableCache::Statistics::hitRate() const
+{
+    const uint32_t numLookups = numHits + numMisses;
+    return numLookups ? float(numHits) / float(numLookups) : 0.0f;
+}
+
+DescriptorTableCache::DescriptorTableCache(WRL::ComPtr<ID3D12Device5> pDevice, DescriptorBlockAllocator* pParentCPU, DescriptorBlockAllocator* pParentGPU, uint32_t maxUnusedFrames)
+    : m_descriptorAllocator(std::move(pDevice), pParentCPU, pParentGPU)
+    , m_maxUnusedFrames(maxUnusedFrames)
+{
+}
+
+DescriptorTableCache::~DescriptorTableCache()
+{
+    for (const auto& [keyBytes, table] : m_tables)
+        m_descriptorAllocator.release(table.descriptors);
+}
+
+std::pair<DescriptorAllocation, bool> DescriptorTableCache::findOrAllocate(const Key& key)
+{
+    const std::string_view keyBytes { key.m_bytes.data(), key.m_bytes.size() };
+
+    std::lock_guard lock { m_mutex };
+    if (auto iter = m_tables.find(keyBytes); iter != std::end(m_tables)) {
+        iter->second.lastUsedFrame = m_frameIdx;
+        ++m_numHits;
+        return { iter->second.descriptors, true };
+    }
+
+    CachedTable table {
+        .descriptors = m_descriptorAllocator.allocate(key.m_numDescriptors),
+        .lastUsedFrame = m_frameIdx,
+        .resources = std::vector<WRL::ComPtr<ID3D12Resource>>(std::begin(key.m_resources), std::end(key.m_resources))
+    };
+    const auto descriptors = table.descriptors;
+    m_tables.emplace(std::string(keyBytes), std::move(table));
+    ++m_numMisses;
+    m_numDescriptorsCopied += key.m_numDescriptors;
+    return { descriptors, false };
+}
+
+void DescriptorTableCache::flush()
+{
+    std::lock_guard lock { m_mutex };
+    m_descriptorAllocator.flush();
+}
+
+void DescriptorTableCache::newFrame()
+{
+    std::lock_guard lock { m_mutex };
+    uint32_t numEvictions = 0;
+    for (auto iter = std::begin(m_tables); iter != std::end(m_tables);) {
+        if (m_frameIdx - iter->second.lastUsedFrame >= m_maxUnusedFrames) {
+            m_descriptorAllocator.release(iter->second.descriptors);
+            iter = m_tables.erase(iter);
+            ++numEvictions;
+        } else {
+            ++iter;
+        }
+    }
+    ++m_frameIdx;
+
+    m_previousFrameStatistics = Statistics {
+        .numHits = m_numHits.exchange(0),
+        .numMisses = m_numMisses.exchange(0),
+        .numDescriptorsCopied = m_numDescriptorsCopied.exchange(0),
+        .numEvictions = numEvictions,
+        .numCachedTables = (uint32_t)m_tables.size()
+    };
+}
+
+DescriptorTableCache::Statistics DescriptorTableCache::getStatistics() const
+{
+    std::lock_guard lock { m_mutex };
+    return m_previousFrameStatistics;
+}
+
+}
@@ -26,6 +26,7 @@ DescriptorAllocation GPUDescriptorLinearAllocator::allocate(uint32_t numDescript
     assert(numDescriptors < m_pParentGPU->descriptorsPerBlock);
     const auto descriptorIncrementSize = m_pParentGPU->descriptorIncrementSize;
 
+    std::lock_guard lock { *m_pMutex };
     if (m_uploadQueue.empty() || m_offsetInBlock + numDescriptors > m_pParentGPU->descriptorsPerBlock) {
         // Current block is full. Allocate a new block.
         m_uploadQueue.push_back(BlockPair {
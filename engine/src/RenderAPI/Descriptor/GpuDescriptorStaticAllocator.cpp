@@ -4,6 +4,8 @@
 DISABLE_WARNINGS_PUSH()
 #include <spdlog/spdlog.h>
 DISABLE_WARNINGS_POP()
+#include <tbx/error_handling.h>
+#include <bit>
 #include <cassert>
 
 namespace RenderAPI {
@@ -27,14 +29,16 @@ GPUDescriptorStaticAllocator::~GPUDescriptorStaticAllocator()
             m_pParentCPU->release(block);
     }
     if (m_pParentGPU) {
-        for (const auto& block : m_blocksGPU)
-            m_pParentGPU->release(block.parentAllocation);
+        for (const auto& block : m_blocksGPU) {
+            if (block.optParentAllocation)
+                m_pParentGPU->release(*block.optParentAllocation);
+        }
     }
 }
 
 DescriptorAllocation GPUDescriptorStaticAllocator::allocate(uint32_t numDescriptors)
 {
-    assert(numDescriptors < m_pParentCPU->descriptorsPerBlock);
+    assert(numDescriptors > 0 && numDescriptors < m_pParentCPU->descriptorsPerBlock);
     const auto descriptorIncrementSize = m_pParentGPU->descriptorIncrementSize;
 
     DescriptorAllocation out {
@@ -51,78 +55,119 @@ DescriptorAllocation GPUDescriptorStaticAllocator::allocate(uint32_t numDescript
         cpuBlock.firstCPUDescriptor, m_offsetInBlockCPU, descriptorIncrementSize);
     m_offsetInBlockCPU += numDescriptors;
 
-    // Try allocate descriptor in GPU memory from the provided block.
-    // This may fail when the block is full.
-    auto tryAllocFromBlockGPU = [this, &out, numDescriptors, descriptorIncrementSize](GPUBlock& block) -> bool {
-        const D3D12MA::VIRTUAL_ALLOCATION_DESC allocDesc { .Size = numDescriptors, .Alignment = 1 };
-        uint64_t offset;
-        if (block.maVirtualBlock->Allocate(&allocDesc, &out.gpuDescriptorAlloc, &offset) == S_OK) {
-            out.firstGPUDescriptor.InitOffsetted(block.parentAllocation.firstGPUDescriptor, (INT)offset, descriptorIncrementSize);
-            block.memoryUsed += numDescriptors;
-            assert(offset + numDescriptors <= m_pParentGPU->descriptorsPerBlock);
-
-            // Store everything we need to copy the descriptors from CPU heap to GPU heap when flush() is called.
-            CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorGpuMemory;
-            cpuDescriptorGpuMemory.InitOffsetted(block.parentAllocation.firstCPUDescriptor, (INT)offset, descriptorIncrementSize);
-            m_uploadQueueSrcDescriptor.push_back(out.firstCPUDescriptor);
-            m_uploadQueueDstDescriptor.push_back(cpuDescriptorGpuMemory);
-            m_uploadQueueNumDescriptors.push_back(numDescriptors);
-            return true;
-        } else {
-            return false;
-        }
-    };
-    // Try to allocate from all available blocks.
-    bool gpuAllocated = false;
-    for (auto& blockGPU : m_blocksGPU) {
-        if (tryAllocFromBlockGPU(blockGPU)) {
-            gpuAllocated = true;
-            break;
-        }
-    }
-    // No space in the current blocks, allocate a new one.
-    if (!gpuAllocated) {
-        // Allocate a new block.
-        GPUBlock blockGPU {
-            .parentAllocation = m_pParentGPU->allocate()
-        };
-        const D3D12MA::VIRTUAL_BLOCK_DESC blockDesc { .Size = m_pParentGPU->descriptorsPerBlock };
-        D3D12MA::VirtualBlock* pMABlock;
-        ThrowIfFailed(CreateVirtualBlock(&blockDesc, &pMABlock));
-        blockGPU.maVirtualBlock = pMABlock;
-
-        // Perform sub allocation from this new block.
-        [[maybe_unused]] bool success = tryAllocFromBlockGPU(blockGPU);
+    // Blocks of which the largest free range is in this size class (or above) are guaranteed to fit the allocation. Prefer
+    // the smallest of those size classes to keep large free ranges intact.
+    const uint32_t minSizeClass = (uint32_t)std::bit_width(numDescriptors - 1);
+    if (const uint32_t largeEnoughSizeClasses = m_nonEmptyLargestSizeClasses & (~0u << minSizeClass)) {
+        const uint32_t blockIdx = (uint32_t)std::countr_zero(m_blocksByLargestSizeClass[std::countr_zero(largeEnoughSizeClasses)]);
+        [[maybe_unused]] bool success = tryAllocateFromBlockGPU(blockIdx, out);
         assert(success);
+        return out;
+    }
+    // A block of which the largest free range is in the size class of the allocation itself may still fit.
+    const uint32_t sizeClass = (uint32_t)std::bit_width(numDescriptors) - 1;
+    if (const uint64_t blocks = m_blocksByLargestSizeClass[sizeClass]; blocks && tryAllocateFromBlockGPU((uint32_t)std::countr_zero(blocks), out))
+        return out;
 
-        // Store the block so we can make more allocations from it.
-        m_blocksGPU.push_front(std::move(blockGPU));
+    // No space in the current blocks, allocate a new one.
+    uint32_t emptySlotIdx;
+    if (m_emptySlotsGPU) {
+        emptySlotIdx = (uint32_t)std::countr_zero(m_emptySlotsGPU);
+        m_emptySlotsGPU &= m_emptySlotsGPU - 1;
+    } else {
+        Tbx::assert_always(m_blocksGPU.size() < maxBlocksGPU, "GPUDescriptorStaticAllocator supports at most 64 blocks");
+        emptySlotIdx = (uint32_t)m_blocksGPU.size();
+        m_blocksGPU.push_back({ .subAllocator = Memory::SegregatedFitAllocator(m_pParentGPU->descriptorsPerBlock) });
     }
+    m_blocksGPU[emptySlotIdx].optParentAllocation = m_pParentGPU->allocate();
 
+    // Perform sub allocation from this new block.
+    [[maybe_unused]] bool success = tryAllocateFromBlockGPU(emptySlotIdx, out);
+    assert(success);
     return out;
 }
 
+// Try allocate descriptor in GPU memory from the provided block.
+// This may fail when the block is full.
+bool GPUDescriptorStaticAllocator::tryAllocateFromBlockGPU(uint32_t blockIdx, DescriptorAllocation& out)
+{
+    const auto descriptorIncrementSize = m_pParentGPU->descriptorIncrementSize;
+    auto& block = m_blocksGPU[blockIdx];
+    const auto optOffset = block.subAllocator.tryAllocate(out.numDescriptors);
+    if (!optOffset)
+        return false;
+
+    const auto offset = (INT)*optOffset;
+    out.firstGPUDescriptor.InitOffsetted(block.optParentAllocation->firstGPUDescriptor, offset, descriptorIncrementSize);
+    out.staticBlockIdx = blockIdx;
+    updateBlock(blockIdx);
+
+    // Store everything we need to copy the descriptors from CPU heap to GPU heap when flush() is called.
+    CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorGpuMemory;
+    cpuDescriptorGpuMemory.InitOffsetted(block.optParentAllocation->firstCPUDescriptor, offset, descriptorIncrementSize);
+    m_uploadQueueSrcDescriptor.push_back(out.firstCPUDescriptor);
+    m_uploadQueueDstDescriptor.push_back(cpuDescriptorGpuMemory);
+    m_uploadQueueNumDescriptors.push_back(out.numDescriptors);
+    return true;
+}
+
 void GPUDescriptorStaticAllocator::release(const DescriptorAllocation& alloc)
+{
+    assert(alloc.staticBlockIdx < m_blocksGPU.size());
+    m_blocksGPU[alloc.staticBlockIdx].subAllocator.deallocate(offsetInBlock(alloc));
+    updateBlock(alloc.staticBlockIdx);
+}
+
+void GPUDescriptorStaticAllocator::release(const DescriptorAllocation& alloc, uint64_t fenceValue)
+{
+    assert(alloc.staticBlockIdx < m_blocksGPU.size());
+    m_blocksGPU[alloc.staticBlockIdx].subAllocator.deallocateAfter(offsetInBlock(alloc), fenceValue);
+}
+
+void GPUDescriptorStaticAllocator::retire(uint64_t completedFenceValue)
+{
+    for (uint32_t blockIdx = 0; blockIdx < m_blocksGPU.size(); ++blockIdx) {
+        if (!m_blocksGPU[blockIdx].optParentAllocation)
+            continue;
+        m_blocksGPU[blockIdx].subAllocator.retire(completedFenceValue);
+        updateBlock(blockIdx);
+    }
+}
+
+uint32_t GPUDescriptorStaticAllocator::offsetInBlock(const DescriptorAllocation& alloc) const
 {
     const auto descriptorIncrementSize = m_pParentGPU->descriptorIncrementSize;
-    const auto blockSizeInBytes = m_pParentGPU->descriptorsPerBlock * descriptorIncrementSize;
-    for (auto iter = std::begin(m_blocksGPU); iter != std::end(m_blocksGPU); ++iter) {
-        auto& block = *iter;
-        if (alloc.firstGPUDescriptor.ptr >= block.parentAllocation.firstGPUDescriptor.ptr && alloc.firstGPUDescriptor.ptr < block.parentAllocation.firstGPUDescriptor.ptr + blockSizeInBytes) {
-            const uint64_t offsetInBytes = alloc.firstGPUDescriptor.ptr - block.parentAllocation.firstGPUDescriptor.ptr;
-            assert(offsetInBytes % descriptorIncrementSize == 0);
-            const uint64_t offsetInDescriptors = offsetInBytes / descriptorIncrementSize;
-            block.maVirtualBlock->FreeAllocation(alloc.gpuDescriptorAlloc);
-            block.memoryUsed -= alloc.numDescriptors;
-
-            // When the free causes the block the become entirely empty, then we return the block to the parent allocator.
-            if (block.memoryUsed == 0) {
-                m_pParentGPU->release(block.parentAllocation);
-            }
-            return;
-        }
+    const auto& block = m_blocksGPU[alloc.staticBlockIdx];
+    assert(block.optParentAllocation);
+    assert(alloc.firstGPUDescriptor.ptr >= block.optParentAllocation->firstGPUDescriptor.ptr);
+    const uint64_t offsetInBytes = alloc.firstGPUDescriptor.ptr - block.optParentAllocation->firstGPUDescriptor.ptr;
+    assert(offsetInBytes % descriptorIncrementSize == 0);
+    return (uint32_t)(offsetInBytes / descriptorIncrementSize);
+}
+
+void GPUDescriptorStaticAllocator::updateBlock(uint32_t blockIdx)
+{
+    auto& block = m_blocksGPU[blockIdx];
+    const uint64_t blockMask = uint64_t(1) << blockIdx;
+    if (block.largestSizeClass != noFreeRange) {
+        uint64_t& blocks = m_blocksByLargestSizeClass[block.largestSizeClass];
+        blocks &= ~blockMask;
+        if (blocks == 0)
+            m_nonEmptyLargestSizeClasses &= ~(1u << block.largestSizeClass);
+        block.largestSizeClass = noFreeRange;
+    }
+
+    // When the block becomes entirely empty, then we return the block to the parent allocator.
+    // The block must not be used for sub allocations afterwards; the parent may hand it out again.
+    if (block.subAllocator.numAllocations() == 0) {
+        m_pParentGPU->release(*block.optParentAllocation);
+        block.optParentAllocation.reset();
+        m_emptySlotsGPU |= blockMask;
+    } else if (const uint32_t nonEmptySizeClasses = block.subAllocator.nonEmptySizeClasses()) {
+        block.largestSizeClass = (uint32_t)std::bit_width(nonEmptySizeClasses) - 1;
+        m_blocksByLargestSizeClass[block.largestSizeClass] |= blockMask;
+        m_nonEmptyLargestSizeClasses |= 1u << block.largestSizeClass;
     }
-    assert(false); // Could not find the allocation.
 }
 
 void GPUDescriptorStaticAllocator::flush()
@@ -32,6 +32,11 @@ uint64_t insertFence(Fence& fence, ID3D12CommandQueue* pCommandQueue)
     return fenceValue;
 }
 
+void insertWait(const Fence& fence, uint64_t fenceValue, ID3D12CommandQueue* pCommandQueue)
+{
+    ThrowIfFailed(pCommandQueue->Wait(fence.pFence.Get(), fenceValue));
+}
+
 void waitForFence(const Fence& fence, uint64_t fenceValue)
 {
     const auto completedValue = fence.pFence->GetCompletedValue();
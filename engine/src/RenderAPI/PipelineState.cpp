@@ -2,6 +2,114 @@
 
 namespace RenderAPI {
 
+// The key is the description with all pointers replaced by the data that they point to. Padding bytes are copied as-is which
+// may (in theory) cause a cache miss, but never a false hit.
+template <typename T>
+static void appendBytes(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+static void appendShader(std::string& key, const D3D12_SHADER_BYTECODE& shader)
+{
+    appendBytes(key, shader.BytecodeLength);
+    if (shader.BytecodeLength > 0)
+        key.append(static_cast<const char*>(shader.pShaderBytecode), shader.BytecodeLength);
+}
+static void appendInputLayout(std::string& key, const D3D12_INPUT_LAYOUT_DESC& inputLayout)
+{
+    appendBytes(key, inputLayout.NumElements);
+    for (uint32_t i = 0; i < inputLayout.NumElements; ++i) {
+        auto inputElement = inputLayout.pInputElementDescs[i];
+        key.append(inputElement.SemanticName);
+        key.push_back('\0');
+        inputElement.SemanticName = nullptr;
+        appendBytes(key, inputElement);
+    }
+}
+
+template <typename F>
+WRL::ComPtr<ID3D12PipelineState> PipelineStateCache::findOrCreate(std::string&& key, ID3D12RootSignature* pRootSignature, F&& createPipelineState)
+{
+    std::lock_guard l { m_mutex };
+    if (auto iter = m_pipelineStates.find(key); iter != std::end(m_pipelineStates)) {
+        ++m_statistics.numReused;
+        return iter->second.pPipelineState;
+    }
+
+    WRL::ComPtr<ID3D12PipelineState> pPipelineState;
+    ThrowIfFailed(createPipelineState(pPipelineState));
+    m_pipelineStates[std::move(key)] = CachedPipelineState { .pPipelineState = pPipelineState, .pRootSignature = pRootSignature };
+    ++m_statistics.numCreated;
+    return pPipelineState;
+}
+
+WRL::ComPtr<ID3D12PipelineState> PipelineStateCache::createGraphicsPipelineState(ID3D12Device5* pDevice, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& pipelineStateDesc)
+{
+    const auto create = [&](WRL::ComPtr<ID3D12PipelineState>& pPipelineState) {
+        return pDevice->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&pPipelineState));
+    };
+    // Stream output is not used by any of the render passes; don't bother including it in the key.
+    if (pipelineStateDesc.StreamOutput.NumEntries > 0) {
+        WRL::ComPtr<ID3D12PipelineState> pPipelineState;
+        ThrowIfFailed(create(pPipelineState));
+        return pPipelineState;
+    }
+
+    std::string key;
+    for (const auto& shader : { pipelineStateDesc.VS, pipelineStateDesc.PS, pipelineStateDesc.DS, pipelineStateDesc.HS, pipelineStateDesc.GS })
+        appendShader(key, shader);
+    appendInputLayout(key, pipelineStateDesc.InputLayout);
+    auto strippedDesc = pipelineStateDesc;
+    strippedDesc.VS = strippedDesc.PS = strippedDesc.DS = strippedDesc.HS = strippedDesc.GS = {};
+    strippedDesc.InputLayout = {};
+    strippedDesc.CachedPSO = {};
+    appendBytes(key, strippedDesc);
+    return findOrCreate(std::move(key), pipelineStateDesc.pRootSignature, create);
+}
+
+WRL::ComPtr<ID3D12PipelineState> PipelineStateCache::createComputePipelineState(ID3D12Device5* pDevice, const D3D12_COMPUTE_PIPELINE_STATE_DESC& pipelineStateDesc)
+{
+    std::string key;
+    appendShader(key, pipelineStateDesc.CS);
+    auto strippedDesc = pipelineStateDesc;
+    strippedDesc.CS = {};
+    strippedDesc.CachedPSO = {};
+    appendBytes(key, strippedDesc);
+    return findOrCreate(std::move(key), pipelineStateDesc.pRootSignature, [&](WRL::ComPtr<ID3D12PipelineState>& pPipelineState) {
+        return pDevice->CreateComputePipelineState(&pipelineStateDesc, IID_PPV_ARGS(&pPipelineState));
+    });
+}
+
+WRL::ComPtr<ID3D12PipelineState> PipelineStateCache::createMeshShaderPipelineState(ID3D12Device5* pDevice, const D3DX12_MESH_SHADER_PIPELINE_STATE_DESC& pipelineStateDesc)
+{
+    std::string key;
+    for (const auto& shader : { pipelineStateDesc.AS, pipelineStateDesc.MS, pipelineStateDesc.PS })
+        appendShader(key, shader);
+    auto strippedDesc = pipelineStateDesc;
+    strippedDesc.AS = strippedDesc.MS = strippedDesc.PS = {};
+    strippedDesc.CachedPSO = {};
+    appendBytes(key, strippedDesc);
+    return findOrCreate(std::move(key), pipelineStateDesc.pRootSignature, [&](WRL::ComPtr<ID3D12PipelineState>& pPipelineState) {
+        auto psoStream = CD3DX12_PIPELINE_MESH_STATE_STREAM(pipelineStateDesc);
+        D3D12_PIPELINE_STATE_STREAM_DESC streamDesc;
+        streamDesc.pPipelineStateSubobjectStream = &psoStream;
+        streamDesc.SizeInBytes = sizeof(psoStream);
+        return pDevice->CreatePipelineState(&streamDesc, IID_PPV_ARGS(&pPipelineState));
+    });
+}
+
+void PipelineStateCache::clear()
+{
+    std::lock_guard l { m_mutex };
+    m_pipelineStates.clear();
+}
+
+PipelineStateCache::Statistics PipelineStateCache::getStatistics() const
+{
+    std::lock_guard l { m_mutex };
+    return m_statistics;
+}
+
 D3D12_INPUT_ELEMENT_DESC sensibleDefaultsInputElementDesc()
 {
     return D3D12_INPUT_ELEMENT_DESC {
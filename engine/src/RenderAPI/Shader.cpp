@@ -1,6 +1,9 @@
 #include "Engine/RenderAPI/Shader.h"
 #include <cassert>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace RenderAPI {
@@ -14,6 +17,21 @@ RenderAPI::Shader loadShader(ID3D12Device5* pDevice, const std::filesystem::path
     }();
     assert(std::filesystem::exists(shaderFilePath));
 
+    // Shaders are loaded again whenever the frame graph is rebuilt; only read them from disk when they were modified (hot reloading).
+    struct CachedShader {
+        std::filesystem::file_time_type lastWriteTime;
+        WRL::ComPtr<IDxcBlob> pBlob;
+    };
+    static std::mutex s_cacheMutex;
+    static std::unordered_map<std::string, CachedShader> s_shaderCache;
+    const auto lastWriteTime = std::filesystem::last_write_time(shaderFilePath);
+    const auto cacheKey = std::filesystem::absolute(shaderFilePath).string();
+    {
+        std::lock_guard l { s_cacheMutex };
+        if (auto iter = s_shaderCache.find(cacheKey); iter != std::end(s_shaderCache) && iter->second.lastWriteTime == lastWriteTime)
+            return { .pBlob = iter->second.pBlob };
+    }
+
     // Read binary DXIL file into memory
     // https://stackoverflow.com/questions/15138353/how-to-read-a-binary-file-into-a-vector-of-unsigned-chars
     std::ifstream file { shaderFilePath, std::ios::binary };
@@ -40,6 +58,8 @@ RenderAPI::Shader loadShader(ID3D12Device5* pDevice, const std::filesystem::path
     // https://www.wihlidal.com/blog/pipeline/2018-09-16-dxil-signing-post-compile/
     WRL::ComPtr<IDxcBlob> pShaderLibrary = pEncodedShaderLibrary;
     auto bufferSize = pShaderLibrary->GetBufferSize();
+    std::lock_guard l { s_cacheMutex };
+    s_shaderCache[cacheKey] = CachedShader { .lastWriteTime = lastWriteTime, .pBlob = pShaderLibrary };
     return { .pBlob = pShaderLibrary };
 }
 
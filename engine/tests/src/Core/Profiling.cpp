@@ -0,0 +1,207 @@
+#include "pch.h"
+#include <Engine/Core/Profiling.h>
+#include <Engine/Core/Stopwatch.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const Core::ProfileTrack& findTrack(std::span<const Core::ProfileTrack> tracks, const std::string& name)
+{
+    const auto iter = std::find_if(std::begin(tracks), std::end(tracks), [&](const Core::ProfileTrack& track) { return track.name == name; });
+    REQUIRE(iter != std::end(tracks));
+    return *iter;
+}
+
+TEST_CASE("Core::CPUProfiler::Zones of all threads are collected per frame", "[Core]")
+{
+    Core::CPUProfiler profiler { 4 };
+    {
+        Core::ProfileZone outerZone { "Outer" };
+        Core::ProfileZone innerZone { "Inner" };
+    }
+    std::thread worker { []() { Core::ProfileZone zone { "Worker" }; } };
+    worker.join();
+    profiler.newFrame();
+
+    auto timeline = profiler.getTimeline();
+    REQUIRE(timeline.size() == 3);
+    REQUIRE(timeline[0].name == "CPU frames");
+    REQUIRE(timeline[0].tasks.size() == 1);
+    const auto& frame = timeline[0].tasks[0];
+
+    // Outer zones come before the zones that are nested in them.
+    const auto& mainThread = findTrack(timeline, "CPU thread 0");
+    REQUIRE(mainThread.tasks.size() == 2);
+    REQUIRE(mainThread.tasks[0].name == "Outer");
+    REQUIRE(mainThread.tasks[1].name == "Inner");
+    REQUIRE(mainThread.tasks[0].start <= mainThread.tasks[1].start);
+    REQUIRE(mainThread.tasks[0].end >= mainThread.tasks[1].end);
+    REQUIRE(mainThread.tasks[0].start >= frame.start);
+    REQUIRE(mainThread.tasks[0].end <= frame.end);
+    const auto& workerThread = findTrack(timeline, "CPU thread 1");
+    REQUIRE(workerThread.tasks.size() == 1);
+    REQUIRE(workerThread.tasks[0].name == "Worker");
+
+    // Only the last frames are stored.
+    for (int i = 0; i < 8; i++) {
+        Core::ProfileZone zone { "Update" };
+        profiler.newFrame();
+    }
+    timeline = profiler.getTimeline();
+    REQUIRE(timeline[0].tasks.size() == 4);
+    REQUIRE(findTrack(timeline, "CPU thread 0").tasks.size() == 4);
+    REQUIRE(findTrack(timeline, "CPU thread 1").tasks.empty());
+}
+
+TEST_CASE("Core::CPUProfiler::Zones are dropped when the ring buffer is full", "[Core]")
+{
+    Core::CPUProfiler profiler { 1, 16 };
+    for (int i = 0; i < 20; i++)
+        Core::ProfileZone zone { "Zone" };
+    REQUIRE(profiler.numDroppedZones() == 4);
+    profiler.newFrame();
+    REQUIRE(findTrack(profiler.getTimeline(), "CPU thread 0").tasks.size() == 16);
+
+    // Draining the ring buffer makes room for new zones.
+    for (int i = 0; i < 16; i++)
+        Core::ProfileZone zone { "Zone" };
+    REQUIRE(profiler.numDroppedZones() == 4);
+}
+
+TEST_CASE("Core::CPUProfiler::Zones are not recorded without a profiler", "[Core]")
+{
+    {
+        Core::CPUProfiler profiler { 1 };
+    }
+    REQUIRE(Core::CPUProfiler::getInstance() == nullptr);
+    Core::ProfileZone zone { "Zone" };
+}
+
+TEST_CASE("Core::CPUProfiler::Zones that outlive the profiler are not recorded", "[Core]")
+{
+    std::optional<Core::CPUProfiler> optProfiler;
+    optProfiler.emplace(1);
+    {
+        Core::ProfileZone zone { "Zone" };
+        optProfiler.reset();
+    }
+
+    Core::CPUProfiler profiler { 1 };
+    {
+        Core::ProfileZone zone { "Zone" };
+    }
+    profiler.newFrame();
+    const auto timeline = profiler.getTimeline();
+    REQUIRE(timeline.size() == 2);
+    REQUIRE(timeline[1].tasks.size() == 1);
+}
+
+TEST_CASE("Core::CPUProfiler::Concurrent recording", "[Core]")
+{
+    constexpr int numThreads = 4;
+    constexpr int numZonesPerThread = 100000;
+    Core::CPUProfiler profiler { 1, 1024 };
+
+    std::atomic_int numFinishedThreads = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < numZonesPerThread; j++)
+                Core::ProfileZone zone { "Zone" };
+            numFinishedThreads.fetch_add(1);
+        });
+    }
+    // Drain the ring buffers while the threads are recording; only the last frame is stored.
+    size_t numCollectedZones = 0;
+    const auto collect = [&]() {
+        profiler.newFrame();
+        for (const auto& track : profiler.getTimeline()) {
+            if (track.name != "CPU frames")
+                numCollectedZones += track.tasks.size();
+        }
+    };
+    while (numFinishedThreads.load() != numThreads)
+        collect();
+    for (auto& thread : threads)
+        thread.join();
+    collect();
+    REQUIRE(numCollectedZones > 0);
+    REQUIRE(numCollectedZones + profiler.numDroppedZones() == (size_t)numThreads * numZonesPerThread);
+}
+
+TEST_CASE("Core::exportChromeTrace::Tasks are exported as complete events", "[Core]")
+{
+    const std::vector<Core::ProfileTrack> tracks {
+        { .name = "CPU thread 0", .tasks = { { .name = "Update", .start = 1'000'000, .end = 1'500'000 } } },
+        { .name = "GPU", .tasks = { { .name = "Shading", .start = 1'200'000, .end = 2'200'000 } } }
+    };
+    const auto json = nlohmann::json::parse(Core::exportChromeTrace(tracks));
+    REQUIRE(json["displayTimeUnit"] == "ms");
+
+    std::vector<nlohmann::json> completeEvents, threadNames;
+    for (const auto& event : json["traceEvents"]) {
+        if (event["ph"] == "X")
+            completeEvents.push_back(event);
+        else if (event["name"] == "thread_name")
+            threadNames.push_back(event);
+    }
+    REQUIRE(threadNames.size() == 2);
+    REQUIRE(threadNames[1]["tid"] == 1);
+    REQUIRE(threadNames[1]["args"]["name"] == "GPU");
+
+    // Times are in microseconds, relative to the first task.
+    REQUIRE(completeEvents.size() == 2);
+    REQUIRE(completeEvents[0]["name"] == "Update");
+    REQUIRE(completeEvents[0]["tid"] == 0);
+    REQUIRE(completeEvents[0]["ts"] == 0.0);
+    REQUIRE(completeEvents[0]["dur"] == 500.0);
+    REQUIRE(completeEvents[1]["name"] == "Shading");
+    REQUIRE(completeEvents[1]["tid"] == 1);
+    REQUIRE(completeEvents[1]["ts"] == 200.0);
+    REQUIRE(completeEvents[1]["dur"] == 1000.0);
+}
+
+TEST_CASE("Core::CPUProfiler::Zone overhead benchmark", "[Core][.benchmark]")
+{
+    constexpr int numZones = 1024 * 1024;
+    const auto runZones = [&]() {
+        uint64_t sum = 0;
+        for (int i = 0; i < numZones; i++) {
+            Core::ProfileZone zone { "Zone" };
+            sum += i;
+        }
+        return sum;
+    };
+
+    Core::Stopwatch stopwatch;
+    BENCHMARK("Without profiler")
+    {
+        return runZones();
+    };
+    stopwatch.restart();
+    runZones();
+    const auto timeWithoutProfiler = stopwatch.restart();
+
+    Core::CPUProfiler profiler { 1, numZones };
+    BENCHMARK("With profiler")
+    {
+        const auto out = runZones();
+        profiler.newFrame();
+        return out;
+    };
+    stopwatch.restart();
+    runZones();
+    const auto timeWithProfiler = stopwatch.restart();
+    profiler.newFrame();
+
+    REQUIRE(profiler.numDroppedZones() == 0);
+    const auto toNanosecondsPerZone = [](Core::Stopwatch::FrameTime time) { return time.count() * 1'000'000.0f / numZones; };
+    WARN(fmt::format("Zone overhead: {:.1f}ns without profiler, {:.1f}ns with profiler", toNanosecondsPerZone(timeWithoutProfiler), toNanosecondsPerZone(timeWithProfiler)));
+}
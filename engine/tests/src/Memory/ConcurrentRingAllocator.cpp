@@ -0,0 +1,174 @@
+#include "pch.h"
+#include <Engine/Memory/ConcurrentRingAllocator.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Memory::ConcurrentRingAllocator::Offset is aligned according to alignment argument", "[Memory]")
+{
+    Memory::ConcurrentRingAllocator allocator { 64 * 1024, 1024, 2 };
+
+    REQUIRE(allocator.allocate(12, 4) % 4 == 0);
+    REQUIRE(allocator.allocate(12, 8) % 8 == 0);
+    REQUIRE(allocator.allocate(48, 256) % 256 == 0);
+    // Structured buffers are aligned to their stride.
+    REQUIRE(allocator.allocate(36, 12) % 12 == 0);
+    REQUIRE(allocator.allocate(100, 12) % 12 == 0);
+    // Allocations that do not fit in a chunk.
+    REQUIRE(allocator.allocate(3000, 256) % 256 == 0);
+    REQUIRE(allocator.allocate(3000, 12) % 12 == 0);
+}
+
+TEST_CASE("Memory::ConcurrentRingAllocator::Allocations of frames in flight are never overwritten", "[Memory]")
+{
+    constexpr int numThreads = 8;
+    constexpr uint32_t numFramesInFlight = 2;
+    Memory::ConcurrentRingAllocator allocator { 1024 * 1024, 4096, numFramesInFlight };
+    // Stand-in for the mapped buffer.
+    std::vector<uint32_t> memory(allocator.size() / sizeof(uint32_t));
+
+    struct Allocation {
+        Memory::Offset offset;
+        size_t numValues;
+        uint32_t value;
+    };
+    std::vector<std::vector<Allocation>> frameAllocations;
+    for (uint32_t frame = 0; frame < 32; frame++) {
+        std::vector<std::vector<Allocation>> threadAllocations(numThreads);
+        std::vector<std::thread> threads;
+        for (int threadIdx = 0; threadIdx < numThreads; threadIdx++) {
+            threads.emplace_back([&, threadIdx]() {
+                std::mt19937 rng { frame * numThreads + threadIdx };
+                // Vary the amount of memory per thread & frame so that the frames do not line up with the end of the ring.
+                const int numAllocations = 64 + rng() % 128;
+                for (int i = 0; i < numAllocations; i++) {
+                    // Mostly small allocations with an occasional one that is larger than a chunk.
+                    const size_t numValues = (i % 50 == 0) ? 1024 + rng() % 2048 : 1 + rng() % 64;
+                    const uint32_t value = (frame << 24) | (threadIdx << 16) | i;
+                    const auto offset = allocator.allocate(numValues * sizeof(uint32_t), sizeof(uint32_t));
+                    std::fill_n(std::begin(memory) + offset / sizeof(uint32_t), numValues, value);
+                    threadAllocations[threadIdx].push_back({ offset, numValues, value });
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        std::vector<Allocation> allocations;
+        for (const auto& allocationsOfThread : threadAllocations)
+            allocations.insert(std::end(allocations), std::begin(allocationsOfThread), std::end(allocationsOfThread));
+        frameAllocations.push_back(std::move(allocations));
+
+        // Check the allocations of all frames that are (assumed to be) in flight.
+        for (uint32_t i = 0; i < std::min(frame + 1, numFramesInFlight); i++) {
+            for (const auto& allocation : frameAllocations[frame - i]) {
+                const auto begin = std::begin(memory) + allocation.offset / sizeof(uint32_t);
+                REQUIRE(allocation.offset + allocation.numValues * sizeof(uint32_t) <= allocator.size());
+                REQUIRE(std::all_of(begin, begin + allocation.numValues, [&](uint32_t value) { return value == allocation.value; }));
+            }
+        }
+        allocator.newFrame();
+    }
+}
+
+TEST_CASE("Memory::ConcurrentRingAllocator::Throws when overwriting a frame in flight", "[Memory]")
+{
+    Memory::ConcurrentRingAllocator allocator { 64 * 1024, 1024, 2 };
+
+    // Two frames that each use half of the ring.
+    for (int i = 0; i < 32; i++)
+        allocator.allocate(1024, 256);
+    allocator.newFrame();
+    for (int i = 0; i < 32; i++)
+        allocator.allocate(1024, 256);
+    // The first frame is still in flight.
+    REQUIRE_THROWS(allocator.allocate(256, 256));
+}
+
+TEST_CASE("Memory::ConcurrentRingAllocator::Memory of retired frames is reused", "[Memory]")
+{
+    Memory::ConcurrentRingAllocator allocator { 64 * 1024, 1024, 3 };
+
+    // Every frame uses a third of the ring.
+    for (int frame = 0; frame < 100; frame++) {
+        for (int i = 0; i < 21; i++)
+            REQUIRE(allocator.allocate(512, 256) < allocator.size());
+        allocator.newFrame();
+    }
+}
+
+TEST_CASE("Memory::ConcurrentRingAllocator::Allocation throughput", "[Memory][.benchmark]")
+{
+    // Offsets only, no memory is written; this measures the allocator.
+    constexpr int numAllocations = 64 * 1024;
+    constexpr size_t chunkSize = 16 * 1024;
+
+    // Reference: a bump allocator protected by a mutex (what CPUBufferRingAllocator used before).
+    struct MutexRingAllocator {
+        std::mutex mutex {};
+        size_t size, writeOffset = 0;
+
+        Memory::Offset allocate(size_t allocationSize, size_t alignment)
+        {
+            std::lock_guard lock { mutex };
+            writeOffset = Memory::alignSize(writeOffset, alignment);
+            if (writeOffset + allocationSize > size)
+                writeOffset = 0;
+            const auto out = writeOffset;
+            writeOffset += allocationSize;
+            return out;
+        }
+    };
+
+    // Sizes similar to the per-draw/per-pass constants of the renderer.
+    std::vector<size_t> allocationSizes(1024);
+    std::mt19937 rng { 12345 };
+    std::generate(std::begin(allocationSizes), std::end(allocationSizes), [&]() { return 16 + rng() % 512; });
+
+    for (const int numThreads : { 1, 2, 4, 8, 16, 32 }) {
+        const auto runOnAllThreads = [&](auto&& f) {
+            std::vector<std::thread> threads;
+            for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+                threads.emplace_back(f);
+            for (auto& thread : threads)
+                thread.join();
+        };
+        // Enough for two frames of 256 byte aligned allocations, plus one partially used chunk per thread.
+        const size_t ringSize = 2 * numThreads * (numAllocations * 1024 + chunkSize);
+
+        MutexRingAllocator mutexAllocator { .size = ringSize };
+        BENCHMARK(fmt::format("Mutex ({} threads)", numThreads))
+        {
+            std::atomic<Memory::Offset> checksum { 0 };
+            runOnAllThreads([&]() {
+                Memory::Offset localChecksum = 0;
+                for (int i = 0; i < numAllocations; i++)
+                    localChecksum += mutexAllocator.allocate(allocationSizes[i % allocationSizes.size()], 256);
+                checksum += localChecksum;
+            });
+            return checksum.load();
+        };
+
+        Memory::ConcurrentRingAllocator allocator { ringSize, chunkSize, 2 };
+        BENCHMARK(fmt::format("ConcurrentRingAllocator ({} threads)", numThreads))
+        {
+            std::atomic<Memory::Offset> checksum { 0 };
+            runOnAllThreads([&]() {
+                Memory::Offset localChecksum = 0;
+                for (int i = 0; i < numAllocations; i++)
+                    localChecksum += allocator.allocate(allocationSizes[i % allocationSizes.size()], 256);
+                checksum += localChecksum;
+            });
+            allocator.newFrame();
+            return checksum.load();
+        };
+    }
+}
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include <Engine/Memory/FixedSizePoolAllocator.h>
 #include <Engine/Memory/Memory.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <unordered_set>
 
 TEST_CASE("Memory::FixedSizePoolAllocator::Randomly allocating and deallocating", "[Memory]")
@@ -52,3 +55,71 @@ TEST_CASE("Memory::FixedSizePoolAllocator::Randomly allocating and deallocating"
         });
     }
 }
+
+TEST_CASE("Memory::FixedSizePoolAllocator::Returns nullptr when out of memory", "[Memory]")
+{
+    constexpr size_t allocationSize = 1024;
+    // The remainder is too small to fit another block.
+    std::vector<std::byte> memory { std::size_t(4 * allocationSize + allocationSize / 2) };
+    Memory::FixedSizePoolAllocator allocator { memory, allocationSize };
+    REQUIRE(allocator.numBlocks() == 4);
+
+    std::unordered_set<void*> allocations;
+    for (int i = 0; i < 4; i++)
+        allocations.insert(allocator.allocate());
+    REQUIRE(allocations.size() == 4);
+    REQUIRE(!allocations.contains(nullptr));
+    REQUIRE(allocator.allocate() == nullptr);
+
+    allocator.deallocate(*std::begin(allocations));
+    REQUIRE(allocator.allocate() == *std::begin(allocations));
+}
+
+TEST_CASE("Memory::FixedSizePoolAllocator::Allocating and deallocating from multiple threads", "[Memory]")
+{
+    constexpr size_t allocationSize = 256;
+    constexpr size_t numBlocks = 64;
+    constexpr int numThreads = 8;
+    constexpr int numIterations = 20000;
+    std::vector<std::byte> memory { std::size_t(numBlocks * allocationSize) };
+    Memory::FixedSizePoolAllocator allocator { memory, allocationSize };
+
+    std::atomic_int numErrors { 0 };
+    std::vector<std::thread> threads;
+    for (int threadIdx = 0; threadIdx < numThreads; threadIdx++) {
+        threads.emplace_back([&, threadIdx]() {
+            std::mt19937 rng { (unsigned)threadIdx };
+            std::vector<int*> allocations;
+            for (int i = 0; i < numIterations; i++) {
+                if (allocations.size() < numBlocks / numThreads && rng() % 2 == 0) {
+                    int* pValues = reinterpret_cast<int*>(allocator.allocate());
+                    if (!pValues) {
+                        ++numErrors;
+                        continue;
+                    }
+                    std::fill(pValues, pValues + allocationSize / sizeof(int), threadIdx);
+                    allocations.push_back(pValues);
+                } else if (!allocations.empty()) {
+                    int* pValues = allocations.back();
+                    allocations.pop_back();
+                    // No other thread should have received the same block.
+                    if (!std::all_of(pValues, pValues + allocationSize / sizeof(int), [=](int value) { return value == threadIdx; }))
+                        ++numErrors;
+                    allocator.deallocate(pValues);
+                }
+            }
+            for (int* pValues : allocations)
+                allocator.deallocate(pValues);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    REQUIRE(numErrors == 0);
+
+    // All blocks should have been returned to the pool.
+    std::unordered_set<void*> allocations;
+    for (size_t i = 0; i < numBlocks; i++)
+        allocations.insert(allocator.allocate());
+    REQUIRE(allocations.size() == numBlocks);
+    REQUIRE(!allocations.contains(nullptr));
+}
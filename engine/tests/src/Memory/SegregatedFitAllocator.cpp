@@ -0,0 +1,201 @@
+#include "pch.h"
+#include <Engine/Memory/SegregatedFitAllocator.h>
+#include <Engine/Memory/UnintrusiveBuddyAllocator.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <map>
+#include <random>
+
+TEST_CASE("Memory::SegregatedFitAllocator::Allocations are tightly packed", "[Memory]")
+{
+    Memory::SegregatedFitAllocator allocator { 100 };
+
+    // Allocation sizes are not rounded up.
+    REQUIRE(allocator.tryAllocate(30) == 0);
+    REQUIRE(allocator.tryAllocate(30) == 30);
+    REQUIRE(allocator.tryAllocate(40) == 60);
+    REQUIRE(!allocator.tryAllocate(1));
+
+    auto statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == 3);
+    REQUIRE(statistics.allocatedSize == 100);
+    REQUIRE(statistics.freeSize == 0);
+    REQUIRE(statistics.numFreeRanges == 0);
+}
+
+TEST_CASE("Memory::SegregatedFitAllocator::Deallocating merges free neighbours", "[Memory]")
+{
+    Memory::SegregatedFitAllocator allocator { 100 };
+    std::vector<Memory::Offset> offsets;
+    for (int i = 0; i < 10; i++)
+        offsets.push_back(*allocator.tryAllocate(10));
+
+    allocator.deallocate(offsets[3]);
+    allocator.deallocate(offsets[5]);
+    REQUIRE(allocator.getStatistics().numFreeRanges == 2);
+    REQUIRE(!allocator.tryAllocate(20));
+
+    // Merges with both the left and the right neighbour.
+    allocator.deallocate(offsets[4]);
+    auto statistics = allocator.getStatistics();
+    REQUIRE(statistics.numFreeRanges == 1);
+    REQUIRE(statistics.largestFreeRangeSize == 30);
+    REQUIRE(allocator.tryAllocate(30) == offsets[3]);
+
+    allocator.deallocate(offsets[3]);
+    for (const size_t i : { 0, 1, 2, 6, 7, 8, 9 })
+        allocator.deallocate(offsets[i]);
+    statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == 0);
+    REQUIRE(statistics.numFreeRanges == 1);
+    REQUIRE(statistics.largestFreeRangeSize == 100);
+}
+
+TEST_CASE("Memory::SegregatedFitAllocator::Free ranges that are too small are skipped", "[Memory]")
+{
+    Memory::SegregatedFitAllocator allocator { 40 };
+    const auto offset0 = *allocator.tryAllocate(10);
+    REQUIRE(allocator.tryAllocate(1));
+    const auto offset1 = *allocator.tryAllocate(13);
+    REQUIRE(allocator.tryAllocate(1));
+    REQUIRE(allocator.tryAllocate(15));
+
+    // Both free ranges are in the same size class as the allocation, and the first one in the free list is too small.
+    allocator.deallocate(offset1);
+    allocator.deallocate(offset0);
+    REQUIRE(allocator.tryAllocate(12) == offset1);
+    REQUIRE(!allocator.tryAllocate(11));
+    REQUIRE(allocator.tryAllocate(10) == offset0);
+}
+
+TEST_CASE("Memory::SegregatedFitAllocator::Deferred deallocations are retired by fence value", "[Memory]")
+{
+    Memory::SegregatedFitAllocator allocator { 64 };
+    const auto offset0 = *allocator.tryAllocate(32);
+    const auto offset1 = *allocator.tryAllocate(32);
+
+    allocator.deallocateAfter(offset0, 1);
+    allocator.deallocateAfter(offset1, 2);
+    REQUIRE(allocator.numAllocations() == 2);
+    REQUIRE(allocator.getStatistics().numPendingDeallocations == 2);
+    REQUIRE(!allocator.tryAllocate(32));
+
+    allocator.retire(0);
+    REQUIRE(!allocator.tryAllocate(32));
+    allocator.retire(1);
+    REQUIRE(allocator.numAllocations() == 1);
+    REQUIRE(allocator.tryAllocate(32) == offset0);
+
+    allocator.retire(5);
+    REQUIRE(allocator.getStatistics().numPendingDeallocations == 0);
+    REQUIRE(allocator.tryAllocate(32) == offset1);
+}
+
+TEST_CASE("Memory::SegregatedFitAllocator::Randomized stress test", "[Memory]")
+{
+    const size_t poolSize = 64 * 1024;
+    Memory::SegregatedFitAllocator allocator { poolSize };
+
+    std::mt19937 rng { 12345 };
+    std::map<Memory::Offset, size_t> allocations; // Offset => size
+    std::map<Memory::Offset, uint64_t> pendingDeallocations; // Offset => fence value
+    uint64_t fenceValue = 0;
+    for (int i = 0; i < 100000; i++) {
+        const auto operation = rng() % 8;
+        if (!allocations.empty() && operation < 3) {
+            auto iter = allocations.begin();
+            std::advance(iter, rng() % allocations.size());
+            if (pendingDeallocations.contains(iter->first))
+                continue;
+            if (operation == 0) {
+                allocator.deallocateAfter(iter->first, fenceValue + 2);
+                pendingDeallocations[iter->first] = fenceValue + 2;
+            } else {
+                allocator.deallocate(iter->first);
+                allocations.erase(iter);
+            }
+        } else if (operation == 3) {
+            // Memory of a pending deallocation must not be reused until its fence value has been retired.
+            allocator.retire(++fenceValue);
+            std::erase_if(pendingDeallocations, [&](const auto& offsetAndFenceValue) {
+                if (offsetAndFenceValue.second > fenceValue)
+                    return false;
+                allocations.erase(offsetAndFenceValue.first);
+                return true;
+            });
+        } else {
+            const size_t size = rng() % 8 == 0 ? 1 + rng() % 2048 : 1 + rng() % 64;
+            const auto optOffset = allocator.tryAllocate(size);
+            if (!optOffset)
+                continue;
+
+            // Allocations should not overlap and should be inside the pool.
+            const Memory::Offset offset = *optOffset;
+            REQUIRE(offset + size <= poolSize);
+            const auto nextIter = allocations.lower_bound(offset);
+            if (nextIter != allocations.end())
+                REQUIRE(offset + size <= nextIter->first);
+            if (nextIter != allocations.begin())
+                REQUIRE(std::prev(nextIter)->first + std::prev(nextIter)->second <= offset);
+            allocations[offset] = size;
+        }
+    }
+    const auto statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == allocations.size());
+    REQUIRE(statistics.numPendingDeallocations == pendingDeallocations.size());
+
+    allocator.retire(fenceValue + 2);
+    for (const auto& [offset, size] : allocations) {
+        if (!pendingDeallocations.contains(offset))
+            allocator.deallocate(offset);
+    }
+    REQUIRE(allocator.getStatistics().largestFreeRangeSize == poolSize);
+}
+
+TEST_CASE("Memory::SegregatedFitAllocator::Randomized allocation benchmark", "[Memory][.benchmark]")
+{
+    // Descriptor table sized allocations from a descriptor heap sized pool, which is kept about half full.
+    const size_t poolSize = 64 * 1024;
+    constexpr size_t numOperations = 1024 * 1024;
+    std::mt19937 rng { 12345 };
+    std::vector<size_t> allocationSizes(numOperations);
+    std::generate(std::begin(allocationSizes), std::end(allocationSizes), [&]() { return 1 + rng() % 32; });
+    std::vector<uint32_t> deallocationIndices(numOperations);
+    std::generate(std::begin(deallocationIndices), std::end(deallocationIndices), [&]() { return rng(); });
+
+    const auto runBenchmark = [&](auto& allocator) {
+        std::vector<Memory::Offset> allocations;
+        allocations.reserve(numOperations);
+        for (size_t i = 0; i < numOperations; i++) {
+            if (allocations.size() * 16 > poolSize / 2 || (i % 3 == 2 && !allocations.empty())) {
+                const size_t allocationIdx = deallocationIndices[i] % allocations.size();
+                allocator.deallocate(allocations[allocationIdx]);
+                std::swap(allocations[allocationIdx], allocations.back());
+                allocations.pop_back();
+            } else if (const auto optOffset = allocator.tryAllocate(allocationSizes[i])) {
+                allocations.push_back(*optOffset);
+            }
+        }
+        const size_t numAllocations = allocations.size();
+        for (const auto offset : allocations)
+            allocator.deallocate(offset);
+        return numAllocations;
+    };
+
+    Memory::SegregatedFitAllocator segregatedFitAllocator { poolSize };
+    BENCHMARK("SegregatedFitAllocator")
+    {
+        return runBenchmark(segregatedFitAllocator);
+    };
+    Memory::UnintrusiveBuddyAllocator buddyAllocator { 0, poolSize, 1 };
+    BENCHMARK("UnintrusiveBuddyAllocator")
+    {
+        return runBenchmark(buddyAllocator);
+    };
+
+    const auto statistics = segregatedFitAllocator.getStatistics();
+    WARN(fmt::format("{} free range(s) after freeing all allocations, largest is {}KiB", statistics.numFreeRanges, statistics.largestFreeRangeSize >> 10));
+}
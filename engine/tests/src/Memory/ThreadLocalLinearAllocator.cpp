@@ -0,0 +1,174 @@
+#include "pch.h"
+#include <Engine/Memory/Memory.h>
+#include <Engine/Memory/ThreadLocalLinearAllocator.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include <unordered_set>
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Pointer is aligned according to alignment argument", "[Memory]")
+{
+    Memory::ThreadLocalLinearAllocator allocator { 4096, 16 };
+
+    // Small allocations.
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(12, 4)) % 4 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(12, 8)) % 8 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(48, 16)) % 16 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(4, 64)) % 64 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(154, 128)) % 128 == 0);
+
+    // Allocations that do not fit in a block.
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(3000, 8)) % 8 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(allocator.allocate(10000, 256)) % 256 == 0);
+}
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Memory is reused after reset", "[Memory]")
+{
+    Memory::ThreadLocalLinearAllocator allocator { 4096, 16 };
+
+    // Allocate more memory than the pool holds; that only works if reset() returns the blocks to the pool.
+    for (int frame = 0; frame < 64; frame++) {
+        std::vector<std::pair<int, int*>> allocations;
+        for (int i = 0; i < 512; i++) {
+            int* pValue = Memory::allocate_t<int>(allocator)(frame * 512 + i);
+            allocations.emplace_back(frame * 512 + i, pValue);
+        }
+        int* pLargeValues = Memory::allocate_ts<int>(4096, allocator);
+        std::fill(pLargeValues, pLargeValues + 4096, frame);
+
+        std::unordered_set<int*> uniquePointers;
+        for (const auto& [value, pValue] : allocations) {
+            REQUIRE(*pValue == value);
+            uniquePointers.insert(pValue);
+        }
+        REQUIRE(uniquePointers.size() == allocations.size());
+        REQUIRE(std::all_of(pLargeValues, pLargeValues + 4096, [=](int value) { return value == frame; }));
+        allocator.reset();
+    }
+}
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Allocations fall back to the heap when the pool is exhausted", "[Memory]")
+{
+    Memory::ThreadLocalLinearAllocator allocator { 1024, 2 };
+
+    for (int frame = 0; frame < 4; frame++) {
+        // Allocate much more than the two blocks of the pool can hold.
+        std::vector<std::pair<int, int*>> allocations;
+        for (int i = 0; i < 4096; i++) {
+            int* pValue = Memory::allocate_t<int>(allocator)(frame * 4096 + i);
+            REQUIRE(pValue != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(pValue) % alignof(int) == 0);
+            allocations.emplace_back(frame * 4096 + i, pValue);
+        }
+
+        std::unordered_set<int*> uniquePointers;
+        for (const auto& [value, pValue] : allocations) {
+            REQUIRE(*pValue == value);
+            uniquePointers.insert(pValue);
+        }
+        REQUIRE(uniquePointers.size() == allocations.size());
+        allocator.reset();
+    }
+}
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Allocating from multiple threads", "[Memory]")
+{
+    constexpr int numThreads = 8;
+    constexpr int numAllocations = 4 * 1024;
+    Memory::ThreadLocalLinearAllocator allocator { 16 * 1024, 512 };
+
+    for (int frame = 0; frame < 4; frame++) {
+        std::atomic_int numErrors { 0 };
+        std::vector<std::thread> threads;
+        for (int threadIdx = 0; threadIdx < numThreads; threadIdx++) {
+            threads.emplace_back([&, threadIdx]() {
+                std::mt19937 rng { (unsigned)threadIdx };
+                std::vector<std::span<int>> allocations;
+                for (int i = 0; i < numAllocations; i++) {
+                    const size_t numValues = 1 + rng() % 64;
+                    auto values = Memory::allocate_ts_span<int>(numValues, allocator);
+                    std::fill(std::begin(values), std::end(values), threadIdx * numAllocations + i);
+                    allocations.push_back(values);
+                }
+                // Other threads should not have written to the memory of this thread.
+                for (int i = 0; i < numAllocations; i++) {
+                    const auto values = allocations[i];
+                    if (!std::all_of(std::begin(values), std::end(values), [=](int value) { return value == threadIdx * numAllocations + i; }))
+                        ++numErrors;
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        REQUIRE(numErrors == 0);
+        allocator.reset();
+    }
+}
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Used as a std::pmr::memory_resource", "[Memory]")
+{
+    Memory::ThreadLocalLinearAllocator allocator { 4096, 16 };
+    Memory::ThreadLocalLinearAllocator otherAllocator { 4096, 16 };
+    REQUIRE(allocator.is_equal(allocator));
+    REQUIRE(!allocator.is_equal(otherAllocator));
+
+    // Growing the vector deallocates the old storage (noop) and eventually requires allocations that do not fit in a block.
+    std::pmr::vector<int> values { &allocator };
+    for (int i = 0; i < 10000; i++)
+        values.push_back(i);
+    std::pmr::vector<int> expectedValues { &otherAllocator };
+    expectedValues.resize(10000);
+    std::iota(std::begin(expectedValues), std::end(expectedValues), 0);
+    REQUIRE(values == expectedValues);
+}
+
+TEST_CASE("Memory::ThreadLocalLinearAllocator::Allocation throughput under contention", "[Memory][.benchmark]")
+{
+    constexpr int numAllocations = 16 * 1024;
+    const int numThreads = (int)std::max(std::thread::hardware_concurrency(), 2u);
+    WARN(fmt::format("{} threads, {} allocations per thread", numThreads, numAllocations));
+
+    // Random sizes similar to the small per-frame temporaries (barriers, descriptors, geometry descs) of the renderer.
+    std::array<size_t, 1024> allocationSizes;
+    std::mt19937 rng { 12345 };
+    std::generate(std::begin(allocationSizes), std::end(allocationSizes), [&]() { return 16 + rng() % 512; });
+
+    const auto runOnAllThreads = [&](auto&& f) {
+        std::vector<std::thread> threads;
+        for (int threadIdx = 0; threadIdx < numThreads; threadIdx++)
+            threads.emplace_back(f);
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    BENCHMARK("malloc/free")
+    {
+        runOnAllThreads([&]() {
+            std::vector<void*> allocations(numAllocations);
+            for (int i = 0; i < numAllocations; i++)
+                allocations[i] = std::malloc(allocationSizes[i % allocationSizes.size()]);
+            for (void* pMemory : allocations)
+                std::free(pMemory);
+        });
+        return numAllocations;
+    };
+
+    Memory::ThreadLocalLinearAllocator allocator { 64 * 1024, (size_t)numThreads * 128 };
+    BENCHMARK("ThreadLocalLinearAllocator")
+    {
+        runOnAllThreads([&]() {
+            std::vector<void*> allocations(numAllocations);
+            for (int i = 0; i < numAllocations; i++)
+                allocations[i] = allocator.allocate(allocationSizes[i % allocationSizes.size()]);
+        });
+        allocator.reset();
+        return numAllocations;
+    };
+}
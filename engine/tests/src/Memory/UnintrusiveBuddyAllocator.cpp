@@ -1,5 +1,11 @@
 #include "pch.h"
 #include <Engine/Memory/UnintrusiveBuddyAllocator.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <map>
 #include <random>
 
 TEST_CASE("Memory::UnintrusiveBuddyAllocator::Randomly allocating and deallocating", "[Memory]")
@@ -61,3 +67,161 @@ TEST_CASE("Memory::UnintrusiveBuddyAllocator::Randomly allocating and deallocati
         }
     }
 }
+
+TEST_CASE("Memory::UnintrusiveBuddyAllocator::tryAllocate returns nullopt when out of memory", "[Memory]")
+{
+    Memory::UnintrusiveBuddyAllocator allocator { 1024, 1024, 64 };
+
+    std::vector<Memory::Offset> offsets;
+    for (int i = 0; i < 16; i++) {
+        const auto optOffset = allocator.tryAllocate(60);
+        REQUIRE(optOffset);
+        REQUIRE(*optOffset >= 1024);
+        REQUIRE(*optOffset < 2048);
+        offsets.push_back(*optOffset);
+    }
+    REQUIRE(!allocator.tryAllocate(1));
+    REQUIRE_THROWS(allocator.allocate(1));
+
+    // Freeing two buddies allows a larger allocation.
+    std::sort(std::begin(offsets), std::end(offsets));
+    REQUIRE(!allocator.tryAllocate(128));
+    allocator.deallocate(offsets[4]);
+    allocator.deallocate(offsets[5]);
+    REQUIRE(allocator.tryAllocate(128) == offsets[4]);
+
+    REQUIRE(!allocator.tryAllocate(2048));
+}
+
+TEST_CASE("Memory::UnintrusiveBuddyAllocator::Statistics", "[Memory]")
+{
+    const size_t poolSize = 64 * 1024;
+    Memory::UnintrusiveBuddyAllocator allocator { 0, poolSize, 64 };
+    auto statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == 0);
+    REQUIRE(statistics.freeSize == poolSize);
+    REQUIRE(statistics.largestFreeBlockSize == poolSize);
+    REQUIRE(statistics.externalFragmentation() == 0.0f);
+
+    // Allocation sizes are rounded up to a power of 2.
+    const auto offset0 = allocator.allocate(100);
+    const auto offset1 = allocator.allocate(8 * 1024);
+    statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == 2);
+    REQUIRE(statistics.allocatedSize == 128 + 8 * 1024);
+    REQUIRE(statistics.freeSize == poolSize - statistics.allocatedSize);
+    REQUIRE(statistics.largestFreeBlockSize == poolSize / 2);
+    REQUIRE(statistics.externalFragmentation() > 0.0f);
+
+    // Freeing all allocations merges all blocks back together.
+    allocator.deallocate(offset1);
+    allocator.deallocate(offset0);
+    statistics = allocator.getStatistics();
+    REQUIRE(statistics.numAllocations == 0);
+    REQUIRE(statistics.numFreeBlocks == 1);
+    REQUIRE(statistics.largestFreeBlockSize == poolSize);
+}
+
+TEST_CASE("Memory::UnintrusiveBuddyAllocator::Randomized stress test", "[Memory]")
+{
+    const size_t baseOffset = 4 * 1024 * 1024;
+    const size_t poolSize = 1024 * 1024;
+    Memory::UnintrusiveBuddyAllocator allocator { baseOffset, poolSize, 16 };
+
+    std::mt19937 rng { 12345 };
+    std::map<Memory::Offset, size_t> allocations; // Offset => size
+    for (int i = 0; i < 100000; i++) {
+        if (!allocations.empty() && rng() % 2 == 0) {
+            auto iter = allocations.begin();
+            std::advance(iter, rng() % allocations.size());
+            allocator.deallocate(iter->first);
+            allocations.erase(iter);
+        } else {
+            // Mostly small allocations with the occasional large one.
+            const size_t size = rng() % 8 == 0 ? 1 + rng() % (64 * 1024) : 1 + rng() % 512;
+            const auto optOffset = allocator.tryAllocate(size);
+            if (!optOffset)
+                continue;
+
+            // Allocations should not overlap and should be inside the pool.
+            const Memory::Offset offset = *optOffset;
+            REQUIRE(offset >= baseOffset);
+            REQUIRE(offset + size <= baseOffset + poolSize);
+            const auto nextIter = allocations.lower_bound(offset);
+            if (nextIter != allocations.end())
+                REQUIRE(offset + size <= nextIter->first);
+            if (nextIter != allocations.begin())
+                REQUIRE(std::prev(nextIter)->first + std::prev(nextIter)->second <= offset);
+            allocations[offset] = size;
+        }
+    }
+    REQUIRE(allocator.getStatistics().numAllocations == allocations.size());
+
+    for (const auto& [offset, size] : allocations)
+        allocator.deallocate(offset);
+    REQUIRE(allocator.getStatistics().largestFreeBlockSize == poolSize);
+}
+
+TEST_CASE("Memory::UnintrusiveBuddyAllocator::Finds free blocks anywhere in a large pool", "[Memory]")
+{
+    // 2^20 blocks of the smallest size are tracked by three levels of summary bitmaps.
+    const size_t poolSize = 1024 * 1024;
+    Memory::UnintrusiveBuddyAllocator allocator { 0, poolSize, 1 };
+
+    // Blocks are handed out from the start of the pool.
+    for (size_t i = 0; i < poolSize; i++)
+        REQUIRE(allocator.allocate(1) == i);
+    REQUIRE(!allocator.tryAllocate(1));
+
+    // A single free block is found, no matter where it is.
+    for (const size_t offset : { poolSize - 1, size_t(0), poolSize / 2 + 4097, size_t(64 * 64 * 64 + 1) }) {
+        allocator.deallocate(offset);
+        REQUIRE(allocator.allocate(1) == offset);
+    }
+
+    // Free (and merge) the second half, except for the last block.
+    for (size_t offset = poolSize / 2; offset < poolSize - 1; offset++)
+        allocator.deallocate(offset);
+    REQUIRE(allocator.allocate(poolSize / 4) == poolSize / 2);
+    // The smallest free block is the buddy of the last block.
+    REQUIRE(allocator.allocate(1) == poolSize - 2);
+    REQUIRE(allocator.allocate(2) == poolSize - 4);
+}
+
+TEST_CASE("Memory::UnintrusiveBuddyAllocator::Randomized allocation benchmark", "[Memory][.benchmark]")
+{
+    const size_t poolSize = 256 * 1024 * 1024;
+    Memory::UnintrusiveBuddyAllocator allocator { 0, poolSize, 256 };
+
+    // Pre-generate the operations such that the benchmark only measures the allocator.
+    constexpr size_t numOperations = 1024 * 1024;
+    std::mt19937 rng { 12345 };
+    std::vector<size_t> allocationSizes(numOperations);
+    std::generate(std::begin(allocationSizes), std::end(allocationSizes), [&]() { return 256 + rng() % (64 * 1024); });
+    std::vector<uint32_t> deallocationIndices(numOperations);
+    std::generate(std::begin(deallocationIndices), std::end(deallocationIndices), [&]() { return rng(); });
+
+    std::vector<Memory::Offset> allocations;
+    allocations.reserve(numOperations);
+    BENCHMARK("Random allocations & deallocations")
+    {
+        for (size_t i = 0; i < numOperations; i++) {
+            if (i % 3 == 2 && !allocations.empty()) {
+                const size_t allocationIdx = deallocationIndices[i] % allocations.size();
+                allocator.deallocate(allocations[allocationIdx]);
+                std::swap(allocations[allocationIdx], allocations.back());
+                allocations.pop_back();
+            } else if (const auto optOffset = allocator.tryAllocate(allocationSizes[i])) {
+                allocations.push_back(*optOffset);
+            }
+        }
+        const auto statistics = allocator.getStatistics();
+        for (const auto offset : allocations)
+            allocator.deallocate(offset);
+        allocations.clear();
+        return statistics.numAllocations;
+    };
+
+    const auto statistics = allocator.getStatistics();
+    WARN(fmt::format("{} free blocks after freeing all allocations, largest is {}KiB", statistics.numFreeBlocks, statistics.largestFreeBlockSize >> 10));
+}
@@ -0,0 +1,58 @@
+#include "pch.h"
+#include <Engine/Render/RenderContext.h>
+#include <Engine/RenderAPI/Descriptor/DescriptorTableCache.h>
+#include <vector>
+
+TEST_CASE("Render::DescriptorTableCache::Identical tables share descriptors", "[Render]")
+{
+    Render::RenderContext renderContext {};
+    auto& cache = renderContext.descriptorTableCache;
+
+    const std::vector<float> data(1024, 1.0f);
+    const auto buffer1 = renderContext.createBufferSRVWithArrayData<float>(data, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    const auto buffer2 = renderContext.createBufferSRVWithArrayData<float>(data, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    const auto createKey = [](const RenderAPI::SRVDesc& srvDesc0, const RenderAPI::SRVDesc& srvDesc1) {
+        RenderAPI::DescriptorTableCache::Key key { 2 };
+        key.addView(0, srvDesc0);
+        key.addView(1, srvDesc1);
+        return key;
+    };
+
+    const auto [descriptors, found] = cache.findOrAllocate(createKey(buffer1, buffer2));
+    REQUIRE(!found);
+    REQUIRE(descriptors.numDescriptors == 2);
+    const auto [sameDescriptors, sameFound] = cache.findOrAllocate(createKey(buffer1, buffer2));
+    REQUIRE(sameFound);
+    REQUIRE(sameDescriptors.firstGPUDescriptor.ptr == descriptors.firstGPUDescriptor.ptr);
+    // The position of the views is part of the key.
+    const auto [swappedDescriptors, swappedFound] = cache.findOrAllocate(createKey(buffer2, buffer1));
+    REQUIRE(!swappedFound);
+    REQUIRE(swappedDescriptors.firstGPUDescriptor.ptr != descriptors.firstGPUDescriptor.ptr);
+    cache.flush();
+
+    cache.newFrame();
+    auto statistics = cache.getStatistics();
+    REQUIRE(statistics.numHits == 1);
+    REQUIRE(statistics.numMisses == 2);
+    REQUIRE(statistics.numDescriptorsCopied == 2 + 2);
+    REQUIRE(statistics.numCachedTables == 2);
+
+    // Tables are reused across frames...
+    REQUIRE(cache.findOrAllocate(createKey(buffer1, buffer2)).second);
+    cache.newFrame();
+    statistics = cache.getStatistics();
+    REQUIRE(statistics.numHits == 1);
+    REQUIRE(statistics.numMisses == 0);
+    REQUIRE(statistics.numDescriptorsCopied == 0);
+
+    // ...until they have not been used for a while.
+    uint32_t numEvictions = 0;
+    for (int i = 0; i < 16; ++i) {
+        cache.newFrame();
+        numEvictions += cache.getStatistics().numEvictions;
+    }
+    REQUIRE(numEvictions == 2);
+    REQUIRE(cache.getStatistics().numCachedTables == 0);
+    REQUIRE(!cache.findOrAllocate(createKey(buffer1, buffer2)).second);
+    renderContext.waitForIdle();
+}
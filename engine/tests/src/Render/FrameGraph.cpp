@@ -0,0 +1,88 @@
+#include "FrameGraph.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+uint32_t TestFrameGraph::addResource(FGResourceType resourceType, const CD3DX12_RESOURCE_DESC& desc)
+{
+    resources.push_back(FGResource { .resourceType = resourceType, .desc = desc });
+    return (uint32_t)resources.size() - 1;
+}
+
+void TestFrameGraph::addRenderPass(ResourceAccesses accesses)
+{
+    addRenderPass("", RenderPassQueue::Graphics, accesses);
+}
+
+void TestFrameGraph::addRenderPass(RenderPassQueue queue, ResourceAccesses accesses)
+{
+    addRenderPass("", queue, accesses);
+}
+
+void TestFrameGraph::addRenderPass(std::string name, RenderPassQueue queue, ResourceAccesses accesses)
+{
+    FGRenderPass renderPass;
+    renderPass.name = std::move(name);
+    renderPass.queue = queue;
+    renderPass.resourceAccessBegin = resourceAccesses.size();
+    for (const auto& [resourceIdx, desiredState] : accesses)
+        resourceAccesses.push_back({ .resourceIdx = resourceIdx, .accessType = FGResourceAccessType::General, .desiredState = desiredState });
+    renderPass.resourceAccessEnd = resourceAccesses.size();
+    renderPasses.emplace_back(std::move(renderPass));
+}
+
+TestFrameGraph createRandomFrameGraph(const RandomFrameGraphSettings& settings, std::mt19937& rng)
+{
+    constexpr std::array graphicsStates {
+        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_DEPTH_WRITE,
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE
+    };
+    constexpr std::array computeStates {
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE
+    };
+    TestFrameGraph out;
+    out.addResource(FGResourceType::SwapChain);
+    for (uint32_t resourceIdx = 1; resourceIdx < settings.numResources; ++resourceIdx)
+        out.addResource(rng() % 2 ? FGResourceType::Transient : FGResourceType::Persistent);
+    for (uint32_t renderPassIdx = 0; renderPassIdx < settings.numRenderPasses; ++renderPassIdx) {
+        FGRenderPass renderPass;
+        renderPass.queue = settings.asyncCompute && rng() % 3 == 0 ? RenderPassQueue::AsyncCompute : RenderPassQueue::Graphics;
+        renderPass.resourceAccessBegin = out.resourceAccesses.size();
+        // Every resource is accessed at most once per render pass. The swap chain is only used by the graphics queue.
+        std::vector<uint32_t> resourceIndices(out.resources.size() - 1);
+        std::iota(std::begin(resourceIndices), std::end(resourceIndices), 1u);
+        if (renderPass.queue == RenderPassQueue::Graphics)
+            resourceIndices.push_back(0);
+        std::shuffle(std::begin(resourceIndices), std::end(resourceIndices), rng);
+        uint32_t numAccesses = std::min(1 + (uint32_t)(rng() % 4), (uint32_t)resourceIndices.size());
+        if (settings.emptyRenderPasses && rng() % 16 == 0)
+            numAccesses = 0;
+        for (uint32_t accessIdx = 0; accessIdx < numAccesses; ++accessIdx) {
+            const uint32_t resourceIdx = resourceIndices[accessIdx];
+            D3D12_RESOURCE_STATES desiredState;
+            if (resourceIdx == 0)
+                desiredState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+            else if (renderPass.queue == RenderPassQueue::Graphics)
+                desiredState = graphicsStates[rng() % graphicsStates.size()];
+            else
+                desiredState = computeStates[rng() % computeStates.size()];
+            out.resourceAccesses.push_back({ .resourceIdx = resourceIdx, .accessType = FGResourceAccessType::General, .desiredState = desiredState });
+        }
+        renderPass.resourceAccessEnd = out.resourceAccesses.size();
+        out.renderPasses.emplace_back(std::move(renderPass));
+    }
+    return out;
+}
+
+void TestCommandRecorder::recordBarriers(std::span<const FGBarrier> barriers)
+{
+    commands.emplace_back(std::vector(std::begin(barriers), std::end(barriers)));
+}
+
+void TestCommandRecorder::recordRenderPass(size_t operationIdx)
+{
+    commands.emplace_back(operationIdx);
+}
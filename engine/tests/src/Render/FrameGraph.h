@@ -0,0 +1,46 @@
+#pragma once
+#include <Engine/Render/FrameGraph/CommandRecording.h>
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Frame graph without a device: only the resource types and the resource accesses of the render passes.
+struct TestFrameGraph {
+    std::vector<Render::FrameGraphInternal::FGResource> resources;
+    std::vector<Render::FrameGraphInternal::FGResourceAccess> resourceAccesses;
+    std::vector<Render::FrameGraphInternal::FGRenderPass> renderPasses;
+
+    using ResourceAccesses = std::initializer_list<std::pair<uint32_t, D3D12_RESOURCE_STATES>>;
+    uint32_t addResource(Render::FrameGraphInternal::FGResourceType resourceType, const CD3DX12_RESOURCE_DESC& desc = {});
+    void addRenderPass(ResourceAccesses accesses);
+    void addRenderPass(Render::RenderPassQueue queue, ResourceAccesses accesses);
+    void addRenderPass(std::string name, Render::RenderPassQueue queue, ResourceAccesses accesses);
+};
+
+struct RandomFrameGraphSettings {
+    uint32_t numRenderPasses;
+    // The first resource is the swap chain; the others are transient or persistent with equal probability.
+    uint32_t numResources = 8;
+    // Schedule about a third of the render passes on the async compute queue.
+    bool asyncCompute = false;
+    // Some render passes do not access any resources (side effects outside of the frame graph).
+    bool emptyRenderPasses = false;
+};
+// Render passes access up to 4 different resources, in a random state that is supported by their queue.
+TestFrameGraph createRandomFrameGraph(const RandomFrameGraphSettings& settings, std::mt19937& rng);
+
+// Records the commands into a list so that the order in which they are submitted can be verified.
+class TestCommandRecorder : public Render::FrameGraphInternal::IFGCommandRecorder {
+public:
+    void recordBarriers(std::span<const Render::FrameGraphInternal::FGBarrier> barriers) override;
+    void recordRenderPass(size_t operationIdx) override;
+
+    using Command = std::variant<std::vector<Render::FrameGraphInternal::FGBarrier>, size_t>;
+    std::vector<Command> commands;
+};
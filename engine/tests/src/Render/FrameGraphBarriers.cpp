@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "FrameGraph.h"
+#include <Engine/Render/FrameGraph/BarrierPlanner.h>
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+static FGBarrierPlan planTestBarriers(const TestFrameGraph& frameGraph, const FGBarrierPlannerSettings& settings = {})
+{
+    return planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses, settings);
+}
+
+static bool isTransition(const FGBarrier& barrier, uint32_t resourceIdx, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter, D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE)
+{
+    return barrier.barrierType == FGBarrierType::Transition && barrier.resourceIdx == resourceIdx && barrier.stateBefore == stateBefore && barrier.stateAfter == stateAfter && barrier.flags == flags;
+}
+
+// Executes the plan for two frames and verifies that every render pass sees its resources in the desired state.
+static void validatePlan(const TestFrameGraph& frameGraph, const FGBarrierPlan& plan)
+{
+    REQUIRE(plan.numBatches() == frameGraph.renderPasses.size() + 1);
+    std::vector<D3D12_RESOURCE_STATES> states = plan.initialStates;
+    std::vector<std::optional<D3D12_RESOURCE_STATES>> pendingTransitions(states.size());
+    for (int frame = 0; frame < 2; ++frame) {
+        for (size_t batchIdx = 0; batchIdx < plan.numBatches(); ++batchIdx) {
+            for (const auto& barrier : plan.batch(batchIdx)) {
+                if (barrier.barrierType != FGBarrierType::Transition)
+                    continue;
+                REQUIRE(states[barrier.resourceIdx] == barrier.stateBefore);
+                if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+                    REQUIRE(!pendingTransitions[barrier.resourceIdx]);
+                    pendingTransitions[barrier.resourceIdx] = barrier.stateAfter;
+                } else if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+                    REQUIRE(pendingTransitions[barrier.resourceIdx] == barrier.stateAfter);
+                    pendingTransitions[barrier.resourceIdx].reset();
+                    states[barrier.resourceIdx] = barrier.stateAfter;
+                } else {
+                    REQUIRE(!pendingTransitions[barrier.resourceIdx]);
+                    states[barrier.resourceIdx] = barrier.stateAfter;
+                }
+            }
+            if (batchIdx == frameGraph.renderPasses.size())
+                break;
+
+            const auto& renderPass = frameGraph.renderPasses[batchIdx];
+            for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+                const auto& resourceAccess = frameGraph.resourceAccesses[resourceAccessIdx];
+                REQUIRE(!pendingTransitions[resourceAccess.resourceIdx]);
+                REQUIRE((states[resourceAccess.resourceIdx] & resourceAccess.desiredState) == resourceAccess.desiredState);
+            }
+        }
+        REQUIRE(states == plan.initialStates);
+    }
+}
+
+TEST_CASE("Render::FrameGraph::Barriers batched per render pass", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t gBuffer = frameGraph.addResource(FGResourceType::Transient);
+    const uint32_t depthBuffer = frameGraph.addResource(FGResourceType::Persistent);
+    frameGraph.addRenderPass({ { gBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET }, { depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE } });
+    frameGraph.addRenderPass({ { gBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { depthBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE } });
+
+    const auto plan = planTestBarriers(frameGraph);
+    validatePlan(frameGraph, plan);
+    REQUIRE(plan.initialStates[gBuffer] == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    REQUIRE(plan.initialStates[depthBuffer] == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    // The transient resource is activated before it is transitioned.
+    const auto batch0 = plan.batch(0);
+    REQUIRE(batch0.size() == 3);
+    REQUIRE(batch0[0].barrierType == FGBarrierType::Aliasing);
+    REQUIRE(batch0[0].resourceIdx == gBuffer);
+    REQUIRE(isTransition(batch0[1], gBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET));
+    REQUIRE(isTransition(batch0[2], depthBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE));
+
+    const auto batch1 = plan.batch(1);
+    REQUIRE(batch1.size() == 2);
+    REQUIRE(isTransition(batch1[0], gBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+    REQUIRE(isTransition(batch1[1], depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+    REQUIRE(plan.batch(2).empty());
+
+    REQUIRE(plan.statistics.numBatches == 2);
+    REQUIRE(plan.statistics.numTransitions == 4);
+    REQUIRE(plan.statistics.numAliasingBarriers == 1);
+}
+
+TEST_CASE("Render::FrameGraph::Split barriers", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t swapChain = frameGraph.addResource(FGResourceType::SwapChain);
+    const uint32_t shadowMap = frameGraph.addResource(FGResourceType::Persistent);
+    const uint32_t other = frameGraph.addResource(FGResourceType::Persistent);
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE } });
+    frameGraph.addRenderPass({ { other, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { other, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass({ { other, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+
+    SECTION("Enabled")
+    {
+        const auto plan = planTestBarriers(frameGraph);
+        validatePlan(frameGraph, plan);
+        REQUIRE(plan.statistics.numSplitTransitions == 2);
+
+        // The shadow map transition starts right after the last pass that writes it and ends before the pass that reads it.
+        REQUIRE(plan.batch(1).size() == 1);
+        REQUIRE(isTransition(plan.batch(1)[0], shadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY));
+        const auto batch3 = plan.batch(3);
+        REQUIRE(std::count_if(std::begin(batch3), std::end(batch3), [&](const FGBarrier& barrier) {
+            return isTransition(barrier, shadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+        }) == 1);
+
+        // The swap chain is transitioned back to PRESENT at the end of the frame (its next use).
+        REQUIRE(plan.initialStates[swapChain] == D3D12_RESOURCE_STATE_PRESENT);
+        REQUIRE(isTransition(plan.batch(4).back(), swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY));
+        REQUIRE(plan.batch(5).size() == 1);
+        REQUIRE(isTransition(plan.batch(5)[0], swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY));
+    }
+
+    SECTION("Disabled")
+    {
+        const auto plan = planTestBarriers(frameGraph, { .splitBarriers = false });
+        validatePlan(frameGraph, plan);
+        REQUIRE(plan.statistics.numSplitTransitions == 0);
+        REQUIRE(plan.batch(1).empty());
+        for (const auto& barrier : plan.barriers)
+            REQUIRE(barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_NONE);
+    }
+}
+
+TEST_CASE("Render::FrameGraph::UAV barriers", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t bufferA = frameGraph.addResource(FGResourceType::Persistent);
+    const uint32_t bufferB = frameGraph.addResource(FGResourceType::Persistent);
+    const uint32_t texture = frameGraph.addResource(FGResourceType::Persistent);
+    frameGraph.addRenderPass({ { bufferA, D3D12_RESOURCE_STATE_UNORDERED_ACCESS }, { bufferB, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { bufferA, D3D12_RESOURCE_STATE_UNORDERED_ACCESS }, { bufferB, D3D12_RESOURCE_STATE_UNORDERED_ACCESS }, { texture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+
+    // No UAV barriers at the start of the frame (nothing to wait for), nor for resources that are also transitioned.
+    const auto plan = planTestBarriers(frameGraph);
+    validatePlan(frameGraph, plan);
+    REQUIRE(plan.batch(0).empty());
+    REQUIRE(plan.batch(1).size() == 1);
+    REQUIRE(plan.batch(1)[0].barrierType == FGBarrierType::UAV);
+    REQUIRE(plan.batch(1)[0].resourceIdx == FGBarrier::AllResources);
+    REQUIRE(plan.statistics.numUAVBarriers == 1);
+    REQUIRE(plan.statistics.numMergedUAVBarriers == 1);
+
+    const auto unmergedPlan = planTestBarriers(frameGraph, { .mergeUAVBarriers = false });
+    REQUIRE(unmergedPlan.batch(1).size() == 2);
+    REQUIRE(unmergedPlan.batch(1)[0].resourceIdx == bufferA);
+    REQUIRE(unmergedPlan.batch(1)[1].resourceIdx == bufferB);
+    REQUIRE(unmergedPlan.statistics.numUAVBarriers == 2);
+}
+
+TEST_CASE("Render::FrameGraph::Read-only states are combined", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t depthBuffer = frameGraph.addResource(FGResourceType::Transient);
+    frameGraph.addRenderPass({ { depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE } });
+    frameGraph.addRenderPass({ { depthBuffer, D3D12_RESOURCE_STATE_DEPTH_READ }, { depthBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE } });
+
+    const auto plan = planTestBarriers(frameGraph);
+    validatePlan(frameGraph, plan);
+    REQUIRE(plan.batch(1).size() == 1);
+    REQUIRE(isTransition(plan.batch(1)[0], depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+}
+
+TEST_CASE("Render::FrameGraph::Random barrier plans", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    for (int i = 0; i < 100; ++i) {
+        const uint32_t numRenderPasses = 1 + rng() % 12;
+        const auto frameGraph = createRandomFrameGraph({ .numRenderPasses = numRenderPasses }, rng);
+        const auto plan = planTestBarriers(frameGraph, { .minSplitDistance = 1 + (uint32_t)i % 3 });
+        validatePlan(frameGraph, plan);
+        REQUIRE(plan.statistics.numBatches <= numRenderPasses + 1);
+    }
+}
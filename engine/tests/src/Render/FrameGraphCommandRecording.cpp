@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "FrameGraph.h"
+#include <Engine/Render/FrameGraph/BarrierPlanner.h>
+#include <Engine/Render/FrameGraph/CommandRecording.h>
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <Engine/Render/FrameGraph/QueueScheduling.h>
+#include <random>
+#include <variant>
+#include <vector>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+// Every split transition must begin and end within the same command list.
+static void validateSplitBarriers(std::span<const FGBarrier> barriers, size_t numResources)
+{
+    std::vector<bool> pendingSplitTransitions(numResources, false);
+    for (const auto& barrier : barriers) {
+        if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+            REQUIRE(!pendingSplitTransitions[barrier.resourceIdx]);
+            pendingSplitTransitions[barrier.resourceIdx] = true;
+        } else if (barrier.flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+            REQUIRE(pendingSplitTransitions[barrier.resourceIdx]);
+            pendingSplitTransitions[barrier.resourceIdx] = false;
+        }
+    }
+    for (const bool pending : pendingSplitTransitions)
+        REQUIRE(!pending);
+}
+
+namespace Render::FrameGraphInternal {
+static bool operator==(const FGBarrier& lhs, const FGBarrier& rhs)
+{
+    return lhs.barrierType == rhs.barrierType && lhs.resourceIdx == rhs.resourceIdx && lhs.stateBefore == rhs.stateBefore && lhs.stateAfter == rhs.stateAfter && lhs.flags == rhs.flags;
+}
+}
+
+TEST_CASE("Render::FrameGraph::Pass groups cover all render passes", "[Render]")
+{
+    const auto groupSizes = [](std::span<const FGPassGroup> passGroups) {
+        std::vector<size_t> out;
+        size_t operationEnd = 0;
+        for (const auto& passGroup : passGroups) {
+            REQUIRE(passGroup.operationBegin == operationEnd);
+            out.push_back(passGroup.operationEnd - passGroup.operationBegin);
+            operationEnd = passGroup.operationEnd;
+        }
+        return out;
+    };
+    REQUIRE(groupSizes(partitionPassGroups(10, 4, 2)) == std::vector<size_t> { 3, 3, 2, 2 });
+    REQUIRE(groupSizes(partitionPassGroups(10, 4, 4)) == std::vector<size_t> { 5, 5 });
+    REQUIRE(groupSizes(partitionPassGroups(10, 4, 16)) == std::vector<size_t> { 10 });
+    REQUIRE(groupSizes(partitionPassGroups(5, 16, 1)) == std::vector<size_t> { 1, 1, 1, 1, 1 });
+    REQUIRE(groupSizes(partitionPassGroups(0, 4, 1)) == std::vector<size_t> { 0 });
+}
+
+TEST_CASE("Render::FrameGraph::Split barriers do not cross pass groups", "[Render]")
+{
+    // The shadow map is written by the first and read by the last render pass.
+    TestFrameGraph frameGraph;
+    const uint32_t shadowMap = frameGraph.addResource(FGResourceType::Persistent);
+    const uint32_t other = frameGraph.addResource(FGResourceType::Persistent);
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE } });
+    frameGraph.addRenderPass({ { other, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { other, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE } });
+    const auto barrierPlan = planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    const auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(barrierPlan.statistics.numSplitTransitions == 1);
+
+    SECTION("Single group")
+    {
+        const auto passGroups = partitionPassGroups(frameGraph.renderPasses.size(), 1, 1);
+        const auto legalizedPlan = legalizeSplitBarriers(barrierPlan, queueSchedule, passGroups);
+        REQUIRE(legalizedPlan.barriers.size() == barrierPlan.barriers.size());
+        REQUIRE(legalizedPlan.batchStarts == barrierPlan.batchStarts);
+        REQUIRE(legalizedPlan.statistics.numSplitTransitions == 1);
+    }
+
+    SECTION("Two groups")
+    {
+        const auto passGroups = partitionPassGroups(frameGraph.renderPasses.size(), 2, 1);
+        const auto legalizedPlan = legalizeSplitBarriers(barrierPlan, queueSchedule, passGroups);
+        REQUIRE(legalizedPlan.statistics.numSplitTransitions == 0);
+        REQUIRE(legalizedPlan.statistics.numTransitions == barrierPlan.statistics.numTransitions + 1);
+        REQUIRE(legalizedPlan.batch(1).empty());
+        const auto batch3 = legalizedPlan.batch(3);
+        REQUIRE(batch3.size() == 1);
+        REQUIRE(batch3[0] == FGBarrier { .barrierType = FGBarrierType::Transition, .resourceIdx = 0, .stateBefore = D3D12_RESOURCE_STATE_DEPTH_WRITE, .stateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE });
+        REQUIRE(legalizedPlan.initialStates == barrierPlan.initialStates);
+    }
+}
+
+TEST_CASE("Render::FrameGraph::Pass groups are recorded in order", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    for (int i = 0; i < 100; ++i) {
+        const auto frameGraph = createRandomFrameGraph({ .numRenderPasses = 1 + (uint32_t)(rng() % 24) }, rng);
+        const auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+        const auto passGroups = partitionPassGroups(frameGraph.renderPasses.size(), 1 + rng() % 6, 1 + rng() % 3);
+        const auto barrierPlan = legalizeSplitBarriers(planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses, { .minSplitDistance = 2 }), queueSchedule, passGroups);
+        const std::vector<FGBarrier> initialBarriers {
+            { .barrierType = FGBarrierType::Transition, .resourceIdx = 1, .stateBefore = D3D12_RESOURCE_STATE_COMMON, .stateAfter = barrierPlan.initialStates[1] }
+        };
+
+        std::vector<TestCommandRecorder> recorders(passGroups.size());
+        std::vector<IFGCommandRecorder*> pRecorders;
+        for (auto& recorder : recorders)
+            pRecorders.push_back(&recorder);
+        recordPassGroups(barrierPlan, queueSchedule, initialBarriers, passGroups, pRecorders);
+
+        // Submitting the recorders in order gives the same commands as recording the frame graph on a single thread.
+        std::vector<TestCommandRecorder::Command> expectedCommands;
+        expectedCommands.emplace_back(initialBarriers);
+        for (size_t operationIdx = 0; operationIdx <= frameGraph.renderPasses.size(); ++operationIdx) {
+            const auto batch = barrierPlan.batch(operationIdx);
+            if (!batch.empty())
+                expectedCommands.emplace_back(std::vector(std::begin(batch), std::end(batch)));
+            if (operationIdx < frameGraph.renderPasses.size())
+                expectedCommands.emplace_back(operationIdx);
+        }
+        std::vector<TestCommandRecorder::Command> commands;
+        for (size_t groupIdx = 0; groupIdx < passGroups.size(); ++groupIdx) {
+            const auto& recorder = recorders[groupIdx];
+            commands.insert(std::end(commands), std::begin(recorder.commands), std::end(recorder.commands));
+
+            // Render passes are recorded by the recorder of their group.
+            std::vector<FGBarrier> barriers;
+            for (const auto& command : recorder.commands) {
+                if (const auto* pOperationIdx = std::get_if<size_t>(&command)) {
+                    REQUIRE(*pOperationIdx >= passGroups[groupIdx].operationBegin);
+                    REQUIRE(*pOperationIdx < passGroups[groupIdx].operationEnd);
+                } else {
+                    const auto& commandBarriers = std::get<std::vector<FGBarrier>>(command);
+                    barriers.insert(std::end(barriers), std::begin(commandBarriers), std::end(commandBarriers));
+                }
+            }
+            validateSplitBarriers(barriers, frameGraph.resources.size());
+        }
+        REQUIRE(commands == expectedCommands);
+    }
+}
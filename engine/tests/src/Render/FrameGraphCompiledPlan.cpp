@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "FrameGraph.h"
+#include <Engine/Render/FrameGraph/BarrierPlanner.h>
+#include <Engine/Render/FrameGraph/CompiledPlan.h>
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <Engine/Render/FrameGraph/QueueScheduling.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <nlohmann/json.hpp>
+DISABLE_WARNINGS_POP()
+#include <string>
+#include <vector>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+static const CD3DX12_RESOURCE_DESC textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, 1920, 1080);
+
+static FGCompiledPlan compileTestPlan(const TestFrameGraph& frameGraph)
+{
+    auto plan = createCompiledPlan(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    plan.queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    plan.barrierPlan = planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    plan.barrierPlan = legalizeQueueBarriers(plan.barrierPlan, plan.queueSchedule, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    for (size_t resourceIdx = 0; resourceIdx < plan.resources.size(); ++resourceIdx)
+        plan.resources[resourceIdx].initialState = plan.barrierPlan.initialStates[resourceIdx];
+    return plan;
+}
+
+TEST_CASE("Render::FrameGraph::Compiled plans are exported as JSON", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t swapChain = frameGraph.addResource(FGResourceType::SwapChain, textureDesc);
+    const uint32_t gbuffer = frameGraph.addResource(FGResourceType::Transient, textureDesc);
+    const uint32_t unused = frameGraph.addResource(FGResourceType::Transient, textureDesc);
+    frameGraph.addRenderPass("GBuffer", RenderPassQueue::Graphics, { { gbuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass("Shading", RenderPassQueue::Graphics, { { gbuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    auto plan = compileTestPlan(frameGraph);
+    plan.resources[gbuffer].heapOffset = 65536;
+    plan.resources[gbuffer].sizeInBytes = 1920 * 1080 * 8;
+    plan.heapSizes = { 65536 + 1920 * 1080 * 8 };
+
+    const auto json = nlohmann::json::parse(exportPlanToJSON(plan));
+    REQUIRE(json["statistics"]["transientMemorySize"] == plan.heapSizes[0]);
+    REQUIRE(json["statistics"]["numTransitions"] == plan.barrierPlan.statistics.numTransitions);
+
+    const auto& jsonResources = json["resources"];
+    REQUIRE(jsonResources.size() == 3);
+    REQUIRE(jsonResources[swapChain]["type"] == "SwapChain");
+    REQUIRE(jsonResources[gbuffer]["type"] == "Transient");
+    REQUIRE(jsonResources[gbuffer]["width"] == 1920);
+    REQUIRE(jsonResources[gbuffer]["lifetime"] == nlohmann::json { 0, 1 });
+    REQUIRE(jsonResources[gbuffer]["offset"] == 65536);
+    REQUIRE(jsonResources[unused]["lifetime"].is_null());
+    REQUIRE(!jsonResources[swapChain].contains("offset"));
+
+    const auto& jsonPasses = json["passes"];
+    REQUIRE(jsonPasses.size() == 2);
+    REQUIRE(jsonPasses[0]["name"] == "GBuffer");
+    REQUIRE(jsonPasses[0]["queue"] == "Graphics");
+    REQUIRE(jsonPasses[1]["accesses"][0]["resource"] == gbuffer);
+    REQUIRE(jsonPasses[1]["accesses"][0]["state"] == "NON_PIXEL_SHADER_RESOURCE|PIXEL_SHADER_RESOURCE");
+
+    // Every barrier of the plan is exported, right before the render pass that it was planned for.
+    size_t numBarriers = json["endOfFrameBarriers"].size();
+    for (const auto& jsonPass : jsonPasses)
+        numBarriers += jsonPass["barriers"].size();
+    REQUIRE(numBarriers == plan.barrierPlan.barriers.size());
+    bool foundTransition = false;
+    for (const auto& jsonBarrier : jsonPasses[1]["barriers"]) {
+        if (jsonBarrier["type"] == "Transition" && jsonBarrier["resource"] == gbuffer) {
+            REQUIRE(jsonBarrier["before"] == "RENDER_TARGET");
+            REQUIRE(jsonBarrier["after"] == "NON_PIXEL_SHADER_RESOURCE|PIXEL_SHADER_RESOURCE");
+            foundTransition = true;
+        }
+    }
+    REQUIRE(foundTransition);
+
+    REQUIRE(json["segments"].size() == 1);
+    REQUIRE(json["segments"][0]["passes"] == nlohmann::json { 0, 1 });
+}
+
+TEST_CASE("Render::FrameGraph::Compiled plans are exported as Graphviz", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    frameGraph.addResource(FGResourceType::SwapChain, textureDesc);
+    frameGraph.addResource(FGResourceType::Transient, textureDesc);
+    frameGraph.addResource(FGResourceType::Transient, textureDesc);
+    frameGraph.addRenderPass("GBuffer", RenderPassQueue::Graphics, { { 1, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass("Sun \"visibility\"", RenderPassQueue::AsyncCompute, { { 1, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE }, { 2, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass("Shading", RenderPassQueue::Graphics, { { 2, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { 0, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    const auto plan = compileTestPlan(frameGraph);
+
+    const auto graphviz = exportPlanToGraphviz(plan);
+    REQUIRE(graphviz.starts_with("digraph FrameGraph {"));
+    REQUIRE(graphviz.ends_with("}\n"));
+    REQUIRE(graphviz.find("pass0 -> resource1 [label=\"RENDER_TARGET\"]") != std::string::npos);
+    REQUIRE(graphviz.find("resource1 -> pass1 [label=\"NON_PIXEL_SHADER_RESOURCE\"]") != std::string::npos);
+    REQUIRE(graphviz.find("pass1 -> resource2 [label=\"UNORDERED_ACCESS\"]") != std::string::npos);
+    REQUIRE(graphviz.find("label=\"1: Sun \\\"visibility\\\"\"") != std::string::npos);
+    // The shading pass waits for the async compute pass.
+    REQUIRE(graphviz.find("pass1 -> pass2 [style=dashed, label=\"fence\"]") != std::string::npos);
+    for (size_t segmentIdx = 0; segmentIdx < plan.queueSchedule.segments.size(); ++segmentIdx)
+        REQUIRE(graphviz.find("subgraph cluster_segment" + std::to_string(segmentIdx) + " {") != std::string::npos);
+}
@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "FrameGraph.h"
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <Engine/Render/FrameGraph/PassOrdering.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+static bool isWrite(const FGResourceAccess& resourceAccess)
+{
+    return resourceAccess.desiredState == D3D12_RESOURCE_STATE_RENDER_TARGET || resourceAccess.desiredState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+        || resourceAccess.desiredState == D3D12_RESOURCE_STATE_DEPTH_WRITE || resourceAccess.desiredState == D3D12_RESOURCE_STATE_COPY_DEST;
+}
+
+static std::span<const FGResourceAccess> accessesOf(const TestFrameGraph& frameGraph, uint32_t passIdx)
+{
+    const auto& renderPass = frameGraph.renderPasses[passIdx];
+    return std::span(frameGraph.resourceAccesses).subspan(renderPass.resourceAccessBegin, renderPass.resourceAccessEnd - renderPass.resourceAccessBegin);
+}
+
+TEST_CASE("Render::FrameGraph::Render passes that do not contribute to the output are culled", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t swapChain = frameGraph.addResource(FGResourceType::SwapChain);
+    const uint32_t gbuffer = frameGraph.addResource(FGResourceType::Transient);
+    const uint32_t debugBuffer = frameGraph.addResource(FGResourceType::Transient);
+    const uint32_t history = frameGraph.addResource(FGResourceType::Persistent);
+    frameGraph.addRenderPass({ { gbuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } }); // 0
+    frameGraph.addRenderPass({ { gbuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { debugBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } }); // 1: unused debug output.
+    frameGraph.addRenderPass({ { debugBuffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } }); // 2: modifies the unused debug output.
+    frameGraph.addRenderPass({}); // 3: no resources (side effects outside of the frame graph).
+    frameGraph.addRenderPass({ { gbuffer, D3D12_RESOURCE_STATE_COPY_SOURCE } }); // 4: only reads (copies to a readback buffer).
+    frameGraph.addRenderPass({ { gbuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET } }); // 5
+    frameGraph.addRenderPass({ { swapChain, D3D12_RESOURCE_STATE_COPY_SOURCE }, { history, D3D12_RESOURCE_STATE_COPY_DEST } }); // 6
+
+    const auto passOrder = orderRenderPasses(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(passOrder.order == std::vector<uint32_t> { 0, 3, 4, 5, 6 });
+    REQUIRE(passOrder.statistics.numCulledPasses == 2);
+    REQUIRE(passOrder.statistics.numMovedPasses == 0);
+}
+
+TEST_CASE("Render::FrameGraph::Render passes are reordered to shorten transient lifetimes", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    const uint32_t swapChain = frameGraph.addResource(FGResourceType::SwapChain);
+    const uint32_t shadowMap = frameGraph.addResource(FGResourceType::Transient);
+    const uint32_t ambientOcclusion = frameGraph.addResource(FGResourceType::Transient);
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE } });
+    frameGraph.addRenderPass({ { ambientOcclusion, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass({ { shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass({ { ambientOcclusion, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { swapChain, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+
+    // The shadow map is no longer needed by the time that the ambient occlusion is computed, so they can share memory.
+    const auto passOrder = orderRenderPasses(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(passOrder.order == std::vector<uint32_t> { 0, 2, 1, 3 });
+    REQUIRE(passOrder.statistics.numCulledPasses == 0);
+    REQUIRE(passOrder.statistics.numMovedPasses == 2);
+
+    SECTION("Render passes without resources are not reordered")
+    {
+        auto iter = frameGraph.renderPasses.emplace(std::begin(frameGraph.renderPasses) + 2);
+        iter->resourceAccessBegin = iter->resourceAccessEnd = 0;
+        const auto passOrder2 = orderRenderPasses(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+        REQUIRE(passOrder2.order == std::vector<uint32_t> { 0, 1, 2, 3, 4 });
+        REQUIRE(passOrder2.statistics.numMovedPasses == 0);
+    }
+}
+
+TEST_CASE("Render::FrameGraph::Reordered render passes respect their dependencies", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    for (int i = 0; i < 200; ++i) {
+        const uint32_t numRenderPasses = 1 + rng() % 24;
+        const auto frameGraph = createRandomFrameGraph({ .numRenderPasses = numRenderPasses, .numResources = 10, .emptyRenderPasses = true }, rng);
+
+        const auto passOrder = orderRenderPasses(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+        std::vector<uint32_t> positions(numRenderPasses, (uint32_t)-1);
+        for (uint32_t position = 0; position < passOrder.order.size(); ++position) {
+            REQUIRE(positions[passOrder.order[position]] == (uint32_t)-1);
+            positions[passOrder.order[position]] = position;
+        }
+        const auto isKept = [&](uint32_t passIdx) { return positions[passIdx] != (uint32_t)-1; };
+        REQUIRE(passOrder.statistics.numCulledPasses == numRenderPasses - passOrder.order.size());
+
+        for (uint32_t passIdx = 0; passIdx < numRenderPasses; ++passIdx) {
+            const auto accesses = accessesOf(frameGraph, passIdx);
+            // A render pass is kept if it has no writes, writes a non-transient resource, or writes a resource that a
+            // (kept) render pass accesses later.
+            bool required = std::none_of(std::begin(accesses), std::end(accesses), isWrite);
+            for (const auto& resourceAccess : accesses) {
+                if (!isWrite(resourceAccess))
+                    continue;
+                if (frameGraph.resources[resourceAccess.resourceIdx].resourceType != FGResourceType::Transient)
+                    required = true;
+                for (uint32_t laterPassIdx = passIdx + 1; laterPassIdx < numRenderPasses; ++laterPassIdx) {
+                    const auto laterAccesses = accessesOf(frameGraph, laterPassIdx);
+                    if (isKept(laterPassIdx) && std::any_of(std::begin(laterAccesses), std::end(laterAccesses), [&](const FGResourceAccess& laterAccess) { return laterAccess.resourceIdx == resourceAccess.resourceIdx; }))
+                        required = true;
+                }
+            }
+            REQUIRE(isKept(passIdx) == required);
+            if (!isKept(passIdx))
+                continue;
+
+            // Render passes that access the same resource (of which at least one writes to it) are not reordered. Neither
+            // are render passes without resources.
+            for (uint32_t laterPassIdx = passIdx + 1; laterPassIdx < numRenderPasses; ++laterPassIdx) {
+                if (!isKept(laterPassIdx))
+                    continue;
+                const auto laterAccesses = accessesOf(frameGraph, laterPassIdx);
+                bool dependent = accesses.empty() || laterAccesses.empty();
+                for (const auto& resourceAccess : accesses) {
+                    for (const auto& laterAccess : laterAccesses)
+                        dependent |= resourceAccess.resourceIdx == laterAccess.resourceIdx && (isWrite(resourceAccess) || isWrite(laterAccess));
+                }
+                if (dependent)
+                    REQUIRE(positions[passIdx] < positions[laterPassIdx]);
+            }
+        }
+    }
+}
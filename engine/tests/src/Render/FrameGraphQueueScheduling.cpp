@@ -0,0 +1,245 @@
+#include "pch.h"
+#include "FrameGraph.h"
+#include <Engine/Render/FrameGraph/BarrierPlanner.h>
+#include <Engine/Render/FrameGraph/CommandRecording.h>
+#include <Engine/Render/FrameGraph/FrameGraphInternal.h>
+#include <Engine/Render/FrameGraph/QueueScheduling.h>
+#include <random>
+#include <variant>
+#include <vector>
+
+using namespace Render;
+using namespace Render::FrameGraphInternal;
+
+// Track the state of each resource while executing the commands; render passes must find their resources in the desired state.
+static void executeCommands(const TestFrameGraph& frameGraph, std::span<const TestCommandRecorder::Command> commands, std::vector<D3D12_RESOURCE_STATES>& resourceStates)
+{
+    for (const auto& command : commands) {
+        if (const auto* pOperationIdx = std::get_if<size_t>(&command)) {
+            const auto& renderPass = frameGraph.renderPasses[*pOperationIdx];
+            for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+                const auto& resourceAccess = frameGraph.resourceAccesses[resourceAccessIdx];
+                REQUIRE(resourceStates[resourceAccess.resourceIdx] == resourceAccess.desiredState);
+            }
+            continue;
+        }
+        for (const auto& barrier : std::get<std::vector<FGBarrier>>(command)) {
+            if (barrier.barrierType != FGBarrierType::Transition)
+                continue;
+            REQUIRE(resourceStates[barrier.resourceIdx] == barrier.stateBefore);
+            if (barrier.flags != D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+                resourceStates[barrier.resourceIdx] = barrier.stateAfter;
+        }
+    }
+}
+
+TEST_CASE("Render::FrameGraph::Graphics-only frame graphs are scheduled as a single segment", "[Render]")
+{
+    TestFrameGraph frameGraph;
+    frameGraph.resources = { { .resourceType = FGResourceType::Transient }, { .resourceType = FGResourceType::SwapChain } };
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { 0, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { 0, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { 1, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+
+    const auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(queueSchedule.segments.size() == 1);
+    REQUIRE(queueSchedule.segments[0].queue == RenderPassQueue::Graphics);
+    REQUIRE(queueSchedule.segments[0].waitSegments.empty());
+    REQUIRE(!queueSchedule.segments[0].signal);
+    REQUIRE(queueSchedule.operationOrder == std::vector<uint32_t> { 0, 1 });
+    REQUIRE(queueSchedule.lastConcurrentPass == std::vector<uint32_t> { 0, 1 });
+    REQUIRE(queueSchedule.statistics.numWaits == 0);
+}
+
+TEST_CASE("Render::FrameGraph::Async compute passes are synchronized with the graphics queue", "[Render]")
+{
+    // Deferred rendering with the sun visibility computed on the async compute queue.
+    enum : uint32_t {
+        GBuffer,
+        SunVisibility,
+        RenderBuffer,
+        FrameBuffer
+    };
+    TestFrameGraph frameGraph;
+    frameGraph.resources = { { .resourceType = FGResourceType::Persistent }, { .resourceType = FGResourceType::Transient },
+        { .resourceType = FGResourceType::Transient }, { .resourceType = FGResourceType::SwapChain } };
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { GBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass(RenderPassQueue::AsyncCompute, { { GBuffer, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE }, { SunVisibility, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { RenderBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { GBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { SunVisibility, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { RenderBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { RenderBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE }, { FrameBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+
+    auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(queueSchedule.operationOrder == std::vector<uint32_t> { 0, 1, 2, 3, 4 });
+    const auto& segments = queueSchedule.segments;
+    REQUIRE(segments.size() == 5);
+    const auto segmentOperations = [&](const FGQueueSegment& segment) {
+        return std::vector(std::begin(queueSchedule.operationOrder) + segment.operationBegin, std::begin(queueSchedule.operationOrder) + segment.operationEnd);
+    };
+    // The async compute queue waits for the start of the frame and for the G-buffer; the graphics pass that clears the
+    // render buffer does not depend on the sun visibility and may overlap with it.
+    REQUIRE(segmentOperations(segments[0]).empty());
+    REQUIRE(segments[0].signal);
+    REQUIRE(segmentOperations(segments[1]) == std::vector<uint32_t> { 0 });
+    REQUIRE(segments[1].signal);
+    REQUIRE(segments[2].queue == RenderPassQueue::AsyncCompute);
+    REQUIRE(segmentOperations(segments[2]) == std::vector<uint32_t> { 1 });
+    REQUIRE(segments[2].waitSegments == std::vector<uint32_t> { 0, 1 });
+    REQUIRE(segments[2].signal);
+    REQUIRE(segmentOperations(segments[3]) == std::vector<uint32_t> { 2 });
+    REQUIRE(segments[3].waitSegments.empty());
+    REQUIRE(segmentOperations(segments[4]) == std::vector<uint32_t> { 3, 4 });
+    REQUIRE(segments[4].waitSegments == std::vector<uint32_t> { 2 });
+    REQUIRE(!segments[4].signal);
+    REQUIRE(queueSchedule.statistics.numAsyncComputePasses == 1);
+    REQUIRE(queueSchedule.statistics.numCrossQueueDependencies == 3);
+    REQUIRE(queueSchedule.statistics.numWaits == 3);
+    // The sun visibility pass may overlap with clearing the render buffer, which therefore cannot alias the sun visibility.
+    REQUIRE(queueSchedule.lastConcurrentPass == std::vector<uint32_t> { 0, 2, 2, 3, 4 });
+
+    // The async compute queue cannot transition the G-buffer from RENDER_TARGET, nor the sun visibility from PIXEL_SHADER_RESOURCE
+    // (the state in which the previous frame left it).
+    const auto passGroups = partitionPassGroups(queueSchedule, 4, 1);
+    auto barrierPlan = legalizeSplitBarriers(planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses), queueSchedule, passGroups);
+    barrierPlan = legalizeQueueBarriers(barrierPlan, queueSchedule, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    REQUIRE(queueSchedule.statistics.numMovedTransitions == 2);
+    REQUIRE(segments[0].signalBarriers.size() == 1);
+    REQUIRE(segments[0].signalBarriers[0].resourceIdx == SunVisibility);
+    REQUIRE(segments[0].signalBarriers[0].stateBefore == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    REQUIRE(segments[0].signalBarriers[0].stateAfter == D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    REQUIRE(segments[1].signalBarriers.size() == 1);
+    REQUIRE(segments[1].signalBarriers[0].resourceIdx == GBuffer);
+    REQUIRE(segments[1].signalBarriers[0].stateBefore == D3D12_RESOURCE_STATE_RENDER_TARGET);
+    REQUIRE(segments[1].signalBarriers[0].stateAfter == D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    const auto asyncComputeBarriers = barrierPlan.batch(1);
+    REQUIRE(asyncComputeBarriers.size() == 1);
+    REQUIRE(asyncComputeBarriers[0].barrierType == FGBarrierType::Aliasing);
+    // Split barriers are not used across queues.
+    REQUIRE(barrierPlan.statistics.numSplitTransitions == 0);
+}
+
+TEST_CASE("Render::FrameGraph::Fence waits that are implied by an earlier wait are skipped", "[Render]")
+{
+    enum : uint32_t {
+        A,
+        B,
+        X
+    };
+    TestFrameGraph frameGraph;
+    frameGraph.resources = { { .resourceType = FGResourceType::Transient }, { .resourceType = FGResourceType::Transient }, { .resourceType = FGResourceType::Transient } };
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { A, D3D12_RESOURCE_STATE_RENDER_TARGET }, { B, D3D12_RESOURCE_STATE_RENDER_TARGET } });
+    frameGraph.addRenderPass(RenderPassQueue::AsyncCompute, { { A, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE }, { X, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass(RenderPassQueue::AsyncCompute, { { B, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE }, { X, D3D12_RESOURCE_STATE_UNORDERED_ACCESS } });
+    frameGraph.addRenderPass(RenderPassQueue::Graphics, { { X, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE } });
+
+    const auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+    const auto& segments = queueSchedule.segments;
+    REQUIRE(segments.size() == 4);
+    REQUIRE(segments[2].queue == RenderPassQueue::AsyncCompute);
+    REQUIRE(segments[2].operationEnd - segments[2].operationBegin == 2);
+    REQUIRE(segments[2].waitSegments == std::vector<uint32_t> { 0, 1 });
+    REQUIRE(segments[3].waitSegments == std::vector<uint32_t> { 2 });
+    REQUIRE(queueSchedule.statistics.numCrossQueueDependencies == 3);
+    REQUIRE(queueSchedule.statistics.numWaits == 3);
+}
+
+TEST_CASE("Render::FrameGraph::Random frame graphs are scheduled without races", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    for (int i = 0; i < 200; ++i) {
+        const auto frameGraph = createRandomFrameGraph({ .numRenderPasses = 1 + (uint32_t)(rng() % 24), .asyncCompute = true }, rng);
+        const uint32_t numPasses = (uint32_t)frameGraph.renderPasses.size();
+        auto queueSchedule = scheduleQueues(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses);
+        const auto& segments = queueSchedule.segments;
+
+        // Segments only wait for segments that were submitted before them; the frame ends on the graphics queue.
+        std::vector<uint32_t> passSegments(numPasses), passPositions(numPasses);
+        REQUIRE(segments.back().queue == RenderPassQueue::Graphics);
+        for (uint32_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx) {
+            const auto& segment = segments[segmentIdx];
+            for (const uint32_t waitSegmentIdx : segment.waitSegments) {
+                REQUIRE(waitSegmentIdx < segmentIdx);
+                REQUIRE(segments[waitSegmentIdx].queue != segment.queue);
+                REQUIRE(segments[waitSegmentIdx].signal);
+            }
+            for (size_t i = segment.operationBegin; i < segment.operationEnd; ++i) {
+                const uint32_t passIdx = queueSchedule.operationOrder[i];
+                REQUIRE(frameGraph.renderPasses[passIdx].queue == segment.queue);
+                passSegments[passIdx] = segmentIdx;
+                passPositions[passIdx] = (uint32_t)i;
+            }
+        }
+
+        // Segment A completes before segment B starts if there is a path from A to B through the segments of the same queue
+        // and the fence waits.
+        std::vector<std::vector<bool>> segmentCompletedBefore(segments.size(), std::vector<bool>(segments.size(), false));
+        for (uint32_t segmentIdx = 0; segmentIdx < segments.size(); ++segmentIdx) {
+            auto& completedBefore = segmentCompletedBefore[segmentIdx];
+            const auto addPredecessor = [&](uint32_t predecessorIdx) {
+                completedBefore[predecessorIdx] = true;
+                for (uint32_t segmentIdx2 = 0; segmentIdx2 < segments.size(); ++segmentIdx2)
+                    completedBefore[segmentIdx2] = completedBefore[segmentIdx2] || segmentCompletedBefore[predecessorIdx][segmentIdx2];
+            };
+            for (uint32_t previousSegmentIdx = 0; previousSegmentIdx < segmentIdx; ++previousSegmentIdx) {
+                if (segments[previousSegmentIdx].queue == segments[segmentIdx].queue)
+                    addPredecessor(previousSegmentIdx);
+            }
+            for (const uint32_t waitSegmentIdx : segments[segmentIdx].waitSegments)
+                addPredecessor(waitSegmentIdx);
+        }
+        // The last graphics segment starts after all other segments have completed, such that the next graphics fence also
+        // covers the async compute work of the frame.
+        for (uint32_t segmentIdx = 0; segmentIdx + 1 < segments.size(); ++segmentIdx)
+            REQUIRE(segmentCompletedBefore.back()[segmentIdx]);
+        const auto completedBefore = [&](uint32_t passIdx, uint32_t otherPassIdx) {
+            if (passSegments[passIdx] == passSegments[otherPassIdx])
+                return passPositions[passIdx] < passPositions[otherPassIdx];
+            return (bool)segmentCompletedBefore[passSegments[otherPassIdx]][passSegments[passIdx]];
+        };
+
+        // Consecutive users of a resource never overlap.
+        std::vector<uint32_t> previousUser(frameGraph.resources.size(), (uint32_t)-1);
+        for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+            const auto& renderPass = frameGraph.renderPasses[passIdx];
+            for (size_t resourceAccessIdx = renderPass.resourceAccessBegin; resourceAccessIdx < renderPass.resourceAccessEnd; ++resourceAccessIdx) {
+                const uint32_t resourceIdx = frameGraph.resourceAccesses[resourceAccessIdx].resourceIdx;
+                if (previousUser[resourceIdx] != (uint32_t)-1)
+                    REQUIRE(completedBefore(previousUser[resourceIdx], passIdx));
+                previousUser[resourceIdx] = passIdx;
+            }
+        }
+        // All render passes after the last concurrent render pass start after the render pass has completed.
+        for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+            uint32_t lastConcurrentPass = passIdx;
+            for (uint32_t otherPassIdx = passIdx + 1; otherPassIdx < numPasses; ++otherPassIdx) {
+                if (!completedBefore(passIdx, otherPassIdx))
+                    lastConcurrentPass = otherPassIdx;
+            }
+            REQUIRE(queueSchedule.lastConcurrentPass[passIdx] == lastConcurrentPass);
+        }
+
+        // Submitting the command lists in order transitions every resource to the state in which it is used, and the async
+        // compute queue never records a transition from/to a graphics state.
+        const auto passGroups = partitionPassGroups(queueSchedule, 1 + rng() % 6, 1 + rng() % 3);
+        auto barrierPlan = legalizeSplitBarriers(planBarriers(frameGraph.resources, frameGraph.resourceAccesses, frameGraph.renderPasses, { .minSplitDistance = 2 }), queueSchedule, passGroups);
+        barrierPlan = legalizeQueueBarriers(barrierPlan, queueSchedule, frameGraph.resourceAccesses, frameGraph.renderPasses);
+        constexpr auto computeStates = D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_COPY_SOURCE;
+        for (uint32_t passIdx = 0; passIdx < numPasses; ++passIdx) {
+            if (frameGraph.renderPasses[passIdx].queue != RenderPassQueue::AsyncCompute)
+                continue;
+            for (const auto& barrier : barrierPlan.batch(passIdx)) {
+                if (barrier.barrierType == FGBarrierType::Transition)
+                    REQUIRE(((barrier.stateBefore | barrier.stateAfter) & ~computeStates) == 0);
+            }
+        }
+
+        std::vector<TestCommandRecorder> recorders(passGroups.size());
+        std::vector<IFGCommandRecorder*> pRecorders;
+        for (auto& recorder : recorders)
+            pRecorders.push_back(&recorder);
+        recordPassGroups(barrierPlan, queueSchedule, {}, passGroups, pRecorders);
+        std::vector<D3D12_RESOURCE_STATES> resourceStates = barrierPlan.initialStates;
+        for (const auto& recorder : recorders)
+            executeCommands(frameGraph, recorder.commands, resourceStates);
+        REQUIRE(resourceStates == barrierPlan.initialStates);
+    }
+}
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include <Engine/Render/FrameGraph/TransientPlacement.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Render::FrameGraphInternal;
+
+static constexpr size_t KiB = 1024;
+static constexpr size_t MiB = 1024 * KiB;
+
+// Resources that are alive during the same render pass may not share memory.
+static void validatePlacement(std::span<const FGTransientResource> resources, const FGTransientPlacement& placement, size_t numHeaps)
+{
+    REQUIRE(placement.offsets.size() == resources.size());
+    REQUIRE(placement.heapSizes.size() == numHeaps);
+    for (size_t i = 0; i < resources.size(); ++i) {
+        const auto& resource = resources[i];
+        REQUIRE(placement.offsets[i] % resource.alignment == 0);
+        REQUIRE(placement.offsets[i] + resource.sizeInBytes <= placement.heapSizes[resource.heapIdx]);
+        for (size_t j = i + 1; j < resources.size(); ++j) {
+            const auto& otherResource = resources[j];
+            const bool overlapsInTime = resource.heapIdx == otherResource.heapIdx && resource.firstPassIdx <= otherResource.lastPassIdx && otherResource.firstPassIdx <= resource.lastPassIdx;
+            const bool overlapsInMemory = placement.offsets[i] < placement.offsets[j] + otherResource.sizeInBytes && placement.offsets[j] < placement.offsets[i] + resource.sizeInBytes;
+            REQUIRE(!(overlapsInTime && overlapsInMemory));
+        }
+    }
+}
+
+static std::vector<FGTransientResource> randomResources(uint32_t numResources, uint32_t numPasses, uint32_t numHeaps, std::mt19937& rng)
+{
+    // Mix of render target sized (MiB) and small (64KiB) resources with short & long lifetimes.
+    std::uniform_int_distribution<uint32_t> sizeDistribution { 1, 32 };
+    std::uniform_int_distribution<uint32_t> passDistribution { 0, numPasses - 1 };
+    std::uniform_int_distribution<uint32_t> lifetimeDistribution { 0, 4 };
+    std::uniform_int_distribution<uint32_t> heapDistribution { 0, numHeaps - 1 };
+    std::bernoulli_distribution smallDistribution { 0.3 };
+    std::vector<FGTransientResource> out;
+    for (uint32_t i = 0; i < numResources; ++i) {
+        const bool small = smallDistribution(rng);
+        const uint32_t firstPassIdx = passDistribution(rng);
+        out.push_back({ .sizeInBytes = sizeDistribution(rng) * (small ? 64 * KiB : MiB),
+            .alignment = small ? 64 * KiB : 4 * MiB,
+            .firstPassIdx = firstPassIdx,
+            .lastPassIdx = std::min(firstPassIdx + lifetimeDistribution(rng), numPasses - 1),
+            .heapIdx = heapDistribution(rng) });
+    }
+    return out;
+}
+
+TEST_CASE("Render::FrameGraph::Transients with disjoint lifetimes share memory", "[Render]")
+{
+    const std::vector<FGTransientResource> resources {
+        { .sizeInBytes = 8 * MiB, .alignment = 64 * KiB, .firstPassIdx = 0, .lastPassIdx = 1 },
+        { .sizeInBytes = 4 * MiB, .alignment = 64 * KiB, .firstPassIdx = 2, .lastPassIdx = 3 },
+        { .sizeInBytes = 4 * MiB, .alignment = 64 * KiB, .firstPassIdx = 2, .lastPassIdx = 2 },
+    };
+    for (const auto strategy : { FGPlacementStrategy::Greedy, FGPlacementStrategy::BestFitDecreasingSize }) {
+        const auto placement = placeTransientResources(resources, 1, strategy);
+        validatePlacement(resources, placement, 1);
+        REQUIRE(placement.totalSizeInBytes() == 8 * MiB);
+    }
+}
+
+TEST_CASE("Render::FrameGraph::Transient placement respects alignment", "[Render]")
+{
+    const std::vector<FGTransientResource> resources {
+        { .sizeInBytes = 64 * KiB, .alignment = 64 * KiB, .firstPassIdx = 0, .lastPassIdx = 2 },
+        { .sizeInBytes = 4 * MiB, .alignment = 4 * MiB, .firstPassIdx = 1, .lastPassIdx = 2 },
+    };
+    const auto placement = placeTransientResources(resources, 1);
+    validatePlacement(resources, placement, 1);
+    REQUIRE(placement.offsets[1] % (4 * MiB) == 0);
+}
+
+TEST_CASE("Render::FrameGraph::Best fit transient placement beats greedy", "[Render]")
+{
+    // Greedy places the small resource of pass 0 at offset 0; the large resource that starts later has to go after it
+    // because the medium resource still occupies the memory behind it. Placing the largest resource first avoids this.
+    const std::vector<FGTransientResource> resources {
+        { .sizeInBytes = 2 * MiB, .alignment = 64 * KiB, .firstPassIdx = 0, .lastPassIdx = 0 },
+        { .sizeInBytes = 4 * MiB, .alignment = 64 * KiB, .firstPassIdx = 0, .lastPassIdx = 1 },
+        { .sizeInBytes = 6 * MiB, .alignment = 64 * KiB, .firstPassIdx = 1, .lastPassIdx = 2 },
+    };
+    const auto greedyPlacement = placeTransientResources(resources, 1, FGPlacementStrategy::Greedy);
+    const auto placement = placeTransientResources(resources, 1, FGPlacementStrategy::BestFitDecreasingSize);
+    validatePlacement(resources, greedyPlacement, 1);
+    validatePlacement(resources, placement, 1);
+    REQUIRE(greedyPlacement.totalSizeInBytes() == 12 * MiB);
+    REQUIRE(placement.totalSizeInBytes() == 10 * MiB);
+    REQUIRE(placement.totalSizeInBytes() == computeTransientMemoryLowerBound(resources, 1)[0]);
+}
+
+TEST_CASE("Render::FrameGraph::Transient placement of equal sizes is optimal", "[Render]")
+{
+    // With equal sizes placement is interval coloring, which best fit solves optimally.
+    std::mt19937 rng { 12345 };
+    auto resources = randomResources(64, 20, 1, rng);
+    for (auto& resource : resources) {
+        resource.sizeInBytes = MiB;
+        resource.alignment = MiB;
+    }
+    const auto placement = placeTransientResources(resources, 1);
+    validatePlacement(resources, placement, 1);
+    REQUIRE(placement.totalSizeInBytes() == computeTransientMemoryLowerBound(resources, 1)[0]);
+}
+
+TEST_CASE("Render::FrameGraph::Random transient placements", "[Render]")
+{
+    std::mt19937 rng { 54321 };
+    size_t totalBestFit = 0, totalGreedy = 0;
+    for (int i = 0; i < 50; ++i) {
+        const uint32_t numHeaps = (i % 2) ? 3 : 1;
+        const auto resources = randomResources(40, 16, numHeaps, rng);
+        const auto greedyPlacement = placeTransientResources(resources, numHeaps, FGPlacementStrategy::Greedy);
+        const auto placement = placeTransientResources(resources, numHeaps, FGPlacementStrategy::BestFitDecreasingSize);
+        validatePlacement(resources, greedyPlacement, numHeaps);
+        validatePlacement(resources, placement, numHeaps);
+
+        const auto lowerBound = computeTransientMemoryLowerBound(resources, numHeaps);
+        for (uint32_t heapIdx = 0; heapIdx < numHeaps; ++heapIdx) {
+            REQUIRE(placement.heapSizes[heapIdx] >= lowerBound[heapIdx]);
+            REQUIRE(placement.heapSizes[heapIdx] <= greedyPlacement.heapSizes[heapIdx]);
+        }
+        totalBestFit += placement.totalSizeInBytes();
+        totalGreedy += greedyPlacement.totalSizeInBytes();
+    }
+    REQUIRE(totalBestFit < totalGreedy);
+}
@@ -0,0 +1,69 @@
+#include "GLTF.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t GLTF_UnsignedInt = 5125;
+static constexpr uint32_t GLTF_Float = 5126;
+
+void writeTestGLTF(const std::filesystem::path& filePath, uint32_t numMeshes, uint32_t gridResolution)
+{
+    std::vector<std::byte> buffer;
+    std::string jsonBufferViews, jsonAccessors, jsonMeshes, jsonNodes, jsonSceneNodes;
+    uint32_t bufferViewIdx = 0;
+    const auto addAccessor = [&]<typename T>(const std::vector<T>& items, uint32_t componentType, const char* type, size_t numComponents) {
+        const size_t byteOffset = buffer.size();
+        buffer.resize(byteOffset + items.size() * sizeof(T));
+        std::memcpy(&buffer[byteOffset], items.data(), items.size() * sizeof(T));
+
+        const std::string separator = bufferViewIdx == 0 ? "" : ",";
+        jsonBufferViews += fmt::format(R"({}{{"buffer":0,"byteOffset":{},"byteLength":{}}})", separator, byteOffset, items.size() * sizeof(T));
+        jsonAccessors += fmt::format(R"({}{{"bufferView":{},"componentType":{},"count":{},"type":"{}"}})", separator, bufferViewIdx, componentType, items.size() / numComponents, type);
+        return bufferViewIdx++;
+    };
+
+    for (uint32_t meshIdx = 0; meshIdx < numMeshes; ++meshIdx) {
+        std::vector<float> positions, normals, texCoords;
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < gridResolution; ++y) {
+            for (uint32_t x = 0; x < gridResolution; ++x) {
+                const float u = float(x) / float(gridResolution - 1), v = float(y) / float(gridResolution - 1);
+                positions.insert(std::end(positions), { u, float(meshIdx), v });
+                normals.insert(std::end(normals), { 0.0f, 1.0f, 0.0f });
+                texCoords.insert(std::end(texCoords), { u, v });
+
+                if (x + 1 < gridResolution && y + 1 < gridResolution) {
+                    const uint32_t i = y * gridResolution + x;
+                    indices.insert(std::end(indices), { i, i + gridResolution, i + 1, i + 1, i + gridResolution, i + gridResolution + 1 });
+                }
+            }
+        }
+
+        const auto positionsIdx = addAccessor(positions, GLTF_Float, "VEC3", 3);
+        const auto normalsIdx = addAccessor(normals, GLTF_Float, "VEC3", 3);
+        const auto texCoordsIdx = addAccessor(texCoords, GLTF_Float, "VEC2", 2);
+        const auto indicesIdx = addAccessor(indices, GLTF_UnsignedInt, "SCALAR", 1);
+
+        const std::string separator = meshIdx == 0 ? "" : ",";
+        jsonMeshes += fmt::format(R"({}{{"primitives":[{{"attributes":{{"POSITION":{},"NORMAL":{},"TEXCOORD_0":{}}},"indices":{}}}]}})", separator, positionsIdx, normalsIdx, texCoordsIdx, indicesIdx);
+        jsonNodes += fmt::format(R"({}{{"mesh":{}}})", separator, meshIdx);
+        jsonSceneNodes += fmt::format("{}{}", separator, meshIdx);
+    }
+
+    auto binFilePath = filePath;
+    binFilePath.replace_extension(".bin");
+    {
+        std::ofstream binFile { binFilePath, std::ios::binary };
+        binFile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+
+    std::ofstream jsonFile { filePath };
+    jsonFile << fmt::format(
+        R"({{"asset":{{"version":"2.0"}},"scene":0,"scenes":[{{"nodes":[{}]}}],"nodes":[{}],"meshes":[{}],"accessors":[{}],"bufferViews":[{}],"buffers":[{{"uri":"{}","byteLength":{}}}]}})",
+        jsonSceneNodes, jsonNodes, jsonMeshes, jsonAccessors, jsonBufferViews, binFilePath.filename().string(), buffer.size());
+}
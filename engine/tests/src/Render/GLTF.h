@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Writes a GLTF file (+ separate *.bin buffer) containing numMeshes flat grids of gridResolution x gridResolution vertices.
+// Each mesh is instanced once in the scene graph. The file does not contain textures.
+void writeTestGLTF(const std::filesystem::path& filePath, uint32_t numMeshes, uint32_t gridResolution);
@@ -0,0 +1,155 @@
+#include "pch.h"
+#include <Engine/Render/GLTFAccessor.h>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Render;
+
+// Write count elements of numComponents random values each with the given stride (0 = tightly packed).
+template <typename T>
+static std::vector<std::byte> createRandomAccessorData(size_t count, uint32_t numComponents, size_t byteStride, std::vector<T>& outValues)
+{
+    std::mt19937 rng { 12345 };
+    const size_t stride = byteStride == 0 ? numComponents * sizeof(T) : byteStride;
+    std::vector<std::byte> out(count * stride, std::byte(0xFF));
+    outValues.resize(count * numComponents);
+    for (size_t i = 0; i < count; ++i) {
+        for (uint32_t c = 0; c < numComponents; ++c) {
+            T value;
+            if constexpr (std::is_floating_point_v<T>)
+                value = std::uniform_real_distribution<T>(-100, 100)(rng);
+            else
+                value = T(std::uniform_int_distribution<int64_t>(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max())(rng));
+            outValues[i * numComponents + c] = value;
+            std::memcpy(&out[i * stride + c * sizeof(T)], &value, sizeof(T));
+        }
+    }
+    return out;
+}
+
+template <typename T>
+static void testDecodeFloat(GLTFComponentType componentType, size_t count, uint32_t numComponents, size_t byteStride, bool normalized)
+{
+    std::vector<T> values;
+    const auto data = createRandomAccessorData<T>(count, numComponents, byteStride, values);
+    const GLTFAccessor accessor {
+        .data = data,
+        .count = count,
+        .byteStride = byteStride,
+        .componentType = componentType,
+        .numComponents = numComponents,
+        .normalized = normalized
+    };
+    std::vector<float> decoded(count * numComponents);
+    decodeAccessor(accessor, decoded);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        float expected = float(values[i]);
+        if (normalized) {
+            expected = std::max(expected / float(std::numeric_limits<T>::max()), -1.0f);
+            REQUIRE(decoded[i] >= -1.0f);
+            REQUIRE(decoded[i] <= 1.0f);
+        }
+        REQUIRE(decoded[i] == Catch::Approx(expected));
+    }
+}
+
+TEST_CASE("Render::GLTFAccessor::decodeAccessor float", "[Render]")
+{
+    for (const uint32_t numComponents : { 1, 2, 3, 4 }) {
+        // Tightly packed, interleaved with a vertex struct and large enough to be decoded in parallel.
+        testDecodeFloat<float>(GLTFComponentType::Float, 123, numComponents, 0, false);
+        testDecodeFloat<float>(GLTFComponentType::Float, 123, numComponents, 32, false);
+        testDecodeFloat<float>(GLTFComponentType::Float, 200000, numComponents, 0, false);
+    }
+}
+
+TEST_CASE("Render::GLTFAccessor::decodeAccessor normalized", "[Render]")
+{
+    for (const bool normalized : { true, false }) {
+        for (const uint32_t numComponents : { 2, 3, 4 }) {
+            testDecodeFloat<int8_t>(GLTFComponentType::Byte, 123, numComponents, 0, normalized);
+            testDecodeFloat<uint8_t>(GLTFComponentType::UnsignedByte, 123, numComponents, 0, normalized);
+            testDecodeFloat<int16_t>(GLTFComponentType::Short, 123, numComponents, 0, normalized);
+            testDecodeFloat<uint16_t>(GLTFComponentType::UnsignedShort, 123, numComponents, 0, normalized);
+
+            // Vertex attributes are aligned to 4 bytes (GLTF 2.0 specification, section 3.6.2.4).
+            testDecodeFloat<int8_t>(GLTFComponentType::Byte, 123, numComponents, 4, normalized);
+            testDecodeFloat<uint16_t>(GLTFComponentType::UnsignedShort, 123, numComponents, 8, normalized);
+        }
+        testDecodeFloat<int16_t>(GLTFComponentType::Short, 200000, 4, 0, normalized);
+    }
+}
+
+template <typename T>
+static void testDecodeIndices(GLTFComponentType componentType, size_t count)
+{
+    std::vector<T> values;
+    const auto data = createRandomAccessorData<T>(count, 1, 0, values);
+    const GLTFAccessor accessor {
+        .data = data,
+        .count = count,
+        .componentType = componentType,
+        .numComponents = 1
+    };
+    std::vector<uint32_t> decoded(count);
+    decodeAccessor(accessor, decoded);
+    for (size_t i = 0; i < count; ++i)
+        REQUIRE(decoded[i] == values[i]);
+}
+
+TEST_CASE("Render::GLTFAccessor::decodeAccessor indices", "[Render]")
+{
+    for (const size_t count : { 0, 1, 7, 17, 1023, 200001 }) {
+        testDecodeIndices<uint8_t>(GLTFComponentType::UnsignedByte, count);
+        testDecodeIndices<uint16_t>(GLTFComponentType::UnsignedShort, count);
+        testDecodeIndices<uint32_t>(GLTFComponentType::UnsignedInt, count);
+    }
+}
+
+template <typename T>
+static void benchmarkDecode(const char* name, GLTFComponentType componentType, uint32_t numComponents, size_t byteStride, bool normalized)
+{
+    constexpr size_t count = 4 * 1024 * 1024;
+    std::vector<T> values;
+    const auto data = createRandomAccessorData<T>(count, numComponents, byteStride, values);
+    const GLTFAccessor accessor {
+        .data = data,
+        .count = count,
+        .byteStride = byteStride,
+        .componentType = componentType,
+        .numComponents = numComponents,
+        .normalized = normalized
+    };
+
+    if (numComponents == 1 && !std::is_floating_point_v<T>) {
+        std::vector<uint32_t> decoded(count);
+        BENCHMARK(name)
+        {
+            decodeAccessor(accessor, decoded);
+            return decoded.back();
+        };
+    } else {
+        std::vector<float> decoded(count * numComponents);
+        BENCHMARK(name)
+        {
+            decodeAccessor(accessor, decoded);
+            return decoded.back();
+        };
+    }
+}
+
+TEST_CASE("Render::GLTFAccessor::decodeAccessor benchmark", "[Render][.benchmark]")
+{
+    benchmarkDecode<float>("VEC3 float packed", GLTFComponentType::Float, 3, 0, false);
+    benchmarkDecode<float>("VEC3 float interleaved", GLTFComponentType::Float, 3, 32, false);
+    benchmarkDecode<float>("VEC2 float interleaved", GLTFComponentType::Float, 2, 32, false);
+    benchmarkDecode<int8_t>("VEC4 normalized byte", GLTFComponentType::Byte, 4, 0, true);
+    benchmarkDecode<uint16_t>("VEC2 normalized unsigned short", GLTFComponentType::UnsignedShort, 2, 0, true);
+    benchmarkDecode<int16_t>("VEC3 normalized short (padded)", GLTFComponentType::Short, 3, 8, true);
+    benchmarkDecode<uint8_t>("SCALAR unsigned byte indices", GLTFComponentType::UnsignedByte, 1, 0, false);
+    benchmarkDecode<uint16_t>("SCALAR unsigned short indices", GLTFComponentType::UnsignedShort, 1, 0, false);
+    benchmarkDecode<uint32_t>("SCALAR unsigned int indices", GLTFComponentType::UnsignedInt, 1, 0, false);
+}
@@ -154,6 +154,37 @@ TEST_CASE("Render::FrameGraph::ClearFrameBuffer", "[Render][GPU]")
     }
 }
 
+TEST_CASE("Render::FrameGraph::execute overhead", "[Render][GPU][.benchmark]")
+{
+    static constexpr uint32_t resolution = 64;
+    static constexpr int numFrameBuffers = 8;
+
+    Render::RenderContext renderContext {};
+
+    // Many cheap graphics passes so that the CPU overhead of FrameGraph::execute() dominates.
+    Render::FrameGraphBuilder frameGraphBuilder { &renderContext };
+    auto frameBufferDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, resolution, resolution);
+    frameBufferDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+    auto depthBufferDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_D32_FLOAT, resolution, resolution);
+    depthBufferDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+    for (int i = 0; i < numFrameBuffers; ++i) {
+        // Persistent such that none of the clear passes are culled (nothing reads these resources).
+        const auto frameBufferHandle = frameGraphBuilder.createPersistentResource(frameBufferDesc);
+        const auto depthBufferHandle = frameGraphBuilder.createPersistentResource(depthBufferDesc);
+        for (int j = 0; j < 4; ++j) {
+            frameGraphBuilder.clearFrameBuffer(frameBufferHandle, glm::vec4((float)j));
+            frameGraphBuilder.clearDepthBuffer(depthBufferHandle, 1.0f);
+        }
+    }
+    auto frameGraph = frameGraphBuilder.compile();
+
+    BENCHMARK("64 clear passes")
+    {
+        frameGraph.execute();
+    };
+    renderContext.waitForIdle();
+}
+
 TEST_CASE("Render::GPU::RasterDebug", "[Render][GPU]")
 {
     static constexpr float sphereRadius = 1.0f;
@@ -214,6 +245,65 @@ TEST_CASE("Render::GPU::RasterDebug", "[Render][GPU]")
     }
 }
 
+TEST_CASE("Render::GPU::Recompile frame graph", "[Render][GPU]")
+{
+    static constexpr float sphereRadius = 1.0f;
+    static constexpr float cameraDistance = 5.0f;
+
+    Render::RenderContext renderContext {};
+    std::vector<Render::TextureCPU> textures { createBasicTexture() };
+    std::vector<Render::MeshCPU> meshes { createSphereMesh(glm::vec3(0.0f), sphereRadius) };
+    Render::Scene scene;
+    scene.meshInstances.emplace_back().meshIdx = 0;
+    scene.loadFromMeshes(meshes, textures, renderContext);
+    scene.camera.aspectRatio = 1.0f;
+    scene.camera.fovY = 2 * std::tan(sphereRadius / cameraDistance);
+    scene.camera.transform = Core::Transform::lookAt(glm::vec3(0, 0, -cameraDistance), glm::vec3(0), glm::vec3(0, 1, 0));
+    scene.buildRayTracingAccelerationStructure(renderContext);
+
+    // Same render passes at a different resolution (like the editor does when the window is resized).
+    const Render::DownloadImagePass* pDownloadImagePass = nullptr;
+    const auto buildFrameGraph = [&](uint32_t resolution, Render::FrameGraph* pPreviousFrameGraph) {
+        Render::FrameGraphBuilder frameGraphBuilder { &renderContext };
+        auto frameBufferDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, resolution, resolution);
+        frameBufferDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+        auto frameBufferHandle = frameGraphBuilder.createPersistentResource(frameBufferDesc);
+        auto depthBufferDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_D32_FLOAT, resolution, resolution);
+        depthBufferDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+        auto depthBufferHandle = frameGraphBuilder.createTransientResource(depthBufferDesc);
+
+        frameGraphBuilder.clearFrameBuffer(frameBufferHandle, glm::vec4(0.0f));
+        frameGraphBuilder.clearDepthBuffer(depthBufferHandle, 1.0f);
+        frameGraphBuilder.addOperation<Render::RasterDebugPass>({ &scene })
+            .bind<"framebuffer">(frameBufferHandle)
+            .bind<"depthbuffer">(depthBufferHandle)
+            .finalize();
+        pDownloadImagePass = frameGraphBuilder.addOperation<Render::DownloadImagePass>()
+                                 .bind<"image">(frameBufferHandle)
+                                 .finalize();
+        return frameGraphBuilder.compile(pPreviousFrameGraph);
+    };
+
+    auto frameGraph = buildFrameGraph(128, nullptr);
+    frameGraph.execute();
+    renderContext.waitForIdle();
+    const auto statisticsBefore = renderContext.pipelineStateCache.getStatistics();
+    REQUIRE(statisticsBefore.numCreated > 0);
+
+    frameGraph = buildFrameGraph(64, &frameGraph);
+    const auto statisticsAfter = renderContext.pipelineStateCache.getStatistics();
+    REQUIRE(statisticsAfter.numCreated == statisticsBefore.numCreated);
+    REQUIRE(statisticsAfter.numReused > statisticsBefore.numReused);
+
+    frameGraph.execute();
+    const Render::TextureCPU texture = pDownloadImagePass->syncAndGetTexture(renderContext);
+    REQUIRE(texture.resolution == glm::uvec2(64));
+    using Pixel = glm::u8vec4;
+    const auto* pPixels = (const Pixel*)texture.pixelData.data();
+    REQUIRE(pPixels[32 * 64 + 32] == Pixel(127, 127, 127, 255)); // Center of the sphere.
+    REQUIRE(pPixels[0] == Pixel(0));
+}
+
 TEST_CASE("Render::GPU::PathTrace", "[Render][GPU]")
 {
     static constexpr glm::vec3 spherePosition = glm::vec3(0.0f);
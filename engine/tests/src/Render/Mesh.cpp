@@ -0,0 +1,335 @@
+#include "pch.h"
+#include <Engine/Render/Mesh.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace Render;
+
+// Mesh with one (randomly perturbed) grid per sub mesh.
+static MeshCPU createGridMesh(uint32_t numSubMeshes, uint32_t gridResolution, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> offsetDist { -0.2f, 0.2f };
+
+    MeshCPU out {};
+    for (uint32_t subMeshIdx = 0; subMeshIdx < numSubMeshes; ++subMeshIdx) {
+        SubMesh subMesh {
+            .indexStart = (uint32_t)out.indices.size(),
+            .baseVertex = (uint32_t)out.vertices.size(),
+            .numVertices = gridResolution * gridResolution
+        };
+        for (uint32_t y = 0; y < gridResolution; ++y) {
+            for (uint32_t x = 0; x < gridResolution; ++x) {
+                out.vertices.push_back(ShaderInputs::Vertex {
+                    .pos = glm::vec3(float(x) + offsetDist(rng), offsetDist(rng), float(y) + offsetDist(rng)),
+                    .normal = glm::vec3(0.0f, 1.0f, 0.0f),
+                    .texCoord = glm::vec2(x, y) / float(gridResolution) });
+
+                if (x + 1 < gridResolution && y + 1 < gridResolution) {
+                    const uint32_t i = y * gridResolution + x;
+                    out.indices.insert(std::end(out.indices), { i, i + gridResolution, i + 1, i + 1, i + gridResolution, i + gridResolution + 1 });
+                }
+            }
+        }
+        subMesh.numIndices = (uint32_t)out.indices.size() - subMesh.indexStart;
+        out.subMeshes.push_back(subMesh);
+        out.materials.emplace_back();
+    }
+    return out;
+}
+
+static bool isSameMeshlet(const Meshlet& lhs, const Meshlet& rhs)
+{
+    return lhs.vertexOffset == rhs.vertexOffset && lhs.primitiveOffset == rhs.primitiveOffset
+        && lhs.numVertices == rhs.numVertices && lhs.numPrimitives == rhs.numPrimitives && lhs.subMeshIdx == rhs.subMeshIdx
+        && lhs.boundingSphereCenter == rhs.boundingSphereCenter && lhs.boundingSphereRadius == rhs.boundingSphereRadius
+        && lhs.coneAxis == rhs.coneAxis && lhs.coneCutoff == rhs.coneCutoff;
+}
+
+// Triangles (as indices into the vertex array) rotated such that the smallest index comes first; keeps the winding order.
+using Triangle = std::array<uint32_t, 3>;
+static Triangle normalizeTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+{
+    if (i1 < i0 && i1 < i2)
+        return { i1, i2, i0 };
+    if (i2 < i0 && i2 < i1)
+        return { i2, i0, i1 };
+    return { i0, i1, i2 };
+}
+static std::vector<Triangle> decodeMeshlets(const MeshCPU& mesh)
+{
+    std::vector<Triangle> out;
+    for (const auto& meshlet : mesh.meshlets) {
+        for (uint32_t i = 0; i < meshlet.numPrimitives; ++i) {
+            const uint32_t encodedPrimitive = Meshlet::loadPrimitive(mesh.meshletPrimitives, meshlet.primitiveOffset + i);
+            const auto localToGlobal = [&](uint32_t shift) {
+                const uint32_t localIndex = (encodedPrimitive >> shift) & 0xFF;
+                REQUIRE(localIndex < meshlet.numVertices);
+                return mesh.meshletVertices[meshlet.vertexOffset + localIndex];
+            };
+            out.push_back(normalizeTriangle(localToGlobal(0), localToGlobal(8), localToGlobal(16)));
+        }
+    }
+    std::sort(std::begin(out), std::end(out));
+    return out;
+}
+static std::vector<Triangle> decodeLegacyMeshlets(std::span<const LegacyMeshlet> meshlets)
+{
+    std::vector<Triangle> out;
+    for (const auto& meshlet : meshlets) {
+        for (uint32_t i = 0; i < meshlet.numPrimitives; ++i) {
+            const uint32_t encodedPrimitive = meshlet.primitives[i];
+            out.push_back(normalizeTriangle(
+                meshlet.vertices[encodedPrimitive & 0xFF], meshlet.vertices[(encodedPrimitive >> 8) & 0xFF], meshlet.vertices[(encodedPrimitive >> 16) & 0xFF]));
+        }
+    }
+    std::sort(std::begin(out), std::end(out));
+    return out;
+}
+static std::vector<Triangle> meshTriangles(const MeshCPU& mesh)
+{
+    std::vector<Triangle> out;
+    for (const auto& subMesh : mesh.subMeshes) {
+        for (uint32_t i = subMesh.indexStart; i < subMesh.indexStart + subMesh.numIndices; i += 3)
+            out.push_back(normalizeTriangle(subMesh.baseVertex + mesh.indices[i], subMesh.baseVertex + mesh.indices[i + 1], subMesh.baseVertex + mesh.indices[i + 2]));
+    }
+    std::sort(std::begin(out), std::end(out));
+    return out;
+}
+
+TEST_CASE("Render::MeshCPU::generateMeshlets", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    std::vector<MeshCPU> meshes;
+    for (uint32_t i = 0; i < 16; ++i)
+        meshes.push_back(createGridMesh(1 + i % 4, 8 + 4 * i, rng));
+
+    // Reference: one mesh at a time.
+    std::vector<MeshCPU> referenceMeshes = meshes;
+    for (auto& mesh : referenceMeshes)
+        mesh.generateMeshlets();
+
+    for (const auto& mesh : referenceMeshes) {
+        uint32_t expectedMeshletStart = 0;
+        for (uint32_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+            const auto& subMesh = mesh.subMeshes[subMeshIdx];
+            REQUIRE(subMesh.meshletStart == expectedMeshletStart);
+            expectedMeshletStart += subMesh.numMeshlets;
+
+            // All triangles of the sub mesh are covered by its meshlets.
+            uint32_t numPrimitives = 0;
+            for (uint32_t meshletIdx = subMesh.meshletStart; meshletIdx < subMesh.meshletStart + subMesh.numMeshlets; ++meshletIdx) {
+                const auto& meshlet = mesh.meshlets[meshletIdx];
+                REQUIRE(meshlet.subMeshIdx == subMeshIdx);
+                REQUIRE(meshlet.numVertices <= Meshlet::MaxNumVertices);
+                REQUIRE(meshlet.numPrimitives <= Meshlet::MaxNumPrimitives);
+                for (uint32_t i = 0; i < meshlet.numVertices; ++i) {
+                    REQUIRE(mesh.meshletVertices[meshlet.vertexOffset + i] >= subMesh.baseVertex);
+                    REQUIRE(mesh.meshletVertices[meshlet.vertexOffset + i] < subMesh.baseVertex + subMesh.numVertices);
+                }
+                numPrimitives += meshlet.numPrimitives;
+            }
+            REQUIRE(numPrimitives == subMesh.numIndices / 3);
+        }
+        REQUIRE(expectedMeshletStart == mesh.meshlets.size());
+    }
+
+    // All meshes at once (in parallel) should produce the exact same output.
+    std::vector<MeshCPU*> pMeshes;
+    for (auto& mesh : meshes)
+        pMeshes.push_back(&mesh);
+    MeshCPU::generateMeshlets(pMeshes);
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx) {
+        const auto& mesh = meshes[meshIdx];
+        const auto& referenceMesh = referenceMeshes[meshIdx];
+        REQUIRE(mesh.meshlets.size() == referenceMesh.meshlets.size());
+        for (size_t meshletIdx = 0; meshletIdx < mesh.meshlets.size(); ++meshletIdx)
+            REQUIRE(isSameMeshlet(mesh.meshlets[meshletIdx], referenceMesh.meshlets[meshletIdx]));
+        REQUIRE(mesh.meshletVertices == referenceMesh.meshletVertices);
+        REQUIRE(mesh.meshletPrimitives == referenceMesh.meshletPrimitives);
+        for (size_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+            REQUIRE(mesh.subMeshes[subMeshIdx].meshletStart == referenceMesh.subMeshes[subMeshIdx].meshletStart);
+            REQUIRE(mesh.subMeshes[subMeshIdx].numMeshlets == referenceMesh.subMeshes[subMeshIdx].numMeshlets);
+        }
+    }
+}
+
+TEST_CASE("Render::MeshCPU::Compact meshlets", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    for (uint32_t i = 0; i < 8; ++i) {
+        auto mesh = createGridMesh(1 + i % 3, 4 + 8 * i, rng);
+        mesh.generateMeshlets();
+        REQUIRE(mesh.meshletPrimitives.size() == mesh.indices.size());
+
+        // The meshlets cover exactly the triangles of the index buffer (with the same winding order).
+        const auto triangles = meshTriangles(mesh);
+        REQUIRE(decodeMeshlets(mesh) == triangles);
+
+        // Both formats describe the same triangles, and converting back and forth is lossless.
+        const auto legacyMeshlets = mesh.legacyMeshlets();
+        REQUIRE(legacyMeshlets.size() == mesh.meshlets.size());
+        REQUIRE(decodeLegacyMeshlets(legacyMeshlets) == triangles);
+
+        MeshCPU convertedMesh = mesh;
+        convertedMesh.setMeshlets(legacyMeshlets);
+        REQUIRE(convertedMesh.meshlets.size() == mesh.meshlets.size());
+        for (size_t meshletIdx = 0; meshletIdx < mesh.meshlets.size(); ++meshletIdx)
+            REQUIRE(isSameMeshlet(convertedMesh.meshlets[meshletIdx], mesh.meshlets[meshletIdx]));
+        REQUIRE(convertedMesh.meshletVertices == mesh.meshletVertices);
+        REQUIRE(convertedMesh.meshletPrimitives == mesh.meshletPrimitives);
+
+        const MeshCPUView meshView = mesh;
+        REQUIRE(meshView.meshletSizeInBytes() < meshView.legacyMeshletSizeInBytes());
+    }
+}
+
+// Gives every corner of every triangle its own vertex and shuffles the triangles; the worst case input for MeshCPU::optimize.
+static void unweldAndShuffle(MeshCPU& mesh, std::mt19937& rng)
+{
+    std::vector<ShaderInputs::Vertex> vertices;
+    std::vector<uint32_t> indices;
+    for (auto& subMesh : mesh.subMeshes) {
+        std::vector<Triangle> triangles;
+        for (uint32_t i = subMesh.indexStart; i < subMesh.indexStart + subMesh.numIndices; i += 3)
+            triangles.push_back({ mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2] });
+        std::shuffle(std::begin(triangles), std::end(triangles), rng);
+
+        const uint32_t baseVertex = (uint32_t)vertices.size();
+        subMesh.indexStart = (uint32_t)indices.size();
+        for (const auto& triangle : triangles) {
+            for (uint32_t index : triangle) {
+                indices.push_back((uint32_t)vertices.size() - baseVertex);
+                vertices.push_back(mesh.vertices[subMesh.baseVertex + index]);
+            }
+        }
+        subMesh.baseVertex = baseVertex;
+        subMesh.numVertices = (uint32_t)vertices.size() - baseVertex;
+    }
+    mesh.vertices = std::move(vertices);
+    mesh.indices = std::move(indices);
+}
+
+// Triangles as vertex positions (rotated such that the smallest position comes first), which do not depend on the vertex order.
+using PositionTriangle = std::array<std::array<float, 3>, 3>;
+static std::vector<PositionTriangle> meshPositionTriangles(const MeshCPU& mesh)
+{
+    std::vector<PositionTriangle> out;
+    for (const auto& subMesh : mesh.subMeshes) {
+        for (uint32_t i = subMesh.indexStart; i < subMesh.indexStart + subMesh.numIndices; i += 3) {
+            PositionTriangle triangle;
+            for (uint32_t j = 0; j < 3; ++j) {
+                const auto& pos = mesh.vertices[subMesh.baseVertex + mesh.indices[i + j]].pos;
+                triangle[j] = { pos.x, pos.y, pos.z };
+            }
+            std::rotate(std::begin(triangle), std::min_element(std::begin(triangle), std::end(triangle)), std::end(triangle));
+            out.push_back(triangle);
+        }
+    }
+    std::sort(std::begin(out), std::end(out));
+    return out;
+}
+
+TEST_CASE("Render::MeshCPU::optimize", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    std::vector<MeshCPU> meshes;
+    for (uint32_t i = 0; i < 12; ++i) {
+        auto& mesh = meshes.emplace_back(createGridMesh(1 + i % 3, 4 + 4 * i, rng));
+        unweldAndShuffle(mesh, rng);
+        mesh.generateMeshlets();
+    }
+    const std::vector<MeshCPU> inputMeshes = meshes;
+
+    // Reference: one mesh at a time.
+    std::vector<MeshCPU> referenceMeshes = meshes;
+    for (auto& mesh : referenceMeshes) {
+        MeshCPU* pMesh = &mesh;
+        MeshCPU::optimize(std::span(&pMesh, 1));
+    }
+
+    std::vector<MeshCPU*> pMeshes;
+    for (auto& mesh : meshes)
+        pMeshes.push_back(&mesh);
+    const auto statistics = MeshCPU::optimize(pMeshes);
+    REQUIRE(statistics.after.numTriangles == statistics.before.numTriangles);
+    REQUIRE(statistics.numVerticesAfter < statistics.numVerticesBefore);
+    // Every corner of the input is a unique vertex (ACMR of 3); after welding, vertices are shared between triangles.
+    REQUIRE(statistics.before.acmr() == 3.0f);
+    REQUIRE(statistics.after.acmr() < 1.0f);
+    REQUIRE(statistics.after.numFetchedBytes < statistics.before.numFetchedBytes);
+
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx) {
+        const auto& mesh = meshes[meshIdx];
+        const auto& inputMesh = inputMeshes[meshIdx];
+        REQUIRE(mesh.vertices.size() == referenceMeshes[meshIdx].vertices.size());
+        for (size_t vertexIdx = 0; vertexIdx < mesh.vertices.size(); ++vertexIdx)
+            REQUIRE(mesh.vertices[vertexIdx].pos == referenceMeshes[meshIdx].vertices[vertexIdx].pos);
+        REQUIRE(mesh.indices == referenceMeshes[meshIdx].indices);
+
+        // The grid vertices are welded back together, without changing the shape of the mesh.
+        REQUIRE(meshPositionTriangles(mesh) == meshPositionTriangles(inputMesh));
+        uint32_t expectedBaseVertex = 0, expectedIndexStart = 0;
+        for (uint32_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+            const auto& subMesh = mesh.subMeshes[subMeshIdx];
+            const auto& inputSubMesh = inputMesh.subMeshes[subMeshIdx];
+            const uint32_t gridResolution = 4 + 4 * (uint32_t)meshIdx;
+            REQUIRE(subMesh.baseVertex == expectedBaseVertex);
+            REQUIRE(subMesh.indexStart == expectedIndexStart);
+            REQUIRE(subMesh.numVertices == gridResolution * gridResolution);
+            REQUIRE(subMesh.numIndices == inputSubMesh.numIndices);
+            REQUIRE(subMesh.meshletStart == inputSubMesh.meshletStart);
+            REQUIRE(subMesh.numMeshlets == inputSubMesh.numMeshlets);
+            expectedBaseVertex += subMesh.numVertices;
+            expectedIndexStart += subMesh.numIndices;
+        }
+
+        // The meshlets are remapped to the new vertices.
+        REQUIRE(decodeMeshlets(mesh) == meshTriangles(mesh));
+    }
+}
+
+TEST_CASE("Render::MeshCPU::generateMeshlets benchmark", "[Render][.benchmark]")
+{
+    std::mt19937 rng { 12345 };
+    std::vector<MeshCPU> meshes;
+    for (uint32_t i = 0; i < 256; ++i)
+        meshes.push_back(createGridMesh(1 + i % 4, 16 + i % 64, rng));
+    std::vector<MeshCPU*> pMeshes;
+    for (auto& mesh : meshes)
+        pMeshes.push_back(&mesh);
+
+    BENCHMARK("One mesh at a time (parallel over sub meshes)")
+    {
+        for (auto& mesh : meshes)
+            mesh.generateMeshlets();
+        return meshes.back().meshlets.size();
+    };
+
+    MeshletGenerationTimings timings;
+    BENCHMARK("All meshes in parallel")
+    {
+        timings = MeshCPU::generateMeshlets(pMeshes);
+        return meshes.back().meshlets.size();
+    };
+
+    size_t meshletSize = 0, legacyMeshletSize = 0;
+    for (const MeshCPUView mesh : meshes) {
+        meshletSize += mesh.meshletSizeInBytes();
+        legacyMeshletSize += mesh.legacyMeshletSizeInBytes();
+    }
+    WARN(fmt::format("Meshlets use {}KiB ({}KiB with fixed size meshlets)", meshletSize >> 10, legacyMeshletSize >> 10));
+
+    const auto toMilliseconds = [](std::chrono::nanoseconds duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    WARN(fmt::format("Total {:.1f}ms; summed over threads: gather {:.1f}ms, adjacency {:.1f}ms, meshlets {:.1f}ms, convert {:.1f}ms, culling data {:.1f}ms; concatenate {:.1f}ms",
+        toMilliseconds(timings.total), toMilliseconds(timings.gatherPositions), toMilliseconds(timings.generateAdjacency),
+        toMilliseconds(timings.computeMeshlets), toMilliseconds(timings.convertMeshlets), toMilliseconds(timings.computeCullingData), toMilliseconds(timings.concatenate)));
+}
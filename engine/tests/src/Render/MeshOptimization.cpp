@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "Meshes.h"
+#include <Engine/Render/MeshOptimization.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/vec3.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace Render;
+
+static void shuffleTriangles(std::span<uint32_t> indices, std::mt19937& rng)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+        triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+    std::shuffle(std::begin(triangles), std::end(triangles), rng);
+    for (size_t i = 0; i < triangles.size(); ++i)
+        std::copy(std::begin(triangles[i]), std::end(triangles[i]), std::begin(indices) + 3 * i);
+}
+
+// Sorted triangles, rotated such that the smallest index comes first (keeps the winding order).
+static std::vector<std::array<uint32_t, 3>> sortedTriangles(std::span<const uint32_t> indices)
+{
+    std::vector<std::array<uint32_t, 3>> out;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        std::array<uint32_t, 3> triangle { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(std::begin(triangle), std::min_element(std::begin(triangle), std::end(triangle)), std::end(triangle));
+        out.push_back(triangle);
+    }
+    std::sort(std::begin(out), std::end(out));
+    return out;
+}
+
+TEST_CASE("Render::MeshOptimization::analyzeVertexProcessing", "[Render]")
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    createGrid(64, positions, indices);
+
+    const auto ordered = analyzeVertexProcessing(indices, positions.size(), 32);
+    REQUIRE(ordered.numTriangles == indices.size() / 3);
+    REQUIRE(ordered.numVertices == positions.size());
+    REQUIRE(ordered.numVertexBytes == positions.size() * 32);
+    // Scanline order reuses the vertices of the previous triangle but not those of the previous row (cache of 16).
+    REQUIRE(ordered.acmr() > 0.9f);
+    REQUIRE(ordered.acmr() < 1.1f);
+    REQUIRE(ordered.atvr() < 2.1f);
+    REQUIRE(ordered.overfetch() >= 1.0f);
+
+    std::mt19937 rng { 12345 };
+    shuffleTriangles(indices, rng);
+    const auto shuffled = analyzeVertexProcessing(indices, positions.size(), 32);
+    REQUIRE(shuffled.numVertices == ordered.numVertices);
+    REQUIRE(shuffled.acmr() > 2.9f);
+    REQUIRE(shuffled.numFetchedBytes > ordered.numFetchedBytes);
+
+    // Statistics of multiple meshes are summed.
+    auto sum = ordered;
+    sum += shuffled;
+    REQUIRE(sum.numTriangles == 2 * ordered.numTriangles);
+    REQUIRE(sum.numTransformedVertices == ordered.numTransformedVertices + shuffled.numTransformedVertices);
+
+    // Every vertex misses the cache if none of them are shared.
+    const std::vector<uint32_t> unindexed { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+    const auto unindexedStatistics = analyzeVertexProcessing(unindexed, unindexed.size(), 32);
+    REQUIRE(unindexedStatistics.acmr() == 3.0f);
+    REQUIRE(unindexedStatistics.atvr() == 1.0f);
+}
+
+TEST_CASE("Render::MeshOptimization::optimizeOverdraw", "[Render]")
+{
+    // Two stacked grids (facing up): the top grid should be drawn first.
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    createGrid(32, positions, indices);
+    const size_t numBottomVertices = positions.size(), numBottomIndices = indices.size();
+    createGrid(32, positions, indices);
+    for (size_t i = numBottomVertices; i < positions.size(); ++i)
+        positions[i].y = 1.0f;
+    for (size_t i = numBottomIndices; i < indices.size(); ++i)
+        indices[i] += (uint32_t)numBottomVertices;
+
+    const auto inputTriangles = sortedTriangles(indices);
+    const float inputACMR = analyzeVertexProcessing(indices, positions.size(), 32).acmr();
+    optimizeOverdraw(indices, positions, 1.05f);
+
+    REQUIRE(sortedTriangles(indices) == inputTriangles);
+    REQUIRE(analyzeVertexProcessing(indices, positions.size(), 32).acmr() <= 1.1f * inputACMR);
+    REQUIRE(positions[indices[0]].y == 1.0f);
+    REQUIRE(positions[indices.back()].y == 0.0f);
+}
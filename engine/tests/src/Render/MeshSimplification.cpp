@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "Meshes.h"
+#include <Engine/Render/Mesh.h>
+#include <Engine/Render/MeshSimplification.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/geometric.hpp>
+#include <glm/gtc/constants.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Render;
+
+TEST_CASE("Render::simplifyMesh", "[Render]")
+{
+    SECTION("Flat surfaces are simplified without error")
+    {
+        constexpr uint32_t resolution = 32;
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        createGrid(resolution, positions, indices);
+
+        const auto simplified = simplifyMesh(positions, indices, 0);
+        REQUIRE(simplified.indices.size() % 3 == 0);
+        REQUIRE(simplified.indices.size() < indices.size() / 10);
+        REQUIRE(simplified.error < 1e-5f);
+
+        // Border vertices are locked, and the (unfolded) triangles should still cover the whole grid.
+        for (uint32_t y = 0; y < resolution; ++y) {
+            for (uint32_t x = 0; x < resolution; ++x) {
+                if (x == 0 || y == 0 || x == resolution - 1 || y == resolution - 1)
+                    REQUIRE(std::find(std::begin(simplified.indices), std::end(simplified.indices), y * resolution + x) != std::end(simplified.indices));
+            }
+        }
+        float area = 0.0f;
+        for (size_t i = 0; i < simplified.indices.size(); i += 3) {
+            const auto& p0 = positions[simplified.indices[i]];
+            const auto& p1 = positions[simplified.indices[i + 1]];
+            const auto& p2 = positions[simplified.indices[i + 2]];
+            const auto normal = glm::cross(p1 - p0, p2 - p0);
+            REQUIRE(normal.y > 0.0f); // Same orientation as the input triangles.
+            area += 0.5f * glm::length(normal);
+        }
+        REQUIRE(std::abs(area - float((resolution - 1) * (resolution - 1))) < 1e-3f);
+    }
+
+    SECTION("Curved surfaces")
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        createSphere(64, positions, indices);
+
+        const size_t targetNumIndices = indices.size() / 6 * 3;
+        const auto simplified = simplifyMesh(positions, indices, targetNumIndices);
+        REQUIRE(simplified.indices.size() <= targetNumIndices);
+        REQUIRE(simplified.indices.size() > targetNumIndices / 2);
+        REQUIRE(simplified.error > 0.0f);
+        REQUIRE(simplified.error < 0.01f);
+        for (size_t i = 0; i < simplified.indices.size(); i += 3) {
+            REQUIRE(simplified.indices[i] < positions.size());
+            const auto center = (positions[simplified.indices[i]] + positions[simplified.indices[i + 1]] + positions[simplified.indices[i + 2]]) / 3.0f;
+            REQUIRE(glm::length(center) > 0.95f);
+        }
+
+        // Any collapse on a sphere introduces some error.
+        const auto unchanged = simplifyMesh(positions, indices, targetNumIndices, 0.0f);
+        REQUIRE(unchanged.indices.size() == indices.size());
+        REQUIRE(unchanged.error == 0.0f);
+        const auto bounded = simplifyMesh(positions, indices, 0, 1e-3f);
+        REQUIRE(bounded.error <= 1e-3f);
+    }
+}
+
+TEST_CASE("Render::MeshCPU::generateSubMeshLODs", "[Render]")
+{
+    const std::vector<uint32_t> resolutions { 16, 64, 128 };
+    auto mesh = createSphereMesh(resolutions);
+    const LODGenerationSettings settings {};
+    mesh.generateSubMeshLODs(settings);
+
+    REQUIRE(std::is_sorted(std::begin(mesh.lods), std::end(mesh.lods), [](const SubMeshLOD& lhs, const SubMeshLOD& rhs) { return lhs.subMeshIdx < rhs.subMeshIdx; }));
+    for (uint32_t subMeshIdx = 0; subMeshIdx < mesh.subMeshes.size(); ++subMeshIdx) {
+        const auto& subMesh = mesh.subMeshes[subMeshIdx];
+        const auto subMeshLODs = findSubMeshLODs(mesh.lods, subMeshIdx);
+        REQUIRE(!subMeshLODs.empty());
+
+        uint32_t previousNumIndices = subMesh.numIndices;
+        float previousError = 0.0f;
+        for (const auto& lod : subMeshLODs) {
+            REQUIRE(lod.subMeshIdx == subMeshIdx);
+            REQUIRE(lod.numIndices % 3 == 0);
+            REQUIRE(lod.numIndices < previousNumIndices);
+            REQUIRE(lod.numIndices / 3 >= settings.minNumTriangles);
+            REQUIRE(lod.error >= previousError);
+            REQUIRE(lod.error <= settings.maxRelativeError * 2.0f * std::sqrt(3.0f) + 1e-5f);
+            for (uint32_t i = 0; i < lod.numIndices; ++i)
+                REQUIRE(mesh.lodIndices[lod.indexStart + i] < subMesh.numVertices);
+            previousNumIndices = lod.numIndices;
+            previousError = lod.error;
+        }
+    }
+    // Finer tessellations have more LODs.
+    REQUIRE(findSubMeshLODs(mesh.lods, 0).size() < findSubMeshLODs(mesh.lods, 2).size());
+
+    // Generating the LODs of multiple meshes at once gives the same result.
+    std::vector<MeshCPU> meshes { createSphereMesh(resolutions), createSphereMesh(resolutions) };
+    std::vector<MeshCPU*> pMeshes { &meshes[0], &meshes[1] };
+    MeshCPU::generateSubMeshLODs(pMeshes, settings);
+    for (const auto& otherMesh : meshes) {
+        REQUIRE(otherMesh.lodIndices == mesh.lodIndices);
+        REQUIRE(otherMesh.lods.size() == mesh.lods.size());
+        for (size_t i = 0; i < mesh.lods.size(); ++i) {
+            REQUIRE(otherMesh.lods[i].indexStart == mesh.lods[i].indexStart);
+            REQUIRE(otherMesh.lods[i].error == mesh.lods[i].error);
+        }
+    }
+}
+
+TEST_CASE("Render::LODSelector", "[Render]")
+{
+    // 500 pixels per unit at unit distance.
+    const LODSelector selector { glm::half_pi<float>(), 1000, 1.0f };
+    REQUIRE(selector.projectedError(0.5f, 10.0f) == Catch::Approx(25.0f));
+
+    const std::vector<SubMeshLOD> lods {
+        { .subMeshIdx = 0, .indexStart = 0, .numIndices = 3, .error = 0.125f },
+        { .subMeshIdx = 0, .indexStart = 3, .numIndices = 3, .error = 0.5f },
+        { .subMeshIdx = 0, .indexStart = 6, .numIndices = 3, .error = 2.0f }
+    };
+    REQUIRE(selector.selectLOD(lods, 0.0f) == 0);
+    REQUIRE(selector.selectLOD(lods, 10.0f) == 0);
+    REQUIRE(selector.selectLOD(lods, 100.0f) == 1);
+    REQUIRE(selector.selectLOD(lods, 300.0f) == 2);
+    REQUIRE(selector.selectLOD(lods, 2000.0f) == 3);
+    REQUIRE(selector.selectLOD({}, 2000.0f) == 0);
+
+    // A larger pixel error selects coarser LODs at the same distance.
+    const LODSelector coarseSelector { glm::half_pi<float>(), 1000, 8.0f };
+    REQUIRE(coarseSelector.selectLOD(lods, 100.0f) == 2);
+}
@@ -0,0 +1,60 @@
+#include "Meshes.h"
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/gtc/constants.hpp>
+#include <glm/vec2.hpp>
+DISABLE_WARNINGS_POP()
+#include <cmath>
+
+void createGrid(uint32_t resolution, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+{
+    for (uint32_t y = 0; y < resolution; ++y) {
+        for (uint32_t x = 0; x < resolution; ++x) {
+            positions.push_back(glm::vec3(float(x), 0.0f, float(y)));
+            if (x + 1 < resolution && y + 1 < resolution) {
+                const uint32_t i = y * resolution + x;
+                indices.insert(std::end(indices), { i, i + resolution, i + 1, i + 1, i + resolution, i + resolution + 1 });
+            }
+        }
+    }
+}
+
+void createSphere(uint32_t resolution, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+{
+    for (uint32_t i = 0; i <= resolution; ++i) {
+        for (uint32_t j = 0; j <= resolution; ++j) {
+            const float theta = glm::pi<float>() * float(i) / float(resolution);
+            const float phi = glm::two_pi<float>() * float(j) / float(resolution);
+            positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (uint32_t i = 0; i < resolution; ++i) {
+        for (uint32_t j = 0; j < resolution; ++j) {
+            const uint32_t a = i * (resolution + 1) + j, b = a + resolution + 1;
+            indices.insert(std::end(indices), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+}
+
+Render::MeshCPU createSphereMesh(std::span<const uint32_t> resolutions, const glm::vec3& center, float radius)
+{
+    Render::MeshCPU out {};
+    for (uint32_t resolution : resolutions) {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        createSphere(resolution, positions, indices);
+        out.subMeshes.push_back({ .indexStart = (uint32_t)out.indices.size(),
+            .numIndices = (uint32_t)indices.size(),
+            .baseVertex = (uint32_t)out.vertices.size(),
+            .numVertices = (uint32_t)positions.size() });
+        for (uint32_t vertexIdx = 0; vertexIdx < positions.size(); ++vertexIdx) {
+            const glm::vec3& position = positions[vertexIdx];
+            out.vertices.push_back({ .pos = center + radius * position,
+                .normal = position,
+                .texCoord = glm::vec2(vertexIdx % (resolution + 1), vertexIdx / (resolution + 1)) / float(resolution) });
+        }
+        out.indices.insert(std::end(out.indices), std::begin(indices), std::end(indices));
+        out.materials.emplace_back();
+    }
+    return out;
+}
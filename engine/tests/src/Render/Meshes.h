@@ -0,0 +1,23 @@
+#pragma once
+#include <Engine/Render/Mesh.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/vec3.hpp>
+DISABLE_WARNINGS_POP()
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Flat grid of resolution x resolution vertices in the XZ plane, with the triangles in scanline order.
+void createGrid(uint32_t resolution, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices);
+
+// UV sphere of radius 1 around the origin; counter clockwise triangles facing outwards. Like a textured mesh, the vertices
+// along the seam and on the poles are duplicated.
+void createSphere(uint32_t resolution, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices);
+
+// Sphere mesh (see createSphere()) with one sub mesh per resolution, each with a default material. Meshlets are not generated.
+Render::MeshCPU createSphereMesh(std::span<const uint32_t> resolutions, const glm::vec3& center = glm::vec3(0.0f), float radius = 1.0f);
+inline Render::MeshCPU createSphereMesh(uint32_t resolution, const glm::vec3& center = glm::vec3(0.0f), float radius = 1.0f)
+{
+    return createSphereMesh(std::span(&resolution, 1), center, radius);
+}
@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "Meshes.h"
+#include <Engine/Render/Mesh.h>
+#include <Engine/Render/MeshletCulling.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+DISABLE_WARNINGS_POP()
+#include <cmath>
+#include <vector>
+
+using namespace Render;
+
+struct MeshletTriangle {
+    glm::vec3 p0, p1, p2;
+};
+static std::vector<MeshletTriangle> getTriangles(const MeshCPU& mesh, const Meshlet& meshlet)
+{
+    std::vector<MeshletTriangle> out;
+    const auto getPosition = [&](uint32_t localIndex) { return mesh.vertices[mesh.meshletVertices[meshlet.vertexOffset + localIndex]].pos; };
+    for (uint32_t i = 0; i < meshlet.numPrimitives; ++i) {
+        const uint32_t encodedPrimitive = Meshlet::loadPrimitive(mesh.meshletPrimitives, meshlet.primitiveOffset + i);
+        out.push_back({ getPosition(encodedPrimitive & 0xFF), getPosition((encodedPrimitive >> 8) & 0xFF), getPosition((encodedPrimitive >> 16) & 0xFF) });
+    }
+    return out;
+}
+
+TEST_CASE("Render::MeshCPU::generateMeshlets culling data", "[Render]")
+{
+    auto mesh = createSphereMesh(64);
+    mesh.generateMeshlets();
+    uint32_t numCones = 0;
+    for (const auto& meshlet : mesh.meshlets) {
+        for (uint32_t i = 0; i < meshlet.numVertices; ++i) {
+            const auto& position = mesh.vertices[mesh.meshletVertices[meshlet.vertexOffset + i]].pos;
+            REQUIRE(glm::distance(position, meshlet.boundingSphereCenter) <= meshlet.boundingSphereRadius + 1e-5f);
+        }
+
+        if (meshlet.coneCutoff == 1.0f)
+            continue;
+        ++numCones;
+        // All triangle normals lie inside the normal cone.
+        const float minDot = std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff);
+        for (const auto& [p0, p1, p2] : getTriangles(mesh, meshlet)) {
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            if (glm::length(normal) == 0.0f)
+                continue;
+            REQUIRE(glm::dot(glm::normalize(normal), meshlet.coneAxis) >= minDot - 1e-4f);
+        }
+    }
+    // Small patches of a (finely tessellated) sphere should have a narrow normal cone.
+    REQUIRE(numCones >= mesh.meshlets.size() * 9 / 10);
+}
+
+TEST_CASE("Render::MeshletCuller", "[Render]")
+{
+    auto mesh = createSphereMesh(64);
+    mesh.generateMeshlets();
+    const glm::vec3 cameraPosition { 0.0f, 0.0f, 5.0f };
+    const glm::mat4 viewProjectionMatrix = glm::perspectiveZO(glm::radians(60.0f), 1.0f, 0.1f, 100.0f)
+        * glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const MeshletCuller culler { viewProjectionMatrix, cameraPosition };
+
+    SECTION("Back facing meshlets are culled conservatively")
+    {
+        std::vector<uint32_t> visibleMeshlets;
+        const auto stats = culler.cull(mesh.meshlets, glm::mat4(1.0f), glm::mat3(1.0f), &visibleMeshlets);
+        REQUIRE(stats.numMeshlets == mesh.meshlets.size());
+        REQUIRE(stats.numOutsideFrustum == 0);
+        // From a distance of 5 radii ~60% of the sphere faces away from the camera.
+        REQUIRE(stats.numBackFacing > stats.numMeshlets / 4);
+        REQUIRE(stats.numVisible() == visibleMeshlets.size());
+
+        // No front facing triangle may ever be culled.
+        for (const auto& meshlet : mesh.meshlets) {
+            if (culler.test(meshlet, glm::mat4(1.0f), glm::mat3(1.0f)) != MeshletVisibility::BackFacing)
+                continue;
+            for (const auto& [p0, p1, p2] : getTriangles(mesh, meshlet)) {
+                const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+                REQUIRE(glm::dot(p0 - cameraPosition, normal) >= 0.0f);
+            }
+        }
+    }
+
+    SECTION("Meshlets outside the view frustum are culled")
+    {
+        // Behind the camera.
+        const auto behindStats = culler.cull(mesh.meshlets, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f)), glm::mat3(1.0f));
+        REQUIRE(behindStats.numOutsideFrustum == behindStats.numMeshlets);
+        // Beyond the far plane.
+        const auto farStats = culler.cull(mesh.meshlets, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -200.0f)), glm::mat3(1.0f));
+        REQUIRE(farStats.numOutsideFrustum == farStats.numMeshlets);
+        // Partially outside the left side of the frustum.
+        const auto partialStats = culler.cull(mesh.meshlets, glm::translate(glm::mat4(1.0f), glm::vec3(-2.9f, 0.0f, 0.0f)), glm::mat3(1.0f));
+        REQUIRE(partialStats.numOutsideFrustum > 0);
+        REQUIRE(partialStats.numOutsideFrustum < partialStats.numMeshlets);
+    }
+
+    SECTION("Bounding spheres scale with the instance")
+    {
+        // Just outside of the left side of the view frustum; scaling up the sphere makes part of it visible.
+        const auto modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(-4.5f, 0.0f, 0.0f));
+        const auto stats = culler.cull(mesh.meshlets, modelMatrix, glm::mat3(1.0f));
+        REQUIRE(stats.numOutsideFrustum == stats.numMeshlets);
+        const auto scaledStats = culler.cull(mesh.meshlets, glm::scale(modelMatrix, glm::vec3(3.0f)), glm::mat3(1.0f));
+        REQUIRE(scaledStats.numOutsideFrustum < scaledStats.numMeshlets);
+    }
+}
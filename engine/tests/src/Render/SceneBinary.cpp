@@ -0,0 +1,361 @@
+#include "pch.h"
+#include <Engine/Render/Mesh.h>
+#include <Engine/Render/Scene.h>
+#include <Engine/Render/SceneBinary.h>
+#include <Engine/Render/Texture.h>
+#include <Engine/Util/BinaryWriter.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <span>
+#include <vector>
+
+using namespace Render;
+
+static MeshCPU createRandomMesh(size_t numVertices, size_t numTriangles, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> positionDist { -1.0f, 1.0f };
+    std::uniform_int_distribution<uint32_t> indexDist { 0, (uint32_t)numVertices - 1 };
+
+    MeshCPU out {};
+    for (size_t i = 0; i < numVertices; ++i) {
+        out.vertices.push_back(ShaderInputs::Vertex {
+            .pos = glm::vec3(positionDist(rng), positionDist(rng), positionDist(rng)),
+            .normal = glm::vec3(0.0f, 1.0f, 0.0f),
+            .texCoord = glm::vec2(positionDist(rng), positionDist(rng)) });
+    }
+    for (size_t i = 0; i < 3 * numTriangles; ++i)
+        out.indices.push_back(indexDist(rng));
+    std::uniform_int_distribution<uint32_t> localIndexDist { 0, Meshlet::MaxNumVertices - 1 };
+    std::vector<LegacyMeshlet> meshlets(numTriangles / Meshlet::MaxNumPrimitives);
+    for (auto& meshlet : meshlets) {
+        meshlet.numVertices = Meshlet::MaxNumVertices;
+        meshlet.numPrimitives = Meshlet::MaxNumPrimitives;
+        meshlet.subMeshIdx = 0;
+        std::generate(std::begin(meshlet.vertices), std::end(meshlet.vertices), [&]() { return indexDist(rng); });
+        std::generate(std::begin(meshlet.primitives), std::end(meshlet.primitives),
+            [&]() { return Meshlet::encodePrimitive(localIndexDist(rng), localIndexDist(rng), localIndexDist(rng)); });
+    }
+    out.setMeshlets(meshlets);
+    out.subMeshes.push_back({ .indexStart = 0,
+        .numIndices = (uint32_t)out.indices.size(),
+        .baseVertex = 0,
+        .numVertices = (uint32_t)out.vertices.size(),
+        .meshletStart = 0,
+        .numMeshlets = (uint32_t)out.meshlets.size() });
+    out.materials.emplace_back(ShaderInputs::PBRMaterial {
+        .baseColor = glm::vec3(0.5f),
+        .baseColorTextureIdx = 0,
+        .metallic = 0.0f,
+        .alpha = 1.0f });
+    // Scene binary files do not care whether the LODs are actual simplifications.
+    for (uint32_t lod = 1; lod <= 2; ++lod) {
+        const size_t numIndices = 3 * (numTriangles >> lod);
+        out.lods.push_back({ .subMeshIdx = 0, .indexStart = (uint32_t)out.lodIndices.size(), .numIndices = (uint32_t)numIndices, .error = 0.1f * float(lod) });
+        out.lodIndices.insert(std::end(out.lodIndices), std::begin(out.indices), std::begin(out.indices) + numIndices);
+    }
+    return out;
+}
+
+static TextureCPU createRandomTexture(uint32_t resolution, std::mt19937& rng)
+{
+    TextureCPU out {
+        .resolution = glm::uvec2(resolution),
+        .textureFormat = DXGI_FORMAT_R8G8B8A8_UNORM,
+        .isOpague = true
+    };
+    out.pixelData.resize(resolution * resolution * 4);
+    std::generate(std::begin(out.pixelData), std::end(out.pixelData), [&]() { return (std::byte)rng(); });
+    out.mipLevels.push_back({ .mipLevelStart = 0, .rowPitch = resolution * 4 });
+    return out;
+}
+
+// Scene binary file as written by the previous (version 6) stream based implementation, with fixed size meshlets.
+static void storeLegacySceneBinary(const std::filesystem::path& filePath, const Scene& scene, std::span<const MeshCPU> meshes, std::span<const TextureCPU> textures)
+{
+    Util::BinaryWriter writer { filePath };
+    writer.write(SceneBinary::legacyVersionNumber);
+    writer.write(scene.sun);
+    writer.write(scene.meshInstances);
+    writer.write(scene.camera);
+    writer.write(meshes.size());
+    for (const auto& mesh : meshes) {
+        writer.write(mesh.vertices);
+        writer.write(mesh.indices);
+        writer.write(Meshlet::MaxNumPrimitives);
+        writer.write(Meshlet::MaxNumVertices);
+        writer.write(mesh.legacyMeshlets());
+        writer.write(mesh.bounds);
+        writer.write(mesh.subMeshes);
+        writer.write(mesh.materials);
+    }
+    writer.write(textures);
+}
+
+// Scene binary file as written by the version 7 (memory mapped) implementation, with fixed size meshlets.
+static void storeLegacyMeshletSceneBinary(const std::filesystem::path& filePath, const Scene& scene, std::span<const MeshCPU> meshes, std::span<const TextureCPU> textures)
+{
+    const std::vector<TextureCPUView> textureViews(std::begin(textures), std::end(textures));
+
+    Util::BinaryWriter writer { filePath };
+    writer.write(SceneBinary::legacyMeshletVersionNumber);
+    writer.write(scene.sun);
+    writer.write(scene.meshInstances);
+    writer.write(scene.camera);
+    writer.write(meshes.size());
+    for (const auto& mesh : meshes) {
+        writer.write(Meshlet::MaxNumPrimitives);
+        writer.write(Meshlet::MaxNumVertices);
+        writer.write(mesh.bounds);
+        writer.writeAligned(std::span<const ShaderInputs::Vertex>(mesh.vertices));
+        writer.writeAligned(std::span<const uint32_t>(mesh.indices));
+        writer.writeAligned(std::span<const LegacyMeshlet>(mesh.legacyMeshlets()));
+        writer.writeAligned(std::span<const SubMesh>(mesh.subMeshes));
+        writer.writeAligned(std::span<const MaterialCPU>(mesh.materials));
+    }
+    // TextureCPUView is trivially copyable; write the payloads rather than the pointers.
+    writer.write(textureViews.size());
+    for (const auto& textureView : textureViews)
+        textureView.writeTo(writer);
+}
+
+static void requireEqual(const MeshCPUView& lhs, const MeshCPU& rhs)
+{
+    REQUIRE(std::equal(std::begin(lhs.indices), std::end(lhs.indices), std::begin(rhs.indices), std::end(rhs.indices)));
+    REQUIRE(lhs.vertices.size() == rhs.vertices.size());
+    REQUIRE(std::memcmp(lhs.vertices.data(), rhs.vertices.data(), lhs.vertices.size_bytes()) == 0);
+    REQUIRE(lhs.meshlets.size() == rhs.meshlets.size());
+    REQUIRE(std::memcmp(lhs.meshlets.data(), rhs.meshlets.data(), lhs.meshlets.size_bytes()) == 0);
+    REQUIRE(std::equal(std::begin(lhs.meshletVertices), std::end(lhs.meshletVertices), std::begin(rhs.meshletVertices), std::end(rhs.meshletVertices)));
+    REQUIRE(std::equal(std::begin(lhs.meshletPrimitives), std::end(lhs.meshletPrimitives), std::begin(rhs.meshletPrimitives), std::end(rhs.meshletPrimitives)));
+    REQUIRE(lhs.subMeshes.size() == rhs.subMeshes.size());
+    REQUIRE(lhs.subMeshes[0].numMeshlets == rhs.subMeshes[0].numMeshlets);
+    REQUIRE(lhs.materials.size() == rhs.materials.size());
+    REQUIRE(lhs.materials[0].alpha == rhs.materials[0].alpha);
+}
+
+static void requireEqual(const TextureCPUView& lhs, const TextureCPU& rhs)
+{
+    REQUIRE(lhs.resolution == rhs.resolution);
+    REQUIRE(lhs.textureFormat == rhs.textureFormat);
+    REQUIRE(lhs.isOpague == rhs.isOpague);
+    REQUIRE(lhs.mipLevels.size() == rhs.mipLevels.size());
+    REQUIRE(std::equal(std::begin(lhs.pixelData), std::end(lhs.pixelData), std::begin(rhs.pixelData), std::end(rhs.pixelData)));
+}
+
+TEST_CASE("Render::SceneBinary::Store and load", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    Scene scene;
+    scene.meshInstances.emplace_back().meshIdx = 1;
+    scene.camera.fovY = 1.23f;
+    const std::vector<MeshCPU> meshes { createRandomMesh(100, 200, rng), createRandomMesh(1000, 3000, rng) };
+    const std::vector<TextureCPU> textures { createRandomTexture(8, rng), createRandomTexture(64, rng) };
+
+    SECTION("Current version")
+    {
+        const std::filesystem::path filePath = "test_scene_binary.bin";
+        SceneBinary::store(filePath, scene, meshes, textures);
+
+        const auto sceneBinary = SceneBinary::load(filePath);
+        REQUIRE(sceneBinary.fileVersionNumber == SceneBinary::versionNumber);
+        REQUIRE(sceneBinary.meshInstances.size() == 1);
+        REQUIRE(sceneBinary.meshInstances[0].meshIdx == 1);
+        REQUIRE(sceneBinary.camera.fovY == 1.23f);
+        REQUIRE(sceneBinary.meshes.size() == meshes.size());
+        REQUIRE(sceneBinary.textures.size() == textures.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            requireEqual(sceneBinary.meshes[i], meshes[i]);
+            REQUIRE(sceneBinary.meshes[i].lods.size() == meshes[i].lods.size());
+            REQUIRE(std::memcmp(sceneBinary.meshes[i].lods.data(), meshes[i].lods.data(), sceneBinary.meshes[i].lods.size_bytes()) == 0);
+            REQUIRE(std::equal(std::begin(sceneBinary.meshes[i].lodIndices), std::end(sceneBinary.meshes[i].lodIndices), std::begin(meshes[i].lodIndices), std::end(meshes[i].lodIndices)));
+            // Payloads should be aligned inside the memory mapped file.
+            REQUIRE((uintptr_t)sceneBinary.meshes[i].vertices.data() % 64 == 0);
+            REQUIRE((uintptr_t)sceneBinary.meshes[i].meshlets.data() % 64 == 0);
+            REQUIRE((uintptr_t)sceneBinary.meshes[i].meshletVertices.data() % 64 == 0);
+        }
+        for (size_t i = 0; i < textures.size(); ++i) {
+            requireEqual(sceneBinary.textures[i], textures[i]);
+            REQUIRE((uintptr_t)sceneBinary.textures[i].pixelData.data() % 64 == 0);
+        }
+    }
+
+    SECTION("Compressed vertices")
+    {
+        const std::filesystem::path filePath = "test_scene_binary_compressed.bin";
+        const std::filesystem::path uncompressedFilePath = "test_scene_binary_uncompressed.bin";
+        SceneBinary::store(filePath, scene, meshes, textures, VertexFormat::Compressed);
+        SceneBinary::store(uncompressedFilePath, scene, meshes, textures, VertexFormat::Float);
+        REQUIRE(std::filesystem::file_size(filePath) < std::filesystem::file_size(uncompressedFilePath));
+
+        const auto sceneBinary = SceneBinary::load(filePath);
+        REQUIRE(sceneBinary.fileVersionNumber == SceneBinary::versionNumber);
+        REQUIRE(sceneBinary.meshes.size() == meshes.size());
+        REQUIRE(sceneBinary.textures.size() == textures.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            const auto& mesh = sceneBinary.meshes[i];
+            REQUIRE(mesh.compressedVertices.size() == meshes[i].vertices.size());
+            REQUIRE(mesh.vertexQuantizations.size() == meshes[i].subMeshes.size());
+            REQUIRE(mesh.vertices.size() == meshes[i].vertices.size());
+            const glm::vec3 maxPositionError = mesh.vertexQuantizations[0].maxPositionError();
+            for (size_t j = 0; j < mesh.vertices.size(); ++j) {
+                const auto& decoded = mesh.vertices[j];
+                const auto& original = meshes[i].vertices[j];
+                const glm::vec3 positionError = glm::abs(decoded.pos - original.pos);
+                REQUIRE(positionError.x <= maxPositionError.x);
+                REQUIRE(positionError.y <= maxPositionError.y);
+                REQUIRE(positionError.z <= maxPositionError.z);
+                REQUIRE(glm::distance(decoded.normal, original.normal) <= maxNormalError);
+                const glm::vec2 maxTexCoordError = glm::max(glm::abs(original.texCoord), glm::vec2(std::ldexp(1.0f, -14))) * maxRelativeTexCoordError;
+                REQUIRE(std::abs(decoded.texCoord.x - original.texCoord.x) <= maxTexCoordError.x);
+                REQUIRE(std::abs(decoded.texCoord.y - original.texCoord.y) <= maxTexCoordError.y);
+            }
+            // All other payloads are unaffected.
+            REQUIRE(std::equal(std::begin(mesh.indices), std::end(mesh.indices), std::begin(meshes[i].indices), std::end(meshes[i].indices)));
+            REQUIRE(mesh.meshlets.size() == meshes[i].meshlets.size());
+            REQUIRE(std::memcmp(mesh.meshlets.data(), meshes[i].meshlets.data(), mesh.meshlets.size_bytes()) == 0);
+            REQUIRE(mesh.lods.size() == meshes[i].lods.size());
+        }
+        for (size_t i = 0; i < textures.size(); ++i)
+            requireEqual(sceneBinary.textures[i], textures[i]);
+    }
+
+    SECTION("Legacy version")
+    {
+        const std::filesystem::path filePath = "test_scene_binary_legacy.bin";
+        storeLegacySceneBinary(filePath, scene, meshes, textures);
+
+        const auto sceneBinary = SceneBinary::load(filePath);
+        REQUIRE(sceneBinary.fileVersionNumber == SceneBinary::legacyVersionNumber);
+        REQUIRE(sceneBinary.meshInstances.size() == 1);
+        REQUIRE(sceneBinary.camera.fovY == 1.23f);
+        REQUIRE(sceneBinary.meshes.size() == meshes.size());
+        REQUIRE(sceneBinary.textures.size() == textures.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            requireEqual(sceneBinary.meshes[i], meshes[i]);
+            REQUIRE(sceneBinary.meshes[i].lods.empty());
+        }
+        for (size_t i = 0; i < textures.size(); ++i)
+            requireEqual(sceneBinary.textures[i], textures[i]);
+    }
+
+    SECTION("Legacy meshlet version")
+    {
+        const std::filesystem::path filePath = "test_scene_binary_legacy_meshlets.bin";
+        storeLegacyMeshletSceneBinary(filePath, scene, meshes, textures);
+
+        const auto sceneBinary = SceneBinary::load(filePath);
+        REQUIRE(sceneBinary.fileVersionNumber == SceneBinary::legacyMeshletVersionNumber);
+        REQUIRE(sceneBinary.meshInstances.size() == 1);
+        REQUIRE(sceneBinary.camera.fovY == 1.23f);
+        REQUIRE(sceneBinary.meshes.size() == meshes.size());
+        REQUIRE(sceneBinary.textures.size() == textures.size());
+        for (size_t i = 0; i < meshes.size(); ++i) {
+            requireEqual(sceneBinary.meshes[i], meshes[i]);
+            REQUIRE(sceneBinary.meshes[i].lods.empty());
+        }
+        for (size_t i = 0; i < textures.size(); ++i)
+            requireEqual(sceneBinary.textures[i], textures[i]);
+    }
+}
+
+TEST_CASE("Render::SceneBinary::Load after the source data was destroyed", "[Render]")
+{
+    // The file must contain the payloads themselves, not pointers to the memory that they were stored from.
+    const std::filesystem::path filePath = "test_scene_binary_destroyed_source.bin";
+    const auto createMeshes = []() {
+        std::mt19937 rng { 12345 };
+        return std::vector<MeshCPU> { createRandomMesh(100, 200, rng), createRandomMesh(1000, 3000, rng) };
+    };
+    const auto createTextures = []() {
+        std::mt19937 rng { 54321 };
+        return std::vector<TextureCPU> { createRandomTexture(8, rng), createRandomTexture(64, rng) };
+    };
+    {
+        const auto meshes = createMeshes();
+        const auto textures = createTextures();
+        SceneBinary::store(filePath, Scene {}, meshes, textures);
+    }
+    // Overwrite the freed heap memory such that stale pointers do not happen to find the original values.
+    std::vector<std::vector<std::byte>> garbage;
+    for (int i = 0; i < 64; ++i)
+        garbage.emplace_back(64 * 1024, std::byte { 0xCD });
+
+    const auto sceneBinary = SceneBinary::load(filePath);
+    const auto meshes = createMeshes();
+    const auto textures = createTextures();
+    REQUIRE(sceneBinary.meshes.size() == meshes.size());
+    REQUIRE(sceneBinary.textures.size() == textures.size());
+    const auto requireAligned = [](const void* pointer) { REQUIRE((uintptr_t)pointer % 64 == 0); };
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const auto& mesh = sceneBinary.meshes[i];
+        requireEqual(mesh, meshes[i]);
+        REQUIRE(std::equal(std::begin(mesh.lodIndices), std::end(mesh.lodIndices), std::begin(meshes[i].lodIndices), std::end(meshes[i].lodIndices)));
+        requireAligned(mesh.vertices.data());
+        requireAligned(mesh.indices.data());
+        requireAligned(mesh.meshlets.data());
+        requireAligned(mesh.meshletVertices.data());
+        requireAligned(mesh.meshletPrimitives.data());
+        requireAligned(mesh.subMeshes.data());
+        requireAligned(mesh.materials.data());
+        requireAligned(mesh.lods.data());
+        requireAligned(mesh.lodIndices.data());
+    }
+    for (size_t i = 0; i < textures.size(); ++i) {
+        requireEqual(sceneBinary.textures[i], textures[i]);
+        requireAligned(sceneBinary.textures[i].mipLevels.data());
+        requireAligned(sceneBinary.textures[i].pixelData.data());
+    }
+}
+
+TEST_CASE("Render::SceneBinary::Load benchmark", "[Render][.benchmark]")
+{
+    std::mt19937 rng { 12345 };
+    Scene scene;
+    std::vector<MeshCPU> meshes;
+    std::vector<TextureCPU> textures;
+    for (int i = 0; i < 32; ++i)
+        meshes.push_back(createRandomMesh(64 * 1024, 128 * 1024, rng));
+    for (int i = 0; i < 16; ++i)
+        textures.push_back(createRandomTexture(1024, rng));
+
+    const std::filesystem::path legacyFilePath = "benchmark_scene_binary_legacy.bin";
+    const std::filesystem::path filePath = "benchmark_scene_binary.bin";
+    storeLegacySceneBinary(legacyFilePath, scene, meshes, textures);
+    SceneBinary::store(filePath, scene, meshes, textures);
+
+    // Touch every payload (like the GPU upload does) such that the lazily mapped file is read in full.
+    const auto checksum = [](const SceneBinary& sceneBinary) {
+        uint64_t out = 0;
+        const auto addBytes = [&](std::span<const std::byte> bytes) {
+            out = std::accumulate(std::begin(bytes), std::end(bytes), out, [](uint64_t lhs, std::byte rhs) { return lhs + (uint64_t)rhs; });
+        };
+        for (const auto& mesh : sceneBinary.meshes) {
+            addBytes(std::as_bytes(mesh.vertices));
+            addBytes(std::as_bytes(mesh.indices));
+            addBytes(std::as_bytes(mesh.meshlets));
+            addBytes(std::as_bytes(mesh.meshletVertices));
+            addBytes(std::as_bytes(mesh.meshletPrimitives));
+        }
+        for (const auto& texture : sceneBinary.textures)
+            addBytes(texture.pixelData);
+        return out;
+    };
+
+    BENCHMARK("Version 6 (BinaryReader)")
+    {
+        return checksum(SceneBinary::load(legacyFilePath));
+    };
+    BENCHMARK("Current version (memory mapped)")
+    {
+        return checksum(SceneBinary::load(filePath));
+    };
+}
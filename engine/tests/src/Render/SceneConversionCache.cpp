@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "GLTF.h"
+#include <Engine/Render/Scene.h>
+#include <Engine/Render/SceneConversionCache.h>
+#include <Engine/Render/SceneStreaming.h>
+#include <Engine/Util/TmpDir.h>
+#include <filesystem>
+
+using namespace Render;
+
+TEST_CASE("Render::SceneConversionCache::Reuse converted meshes", "[Render]")
+{
+    const std::filesystem::path filePath = "test_scene_conversion_cache.gltf";
+    writeTestGLTF(filePath, 8, 32);
+
+    Scene referenceScene;
+    CPUSceneUploadSink referenceSink {};
+    referenceScene.streamFromGLTF(filePath, referenceSink);
+
+    const Util::TmpDir cacheDirectory {};
+    const auto convert = [&](SceneConversionCache& cache) {
+        Scene scene;
+        CPUSceneUploadSink sink {};
+        scene.streamFromGLTF(filePath, sink, { .pConversionCache = &cache });
+        REQUIRE(sink.meshes.size() == referenceSink.meshes.size());
+        for (size_t meshIdx = 0; meshIdx < sink.meshes.size(); ++meshIdx) {
+            const auto& mesh = sink.meshes[meshIdx];
+            const auto& referenceMesh = referenceSink.meshes[meshIdx];
+            REQUIRE(mesh.indices == referenceMesh.indices);
+            REQUIRE(mesh.vertices.size() == referenceMesh.vertices.size());
+            REQUIRE(mesh.meshlets.size() == referenceMesh.meshlets.size());
+            REQUIRE(mesh.subMeshes.size() == referenceMesh.subMeshes.size());
+        }
+    };
+
+    {
+        SceneConversionCache cache { cacheDirectory };
+        convert(cache);
+        const auto stats = cache.stats();
+        REQUIRE(stats.meshHits == 0);
+        REQUIRE(stats.meshMisses == 8);
+    }
+    {
+        SceneConversionCache cache { cacheDirectory };
+        convert(cache);
+        const auto stats = cache.stats();
+        REQUIRE(stats.meshHits == 8);
+        REQUIRE(stats.meshMisses == 0);
+    }
+
+    SECTION("Changed meshes are converted again")
+    {
+        // The first 8 meshes are identical in both files; only the extra meshes are new.
+        writeTestGLTF(filePath, 12, 32);
+        SceneConversionCache cache { cacheDirectory };
+        Scene scene;
+        CPUSceneUploadSink sink {};
+        scene.streamFromGLTF(filePath, sink, { .pConversionCache = &cache });
+        const auto stats = cache.stats();
+        REQUIRE(stats.meshHits == 8);
+        REQUIRE(stats.meshMisses == 4);
+    }
+}
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "GLTF.h"
+#include <Engine/Render/Scene.h>
+#include <Engine/Render/SceneStreaming.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <fmt/format.h>
+DISABLE_WARNINGS_POP()
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <string>
+
+using namespace Render;
+
+TEST_CASE("Render::Scene::streamFromGLTF", "[Render]")
+{
+    const std::filesystem::path filePath = "test_scene_streaming.gltf";
+    writeTestGLTF(filePath, 16, 32);
+
+    // Reference: load everything in a single batch.
+    Scene referenceScene;
+    CPUSceneUploadSink referenceSink {};
+    const auto referenceStats = referenceScene.streamFromGLTF(filePath, referenceSink, { .memoryBudget = std::numeric_limits<size_t>::max() });
+    REQUIRE(referenceStats.numMeshBatches == 1);
+    REQUIRE(referenceStats.numTextureBatches == 1); // Dummy texture.
+    REQUIRE(referenceSink.meshes.size() == 16);
+    REQUIRE(referenceSink.textures.size() == 1);
+    REQUIRE(referenceScene.meshInstances.size() == 16);
+
+    const size_t largestMesh = std::max_element(std::begin(referenceSink.meshes), std::end(referenceSink.meshes),
+        [](const MeshCPU& lhs, const MeshCPU& rhs) { return lhs.sizeInBytes() < rhs.sizeInBytes(); })->sizeInBytes();
+
+    SECTION("Budget limits the peak amount of streamed data")
+    {
+        const StreamingLoadSettings settings { .memoryBudget = 4 * largestMesh };
+        Scene scene;
+        CPUSceneUploadSink sink {};
+        const auto stats = scene.streamFromGLTF(filePath, sink, settings);
+        REQUIRE(stats.numMeshBatches > 1);
+        REQUIRE(stats.peakStreamedBytes <= settings.memoryBudget + largestMesh);
+        REQUIRE(stats.peakStreamedBytes < referenceStats.peakStreamedBytes);
+        REQUIRE(scene.meshInstances.size() == referenceScene.meshInstances.size());
+
+        // Batching should not change the result.
+        REQUIRE(sink.meshes.size() == referenceSink.meshes.size());
+        for (size_t meshIdx = 0; meshIdx < sink.meshes.size(); ++meshIdx) {
+            const auto& mesh = sink.meshes[meshIdx];
+            const auto& referenceMesh = referenceSink.meshes[meshIdx];
+            REQUIRE(mesh.indices == referenceMesh.indices);
+            REQUIRE(mesh.vertices.size() == referenceMesh.vertices.size());
+            REQUIRE(mesh.meshlets.size() == referenceMesh.meshlets.size());
+        }
+    }
+
+    SECTION("Meshes larger than the budget are streamed one at a time")
+    {
+        Scene scene;
+        CPUSceneUploadSink sink { false };
+        const auto stats = scene.streamFromGLTF(filePath, sink, { .memoryBudget = 1 });
+        REQUIRE(stats.numMeshBatches == 16);
+        REQUIRE(stats.peakStreamedBytes <= largestMesh);
+        REQUIRE(sink.numMeshes == 16);
+        REQUIRE(sink.meshes.empty());
+        REQUIRE(sink.numMeshBytes == referenceSink.numMeshBytes);
+    }
+}
+
+TEST_CASE("Render::Scene::streamFromGLTF benchmark", "[Render][.benchmark]")
+{
+    const std::filesystem::path filePath = "benchmark_scene_streaming.gltf";
+    writeTestGLTF(filePath, 64, 256);
+
+    for (const size_t memoryBudget : { size_t(4) << 20, size_t(64) << 20, std::numeric_limits<size_t>::max() }) {
+        const std::string budgetString = memoryBudget == std::numeric_limits<size_t>::max() ? "unlimited" : fmt::format("{}MiB", memoryBudget >> 20);
+        StreamingLoadStats stats;
+        BENCHMARK(fmt::format("Budget {}", budgetString))
+        {
+            Scene scene;
+            CPUSceneUploadSink sink { false };
+            stats = scene.streamFromGLTF(filePath, sink, { .memoryBudget = memoryBudget });
+            return sink.numMeshBytes;
+        };
+        WARN(fmt::format("Budget {}: peak streamed data {}MiB in {} mesh batches", budgetString, stats.peakStreamedBytes >> 20, stats.numMeshBatches));
+    }
+}
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include <Engine/Render/UploadRing.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+
+using namespace Render;
+
+TEST_CASE("Render::UploadRing::Allocations are aligned and do not overlap", "[Render]")
+{
+    UploadRing ring { 4096 };
+    std::map<size_t, size_t> allocations; // Offset => size
+    std::mt19937 rng { 12345 };
+    while (true) {
+        const size_t size = 1 + rng() % 200;
+        const size_t alignment = size_t(1) << (rng() % 10);
+        const auto optOffset = ring.tryAllocate(size, alignment);
+        if (!optOffset)
+            break;
+        REQUIRE(*optOffset % alignment == 0);
+        REQUIRE(*optOffset + size <= ring.size());
+        if (!allocations.empty())
+            REQUIRE(*optOffset >= std::prev(allocations.end())->first + std::prev(allocations.end())->second);
+        allocations[*optOffset] = size;
+    }
+    REQUIRE(allocations.size() > 10);
+    REQUIRE(ring.hasOpenBatch());
+    REQUIRE(ring.usedSize() <= ring.size());
+}
+
+TEST_CASE("Render::UploadRing::Memory is reused once the fence of a batch is reached", "[Render]")
+{
+    UploadRing ring { 1024 };
+    REQUIRE(ring.tryAllocate(512, 16) == 0);
+    ring.closeBatch(1);
+    REQUIRE(ring.tryAllocate(256, 16) == 512);
+    ring.closeBatch(2);
+    REQUIRE(!ring.hasOpenBatch());
+    REQUIRE(ring.oldestBatchFenceValue() == 1);
+
+    // Does not fit at the end of the ring and the start is still in use.
+    REQUIRE(!ring.tryAllocate(300, 16));
+    ring.retire(0);
+    REQUIRE(!ring.tryAllocate(300, 16));
+
+    // Wraps around to the start of the ring; the remainder at the end of the ring is skipped.
+    ring.retire(1);
+    REQUIRE(ring.oldestBatchFenceValue() == 2);
+    REQUIRE(ring.tryAllocate(300, 16) == 0);
+    REQUIRE(ring.usedSize() == 256 + 256 + 300);
+    ring.closeBatch(3);
+
+    // The allocation must not overlap with the batch at [512, 768).
+    REQUIRE(!ring.tryAllocate(256, 16));
+    REQUIRE(ring.tryAllocate(200, 16) == 304);
+    ring.closeBatch(4);
+
+    ring.retire(4);
+    REQUIRE(ring.usedSize() == 0);
+    REQUIRE(!ring.oldestBatchFenceValue());
+    REQUIRE(ring.tryAllocate(1024, 16) == 0);
+}
+
+TEST_CASE("Render::UploadRing::Simulated uploads with a CPU stand-in for the GPU", "[Render]")
+{
+    // The "GPU" completes the submitted batches in order after a random delay; the data of every allocation must remain
+    // intact until its batch has completed.
+    constexpr size_t ringSize = 64 * 1024;
+    UploadRing ring { ringSize };
+    std::vector<uint32_t> stagingMemory(ringSize, 0);
+
+    struct Allocation {
+        size_t offset, size;
+        uint32_t value;
+    };
+    struct SubmittedBatch {
+        uint64_t fenceValue;
+        std::vector<Allocation> allocations;
+    };
+    std::deque<SubmittedBatch> submittedBatches;
+    std::vector<Allocation> openAllocations;
+    uint64_t fenceValue = 0, completedFenceValue = 0;
+
+    const auto completeOldestBatch = [&]() {
+        const auto& batch = submittedBatches.front();
+        for (const auto& allocation : batch.allocations) {
+            const auto begin = std::begin(stagingMemory) + allocation.offset;
+            REQUIRE(std::all_of(begin, begin + allocation.size, [&](uint32_t value) { return value == allocation.value; }));
+        }
+        completedFenceValue = batch.fenceValue;
+        submittedBatches.pop_front();
+    };
+    const auto submit = [&]() {
+        ring.closeBatch(++fenceValue);
+        submittedBatches.push_back({ .fenceValue = fenceValue, .allocations = std::move(openAllocations) });
+        openAllocations.clear();
+    };
+
+    std::mt19937 rng { 12345 };
+    uint32_t nextValue = 1;
+    for (int i = 0; i < 20000; i++) {
+        ring.retire(completedFenceValue);
+
+        const size_t size = rng() % 16 == 0 ? 1 + rng() % (ringSize / 2) : 1 + rng() % 1024;
+        auto optOffset = ring.tryAllocate(size, 4);
+        while (!optOffset) {
+            // The upload manager submits the open batch and waits for the oldest batch when the ring is full.
+            if (ring.hasOpenBatch())
+                submit();
+            REQUIRE(ring.oldestBatchFenceValue() == submittedBatches.front().fenceValue);
+            completeOldestBatch();
+            ring.retire(completedFenceValue);
+            optOffset = ring.tryAllocate(size, 4);
+        }
+        std::fill(std::begin(stagingMemory) + *optOffset, std::begin(stagingMemory) + *optOffset + size, nextValue);
+        openAllocations.push_back({ .offset = *optOffset, .size = size, .value = nextValue++ });
+
+        if (rng() % 8 == 0)
+            submit();
+        if (!submittedBatches.empty() && rng() % 4 == 0)
+            completeOldestBatch();
+    }
+
+    if (ring.hasOpenBatch())
+        submit();
+    while (!submittedBatches.empty())
+        completeOldestBatch();
+    ring.retire(completedFenceValue);
+    REQUIRE(ring.usedSize() == 0);
+}
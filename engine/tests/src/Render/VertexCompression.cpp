@@ -0,0 +1,104 @@
+#include "pch.h"
+#include <Engine/Render/VertexCompression.h>
+#include <tbx/disable_all_warnings.h>
+DISABLE_WARNINGS_PUSH()
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+DISABLE_WARNINGS_POP()
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Render;
+
+static std::vector<glm::vec3> createNormals(std::mt19937& rng)
+{
+    // Axis aligned and diagonal directions lie on the edges & corners of the octahedron.
+    std::vector<glm::vec3> out;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            for (int z = -1; z <= 1; ++z) {
+                if (x != 0 || y != 0 || z != 0)
+                    out.push_back(glm::normalize(glm::vec3(x, y, z)));
+            }
+        }
+    }
+    std::normal_distribution<float> dist {};
+    while (out.size() < 100000) {
+        const glm::vec3 direction { dist(rng), dist(rng), dist(rng) };
+        if (glm::length(direction) > 1e-3f)
+            out.push_back(glm::normalize(direction));
+    }
+    return out;
+}
+
+TEST_CASE("Render::VertexCompression::Normals", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    const VertexQuantization quantization { .offset = glm::vec3(0.0f), .scale = glm::vec3(0.0f) };
+    for (const auto& normal : createNormals(rng)) {
+        const glm::vec2 octahedralNormal = encodeOctahedral(normal);
+        REQUIRE(std::abs(octahedralNormal.x) <= 1.0f);
+        REQUIRE(std::abs(octahedralNormal.y) <= 1.0f);
+        REQUIRE(glm::distance(decodeOctahedral(octahedralNormal), normal) < 1e-5f);
+
+        const auto decoded = decodeVertex(encodeVertex({ .normal = normal }, quantization), quantization);
+        REQUIRE(glm::distance(decoded.normal, normal) <= maxNormalError);
+    }
+
+    // Vertices without a normal should not produce NaNs.
+    const auto decoded = decodeVertex(encodeVertex({ .normal = glm::vec3(0.0f) }, quantization), quantization);
+    REQUIRE(decoded.normal == glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+TEST_CASE("Render::VertexCompression::Positions", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    // Large offset, very different extents per axis, and a flat axis.
+    std::uniform_real_distribution<float> xDist { -1000.0f, -800.0f }, zDist { 3.0f, 3.01f };
+    std::vector<ShaderInputs::Vertex> vertices(10000);
+    for (auto& vertex : vertices)
+        vertex.pos = glm::vec3(xDist(rng), 42.0f, zDist(rng));
+
+    const auto quantization = VertexQuantization::fromVertices(vertices);
+    REQUIRE(quantization.scale.y == 0.0f);
+    const glm::vec3 maxError = quantization.maxPositionError();
+    REQUIRE(maxError.x < 200.0f / 65535.0f);
+
+    std::vector<CompressedVertex> compressedVertices(vertices.size());
+    encodeVertices(vertices, quantization, compressedVertices);
+    std::vector<ShaderInputs::Vertex> decodedVertices(vertices.size());
+    decodeVertices(compressedVertices, quantization, decodedVertices);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        REQUIRE(decodedVertices[i].pos.y == 42.0f);
+        const glm::vec3 error = glm::abs(decodedVertices[i].pos - vertices[i].pos);
+        REQUIRE(error.x <= maxError.x);
+        REQUIRE(error.z <= maxError.z);
+        REQUIRE(decodedVertices[i].pos == decodeVertex(compressedVertices[i], quantization).pos);
+    }
+
+    // The minimum corner of the bounding box is represented exactly.
+    const auto minCorner = decodeVertex(encodeVertex({ .pos = quantization.offset }, quantization), quantization);
+    REQUIRE(minCorner.pos == quantization.offset);
+}
+
+TEST_CASE("Render::VertexCompression::Texture coordinates", "[Render]")
+{
+    std::mt19937 rng { 12345 };
+    std::uniform_real_distribution<float> dist { -8.0f, 8.0f };
+    const VertexQuantization quantization { .offset = glm::vec3(0.0f), .scale = glm::vec3(0.0f) };
+    for (int i = 0; i < 10000; ++i) {
+        const glm::vec2 texCoord { dist(rng), std::ldexp(dist(rng), -(i % 16)) };
+        const auto decoded = decodeVertex(encodeVertex({ .texCoord = texCoord }, quantization), quantization);
+        const glm::vec2 error = glm::abs(decoded.texCoord - texCoord);
+        const glm::vec2 maxError = glm::max(glm::abs(texCoord), glm::vec2(std::ldexp(1.0f, -14))) * maxRelativeTexCoordError;
+        REQUIRE(error.x <= maxError.x);
+        REQUIRE(error.y <= maxError.y);
+    }
+
+    // Common texture coordinates are exact.
+    for (const float value : { 0.0f, 0.25f, 0.5f, 1.0f, -1.0f, 2.0f }) {
+        const auto decoded = decodeVertex(encodeVertex({ .texCoord = glm::vec2(value) }, quantization), quantization);
+        REQUIRE(decoded.texCoord == glm::vec2(value));
+    }
+}
@@ -5,32 +5,75 @@ DISABLE_WARNINGS_PUSH()
 #include <CLI/Formatter.hpp>
 DISABLE_WARNINGS_POP()
 #include <Engine/Render/Scene.h>
+#include <Engine/Render/SceneConversionCache.h>
 #include <filesystem>
 #include <iostream>
+#include <optional>
 #include <tbx/error_handling.h>
 
 int main()
 {
     Tbx::assert_always(SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED)));
 
-    std::filesystem::path inFile, outFile;
+    std::filesystem::path inFile, outFile, cacheDirectory;
     CLI::App app { "Add engine optimized texture & mesh representations" };
     app.add_option("in", inFile, "Input GLTF/GLB file")->required();
     app.add_option("out", outFile, "Output binary file")->required();
+    app.add_option("--cache", cacheDirectory, "Directory in which converted meshes & textures are cached between runs");
+    bool compressVertices = false;
+    app.add_flag("--compress-vertices", compressVertices, "Store quantized positions, octahedral normals and half precision texture coordinates");
+    bool noMeshOptimization = false;
+    app.add_flag("--no-mesh-optimization", noMeshOptimization, "Keep the vertices and the triangle order of the input meshes");
     try {
         app.parse(__argc, __argv);
     } catch (const CLI::ParseError& e) {
         app.exit(e);
     }
 
+    std::optional<Render::SceneConversionCache> optCache;
+    Render::StreamingLoadSettings settings {};
+    if (!cacheDirectory.empty())
+        settings.pConversionCache = &optCache.emplace(cacheDirectory);
+    settings.optimizeMeshes = !noMeshOptimization;
+
+    const auto vertexFormat = compressVertices ? Render::VertexFormat::Compressed : Render::VertexFormat::Float;
+    Render::StreamingLoadStats stats;
     if (inFile.extension() == ".gltf") {
-        Render::Scene::gltf2binary(inFile, outFile);
+        stats = Render::Scene::gltf2binary(inFile, outFile, settings, vertexFormat);
     } else if (inFile.extension() == ".glb") {
-        Render::Scene::glb2binary(inFile, outFile);
+        stats = Render::Scene::glb2binary(inFile, outFile, settings, vertexFormat);
     } else {
         std::cerr << "Unsupported file extension " << inFile.extension() << std::endl;
         return 1;
     }
 
+    if (settings.optimizeMeshes) {
+        // Only meshes that were not found in the cache are optimized (and counted).
+        const auto& before = stats.meshOptimization.before;
+        const auto& after = stats.meshOptimization.after;
+        std::cout << "Mesh optimization: " << stats.meshOptimization.numVerticesBefore << " -> " << stats.meshOptimization.numVerticesAfter << " vertices" << std::endl;
+        std::cout << "  ACMR: " << before.acmr() << " -> " << after.acmr() << std::endl;
+        std::cout << "  ATVR: " << before.atvr() << " -> " << after.atvr() << std::endl;
+        std::cout << "  Vertex fetch overfetch: " << before.overfetch() << " -> " << after.overfetch() << std::endl;
+    }
+    const double meshletMiB = double(stats.meshletMemoryUsage) / (1 << 20);
+    const double legacyMeshletMiB = double(stats.legacyMeshletMemoryUsage) / (1 << 20);
+    std::cout << "Meshlets: " << meshletMiB << " MiB (fixed size meshlets: " << legacyMeshletMiB << " MiB, saved " << (legacyMeshletMiB - meshletMiB) << " MiB)" << std::endl;
+    // Compressed vertices are decoded when the scene is loaded; the savings apply to the file and to vertex fetches by
+    // a renderer that consumes the compressed format directly.
+    const double vertexMiB = double(stats.vertexMemoryUsage) / (1 << 20);
+    const double compressedVertexMiB = double(stats.compressedVertexMemoryUsage) / (1 << 20);
+    if (compressVertices)
+        std::cout << "Vertices: " << compressedVertexMiB << " MiB (uncompressed: " << vertexMiB << " MiB, saved " << (vertexMiB - compressedVertexMiB) << " MiB of file size & vertex bandwidth)" << std::endl;
+    else
+        std::cout << "Vertices: " << vertexMiB << " MiB (compressed: " << compressedVertexMiB << " MiB, use --compress-vertices to save " << (vertexMiB - compressedVertexMiB) << " MiB)" << std::endl;
+    std::cout << "File size: " << double(std::filesystem::file_size(outFile)) / (1 << 20) << " MiB" << std::endl;
+
+    if (optCache) {
+        const auto cacheStats = optCache->stats();
+        std::cout << "Cache hits: " << cacheStats.meshHits << " meshes, " << cacheStats.textureHits << " textures" << std::endl;
+        std::cout << "Cache misses: " << cacheStats.meshMisses << " meshes, " << cacheStats.textureMisses << " textures" << std::endl;
+    }
+
     return 0;
 }
@@ -259,29 +259,29 @@ static void generateDeviceShaderInputGroup(
             const auto shaderBaseRegister = descriptor.descriptorOffset;
 
             const auto& variable = shaderInputGroup.variables[descriptor.variableIdx];
-            if (isCustomConstantVariableType(variable.type)) {
-                const auto& pConstantBuffer = getConstantBufferVariableType(variable.type);
-
-                stream << "cbuffer CONSTANT_DATA : register(b" << shaderBaseRegister << ", space" << shaderRegisterSpace << ") {" << std::endl;
-                for (const auto& constVariable : shaderInputGroup.variables) {
-                    if (isStandardContantVariableType(constVariable.type)) {
-                        stream << "\t" << typeName(constVariable.type, tree) << " _" << constVariable.name;
-                        if (constVariable.arrayCount != 0)
-                            stream << "[" << constVariable.arrayCount << "]";
-                        stream << ";" << std::endl;
-                    }
-                }
-                stream << "};" << std::endl;
-            } else {
-                stream << typeName(variable.type, tree) << " _" << variable.name;
-                if (variable.arrayCount == ast::Variable::Unbounded)
-                    stream << "[]";
-                else if (variable.arrayCount != 0)
-                    stream << "[" << variable.arrayCount << "]";
-                stream << " : register(" << registerTypeChar(variable.type) << shaderBaseRegister;
-                stream << ", space" << shaderRegisterSpace << ");" << std::endl;
+            stream << typeName(variable.type, tree) << " _" << variable.name;
+            if (variable.arrayCount == ast::Variable::Unbounded)
+                stream << "[]";
+            else if (variable.arrayCount != 0)
+                stream << "[" << variable.arrayCount << "]";
+            stream << " : register(" << registerTypeChar(variable.type) << shaderBaseRegister;
+            stream << ", space" << shaderRegisterSpace << ");" << std::endl;
+        }
+    }
+    // The constants are bound as a root CBV, which gets a register space of its own.
+    if (resourceBinding.optConstantBufferRootParameterOffset) {
+        const auto rootParameterIdx = *resourceBinding.optConstantBufferRootParameterOffset + rootParameterOffset;
+        const auto shaderRegisterSpace = rootParameterIdx + (shaderInputLayout.options.localRootSignature ? 500 : 0);
+        stream << "cbuffer CONSTANT_DATA : register(b0, space" << shaderRegisterSpace << ") {" << std::endl;
+        for (const auto& constVariable : shaderInputGroup.variables) {
+            if (isStandardContantVariableType(constVariable.type)) {
+                stream << "\t" << typeName(constVariable.type, tree) << " _" << constVariable.name;
+                if (constVariable.arrayCount != 0)
+                    stream << "[" << constVariable.arrayCount << "]";
+                stream << ";" << std::endl;
             }
         }
+        stream << "};" << std::endl;
     }
 
     // Write wrapper class with getters for the variables.
@@ -13,6 +13,7 @@ DISABLE_WARNINGS_PUSH()
 #include <spdlog/common.h> // for format_string_t
 #include <spdlog/spdlog.h> // for warn
 DISABLE_WARNINGS_POP()
+#include <algorithm> // for all_of
 #include <cstddef> // for size_t
 #include <cstdint> // for uint32_t
 #include <exception> // for exception
@@ -219,68 +220,86 @@ static void generateHostShaderInputGroup(const ast::ShaderInputGroup& shaderInpu
     const auto addGenerateBindingsCode = [&](bool transient) {
         stream << "\tinline " << shaderInputGroup.bindPointName << " generate" << (transient ? "Transient" : "Persistent") << "Bindings(Render::RenderContext& renderContext) const {" << std::endl;
         stream << "\t\t" << shaderInputGroup.bindPointName << " out {};" << std::endl;
-        const auto cbvSrvUavDescriptorAllocator = transient ? "renderContext.getCurrentCbvSrvUavDescriptorTransientAllocator()" : "renderContext.cbvSrvUavDescriptorStaticAllocator";
 
         for (const auto& rootParameter : bindings.rootParameters) {
             const auto& descriptorTable = rootParameter.descriptorTable;
+            std::string numDescriptors = std::to_string(rootParameter.descriptorTable.numKnownDescriptors);
+            if (descriptorTable.optUnboundedVariableIdx)
+                numDescriptors += " + (uint32_t)m_" + shaderInputGroup.variables[*descriptorTable.optUnboundedVariableIdx].name + ".size()";
+
+            // Descriptor tables only contain views (the constants are bound as a root CBV). Transient tables are looked up in the
+            // descriptor table cache (keyed by the views); the descriptors are only created when the table is not found.
+            const bool cached = transient;
+            const std::string indent = cached ? "\t\t\t\t" : "\t\t\t";
 
             stream << "\t\t{" << std::endl;
-            stream << "\t\t\tauto descriptorAllocation = " << cbvSrvUavDescriptorAllocator << ".allocate(" << rootParameter.descriptorTable.numKnownDescriptors;
-            if (descriptorTable.optUnboundedVariableIdx)
-                stream << " + (uint32_t)m_" << shaderInputGroup.variables[*descriptorTable.optUnboundedVariableIdx].name << ".size()";
-            stream << ");" << std::endl;
+            if (cached) {
+                stream << "\t\t\tRenderAPI::DescriptorTableCache::Key key { " << numDescriptors << " };" << std::endl;
+                for (const auto& descriptor : descriptorTable.descriptors) {
+                    const auto& variable = shaderInputGroup.variables[descriptor.variableIdx];
+                    if (variable.arrayCount == 0) {
+                        stream << fmt::format("\t\t\tif (m_{0})\n\t\t\t\tkey.addView({1}, *m_{0});", variable.name, descriptor.descriptorOffset) << std::endl;
+                    } else {
+                        stream << fmt::format("\t\t\tfor (uint32_t i = 0; i < (uint32_t)m_{0}.size(); ++i)\n\t\t\t\tkey.addView({1} + i, m_{0}[i]);", variable.name, descriptor.descriptorOffset) << std::endl;
+                    }
+                }
+                stream << "\t\t\tconst auto [descriptorAllocation, found] = renderContext.descriptorTableCache.findOrAllocate(key);" << std::endl;
+                stream << "\t\t\tif (!found) {" << std::endl;
+            } else {
+                stream << "\t\t\tauto descriptorAllocation = renderContext.cbvSrvUavDescriptorStaticAllocator.allocate(" << numDescriptors << ");" << std::endl;
+            }
 
-            stream << "\t\t\tconst auto descriptorIncrementSize = renderContext.pCbvSrvUavDescriptorBaseAllocatorCPU->descriptorIncrementSize;" << std::endl;
+            stream << indent << "const auto descriptorIncrementSize = renderContext.pCbvSrvUavDescriptorBaseAllocatorCPU->descriptorIncrementSize;" << std::endl;
             for (const auto& descriptor : descriptorTable.descriptors) {
                 const auto& variable = shaderInputGroup.variables[descriptor.variableIdx];
                 const RegisterType registerType = getDX12RenderRegisterType(variable.type);
-                if (registerType == RegisterType::ConstantBuffer)
-                    stream << "\t\t\t{" << std::endl;
-                else if (variable.arrayCount == 0) {
-                    stream << "\t\t\tif (m_" << variable.name << ") {" << std::endl;
+                if (variable.arrayCount == 0) {
+                    stream << indent << "if (m_" << variable.name << ") {" << std::endl;
                 } else {
-                    stream << "\t\t\tif (!m_" << variable.name << ".empty()) {" << std::endl;
+                    stream << indent << "if (!m_" << variable.name << ".empty()) {" << std::endl;
                 }
-                stream << "\t\t\t\tCD3DX12_CPU_DESCRIPTOR_HANDLE descriptor;" << std::endl;
-                stream << "\t\t\t\tdescriptor.InitOffsetted(descriptorAllocation.firstCPUDescriptor, " << descriptor.descriptorOffset << ", descriptorIncrementSize);" << std::endl;
-                if (registerType == RegisterType::ConstantBuffer) {
-                    if (transient) {
-                        stream << "\t\t\t\tauto& allocator = renderContext.singleFrameBufferAllocator;" << std::endl;
-                        stream << "\t\t\t\tconst auto desc = allocator.allocateCBV(m_constants);" << std::endl;
-                    } else {
-                        stream << "\t\t\t\tout.pConstantBuffer = renderContext.createBufferWithData(m_constants, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);" << std::endl;
-                        stream << "\t\t\t\tD3D12_CONSTANT_BUFFER_VIEW_DESC desc { .BufferLocation =  out.pConstantBuffer->GetGPUVirtualAddress(), .SizeInBytes = (UINT)Util::roundUpToClosestMultiplePowerOf2(sizeof(m_constants), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT) };" << std::endl;
-                    }
-                    stream << "\t\t\t\trenderContext.pDevice->CreateConstantBufferView(&desc, descriptor);" << std::endl;
-                } else if (registerType == RegisterType::UnorderedAccess || registerType == RegisterType::ShaderResource) {
+                stream << indent << "\tCD3DX12_CPU_DESCRIPTOR_HANDLE descriptor;" << std::endl;
+                stream << indent << "\tdescriptor.InitOffsetted(descriptorAllocation.firstCPUDescriptor, " << descriptor.descriptorOffset << ", descriptorIncrementSize);" << std::endl;
+                if (registerType == RegisterType::UnorderedAccess || registerType == RegisterType::ShaderResource) {
                     const auto createViewFunc = registerType == RegisterType::UnorderedAccess ? "CreateUnorderedAccessView" : "CreateShaderResourceView";
                     const auto extraArg = registerType == RegisterType::UnorderedAccess ? ", nullptr" : "";
                     if (variable.arrayCount == 0) {
-                        stream << fmt::format("\t\t\t\trenderContext.pDevice->{0}(m_{1}->pResource{2}, &m_{1}->desc, descriptor);",
+                        stream << indent << fmt::format("\trenderContext.pDevice->{0}(m_{1}->pResource{2}, &m_{1}->desc, descriptor);",
                             createViewFunc, variable.name, extraArg)
                                << std::endl;
                     } else {
-                        stream << "\t\t\t\tfor (size_t i = 0; i < ";
+                        stream << indent << "\tfor (size_t i = 0; i < ";
                         if (variable.arrayCount == ast::Variable::Unbounded)
                             stream << "m_" << variable.name << ".size()";
                         else
                             stream << variable.arrayCount;
                         stream << "; ++i) {" << std::endl;
-                        stream << fmt::format("\t\t\t\t\trenderContext.pDevice->{0}(m_{1}[i].pResource{2}, &m_{1}[i].desc, descriptor);",
+                        stream << indent << fmt::format("\t\trenderContext.pDevice->{0}(m_{1}[i].pResource{2}, &m_{1}[i].desc, descriptor);",
                             createViewFunc, variable.name, extraArg)
                                << std::endl;
-                        stream << "\t\t\t\t\tdescriptor = descriptor.Offset(1, descriptorIncrementSize);" << std::endl;
-                        stream << "\t\t\t\t}" << std::endl;
+                        stream << indent << "\t\tdescriptor = descriptor.Offset(1, descriptorIncrementSize);" << std::endl;
+                        stream << indent << "\t}" << std::endl;
                     }
                 } else {
                     // stream << "\t\t\t\tthrow std::runtime_error(\"not implemented yet\");" << std::endl;
-                    stream << "\t\t\t\tspdlog::error(\"not implemented yet\");" << std::endl;
+                    stream << indent << "\tspdlog::error(\"not implemented yet\");" << std::endl;
                 }
-                stream << "\t\t\t}" << std::endl;
+                stream << indent << "}" << std::endl;
             }
+            if (cached)
+                stream << "\t\t\t}" << std::endl;
             stream << "\t\t\tout.rootParameter" << rootParameter.rootParameterOffset << " = descriptorAllocation;" << std::endl;
             stream << "\t\t}" << std::endl;
         }
+        if (bindings.optConstantBufferRootParameterOffset) {
+            // Transient constants live in the per-frame ring buffer; persistent constants get a buffer of their own.
+            if (transient) {
+                stream << "\t\tout.constantBuffer = renderContext.singleFrameBufferAllocator.allocateCBV(m_constants).BufferLocation;" << std::endl;
+            } else {
+                stream << "\t\tout.pConstantBuffer = renderContext.createBufferWithData(m_constants, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);" << std::endl;
+                stream << "\t\tout.constantBuffer = out.pConstantBuffer->GetGPUVirtualAddress();" << std::endl;
+            }
+        }
         if (!transient)
             stream << "\t\tout.pParent = &renderContext;" << std::endl;
         stream << "\t\treturn out;" << std::endl;
@@ -452,14 +471,21 @@ static void generateHostBindPoint(const ast::BindPoint& bindPoint, const BindPoi
     for (const auto& rootParameter : bindings.rootParameters) {
         stream << "\tRenderAPI::DescriptorAllocation rootParameter" << rootParameter.rootParameterOffset << ";" << std::endl;
     }
+    if (bindings.optConstantBufferRootParameterOffset)
+        stream << "\tD3D12_GPU_VIRTUAL_ADDRESS constantBuffer = 0;" << std::endl;
     stream << "\tRenderAPI::D3D12MAResource pConstantBuffer;" << std::endl;
 
     // Destructor.
     stream << "\n\t" << bindPoint.name << "() = default;" << std::endl;
     stream << "\t~" << bindPoint.name << "() {" << std::endl;
     stream << "\t\tif (pParent) {" << std::endl;
+    // The descriptors may still be used by frames in flight; release them once the next graphics fence has been reached.
+    // This also covers the async compute queue: every frame ends on the graphics queue after waiting for its last async
+    // compute segment (asserted by scheduleQueues()). Bind points must not be destroyed while a frame graph is executing.
+    if (!bindings.rootParameters.empty())
+        stream << "\t\t\tconst uint64_t fenceValue = pParent->graphicsFence.fenceValue + 1;" << std::endl;
     for (const auto& rootParameter : bindings.rootParameters) {
-        stream << "\t\t\tpParent->cbvSrvUavDescriptorStaticAllocator.release(rootParameter" << rootParameter.rootParameterOffset << ");" << std::endl;
+        stream << "\t\t\tpParent->cbvSrvUavDescriptorStaticAllocator.release(rootParameter" << rootParameter.rootParameterOffset << ", fenceValue);" << std::endl;
     }
     stream << "\t\t}" << std::endl;
     stream << "\t}" << std::endl;
@@ -497,6 +523,11 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
                        << std::endl;
                 stream << "\t\t}" << std::endl;
             }
+            if (bindPointBindings.optConstantBufferRootParameterOffset) {
+                const uint32_t rootParameterIndex = rootParameterStartIndex + *bindPointBindings.optConstantBufferRootParameterOffset;
+                stream << "\t\tif (shaderInputGroup.constantBuffer)" << std::endl;
+                stream << fmt::format("\t\t\tpCommandList->Set{}RootConstantBufferView({}, shaderInputGroup.constantBuffer);", modeString, rootParameterIndex) << std::endl;
+            }
             stream << "\t}" << std::endl;
         };
         generateBindingCode("Graphics");
@@ -523,6 +554,7 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
         struct RootParameter {
             uint32_t bindPointIdx = (uint32_t)-1;
             uint32_t rootParameterOffset;
+            bool constantBuffer = false;
         };
         std::vector<RootParameter> shaderInputs;
         {
@@ -535,6 +567,12 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
                         shaderInputs.resize(rootParameterIndex + 1);
                     shaderInputs[rootParameterIndex] = { .bindPointIdx = bindPointIdx, .rootParameterOffset = rootParameter.rootParameterOffset };
                 }
+                if (bindPointBindings.optConstantBufferRootParameterOffset) {
+                    const uint32_t rootParameterIndex = rootParameterStartIndex + *bindPointBindings.optConstantBufferRootParameterOffset;
+                    if (rootParameterIndex >= shaderInputs.size())
+                        shaderInputs.resize(rootParameterIndex + 1);
+                    shaderInputs[rootParameterIndex] = { .bindPointIdx = bindPointIdx, .constantBuffer = true };
+                }
                 ++bindPointIdx;
             }
         }
@@ -551,6 +589,9 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
         for (const auto& rootParameter : shaderInputs) {
             if (rootParameter.bindPointIdx == (uint32_t)-1) {
                 stream << "\t\t\t0," << std::endl;
+            } else if (rootParameter.constantBuffer) {
+                // A root CBV is stored in the shader record as its 8 byte GPU virtual address, the same size as a descriptor handle.
+                stream << "\t\t\tCD3DX12_GPU_DESCRIPTOR_HANDLE { D3D12_GPU_DESCRIPTOR_HANDLE { shaderInputGroup" << rootParameter.bindPointIdx << ".constantBuffer } }," << std::endl;
             } else {
                 stream << "\t\t\tshaderInputGroup" << rootParameter.bindPointIdx << ".rootParameter" << rootParameter.rootParameterOffset << ".firstGPUDescriptor," << std::endl;
             }
@@ -575,6 +616,8 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
             const uint32_t rootParameterIndex = rootParameterStartIndex + rootParameter.rootParameterOffset;
             numRootParameters = std::max(numRootParameters, rootParameterIndex + 1);
         }
+        if (bindPointBindings.optConstantBufferRootParameterOffset)
+            numRootParameters = std::max(numRootParameters, rootParameterStartIndex + *bindPointBindings.optConstantBufferRootParameterOffset + 1);
     }
     for (uint32_t rootParameterIndex : shaderInputLayoutBindings.constantRootParameterIndices)
         numRootParameters = std::max(numRootParameters, rootParameterIndex + 1);
@@ -615,6 +658,24 @@ static void generateHostShaderInputLayout(const ast::ShaderInputLayout& shaderIn
             stream << "\t\t\trootParameters[" << rootParameterIndex << "].DescriptorTable.NumDescriptorRanges = " << rootParameter.descriptorTableLayout.ranges.size() << ";" << std::endl;
             stream << std::endl;
         }
+        // The constants of the bind point are bound as a root CBV (register b0) in a register space of its own.
+        if (bindPointBindings.optConstantBufferRootParameterOffset) {
+            const uint32_t rootParameterIndex = rootParameterStartIndex + *bindPointBindings.optConstantBufferRootParameterOffset;
+            const uint32_t shaderRegisterSpace = rootParameterIndex + (shaderInputLayout.options.localRootSignature ? 500 : 0);
+            bool allSameType = true;
+            auto firstShaderStage = bindPointReference.shaderStages[0];
+            for (const auto shaderStage : bindPointReference.shaderStages) {
+                if (shaderStage != ast::ShaderStage::Compute && shaderStage != ast::ShaderStage::RayTracing)
+                    requiresInputAssembler = true;
+                if (shaderStage != firstShaderStage)
+                    allSameType = false;
+            }
+            stream << "\t\t\trootParameters[" << rootParameterIndex << "].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;" << std::endl;
+            stream << "\t\t\trootParameters[" << rootParameterIndex << "].ShaderVisibility = " << (allSameType ? shaderVisibilityString(firstShaderStage) : "D3D12_SHADER_VISIBILITY_ALL") << ";" << std::endl;
+            stream << "\t\t\trootParameters[" << rootParameterIndex << "].Descriptor.ShaderRegister = 0;" << std::endl;
+            stream << "\t\t\trootParameters[" << rootParameterIndex << "].Descriptor.RegisterSpace = " << shaderRegisterSpace << ";" << std::endl;
+            stream << std::endl;
+        }
     }
     // Static samplers.
     const uint32_t staticSamplerRegisterSpace = 500 + (shaderInputLayout.options.localRootSignature ? 500 : 0);
@@ -80,6 +80,7 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
             // Compute the maximum register requirements (per register type) for any single input group.
             std::array<uint32_t, numRegisterTypes> numBoundedRegisters {};
             std::array<uint32_t, numRegisterTypes> numUnboundedVariables {};
+            bool hasConstantBuffer = false;
             for (const auto shaderInputGroupIndex : bindPoint->shaderInputGroups) {
                 std::array<uint32_t, numRegisterTypes> inputGroupNumBoundedRegisters {};
                 std::array<uint32_t, numRegisterTypes> inputGroupNumUnboundedVariables {};
@@ -89,6 +90,11 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
                     // Constants are allocated through the ConstantBuffer custom type. Groups have their individual variables allocated (see flattenInputGroups).
                     if (isStandardContantVariableType(variable.type) || std::holds_alternative<ast::GroupInstance>(variable.type))
                         continue;
+                    // The ConstantBuffer is bound as a root CBV rather than through a descriptor table.
+                    if (isCustomConstantVariableType(variable.type)) {
+                        hasConstantBuffer = true;
+                        continue;
+                    }
 
                     const auto registerType = getDX12RenderRegisterType(variable.type);
                     if (variable.arrayCount == ast::Variable::Unbounded)
@@ -103,8 +109,7 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
                 }
             }
 
-            // Compute how many DescriptorTableAllocators we need ahead of time.
-            // NOTE(Mathijs): currently only using DescriptorTables; but root descriptors or root constants could be added here.
+            // Compute how many DescriptorTableAllocators we need ahead of time. The constants (if any) get a root CBV after the tables.
             std::vector<DescriptorTableAllocator> registerAllocators;
             for (const auto [registerTypeInt, numUnboundedRangesOfType] : iter::enumerate(numUnboundedVariables)) {
                 for (uint32_t i = 0; i < numUnboundedRangesOfType; i++) {
@@ -137,7 +142,7 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
                 for (const auto& variableIdx : variableIndices) {
                     const auto& variable = variables[variableIdx];
                     // Constants are allocated through the ConstantBuffer custom type. Groups have their individual variables allocated (see flattenInputGroups).
-                    if (isStandardContantVariableType(variable.type) || std::holds_alternative<ast::GroupInstance>(variable.type))
+                    if (isStandardContantVariableType(variable.type) || std::holds_alternative<ast::GroupInstance>(variable.type) || isCustomConstantVariableType(variable.type))
                         continue;
 
                     for (auto& registerAllocator : registerAllocators) {
@@ -159,6 +164,10 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
                     };
                     shaderInputGroupBindings.rootParameters.emplace_back(std::move(rootParameter));
                 }
+                const bool groupHasConstantBuffer = std::any_of(std::begin(variables), std::end(variables),
+                    [](const ast::Variable& variable) { return isCustomConstantVariableType(variable.type); });
+                if (groupHasConstantBuffer)
+                    shaderInputGroupBindings.optConstantBufferRootParameterOffset = (uint32_t)registerAllocators.size();
                 bindPointBindings.shaderInputGroups.push_back(std::move(shaderInputGroupBindings));
             }
             Tbx::assert_always(bindPointBindings.shaderInputGroups.size() == bindPoint->shaderInputGroups.size());
@@ -171,6 +180,8 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
                 };
                 bindPointBindings.rootParameters.emplace_back(std::move(rootParameter));
             }
+            if (hasConstantBuffer)
+                bindPointBindings.optConstantBufferRootParameterOffset = (uint32_t)registerAllocators.size();
 
             return bindPointBindings;
         });
@@ -190,7 +201,7 @@ ResourceBindingInfo allocateRegisters(ast::AbstractSyntaxTree& abstractSyntaxTre
             }
             for (const ast::BindPointReference& bindPointRef : shaderInputLayout->bindPoints) {
                 shaderInputLayoutBindings.bindPointsRootParameterIndices.push_back(rootParameterIndex);
-                rootParameterIndex += (uint32_t)out.bindPoints[bindPointRef.bindPointIndex].rootParameters.size();
+                rootParameterIndex += out.bindPoints[bindPointRef.bindPointIndex].numRootParameters();
             }
             return shaderInputLayoutBindings;
         });
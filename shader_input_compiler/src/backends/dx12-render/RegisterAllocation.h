@@ -14,7 +14,8 @@ enum class RegisterType;
 
 namespace dx12_render {
 
-// Different types of root parameters. For now only DescriptorTable but may be extended to CBV or direct variables.
+// Different types of root parameters: descriptor tables for the views, and a root CBV for the constants of a shader input
+// group (such that the descriptor tables only contain views, which can be cached).
 struct DescriptorTable {
     struct Descriptor {
         uint32_t variableIdx;
@@ -40,6 +41,8 @@ struct ShaderInputGroupBindings {
         DescriptorTable descriptorTable;
     };
     std::vector<RootParameter> rootParameters;
+    // Root CBV of the bind point, if this shader input group has any constants.
+    std::optional<uint32_t> optConstantBufferRootParameterOffset;
 };
 
 struct BindPointBindings {
@@ -48,7 +51,14 @@ struct BindPointBindings {
         DescriptorTableLayout descriptorTableLayout;
     };
     std::vector<RootParameter> rootParameters;
+    // Root CBV (after the descriptor tables) if any of the shader input groups has constants.
+    std::optional<uint32_t> optConstantBufferRootParameterOffset;
     std::vector<ShaderInputGroupBindings> shaderInputGroups;
+
+    inline uint32_t numRootParameters() const
+    {
+        return (uint32_t)rootParameters.size() + (optConstantBufferRootParameterOffset ? 1 : 0);
+    }
 };
 
 struct ShaderInputLayoutBindings {